@@ -50,6 +50,11 @@ extern "C"
 #ifndef ALGO_ASSERT
 #	define ALGO_ASSERT assert
 #endif
+/* Time source for AlgoTimerWheel. Defaults to algoTimerWheelClockTicks(), a monotonic wall clock in nanoseconds.
+   Redefine to use another clock; the wheel's ticks are then in whatever unit it returns. */
+#ifndef ALGO_CLOCK_TICKS
+#	define ALGO_CLOCK_TICKS() algoTimerWheelClockTicks()
+#endif
 
 
 /** @brief Error code returned by algo functions. */
@@ -245,6 +250,230 @@ ALGODEF AlgoError algoHeapGetCapacity(const AlgoHeap heap, int32_t *outCapacity)
 /** @brief Retrieves the number of elements currently stored in the heap. */
 ALGODEF AlgoError algoHeapGetCurrentSize(const AlgoHeap heap, int32_t *outSize);
 
+/**
+ * @brief Implements a min-max heap (double-ended priority queue). Each element is inserted with a key; both the
+ *        "min" element (whose key keyCompare orders first; the one AlgoHeap would pop) and the "max" element (ordered
+ *        last) can be inspected in O(1) time and removed in O(log N) time. Useful for bounded searches that must both
+ *        expand the best candidate and evict the worst one when full.
+ * @code{.c}
+ * int32_t heapCapacity = 1024; // Change to suit your needs
+ * size_t heapBufferSize = 0;
+ * AlgoMinMaxHeap heap;
+ * AlgoError err;
+ * AlgoData poppedKey, poppedData;
+ *
+ * err = algoMinMaxHeapComputeBufferSize(&heapBufferSize, heapCapacity);
+ * err = algoMinMaxHeapCreate(&heap, heapCapacity, algoDataCompareIntAscending, malloc(heapBufferSize), heapBufferSize);
+ * err = algoMinMaxHeapInsert(heap, key, value);
+ * err = algoMinMaxHeapPopMin(heap, &poppedKey, &poppedData); // lowest key (with algoDataCompareIntAscending)
+ * err = algoMinMaxHeapPopMax(heap, &poppedKey, &poppedData); // highest key
+ * @endcode
+ */
+typedef struct AlgoMinMaxHeapImpl *AlgoMinMaxHeap;
+/** @brief Computes the required buffer size for a min-max heap with the specified capacity. */
+ALGODEF AlgoError algoMinMaxHeapComputeBufferSize(size_t *outBufferSize, int32_t heapCapacity);
+/** @brief Initializes a min-max heap object using the provided buffer. "Min" refers to keys that keyCompare orders first. */
+ALGODEF AlgoError algoMinMaxHeapCreate(AlgoMinMaxHeap *outHeap, int32_t heapCapacity, AlgoDataCompareFunc keyCompare,
+	void *buffer, size_t bufferSize);
+/** @brief Retrieves the size of the buffer passed when an AlgoMinMaxHeap was created. */
+ALGODEF AlgoError algoMinMaxHeapGetBufferSize(const AlgoMinMaxHeap heap, size_t *outBufferSize);
+/** @brief Inserts an element into the heap, with the specified key. */
+ALGODEF AlgoError algoMinMaxHeapInsert(AlgoMinMaxHeap heap, const AlgoData key, const AlgoData data);
+/** @brief Inspects the "min" element (the first in keyCompare order), but does not remove it from the heap. */
+ALGODEF AlgoError algoMinMaxHeapPeekMin(const AlgoMinMaxHeap heap, AlgoData *outMinKey, AlgoData *outMinData);
+/** @brief Inspects the "max" element (the last in keyCompare order), but does not remove it from the heap. */
+ALGODEF AlgoError algoMinMaxHeapPeekMax(const AlgoMinMaxHeap heap, AlgoData *outMaxKey, AlgoData *outMaxData);
+/** @brief Removes the "min" element from the heap. */
+ALGODEF AlgoError algoMinMaxHeapPopMin(AlgoMinMaxHeap heap, AlgoData *outMinKey, AlgoData *outMinData);
+/** @brief Removes the "max" element from the heap. */
+ALGODEF AlgoError algoMinMaxHeapPopMax(AlgoMinMaxHeap heap, AlgoData *outMaxKey, AlgoData *outMaxData);
+/** @brief Debugging function to validate heap consistency. */
+ALGODEF AlgoError algoMinMaxHeapValidate(const AlgoMinMaxHeap heap);
+/** @brief Retrieves the maximum number of elements that can be stored concurrently in the heap. */
+ALGODEF AlgoError algoMinMaxHeapGetCapacity(const AlgoMinMaxHeap heap, int32_t *outCapacity);
+/** @brief Retrieves the number of elements currently stored in the heap. */
+ALGODEF AlgoError algoMinMaxHeapGetCurrentSize(const AlgoMinMaxHeap heap, int32_t *outSize);
+
+/**
+ * @brief Implements a pairing heap: a pointer-based priority queue with O(1) insertion, O(1) meld, amortized O(log N)
+ *        removal, and decrease-key through node handles. Like AlgoHeap, popping removes the element whose key compares
+ *        lowest. Nodes are allocated from a user-provided AlgoAllocPool, which may be shared by several heaps; two heaps
+ *        can only be melded if they share the same pool and comparison function.
+ * @code{.c}
+ * int32_t nodeSize = 0, nodeCapacity = 1024; // Change to suit your needs
+ * size_t poolBufferSize = 0, heapBufferSize = 0;
+ * AlgoAllocPool nodePool;
+ * AlgoPairingHeap heap;
+ * AlgoPairingHeapNode node;
+ * AlgoError err;
+ * AlgoData poppedKey, poppedData;
+ *
+ * err = algoPairingHeapComputeNodeSize(&nodeSize);
+ * err = algoAllocPoolComputeBufferSize(&poolBufferSize, nodeSize, nodeCapacity);
+ * err = algoAllocPoolCreate(&nodePool, nodeSize, nodeCapacity, malloc(poolBufferSize), poolBufferSize);
+ * err = algoPairingHeapComputeBufferSize(&heapBufferSize);
+ * err = algoPairingHeapCreate(&heap, algoDataCompareIntAscending, nodePool, malloc(heapBufferSize), heapBufferSize);
+ * err = algoPairingHeapInsert(heap, key, value, &node);
+ * err = algoPairingHeapDecreaseKey(heap, node, smallerKey);
+ * err = algoPairingHeapPop(heap, &poppedKey, &poppedData);
+ * @endcode
+ */
+typedef struct AlgoPairingHeapImpl *AlgoPairingHeap;
+/** @brief Handle to an element in an AlgoPairingHeap. Valid from insertion until the element is popped. */
+typedef struct AlgoPairingHeapNodeImpl *AlgoPairingHeapNode;
+/** @brief Computes the element size to pass to algoAllocPoolCreate() when creating a pool of pairing heap nodes. */
+ALGODEF AlgoError algoPairingHeapComputeNodeSize(int32_t *outNodeSize);
+/** @brief Computes the required buffer size for a pairing heap. Nodes are stored separately, in the node pool. */
+ALGODEF AlgoError algoPairingHeapComputeBufferSize(size_t *outBufferSize);
+/** @brief Initializes a pairing heap object using the provided buffer.
+	@param outHeap Pointer to the pairing heap to initialize.
+	@param keyCompare Defines the ordering of keys within the heap.
+	@param nodePool Pool from which heap nodes are allocated. Its element size must be at least the value given by
+	                algoPairingHeapComputeNodeSize(). The pool must outlive the heap.
+	@param buffer Memory buffer to use for this object. Use algoPairingHeapComputeBufferSize() to compute the appropriate buffer size.
+	@param bufferSize Size of the "buffer" parameter, in bytes.
+	*/
+ALGODEF AlgoError algoPairingHeapCreate(AlgoPairingHeap *outHeap, AlgoDataCompareFunc keyCompare, AlgoAllocPool nodePool,
+	void *buffer, size_t bufferSize);
+/** @brief Retrieves the size of the buffer passed when an AlgoPairingHeap was created. */
+ALGODEF AlgoError algoPairingHeapGetBufferSize(const AlgoPairingHeap heap, size_t *outBufferSize);
+/** @brief Inserts an element into the heap, with the specified key. If outNode is non-NULL, it receives a handle
+           to the new element, which can be passed to algoPairingHeapDecreaseKey(). */
+ALGODEF AlgoError algoPairingHeapInsert(AlgoPairingHeap heap, const AlgoData key, const AlgoData data, AlgoPairingHeapNode *outNode);
+/** @brief Inspects the "top" element, but does not remove it from the heap. */
+ALGODEF AlgoError algoPairingHeapPeek(const AlgoPairingHeap heap, AlgoData *outTopKey, AlgoData *outTopData);
+/** @brief Removes the "top" element from the heap, and returns its node to the pool. */
+ALGODEF AlgoError algoPairingHeapPop(AlgoPairingHeap heap, AlgoData *outTopKey, AlgoData *outTopData);
+/** @brief Changes the key of an element to a new key of equal or higher priority.
+	@note  Passing a key of lower priority than the current key is an error. */
+ALGODEF AlgoError algoPairingHeapDecreaseKey(AlgoPairingHeap heap, AlgoPairingHeapNode node, const AlgoData newKey);
+/** @brief Moves every element of srcHeap into destHeap in O(1) time. srcHeap is left empty, but remains valid.
+           Both heaps must share the same node pool and key comparison function. Existing node handles remain valid,
+		   but now refer to elements of destHeap. */
+ALGODEF AlgoError algoPairingHeapMeld(AlgoPairingHeap destHeap, AlgoPairingHeap srcHeap);
+/** @brief Retrieves the key and data of the element referenced by a node handle. */
+ALGODEF AlgoError algoPairingHeapGetNodeContents(const AlgoPairingHeap heap, const AlgoPairingHeapNode node, AlgoData *outKey, AlgoData *outData);
+/** @brief Debugging function to validate heap consistency. */
+ALGODEF AlgoError algoPairingHeapValidate(const AlgoPairingHeap heap);
+/** @brief Retrieves the number of elements currently stored in the heap. */
+ALGODEF AlgoError algoPairingHeapGetCurrentSize(const AlgoPairingHeap heap, int32_t *outSize);
+
+/**
+ * @brief Implements a relaxed concurrent priority queue (a "MultiQueue"). Elements are spread across
+ *        relaxationFactor*threadCount independent AlgoHeaps, each protected by its own try-lock. Insertion goes into
+ *        a random heap; popping compares the tops of two random heaps and pops from the better one. Popped elements are
+ *        therefore only approximately in priority order, but concurrent callers rarely contend for the same lock.
+ *        All functions except algoMultiQueueCreate() may be called concurrently from multiple threads.
+ * @code{.c}
+ * int32_t capacity = 1024*1024, threadCount = 8, relaxationFactor = 2; // Change to suit your needs
+ * size_t queueBufferSize = 0;
+ * AlgoMultiQueue queue;
+ * AlgoError err;
+ * AlgoData poppedKey, poppedData;
+ *
+ * err = algoMultiQueueComputeBufferSize(&queueBufferSize, capacity, threadCount, relaxationFactor);
+ * err = algoMultiQueueCreate(&queue, capacity, threadCount, relaxationFactor, algoDataCompareIntAscending,
+ *     malloc(queueBufferSize), queueBufferSize);
+ * err = algoMultiQueueInsert(queue, key, value); // from any thread
+ * err = algoMultiQueuePop(queue, &poppedKey, &poppedData); // from any thread
+ * @endcode
+ */
+typedef struct AlgoMultiQueueImpl *AlgoMultiQueue;
+/** @brief Computes the required buffer size for a MultiQueue with the specified parameters.
+	@param outBufferSize The required buffer size is written here.
+	@param capacity Maximum number of elements that can be stored concurrently in the queue.
+	@param threadCount Number of threads expected to access the queue concurrently.
+	@param relaxationFactor Number of internal heaps per thread. Higher values reduce contention but weaken the ordering
+	                        guarantees of algoMultiQueuePop(). 2 is a reasonable default.
+	*/
+ALGODEF AlgoError algoMultiQueueComputeBufferSize(size_t *outBufferSize, int32_t capacity, int32_t threadCount, int32_t relaxationFactor);
+/** @brief Initializes a MultiQueue object using the provided buffer. The parameters must match those passed to
+           algoMultiQueueComputeBufferSize(). */
+ALGODEF AlgoError algoMultiQueueCreate(AlgoMultiQueue *outQueue, int32_t capacity, int32_t threadCount, int32_t relaxationFactor,
+	AlgoDataCompareFunc keyCompare, void *buffer, size_t bufferSize);
+/** @brief Retrieves the size of the buffer passed when an AlgoMultiQueue was created. */
+ALGODEF AlgoError algoMultiQueueGetBufferSize(const AlgoMultiQueue queue, size_t *outBufferSize);
+/** @brief Inserts an element into the queue, with the specified key. Fails if the queue is full. */
+ALGODEF AlgoError algoMultiQueueInsert(AlgoMultiQueue queue, const AlgoData key, const AlgoData data);
+/** @brief Removes a high-priority (but not necessarily the highest-priority) element from the queue.
+           Fails if the queue is empty. */
+ALGODEF AlgoError algoMultiQueuePop(AlgoMultiQueue queue, AlgoData *outKey, AlgoData *outData);
+/** @brief Retrieves the maximum number of elements that can be stored concurrently in the queue. */
+ALGODEF AlgoError algoMultiQueueGetCapacity(const AlgoMultiQueue queue, int32_t *outCapacity);
+/** @brief Retrieves the number of elements currently stored in the queue. If other threads are modifying the queue,
+           the result is only a snapshot. */
+ALGODEF AlgoError algoMultiQueueGetCurrentSize(const AlgoMultiQueue queue, int32_t *outSize);
+/** @brief Retrieves the number of internal heaps (relaxationFactor*threadCount). */
+ALGODEF AlgoError algoMultiQueueGetHeapCount(const AlgoMultiQueue queue, int32_t *outHeapCount);
+
+/**
+ * @brief Implements a hierarchical timing wheel: a timer scheduler with O(1) scheduling and cancellation, and O(1)
+ *        amortized work per expired timer. Time is an arbitrary unsigned 64-bit tick count; the wheel never interprets
+ *        its unit. ALGO_CLOCK_TICKS(), used by algoTimerWheelAdvanceToNow(), counts nanoseconds of monotonic wall-clock
+ *        time unless it is redefined, so deadlines keep advancing while the process sleeps or blocks. Each level of the wheel has 64 slots, each covering 64 times as many ticks as a slot in the level
+ *        below; timers in higher levels are cascaded down as time advances, and empty stretches of time are skipped
+ *        without visiting individual ticks. Timer nodes are allocated from an AlgoAllocPool inside the wheel's buffer.
+ * @code{.c}
+ * int32_t timerCapacity = 1024*1024; // Change to suit your needs
+ * size_t wheelBufferSize = 0;
+ * AlgoTimerWheel wheel;
+ * AlgoTimerWheelTimer timer;
+ * AlgoError err;
+ *
+ * err = algoTimerWheelComputeBufferSize(&wheelBufferSize, timerCapacity);
+ * err = algoTimerWheelCreate(&wheel, timerCapacity, ALGO_CLOCK_TICKS(), malloc(wheelBufferSize), wheelBufferSize);
+ * err = algoTimerWheelSchedule(wheel, ALGO_CLOCK_TICKS() + timeout, algoDataFromPtr(connection), &timer);
+ * err = algoTimerWheelCancel(wheel, timer); // if the connection closes before the timeout
+ * err = algoTimerWheelAdvanceToNow(wheel, onTimeout, userData); // fires every timer whose deadline has passed
+ * @endcode
+ */
+typedef struct AlgoTimerWheelImpl *AlgoTimerWheel;
+/** @brief Handle to a scheduled timer. Valid until the timer fires or is cancelled. */
+typedef struct AlgoTimerWheelTimerImpl *AlgoTimerWheelTimer;
+/** @brief Called once for each expired timer, with the deadline and data it was scheduled with. The callback may
+           schedule and cancel other timers, but must not advance the wheel. */
+typedef void (*AlgoTimerWheelCallback)(AlgoTimerWheel wheel, uint64_t deadline, AlgoData timerData, void *userData);
+/** @brief Computes the required buffer size for a timer wheel that can hold up to timerCapacity pending timers. */
+ALGODEF AlgoError algoTimerWheelComputeBufferSize(size_t *outBufferSize, int32_t timerCapacity);
+/** @brief Initializes a timer wheel object using the provided buffer.
+	@param outWheel Pointer to the timer wheel to initialize.
+	@param timerCapacity Maximum number of timers that can be pending at once.
+	@param startTime The wheel's initial current time.
+	@param buffer Memory buffer to use for this object. Use algoTimerWheelComputeBufferSize() to compute the appropriate buffer size.
+	@param bufferSize Size of the "buffer" parameter, in bytes.
+	*/
+ALGODEF AlgoError algoTimerWheelCreate(AlgoTimerWheel *outWheel, int32_t timerCapacity, uint64_t startTime,
+	void *buffer, size_t bufferSize);
+/** @brief Retrieves the size of the buffer passed when an AlgoTimerWheel was created. */
+ALGODEF AlgoError algoTimerWheelGetBufferSize(const AlgoTimerWheel wheel, size_t *outBufferSize);
+/** @brief Schedules a timer to fire once the wheel's current time reaches the specified deadline. Deadlines that have
+           already passed fire on the next advance. If outTimer is non-NULL, it receives a handle that can be passed to
+           algoTimerWheelCancel(). Fails if timerCapacity timers are already pending. */
+ALGODEF AlgoError algoTimerWheelSchedule(AlgoTimerWheel wheel, uint64_t deadline, AlgoData timerData, AlgoTimerWheelTimer *outTimer);
+/** @brief Cancels a pending timer. Its handle becomes invalid. */
+ALGODEF AlgoError algoTimerWheelCancel(AlgoTimerWheel wheel, AlgoTimerWheelTimer timer);
+/** @brief Advances the wheel's current time to newTime, invoking expiredFunc for every timer whose deadline is
+           <= newTime, in deadline order (timers that were already overdue when scheduled count as due one tick after
+           the time at which they were scheduled). newTime must not be earlier than the current time. */
+ALGODEF AlgoError algoTimerWheelAdvance(AlgoTimerWheel wheel, uint64_t newTime, AlgoTimerWheelCallback expiredFunc, void *userData);
+/** @brief Returns the current time of a monotonic wall clock, in nanoseconds. This is the default ALGO_CLOCK_TICKS(). Only
+           differences between two calls are meaningful. */
+ALGODEF uint64_t algoTimerWheelClockTicks(void);
+/** @brief Equivalent to algoTimerWheelAdvance(wheel, ALGO_CLOCK_TICKS(), expiredFunc, userData). Deadlines must be in
+           ALGO_CLOCK_TICKS() units (nanoseconds by default). */
+ALGODEF AlgoError algoTimerWheelAdvanceToNow(AlgoTimerWheel wheel, AlgoTimerWheelCallback expiredFunc, void *userData);
+/** @brief Retrieves the wheel's current time (the newTime passed to the most recent advance, or startTime). */
+ALGODEF AlgoError algoTimerWheelGetCurrentTime(const AlgoTimerWheel wheel, uint64_t *outTime);
+/** @brief Retrieves the deadline and data of a pending timer. */
+ALGODEF AlgoError algoTimerWheelGetTimerContents(const AlgoTimerWheel wheel, const AlgoTimerWheelTimer timer,
+	uint64_t *outDeadline, AlgoData *outTimerData);
+/** @brief Debugging function to validate timer wheel consistency. */
+ALGODEF AlgoError algoTimerWheelValidate(const AlgoTimerWheel wheel);
+/** @brief Retrieves the maximum number of timers that can be pending at once. */
+ALGODEF AlgoError algoTimerWheelGetCapacity(const AlgoTimerWheel wheel, int32_t *outCapacity);
+/** @brief Retrieves the number of timers currently pending. */
+ALGODEF AlgoError algoTimerWheelGetCurrentSize(const AlgoTimerWheel wheel, int32_t *outSize);
+
 /**
  * Implements a generic graph structure.
  */
@@ -256,12 +485,51 @@ typedef enum AlgoGraphEdgeMode
 	kAlgoGraphEdgeDirected   = 1, /**< Graph edges are directed; v0->v1 does not imply v1->v0. */
 } AlgoGraphEdgeMode;
 
+typedef enum AlgoGraphEdgeIndexMode
+{
+	kAlgoGraphEdgeIndexNone             = 0, /**< No edge index; edge lookups search the source vertex's edge list. */
+	kAlgoGraphEdgeIndexEnabled          = 1, /**< Maintain a hash index of all edges, for O(1) edge lookups and removals. */
+	kAlgoGraphEdgeIndexRejectDuplicates = 2, /**< As kAlgoGraphEdgeIndexEnabled, and algoGraphAddEdge() fails if the edge already exists. */
+} AlgoGraphEdgeIndexMode;
+
+/** Optional features of an AlgoGraph, passed to algoGraphCreateWithFlags(). These flags may be combined with bitwise OR. */
+typedef enum AlgoGraphFlags
+{
+	kAlgoGraphDefault = 0, /**< Default behavior */
+	kAlgoGraphInEdges = 1, /**< For directed graphs, also maintain a list of each vertex's incoming edges. */
+	kAlgoGraphEdgeWeights = 2, /**< Store a weight for each edge. Without it, every edge has a weight of 1. */
+} AlgoGraphFlags;
+
 /** @brief Computes the required buffer size for a graph with the specified vertex and edge capacities. */
 ALGODEF AlgoError algoGraphComputeBufferSize(size_t *outBufferSize, int32_t vertexCapacity, int32_t edgeCapacity,
 	const AlgoGraphEdgeMode edgeMode);
 /** @brief Initializes a graph object using the provided buffer. */
 ALGODEF AlgoError algoGraphCreate(AlgoGraph *outGraph, int32_t vertexCapacity, int32_t edgeCapacity,
 	const AlgoGraphEdgeMode edgeMode, void *buffer, size_t bufferSize);
+/** @brief Computes the required buffer size for a graph with an edge index. */
+ALGODEF AlgoError algoGraphComputeBufferSizeWithEdgeIndex(size_t *outBufferSize, int32_t vertexCapacity, int32_t edgeCapacity,
+	const AlgoGraphEdgeMode edgeMode, const AlgoGraphEdgeIndexMode indexMode);
+/** @brief Initializes a graph object with an edge index using the provided buffer.
+           The index is an open-addressing hash table keyed on (srcVertexId, destVertexId), stored in the graph's buffer.
+		   It makes algoGraphHasEdge(), algoGraphGetEdgeWeight(), algoGraphRemoveEdge() and the existing-edge check in
+		   algoGraphAddEdge() run in O(1) time (expected), regardless of vertex degree, at the cost of roughly
+		   24 bytes per edge capacity (per direction, for undirected graphs).
+	@param indexMode If kAlgoGraphEdgeIndexNone, this is equivalent to algoGraphCreate(). */
+ALGODEF AlgoError algoGraphCreateWithEdgeIndex(AlgoGraph *outGraph, int32_t vertexCapacity, int32_t edgeCapacity,
+	const AlgoGraphEdgeMode edgeMode, const AlgoGraphEdgeIndexMode indexMode, void *buffer, size_t bufferSize);
+/** @brief Computes the required buffer size for a graph with optional features. */
+ALGODEF AlgoError algoGraphComputeBufferSizeWithFlags(size_t *outBufferSize, int32_t vertexCapacity, int32_t edgeCapacity,
+	const AlgoGraphEdgeMode edgeMode, const AlgoGraphEdgeIndexMode indexMode, uint32_t graphFlags);
+/** @brief Initializes a graph object with an edge index and optional features using the provided buffer.
+           kAlgoGraphInEdges stores a second, reversed copy of every edge in a directed graph, so algoGraphGetVertexInEdges()
+		   and algoGraphRemoveVertex() don't need to search the whole graph. It is ignored for undirected graphs, where
+		   every edge is already stored in both directions. If the graph also has an edge index, the reversed copies are
+		   indexed too.
+		   kAlgoGraphEdgeWeights stores a 32-bit weight for every edge, which algoGraphAddWeightedEdge() requires.
+	@param graphFlags A combination of AlgoGraphFlags. If kAlgoGraphDefault, this is equivalent to
+	                  algoGraphCreateWithEdgeIndex(). */
+ALGODEF AlgoError algoGraphCreateWithFlags(AlgoGraph *outGraph, int32_t vertexCapacity, int32_t edgeCapacity,
+	const AlgoGraphEdgeMode edgeMode, const AlgoGraphEdgeIndexMode indexMode, uint32_t graphFlags, void *buffer, size_t bufferSize);
 /** @brief Retrieves the size of the buffer passed when an AlgoGraph was created. */
 ALGODEF AlgoError algoGraphGetBufferSize(const AlgoGraph graph, size_t *outBufferSize);
 /** @brief Debugging function to validate graph consistency. */
@@ -279,40 +547,181 @@ ALGODEF AlgoError algoGraphAddVertex(AlgoGraph graph, AlgoData vertexData, int32
 /** @brief Remove an existing vertex from a graph. This will implicitly remove any edges connecting this
            vertex to the rest of the graph.
 	@note  For undirected graphs, this operations runs in O(1) time (expected), approaching O(Ecurrent) in pathological cases.
-	       For directed graphs, this operation runs in O(Vcurrent+Ecurrent) time. */
+	       For directed graphs, this operation runs in O(Vcurrent+Ecurrent) time, unless the graph has in-edge lists;
+	       then it only visits the vertex's own edges, and runs in O(in+out degree) time (expected) if the graph also
+	       has a hash index. */
 ALGODEF AlgoError algoGraphRemoveVertex(AlgoGraph graph, int32_t vertexId);
 /** @brief Add a new edge to a graph, connecting srcVertexId to destVertexId.
            If the graph's edge mode is kAlgoGraphEdgeUndirected, a second edge will automatically be added
-		   from destVertexId to srcVertexId. */
+		   from destVertexId to srcVertexId.
+	@return kAlgoErrorOperationFailed if the edge already exists and the graph was created with
+	        kAlgoGraphEdgeIndexRejectDuplicates. Otherwise, adding an existing edge has no effect. */
 ALGODEF AlgoError algoGraphAddEdge(AlgoGraph graph, int32_t srcVertexId, int32_t destVertexId);
+/** @brief Add a new edge with the specified weight to a graph, connecting srcVertexId to destVertexId.
+           Edges added with algoGraphAddEdge() have a weight of 1, so shortest-path searches on unweighted graphs count
+		   edges. If the edge already exists, its weight is updated.
+		   If the graph's edge mode is kAlgoGraphEdgeUndirected, both directions share the same weight.
+	@return kAlgoErrorOperationFailed if the graph was created without kAlgoGraphEdgeWeights.
+	@note  Weights must be non-negative. */
+ALGODEF AlgoError algoGraphAddWeightedEdge(AlgoGraph graph, int32_t srcVertexId, int32_t destVertexId, int32_t weight);
+/** @brief Compute the required buffer size to add a batch of edges to a graph with algoGraphAddEdges(). */
+ALGODEF AlgoError algoGraphAddEdgesComputeBufferSize(size_t *outBufferSize, const AlgoGraph graph, int32_t edgeCount);
+/** @brief Add a batch of edges to a graph, connecting each srcVertexIds[i] to destVertexIds[i].
+           This is equivalent to calling algoGraphAddEdge() (or algoGraphAddWeightedEdge()) once per edge, but much faster:
+		   the batch is radix-sorted by source vertex, and each vertex's new edges are stored in consecutive edge blocks
+		   instead of being prepended one at a time.
+		   Edges that already exist in the graph (or that appear earlier in the batch) are skipped, and keep their
+		   original weights, unless the graph was created with kAlgoGraphEdgeIndexRejectDuplicates.
+	@param graph The graph to modify.
+	@param edgeCount Number of edges in the batch.
+	@param srcVertexIds Source vertex ID of each edge.
+	@param destVertexIds Destination vertex ID of each edge.
+	@param weights Weight of each edge. If NULL, all edges have a weight of 1. Must be NULL unless the graph was created
+	               with kAlgoGraphEdgeWeights.
+	@param buffer Scratch memory used to sort the batch. Not referenced after this function returns.
+	@param bufferSize Size of the buffer[] array, in bytes. Given by algoGraphAddEdgesComputeBufferSize().
+	@return kAlgoErrorInvalidArgument if any vertex ID is invalid, any edge connects a vertex to itself, or any weight is
+	        negative. kAlgoErrorOperationFailed if the new edges would exceed the graph's edge capacity, if weights is
+	        non-NULL and the graph was created without kAlgoGraphEdgeWeights, or if the graph was created with
+	        kAlgoGraphEdgeIndexRejectDuplicates and any edge in the batch is a duplicate. In all cases, the graph is left
+	        unmodified.
+	@note  This operation runs in O(Vcapacity + Ebatch) time (expected) if the graph has an edge index, or
+	       O(Vcapacity + Ebatch + the existing degrees of the batch's source vertices) otherwise. */
+ALGODEF AlgoError algoGraphAddEdges(AlgoGraph graph, int32_t edgeCount, const int32_t srcVertexIds[], const int32_t destVertexIds[],
+	const int32_t weights[], void *buffer, size_t bufferSize);
+/** @brief Retrieve the weight of the edge from srcVertexId to destVertexId. In graphs created without
+           kAlgoGraphEdgeWeights, this is always 1.
+	@return kAlgoErrorOperationFailed if no such edge exists. */
+ALGODEF AlgoError algoGraphGetEdgeWeight(const AlgoGraph graph, int32_t srcVertexId, int32_t destVertexId, int32_t *outWeight);
+/** @brief Determine whether the graph contains an edge from srcVertexId to destVertexId.
+	@note  This operation runs in O(1) time (expected) if the graph has an edge index, or O(degree of srcVertexId)
+	       otherwise. */
+ALGODEF AlgoError algoGraphHasEdge(const AlgoGraph graph, int32_t srcVertexId, int32_t destVertexId, int *outHasEdge);
 /** @brief Remove an existing vertex from a graph.
            If the graph's edge mode is kAlgoGraphEdgeUndirected, the edge from destVertexId to srcVertexId
 		   will also be removed.
-	@note  This operation runs in O(1) time (expected), approaching O(Ecurrent) in pathological cases. */
+	@note  This operation runs in O(1) time (expected) if the graph has an edge index. Otherwise, it runs in
+	       O(degree of srcVertexId) time, approaching O(Ecurrent) in pathological cases. */
 ALGODEF AlgoError algoGraphRemoveEdge(AlgoGraph graph, int32_t srcVertexId, int32_t destVertexId);
 /** @brief Retrieve the degree (outgoing edge count) of a vertex in the graph. */
 ALGODEF AlgoError algoGraphGetVertexDegree(const AlgoGraph graph, int32_t vertexId, int32_t *outDegree);
 /** @brief Retrieve the vertices to which a given vertex is connected. */
 ALGODEF AlgoError algoGraphGetVertexEdges(const AlgoGraph graph, int32_t srcVertexId, int32_t vertexDegree, int32_t outDestVertexIds[]);
+/** @brief Retrieve the in-degree (incoming edge count) of a vertex in the graph.
+	@return kAlgoErrorOperationFailed if the graph is directed and was created without kAlgoGraphInEdges.
+	        For undirected graphs, this is the same as algoGraphGetVertexDegree(). */
+ALGODEF AlgoError algoGraphGetVertexInDegree(const AlgoGraph graph, int32_t vertexId, int32_t *outInDegree);
+/** @brief Retrieve the vertices with edges leading to a given vertex.
+	@param vertexInDegree The vertex's in-degree, as returned by algoGraphGetVertexInDegree().
+	@param outSrcVertexIds Receives vertexInDegree source vertex IDs, in no particular order.
+	@return kAlgoErrorOperationFailed if the graph is directed and was created without kAlgoGraphInEdges.
+	        For undirected graphs, this is the same as algoGraphGetVertexEdges(). */
+ALGODEF AlgoError algoGraphGetVertexInEdges(const AlgoGraph graph, int32_t destVertexId, int32_t vertexInDegree, int32_t outSrcVertexIds[]);
+/** @brief Retrieve the weights of the edges leading to a given vertex.
+	@param outWeights Receives vertexInDegree edge weights, in the same order as the source vertex IDs returned by
+	                  algoGraphGetVertexInEdges().
+	@return kAlgoErrorOperationFailed if the graph is directed and was created without kAlgoGraphInEdges. */
+ALGODEF AlgoError algoGraphGetVertexInEdgeWeights(const AlgoGraph graph, int32_t destVertexId, int32_t vertexInDegree, int32_t outWeights[]);
 /** @brief Retrieve a vertex's optional user data field. */
 ALGODEF AlgoError algoGraphGetVertexData(const AlgoGraph graph, int32_t vertexId, AlgoData *outValue);
 /** @brief Retrieve a vertex's optional user data field. */
 ALGODEF AlgoError algoGraphSetVertexData(AlgoGraph graph, int32_t vertexId, AlgoData value);
 
+typedef enum AlgoGraphReorderStrategy
+{
+	kAlgoGraphReorderReverseCuthillMcKee = 0, /**< Reverse Cuthill-McKee: a breadth-first order that keeps each vertex's neighbors close to it. */
+	kAlgoGraphReorderBfs                 = 1, /**< Breadth-first order, visiting each component in turn. */
+	kAlgoGraphReorderDegreeDescending    = 2, /**< Highest-degree vertices first. */
+} AlgoGraphReorderStrategy;
+/** @brief Compute the required buffer size to reorder a graph's vertices with algoGraphReorder(). */
+ALGODEF AlgoError algoGraphReorderComputeBufferSize(size_t *outBufferSize, const AlgoGraph graph);
+/** @brief Renumbers a graph's vertices to improve the memory locality of later traversals.
+           The valid vertices receive the IDs [0..currentVertexCount) in the order given by the strategy, and their degrees,
+           user data and edges are moved to match. Each vertex's edges are then stored in consecutive blocks, and the
+           blocks of consecutive vertices are adjacent in memory.
+	@param graph The graph to reorder. Any vertex IDs held by the caller, and any objects created from the graph (search
+	             states, CSR snapshots, topological orders, etc.), are invalidated.
+	@param strategy How to order the vertices. For directed graphs, the breadth-first strategies only follow outgoing edges.
+	@param outOldToNew Must contain at least vertexCapacity elements. The new ID of each old vertex ID is written to
+	                   outOldToNew[oldVertexId], or -1 if oldVertexId was not a valid vertex.
+	@param buffer Used for temporary storage during the reorder.
+	@param bufferSize Size of the buffer[] array, in bytes. Given by algoGraphReorderComputeBufferSize().
+	*/
+ALGODEF AlgoError algoGraphReorder(AlgoGraph graph, AlgoGraphReorderStrategy strategy, int32_t outOldToNew[], void *buffer, size_t bufferSize);
+
+/** @brief Returned by the control callbacks of algoGraphBfs() and algoGraphDfs() to steer the search. */
+typedef enum AlgoGraphSearchControl
+{
+	kAlgoGraphSearchContinue = 0, /**< Keep searching normally. */
+	kAlgoGraphSearchSkip     = 1, /**< From a vertex callback, don't explore the vertex's edges. From an edge callback, don't follow the edge. */
+	kAlgoGraphSearchStop     = 2, /**< Stop the search right away. It can be continued later with algoGraphBfsResume()/algoGraphDfsResume(). */
+} AlgoGraphSearchControl;
+
 typedef struct AlgoGraphBfsStateImpl *AlgoGraphBfsState;
 /** @brief Compute the required buffer size to perform a breadth-first search on a graph.
            This only includes the space required for temporary storage during the search, not the search results themselves. */
 ALGODEF AlgoError algoGraphBfsStateComputeBufferSize(size_t *outBufferSize, const AlgoGraph graph);
 ALGODEF AlgoError algoGraphBfsStateCreate(AlgoGraphBfsState *outState, const AlgoGraph graph, void *buffer, size_t bufferSize);
+/** Optional features of an AlgoGraphBfsState, passed to algoGraphBfsStateCreateWithFlags(). */
+typedef enum AlgoGraphBfsStateFlags
+{
+	kAlgoGraphBfsStateDefault  = 0,
+	kAlgoGraphBfsStatePrefetch = 1, /**< Prefetch the edges and visited bits of vertices a few places ahead in the queue. */
+} AlgoGraphBfsStateFlags;
+/** @brief Compute the required buffer size for an AlgoGraphBfsState with the specified flags. */
+ALGODEF AlgoError algoGraphBfsStateComputeBufferSizeWithFlags(size_t *outBufferSize, const AlgoGraph graph, uint32_t stateFlags);
+/** @brief Initializes an AlgoGraphBfsState with the specified flags, using the provided buffer.
+           With kAlgoGraphBfsStatePrefetch, algoGraphBfs(), algoGraphBfsMulti(), algoGraphBfsResume() and algoGraphCsrBfs()
+           overlap the cache misses of upcoming vertices with the work on the current one: each vertex's edge list, head
+           edge block and neighbors' visited bits are prefetched in stages as it moves up the queue, rather than being loaded
+           one after another when it is popped. This pays off when the graph is much larger than the cache, and costs a little
+           when it isn't. Results and callbacks are unaffected.
+	@param stateFlags A combination of AlgoGraphBfsStateFlags. If kAlgoGraphBfsStateDefault, this is equivalent to algoGraphBfsStateCreate(). */
+ALGODEF AlgoError algoGraphBfsStateCreateWithFlags(AlgoGraphBfsState *outState, const AlgoGraph graph, uint32_t stateFlags,
+	void *buffer, size_t bufferSize);
 /** @brief Retrieves the size of the buffer passed when an AlgoGraphBfsState was created. */
 ALGODEF AlgoError algoGraphBfsStateGetBufferSize(const AlgoGraphBfsState bfsState, size_t *outBufferSize);
+/** @brief Returns an AlgoGraphBfsState to the condition it was in after algoGraphBfsStateCreate(), so it can be reused for another search.
+           Only the vertices discovered since the state was created (or last reset) are cleared, so the cost is proportional to the
+           size of the previous searches rather than the graph's vertex capacity. */
+ALGODEF AlgoError algoGraphBfsStateReset(AlgoGraphBfsState bfsState);
 ALGODEF AlgoError algoGraphBfsStateIsVertexDiscovered(const AlgoGraphBfsState bfsState, int32_t vertexId, int *outIsDiscovered);
 ALGODEF AlgoError algoGraphBfsStateIsVertexProcessed(const AlgoGraphBfsState bfsState, int32_t vertexId, int *outIsProcessed);
 ALGODEF AlgoError algoGraphBfsStateGetVertexParent(const AlgoGraphBfsState bfsState, int32_t vertexId, int32_t *outParentVertexId);
+/** @brief Retrieves a vertex's level in the search: its distance in edges from the (nearest) root, or -1 if it is undiscovered. */
+ALGODEF AlgoError algoGraphBfsStateGetVertexLevel(const AlgoGraphBfsState bfsState, int32_t vertexId, int32_t *outLevel);
+/** @brief Retrieves every vertex's level at once, as a read-only pointer into the state. The pointer remains valid as long
+           as the state's buffer, and reflects later searches with the same state.
+	@param outLevels A pointer to the levels is written here. (*outLevels)[v] is vertex v's level, as returned by
+	                 algoGraphBfsStateGetVertexLevel(), or -1 if v is undiscovered (or is not a valid vertex).
+	@param outVertexCount The number of elements in the array (the graph's vertex capacity) is written here.
+	*/
+ALGODEF AlgoError algoGraphBfsStateGetLevels(const AlgoGraphBfsState bfsState, const int32_t **outLevels, int32_t *outVertexCount);
+/** @brief Retrieves every vertex's parent at once, as a read-only pointer into the state. The pointer remains valid as long
+           as the state's buffer, and reflects later searches with the same state.
+	@param outParents A pointer to the parents is written here. (*outParents)[v] is vertex v's parent, or -1 if v is a root
+	                  or is undiscovered (or is not a valid vertex).
+	@param outVertexCount The number of elements in the array (the graph's vertex capacity) is written here.
+	*/
+ALGODEF AlgoError algoGraphBfsStateGetParents(const AlgoGraphBfsState bfsState, const int32_t **outParents, int32_t *outVertexCount);
+/** @brief Retrieves the path the search followed from a root to a given vertex, which has the fewest possible edges.
+	@param targetVertexId The vertex at which the path ends.
+	@param outPath The path's vertex IDs are written here, from the root to targetVertexId inclusive.
+	@param pathCapacity Number of elements in outPath[].
+	@param outPathLength The number of vertices in the path is written here (one more than its level). If the target is
+	                     undiscovered, this is zero.
+	@return kAlgoErrorOperationFailed if the path does not fit in outPath[]; *outPathLength is still set to the required size.
+	*/
+ALGODEF AlgoError algoGraphBfsStateGetPath(const AlgoGraphBfsState bfsState, int32_t targetVertexId, int32_t outPath[],
+	int32_t pathCapacity, int32_t *outPathLength);
 
 typedef void (*AlgoGraphBfsProcessVertexFunc)(AlgoGraph graph, AlgoGraphBfsState bfsState, int32_t vertexId, void *userData);
 typedef void (*AlgoGraphBfsProcessEdgeFunc)(AlgoGraph graph, AlgoGraphBfsState bfsState, int32_t startVertexId, int32_t endVertexId,
 	void *userData);
+typedef AlgoGraphSearchControl (*AlgoGraphBfsControlVertexFunc)(AlgoGraph graph, AlgoGraphBfsState bfsState, int32_t vertexId,
+	void *userData);
+typedef AlgoGraphSearchControl (*AlgoGraphBfsControlEdgeFunc)(AlgoGraph graph, AlgoGraphBfsState bfsState, int32_t startVertexId,
+	int32_t endVertexId, void *userData);
 typedef struct AlgoGraphBfsCallbacks
 {
 	AlgoGraphBfsProcessVertexFunc vertexFuncEarly; /** If non-NULL, this function will be called on each vertex when it is first encountered during the traversal. */
@@ -322,6 +731,14 @@ typedef struct AlgoGraphBfsCallbacks
 	void *edgeFuncUserData; /** Passed as userData to edgeFunc. */
 	AlgoGraphBfsProcessVertexFunc vertexFuncLate; /**  If non-NULL, this function will be called on each vertex after all of its edges have been explored. */
 	void *vertexFuncLateUserData; /** Passed as userData to vertexFuncLate. */
+	AlgoGraphBfsControlVertexFunc vertexControlFunc; /** If non-NULL, this function will be called on each vertex right after vertexFuncEarly. Returning
+	                                                     kAlgoGraphSearchSkip leaves the vertex's edges unexplored; returning kAlgoGraphSearchStop
+	                                                     stops the search before they are explored. */
+	void *vertexControlFuncUserData; /** Passed as userData to vertexControlFunc. */
+	AlgoGraphBfsControlEdgeFunc edgeControlFunc; /** If non-NULL, this function will be called on each edge right after edgeFunc. Returning
+	                                                 kAlgoGraphSearchSkip keeps the edge's end vertex from being discovered through it; returning
+	                                                 kAlgoGraphSearchStop stops the search once the edge has been followed. */
+	void *edgeControlFuncUserData; /** Passed as userData to edgeControlFunc. */
 } AlgoGraphBfsCallbacks;
 /** @brief Perform a breadth-first search on a graph.
 	@param graph The graph to search.
@@ -330,14 +747,132 @@ typedef struct AlgoGraphBfsCallbacks
 	@param callbacks Callback functions to invoke during various stages of the BFS.
 	*/
 ALGODEF AlgoError algoGraphBfs(const AlgoGraph graph, AlgoGraphBfsState bfsState, int32_t rootVertexId, AlgoGraphBfsCallbacks callbacks);
+/** @brief Perform a breadth-first search from several root vertices at once.
+           All roots start in the queue at distance 0, so each vertex is discovered from its nearest root (ties go to the root
+           listed first). Following a vertex's parents leads back to the root that claimed it. This is equivalent to searching
+           from a virtual source vertex connected to every root, without modifying the graph.
+	@param graph The graph to search.
+	@param bfsState A container for all intermediate states (and results) of the search operation. Created with algoGraphBfsStateCreate().
+	@param rootCount Number of elements in rootVertexIds[].
+	@param rootVertexIds The vertices to search from. Duplicates, and roots already discovered by an earlier search with the same
+	                     bfsState, are skipped.
+	@param callbacks Callback functions to invoke during various stages of the BFS.
+	*/
+ALGODEF AlgoError algoGraphBfsMulti(const AlgoGraph graph, AlgoGraphBfsState bfsState, int32_t rootCount, const int32_t rootVertexIds[],
+	AlgoGraphBfsCallbacks callbacks);
+/** @brief Continues a search that was stopped by a control callback returning kAlgoGraphSearchStop, exactly where it left off.
+	@param graph The graph being searched. It must not be modified while a search is stopped.
+	@param bfsState The state of the stopped search. If the search is already complete, this function does nothing.
+	@param callbacks Callback functions to invoke during the rest of the search. They need not match the original callbacks.
+	@note algoGraphBfs() and algoGraphBfsMulti() also continue a stopped search, with their new roots queued behind the
+	      vertices that were already discovered. To start an unrelated search instead, call algoGraphBfsStateReset() first.
+	*/
+ALGODEF AlgoError algoGraphBfsResume(const AlgoGraph graph, AlgoGraphBfsState bfsState, AlgoGraphBfsCallbacks callbacks);
+
+/** @brief Default thresholds for algoGraphBfsDirectionOptimizing(), as suggested by Beamer et al. */
+#define kAlgoGraphBfsDefaultAlpha 14
+#define kAlgoGraphBfsDefaultBeta 24
+/** @brief Perform a direction-optimizing breadth-first search on a graph.
+           The search proceeds one level at a time. Each level is either expanded top-down (every frontier vertex checks all
+           of its edges for undiscovered neighbors, like algoGraphBfs()) or bottom-up (every undiscovered vertex checks its
+           incoming edges until it finds a parent in the frontier), whichever is expected to check fewer edges. On graphs with
+           a small diameter, the bottom-up steps skip most of the edge checks in the middle levels. Top-down levels keep the
+           frontier as a list of vertices, so sparse levels cost nothing per undiscovered vertex; bottom-up levels also mark
+           it in a bitmap.
+	@param graph The graph to search.
+	@param bfsState A container for all intermediate states (and results) of the search operation. Created with algoGraphBfsStateCreate().
+	@param rootVertexId starting from the specified root vertex.
+	@param alpha Switch from top-down to bottom-up once the frontier's edges outnumber 1/alpha of the undiscovered vertices' edges.
+	             Pass 0 to use kAlgoGraphBfsDefaultAlpha.
+	@param beta Switch from bottom-up back to top-down once the frontier shrinks below 1/beta of the graph's vertices.
+	            Pass 0 to use kAlgoGraphBfsDefaultBeta.
+	@note The discovered/processed flags and parents in bfsState are filled in as by algoGraphBfs(). Every parent is one level closer
+	      to the root than its child, but it may not be the same parent algoGraphBfs() would choose. No callbacks are invoked.
+	@note Bottom-up steps need each vertex's incoming edges. Directed graphs use the in-edge lists kept by kAlgoGraphInEdges;
+	      directed graphs created without that flag are searched top-down at every level.
+	*/
+ALGODEF AlgoError algoGraphBfsDirectionOptimizing(const AlgoGraph graph, AlgoGraphBfsState bfsState, int32_t rootVertexId,
+	int32_t alpha, int32_t beta);
+
+typedef struct AlgoGraphBfsParallelImpl *AlgoGraphBfsParallel;
+/** @brief Compute the required buffer size to perform a multi-threaded breadth-first search on a graph.
+           This only includes the space shared by the threads during the search; the results are stored in an AlgoGraphBfsState. */
+ALGODEF AlgoError algoGraphBfsParallelComputeBufferSize(size_t *outBufferSize, const AlgoGraph graph, int32_t threadCount);
+/** @brief Prepares a multi-threaded breadth-first search, which is then run by calling algoGraphBfsParallel() from each thread.
+	@param outSearch The new search object will be stored here. Each search object can only be run once.
+	@param graph The graph to search. It must not be modified until the search is complete.
+	@param bfsState Receives the results of the search. It must be freshly created with algoGraphBfsStateCreate(), or reset with
+	                algoGraphBfsStateReset().
+	@param rootVertexId starting from the specified root vertex.
+	@param threadCount The number of threads that will run the search.
+	@param buffer Used for storage shared by all threads during the search.
+	@param bufferSize Size of the buffer[] array, in bytes. Given by algoGraphBfsParallelComputeBufferSize().
+	*/
+ALGODEF AlgoError algoGraphBfsParallelCreate(AlgoGraphBfsParallel *outSearch, const AlgoGraph graph, AlgoGraphBfsState bfsState,
+	int32_t rootVertexId, int32_t threadCount, void *buffer, size_t bufferSize);
+/** @brief Retrieves the size of the buffer passed when an AlgoGraphBfsParallel was created. */
+ALGODEF AlgoError algoGraphBfsParallelGetBufferSize(const AlgoGraphBfsParallel search, size_t *outBufferSize);
+/** @brief Runs a multi-threaded breadth-first search, one level at a time. Each thread claims chunks of the current level's
+           frontier, claims undiscovered neighbors with an atomic update of the discovered bitmap, and buffers them locally
+           until they are merged into the next level's frontier.
+	@param search The search to run, created with algoGraphBfsParallelCreate().
+	@param threadIndex Must be called concurrently from exactly threadCount threads, each passing a different threadIndex
+	                   in [0..threadCount). Every call returns once the whole search is complete.
+	@note The discovered/processed flags and parents in bfsState are filled in as by algoGraphBfs(). Every parent is one level
+	      closer to the root than its child, but which parent is chosen depends on thread timing. No callbacks are invoked.
+	*/
+ALGODEF AlgoError algoGraphBfsParallel(AlgoGraphBfsParallel search, int32_t threadIndex);
+
+/** @brief Number of roots searched together by each pass of algoGraphMultiSourceBfs(). */
+#define kAlgoGraphMultiSourceBfsBatchSize 64
+/** @brief Compute the required buffer size for algoGraphMultiSourceBfs(). */
+ALGODEF AlgoError algoGraphMultiSourceBfsComputeBufferSize(size_t *outBufferSize, const AlgoGraph graph);
+/** @brief Computes the distance (in edges) from each of several root vertices to every vertex in the graph.
+           Roots are searched kAlgoGraphMultiSourceBfsBatchSize at a time. Each vertex keeps one bit per root in its
+           seen/visit/visitNext words, so a single pass over a vertex's edges advances every search whose frontier contains it.
+	@param graph The graph to search.
+	@param rootVertexIds The vertices to search from. Duplicates are allowed.
+	@param rootCount Number of elements in rootVertexIds[].
+	@param outDistances Must contain at least rootCount*vertexCapacity elements. The distance from rootVertexIds[i] to vertex v
+	                    is written to outDistances[i*vertexCapacity + v], or -1 if v is unreachable (or is not a valid vertex).
+	@param buffer Used for temporary storage during the search.
+	@param bufferSize Size of the buffer[] array, in bytes. Given by algoGraphMultiSourceBfsComputeBufferSize().
+	*/
+ALGODEF AlgoError algoGraphMultiSourceBfs(const AlgoGraph graph, const int32_t rootVertexIds[], int32_t rootCount,
+	int32_t outDistances[], void *buffer, size_t bufferSize);
 
 typedef struct AlgoGraphDfsStateImpl *AlgoGraphDfsState;
-/** @brief Compute the required buffer size to perform a breadth-first search on a graph.
+/** Optional features of an AlgoGraphDfsState, passed to algoGraphDfsStateCreateWithFlags(). */
+typedef enum AlgoGraphDfsStateFlags
+{
+	kAlgoGraphDfsStateDefault     = 0, /**< Record each vertex's parent and entry/exit times. */
+	kAlgoGraphDfsStateLightweight = 1, /**< Only record which vertices are discovered and processed. */
+} AlgoGraphDfsStateFlags;
+/** @brief Compute the required buffer size to perform a depth-first search on a graph.
            This only includes the space required for temporary storage during the search, not the search results themselves. */
 ALGODEF AlgoError algoGraphDfsStateComputeBufferSize(size_t *outBufferSize, const AlgoGraph graph);
 ALGODEF AlgoError algoGraphDfsStateCreate(AlgoGraphDfsState *outState, const AlgoGraph graph, void *buffer, size_t bufferSize);
+/** @brief Compute the required buffer size for an AlgoGraphDfsState with the specified flags. */
+ALGODEF AlgoError algoGraphDfsStateComputeBufferSizeWithFlags(size_t *outBufferSize, const AlgoGraph graph, uint32_t stateFlags);
+/** @brief Initializes an AlgoGraphDfsState with the specified flags, using the provided buffer.
+           A lightweight state (kAlgoGraphDfsStateLightweight) keeps only the discovered/processed bitmaps and a stack of
+           (vertex, next edge) pairs for the current path, about 16 bytes per vertex instead of about 40. It suits reachability
+           queries and topological sorts, where parents and times are not needed. Searches behave exactly as with a default
+           state, including callbacks, multiple roots and stopping/resuming, but:
+		   - algoGraphDfsStateGetVertexParent(), algoGraphDfsStateGetVertexEntryTime() and algoGraphDfsStateGetVertexExitTime()
+		     return kAlgoErrorOperationFailed. During a search, the parent of the vertex being explored is still respected when
+		     deciding which undirected edges to report.
+		   - algoGraphDfsStateReset() clears the bitmaps, which costs O(vertexCapacity/32) rather than O(vertices visited).
+	@param stateFlags One of AlgoGraphDfsStateFlags. If kAlgoGraphDfsStateDefault, this is equivalent to algoGraphDfsStateCreate(). */
+ALGODEF AlgoError algoGraphDfsStateCreateWithFlags(AlgoGraphDfsState *outState, const AlgoGraph graph, uint32_t stateFlags,
+	void *buffer, size_t bufferSize);
 /** @brief Retrieves the size of the buffer passed when an AlgoGraphDfsState was created. */
 ALGODEF AlgoError algoGraphDfsStateGetBufferSize(const AlgoGraphDfsState dfsState, size_t *outBufferSize);
+/** @brief Returns an AlgoGraphDfsState to the condition it was in after algoGraphDfsStateCreate(), so it can be reused for another search.
+           Only the vertices discovered since the state was created (or last reset) are cleared, so the cost is proportional to the
+           size of the previous searches rather than the graph's vertex capacity (except for lightweight states; see
+           algoGraphDfsStateCreateWithFlags()). */
+ALGODEF AlgoError algoGraphDfsStateReset(AlgoGraphDfsState dfsState);
 ALGODEF AlgoError algoGraphDfsStateIsVertexDiscovered(const AlgoGraphDfsState dfsState, int32_t vertexId, int *outIsDiscovered);
 ALGODEF AlgoError algoGraphDfsStateIsVertexProcessed(const AlgoGraphDfsState dfsState, int32_t vertexId, int *outIsProcessed);
 ALGODEF AlgoError algoGraphDfsStateGetVertexParent(const AlgoGraphDfsState dfsState, int32_t vertexId, int32_t *outParentVertexId);
@@ -347,6 +882,10 @@ ALGODEF AlgoError algoGraphDfsStateGetVertexExitTime(const AlgoGraphDfsState dfs
 typedef void (*AlgoGraphDfsProcessVertexFunc)(AlgoGraph graph, AlgoGraphDfsState dfsState, int32_t vertexId, void *userData);
 typedef void (*AlgoGraphDfsProcessEdgeFunc)(AlgoGraph graph, AlgoGraphDfsState dfsState, int32_t startVertexId, int32_t endVertexId,
 	void *userData);
+typedef AlgoGraphSearchControl (*AlgoGraphDfsControlVertexFunc)(AlgoGraph graph, AlgoGraphDfsState dfsState, int32_t vertexId,
+	void *userData);
+typedef AlgoGraphSearchControl (*AlgoGraphDfsControlEdgeFunc)(AlgoGraph graph, AlgoGraphDfsState dfsState, int32_t startVertexId,
+	int32_t endVertexId, void *userData);
 typedef struct AlgoGraphDfsCallbacks
 {
 	AlgoGraphDfsProcessVertexFunc vertexFuncEarly; /** If non-NULL, this function will be called on each vertex when it is first encountered during the traversal. */
@@ -356,6 +895,15 @@ typedef struct AlgoGraphDfsCallbacks
 	void *edgeFuncUserData; /** Passed as userData to edgeFunc. */
 	AlgoGraphDfsProcessVertexFunc vertexFuncLate; /**  If non-NULL, this function will be called on each vertex after all of its edges have been explored. */
 	void *vertexFuncLateUserData; /** Passed as userData to vertexFuncLate. */
+	AlgoGraphDfsControlVertexFunc vertexControlFunc; /** If non-NULL, this function will be called on each vertex right after vertexFuncEarly. Returning
+	                                                     kAlgoGraphSearchSkip leaves the vertex's edges unexplored (it is finished immediately);
+	                                                     returning kAlgoGraphSearchStop stops the search before they are explored. */
+	void *vertexControlFuncUserData; /** Passed as userData to vertexControlFunc. */
+	AlgoGraphDfsControlEdgeFunc edgeControlFunc; /** If non-NULL, this function will be called on each edge right after edgeFunc. Returning
+	                                                 kAlgoGraphSearchSkip keeps the search from descending through the edge; returning
+	                                                 kAlgoGraphSearchStop stops the search once the edge has been followed (its end vertex,
+	                                                 if newly reached, is discovered when the search resumes). */
+	void *edgeControlFuncUserData; /** Passed as userData to edgeControlFunc. */
 } AlgoGraphDfsCallbacks;
 /** @brief Perform a depth-first search on a graph.
 	@param graph The graph to search.
@@ -364,6 +912,26 @@ typedef struct AlgoGraphDfsCallbacks
 	@param callbacks Callback functions to invoke during various stages of the DFS.
 	*/
 ALGODEF AlgoError algoGraphDfs(const AlgoGraph graph, AlgoGraphDfsState dfsState, int32_t rootVertexId, AlgoGraphDfsCallbacks callbacks);
+/** @brief Perform a depth-first search from each of several root vertices in turn, building a DFS forest.
+           Each root that hasn't already been discovered starts a new tree. Entry and exit times keep increasing from one tree to
+           the next, so they remain valid for edge classification across the whole forest.
+	@param graph The graph to search.
+	@param dfsState A container for all intermediate states (and results) of the search operation. Created with algoGraphDfsStateCreate().
+	@param rootCount Number of elements in rootVertexIds[].
+	@param rootVertexIds The vertices to search from, in order. Roots discovered by an earlier tree are skipped.
+	@param callbacks Callback functions to invoke during various stages of the DFS.
+	*/
+ALGODEF AlgoError algoGraphDfsMulti(const AlgoGraph graph, AlgoGraphDfsState dfsState, int32_t rootCount, const int32_t rootVertexIds[],
+	AlgoGraphDfsCallbacks callbacks);
+/** @brief Continues a search that was stopped by a control callback returning kAlgoGraphSearchStop, exactly where it left off.
+	@param graph The graph being searched. It must not be modified while a search is stopped.
+	@param dfsState The state of the stopped search. If the search is already complete, this function does nothing.
+	@param callbacks Callback functions to invoke during the rest of the search. They need not match the original callbacks.
+	@note This only finishes the tree that was being searched. algoGraphDfs() and algoGraphDfsMulti() also finish a stopped
+	      tree before starting any new ones, so to continue a stopped algoGraphDfsMulti(), call it again with the same roots.
+	      To start an unrelated search instead, call algoGraphDfsStateReset() first.
+	*/
+ALGODEF AlgoError algoGraphDfsResume(const AlgoGraph graph, AlgoGraphDfsState dfsState, AlgoGraphDfsCallbacks callbacks);
 
 /** @brief Compute the required buffer size to perform a topological sort on a graph. 
            This only includes the space required for temporary storage during the sort, not the sort results themselves. */
@@ -379,6 +947,211 @@ ALGODEF AlgoError algoGraphTopoSortComputeBufferSize(size_t *outBufferSize, cons
 	*/
 ALGODEF AlgoError algoGraphTopoSort(const AlgoGraph graph, int32_t outSortedVertices[], size_t sortedVertexCount, 
 	void *buffer, size_t bufferSize);
+
+typedef struct AlgoGraphTopoSortParallelImpl *AlgoGraphTopoSortParallel;
+/** @brief Compute the required buffer size to perform a multi-threaded topological sort on a graph.
+           This only includes the space shared by the threads during the sort, not the sort results themselves. */
+ALGODEF AlgoError algoGraphTopoSortParallelComputeBufferSize(size_t *outBufferSize, const AlgoGraph graph, int32_t threadCount);
+/** @brief Prepares a multi-threaded topological sort, which is then run by calling algoGraphTopoSortParallel() from each thread.
+	@param outSort The new sort object will be stored here. Each sort object can only be run once.
+	@param graph The graph to sort. Its edgeMode must be kGraphEdgeModeDirected. It must not be modified until the sort is complete.
+	@param threadCount The number of threads that will run the sort.
+	@param outSortedVertices A list of sorted vertex IDs will be written to this array.
+	@param sortedVertexCount The outSortedVertices[] array must contain at least this many elements. This value should match the
+	                         graph's current vertex count.
+	@param outVertexLevels If non-NULL, must contain at least vertexCapacity elements. The level of each vertex v (the number of
+	                       edges on the longest path reaching it) is written to outVertexLevels[v]; invalid vertices and vertices
+	                       that could not be sorted receive -1.
+	@param buffer Used for storage shared by all threads during the sort.
+	@param bufferSize Size of the buffer[] array, in bytes. Given by algoGraphTopoSortParallelComputeBufferSize().
+	*/
+ALGODEF AlgoError algoGraphTopoSortParallelCreate(AlgoGraphTopoSortParallel *outSort, const AlgoGraph graph, int32_t threadCount,
+	int32_t outSortedVertices[], size_t sortedVertexCount, int32_t outVertexLevels[], void *buffer, size_t bufferSize);
+/** @brief Retrieves the size of the buffer passed when an AlgoGraphTopoSortParallel was created. */
+ALGODEF AlgoError algoGraphTopoSortParallelGetBufferSize(const AlgoGraphTopoSortParallel sort, size_t *outBufferSize);
+/** @brief Runs a multi-threaded topological sort using Kahn's algorithm. The threads count every vertex's incoming edges,
+           then sort the graph one level at a time: each thread claims chunks of the current level, atomically decrements
+           the in-degree of their successors, and buffers the successors that reach zero until they are appended as the next level.
+	@param sort The sort to run, created with algoGraphTopoSortParallelCreate().
+	@param threadIndex Must be called concurrently from exactly threadCount threads, each passing a different threadIndex
+	                   in [0..threadCount). Every call returns once the whole sort is complete.
+	@return kAlgoErrorOperationFailed if the graph contains a cycle. In that case, only the vertices that could be sorted are
+	        written to outSortedVertices[].
+	*/
+ALGODEF AlgoError algoGraphTopoSortParallel(AlgoGraphTopoSortParallel sort, int32_t threadIndex);
+
+typedef struct AlgoGraphTopoOrderImpl *AlgoGraphTopoOrder;
+/** @brief Compute the required buffer size for an AlgoGraphTopoOrder attached to the specified graph. */
+ALGODEF AlgoError algoGraphTopoOrderComputeBufferSize(size_t *outBufferSize, const AlgoGraph graph);
+/** @brief Attaches a topological order to a graph, which is kept valid as edges are added with algoGraphTopoOrderAddEdge().
+	@param outOrder The new order object will be stored here.
+	@param graph The graph to order. Its edgeMode must be kGraphEdgeModeDirected, and it must not contain any cycles.
+	             While the order is in use, new edges must only be added with algoGraphTopoOrderAddEdge(). Vertices may
+	             be added and removed, and edges removed, directly.
+	@param buffer Used to store the order.
+	@param bufferSize Size of the buffer[] array, in bytes. Given by algoGraphTopoOrderComputeBufferSize().
+	@return kAlgoErrorOperationFailed if the graph is undirected or contains a cycle.
+	*/
+ALGODEF AlgoError algoGraphTopoOrderCreate(AlgoGraphTopoOrder *outOrder, AlgoGraph graph, void *buffer, size_t bufferSize);
+/** @brief Retrieves the size of the buffer passed when an AlgoGraphTopoOrder was created. */
+ALGODEF AlgoError algoGraphTopoOrderGetBufferSize(const AlgoGraphTopoOrder order, size_t *outBufferSize);
+/** @brief Adds an edge to the order's graph, updating the order to keep it valid.
+           An edge that agrees with the current order is added in O(1). Otherwise, the order is repaired with Pearce & Kelly's
+           algorithm: a forward DFS finds the vertices reachable from the destination that currently precede the source, a
+           backward DFS over incoming edges finds the vertices that reach the source and currently follow the destination,
+           and the two groups swap places among their own positions. Only the affected vertices and their edges are visited.
+	@note The backward search needs each vertex's incoming edges, which are only kept for graphs created with
+	      kAlgoGraphInEdges. Without them, or when the affected vertices make up a large part of the region between the two
+	      endpoints, the vertices found by the forward search are instead moved after the rest of that region, which
+	      visits every vertex in it.
+	@return kAlgoErrorOperationFailed if the new edge would create a cycle (in which case neither the graph nor the order is
+	        modified), or if algoGraphAddEdge() fails.
+	*/
+ALGODEF AlgoError algoGraphTopoOrderAddEdge(AlgoGraphTopoOrder order, int32_t srcVertexId, int32_t destVertexId);
+/** @brief Retrieves a vertex's position in the order. Each edge's source has a lower position than its destination. Positions
+           are not contiguous; unused vertex IDs have positions as well. */
+ALGODEF AlgoError algoGraphTopoOrderGetVertexIndex(const AlgoGraphTopoOrder order, int32_t vertexId, int32_t *outIndex);
+/** @brief Writes the graph's valid vertex IDs to outSortedVertices[], in their current topological order.
+	@param sortedVertexCount The outSortedVertices[] array must contain at least this many elements. This value should match the
+	                         graph's current vertex count.
+	*/
+ALGODEF AlgoError algoGraphTopoOrderGetSortedVertices(const AlgoGraphTopoOrder order, int32_t outSortedVertices[], size_t sortedVertexCount);
+
+typedef struct AlgoGraphDijkstraStateImpl *AlgoGraphDijkstraState;
+/** @brief Compute the required buffer size to find weighted shortest paths in a graph with algoGraphDijkstra() or algoGraphAStar().
+           This includes the search results (per-vertex distances and parents) and the search's priority queue. */
+ALGODEF AlgoError algoGraphDijkstraStateComputeBufferSize(size_t *outBufferSize, const AlgoGraph graph);
+ALGODEF AlgoError algoGraphDijkstraStateCreate(AlgoGraphDijkstraState *outState, const AlgoGraph graph, void *buffer, size_t bufferSize);
+/** @brief Retrieves the size of the buffer passed when an AlgoGraphDijkstraState was created. */
+ALGODEF AlgoError algoGraphDijkstraStateGetBufferSize(const AlgoGraphDijkstraState dijkstraState, size_t *outBufferSize);
+/** @brief Determine whether a vertex's shortest-path distance from the source vertex is final. */
+ALGODEF AlgoError algoGraphDijkstraStateIsVertexSettled(const AlgoGraphDijkstraState dijkstraState, int32_t vertexId, int *outIsSettled);
+/** @brief Retrieve a vertex's distance from the source vertex. This is -1 for vertices that were not reached. For vertices
+           that were reached but not settled (because the search stopped early), it is an upper bound on the true distance. */
+ALGODEF AlgoError algoGraphDijkstraStateGetVertexDistance(const AlgoGraphDijkstraState dijkstraState, int32_t vertexId, int32_t *outDistance);
+/** @brief Retrieve a vertex's predecessor on its shortest path from the source vertex, or -1 if it has none. */
+ALGODEF AlgoError algoGraphDijkstraStateGetVertexParent(const AlgoGraphDijkstraState dijkstraState, int32_t vertexId, int32_t *outParentVertexId);
+/** @brief Find the shortest weighted paths from a source vertex to every reachable vertex in a graph, using Dijkstra's algorithm
+           with a pairing heap (O(E + V log V)).
+	@param graph The graph to search. Edge weights are set with algoGraphAddWeightedEdge(); in graphs created without
+	             kAlgoGraphEdgeWeights, every edge has a weight of 1.
+	@param dijkstraState A container for all intermediate states (and results) of the search. Created with algoGraphDijkstraStateCreate().
+	                     Use a newly-created state for each search.
+	@param sourceVertexId The vertex from which all distances are measured.
+	@param targetVertexId If non-negative, the search stops as soon as this vertex is settled; its distance and path are final,
+	                      but other vertices' may not be. Pass -1 to settle every reachable vertex.
+	@return kAlgoErrorOperationFailed if a path length would overflow an int32_t.
+	*/
+ALGODEF AlgoError algoGraphDijkstra(const AlgoGraph graph, AlgoGraphDijkstraState dijkstraState, int32_t sourceVertexId,
+	int32_t targetVertexId);
+
+/** @brief Estimates the length of the shortest path from vertexId to goalVertexId. To guarantee that algoGraphAStar() finds a
+           shortest path, the estimate must be admissible (never greater than the true distance) and non-negative. */
+typedef int32_t (*AlgoGraphAStarHeuristicFunc)(AlgoGraph graph, int32_t vertexId, int32_t goalVertexId, void *userData);
+/** @brief Find the shortest weighted path between two vertices using A* search, which expands vertices in order of their
+           distance from the source plus the heuristic's estimate of their remaining distance to the goal.
+	@param graph The graph to search. Edges added with algoGraphAddEdge() have unit weight.
+	@param dijkstraState A container for all intermediate states (and results) of the search. Created with
+	                     algoGraphDijkstraStateCreate(); use a newly-created state for each search. When the search
+	                     completes, the goal vertex's distance and parent chain describe the shortest path. Other
+	                     vertices' distances are upper bounds.
+	@param sourceVertexId The vertex at which the path starts.
+	@param goalVertexId The vertex at which the path ends. If it is unreachable, its distance will be -1.
+	@param heuristicFunc Estimates the remaining distance to the goal. If NULL, this is equivalent to algoGraphDijkstra()
+	                     with an early exit at goalVertexId.
+	@param userData Passed to heuristicFunc.
+	@return kAlgoErrorOperationFailed if a path length would overflow an int32_t.
+	*/
+ALGODEF AlgoError algoGraphAStar(const AlgoGraph graph, AlgoGraphDijkstraState dijkstraState, int32_t sourceVertexId,
+	int32_t goalVertexId, AlgoGraphAStarHeuristicFunc heuristicFunc, void *userData);
+
+/** @brief Compute the required buffer size to find an unweighted shortest path with algoGraphShortestPathBidirectional().
+           This only includes the space required for temporary storage during the search, not the path itself. */
+ALGODEF AlgoError algoGraphShortestPathBidirectionalComputeBufferSize(size_t *outBufferSize, const AlgoGraph graph);
+/** @brief Find a path with the fewest edges between two vertices, ignoring edge weights.
+           Breadth-first frontiers are grown alternately from both ends (always expanding the smaller frontier by one full
+           level), and the search stops as soon as they meet. On low-diameter graphs this explores far fewer vertices than a
+           full BFS from the source.
+	@note  Searching backwards from the goal requires incoming edges. For directed graphs, the backward frontier follows
+	       the in-edge lists kept by kAlgoGraphInEdges. Directed graphs created without that flag only grow the forward
+	       frontier, and this is equivalent to a BFS that stops when it reaches the goal.
+	@param graph The graph to search.
+	@param sourceVertexId The vertex at which the path starts.
+	@param goalVertexId The vertex at which the path ends.
+	@param outPath The path's vertex IDs are written here, from sourceVertexId to goalVertexId inclusive.
+	@param pathCapacity Number of elements in outPath[].
+	@param outPathLength The number of vertices in the path is written here (one more than its edge count). If the goal is
+	                     unreachable, this is zero.
+	@param buffer Used for temporary storage during the search.
+	@param bufferSize Size of the buffer[] array, in bytes. Given by algoGraphShortestPathBidirectionalComputeBufferSize().
+	@return kAlgoErrorOperationFailed if the path does not fit in outPath[]; *outPathLength is still set to the required size.
+	*/
+ALGODEF AlgoError algoGraphShortestPathBidirectional(const AlgoGraph graph, int32_t sourceVertexId, int32_t goalVertexId,
+	int32_t outPath[], int32_t pathCapacity, int32_t *outPathLength, void *buffer, size_t bufferSize);
+
+/**
+ * @brief An immutable compressed-sparse-row (CSR) snapshot of an AlgoGraph's adjacency: one offset per vertex into a
+ *        single contiguous array of destination vertex IDs. Traversing a snapshot touches memory sequentially instead
+ *        of chasing edge list pointers, which makes it much faster for graphs that are built once and queried often.
+ *        The snapshot does not track later changes to its source graph; freeze it again after modifying the graph.
+ * @code{.c}
+ * size_t csrBufferSize = 0;
+ * AlgoGraphCsr csr;
+ * err = algoGraphFreezeComputeBufferSize(&csrBufferSize, graph);
+ * err = algoGraphFreeze(graph, &csr, malloc(csrBufferSize), csrBufferSize);
+ * err = algoGraphCsrBfs(csr, bfsState, rootVertexId, bfsCallbacks); // bfsState was created for graph
+ * @endcode
+ */
+typedef struct AlgoGraphCsrImpl *AlgoGraphCsr;
+/** @brief Computes the required buffer size for a CSR snapshot of a graph. The result depends on the graph's current
+           edge count, so the graph must not gain edges between this call and algoGraphFreeze(). */
+ALGODEF AlgoError algoGraphFreezeComputeBufferSize(size_t *outBufferSize, const AlgoGraph graph);
+/** @brief Builds a CSR snapshot of a graph's current vertices and edges in the provided buffer. Edges are stored in the
+           same order in which the source graph visits them, so traversals of the snapshot produce the same results
+           as traversals of the source graph. */
+ALGODEF AlgoError algoGraphFreeze(const AlgoGraph graph, AlgoGraphCsr *outCsr, void *buffer, size_t bufferSize);
+/** @brief Retrieves the size of the buffer passed when an AlgoGraphCsr was created. */
+ALGODEF AlgoError algoGraphCsrGetBufferSize(const AlgoGraphCsr csr, size_t *outBufferSize);
+/** @brief Retrieves the graph from which a CSR snapshot was created. */
+ALGODEF AlgoError algoGraphCsrGetGraph(const AlgoGraphCsr csr, AlgoGraph *outGraph);
+/** @brief Retrieve the degree (outgoing edge count) of a vertex in the snapshot. */
+ALGODEF AlgoError algoGraphCsrGetVertexDegree(const AlgoGraphCsr csr, int32_t vertexId, int32_t *outDegree);
+/** @brief Retrieve the vertices to which a given vertex is connected, as a read-only pointer into the snapshot.
+           The pointer remains valid as long as the snapshot's buffer. */
+ALGODEF AlgoError algoGraphCsrGetVertexEdges(const AlgoGraphCsr csr, int32_t srcVertexId, const int32_t **outDestVertexIds,
+	int32_t *outDegree);
+/** @brief Perform a breadth-first search on a CSR snapshot. bfsState must have been created for the snapshot's source
+           graph. Callbacks receive the source graph. Control callbacks are not supported, and must be NULL. */
+ALGODEF AlgoError algoGraphCsrBfs(const AlgoGraphCsr csr, AlgoGraphBfsState bfsState, int32_t rootVertexId, AlgoGraphBfsCallbacks callbacks);
+/** Vector instruction sets that algoGraphCsrBfsSimd() can use. */
+typedef enum AlgoSimdLevel
+{
+	kAlgoSimdScalar = 0, /**< No vector instructions; always available. */
+	kAlgoSimdAvx2   = 1, /**< x86 AVX2: 8 neighbors per step. */
+	kAlgoSimdAvx512 = 2, /**< x86 AVX-512F: 16 neighbors per step. */
+} AlgoSimdLevel;
+/** @brief Retrieves the highest AlgoSimdLevel supported by both the CPU this is running on and the compiler that built it. */
+ALGODEF AlgoError algoGetSupportedSimdLevel(AlgoSimdLevel *outLevel);
+/** @brief Perform a breadth-first search on a CSR snapshot, testing the visited bits of several neighbors at once.
+           The search expands one level at a time. The visited bits of each frontier vertex's neighbors are gathered and
+           tested a vector at a time, and the undiscovered neighbors are compressed into a short list to be visited
+           individually. The results (parents, levels, and discovered/processed bits) are the same as algoGraphCsrBfs(),
+           but no callbacks are invoked.
+	@param maxSimdLevel The highest instruction set to use. The kernel is chosen at run time, and never uses instructions the
+	                    CPU lacks, so pass kAlgoSimdAvx512 to use the best one available, or kAlgoSimdScalar for the
+	                    portable fallback. The vector kernels don't depend on compiler flags such as -mavx2.
+	*/
+ALGODEF AlgoError algoGraphCsrBfsSimd(const AlgoGraphCsr csr, AlgoGraphBfsState bfsState, int32_t rootVertexId,
+	AlgoSimdLevel maxSimdLevel);
+/** @brief Perform a depth-first search on a CSR snapshot. dfsState must have been created for the snapshot's source
+           graph, and must not also be used with algoGraphDfs(). Callbacks receive the source graph. Control callbacks are
+           not supported, and must be NULL. */
+ALGODEF AlgoError algoGraphCsrDfs(const AlgoGraphCsr csr, AlgoGraphDfsState dfsState, int32_t rootVertexId, AlgoGraphDfsCallbacks callbacks);
+/** @brief Perform a topological sort on a CSR snapshot. The snapshot's source graph must be directed, and must have
+           been acyclic when the snapshot was created. Use algoGraphTopoSortComputeBufferSize() on the source graph to
+           compute the buffer size. */
+ALGODEF AlgoError algoGraphCsrTopoSort(const AlgoGraphCsr csr, int32_t outSortedVertices[], size_t sortedVertexCount,
+	void *buffer, size_t bufferSize);
 	
 
 #ifdef __cplusplus
@@ -398,6 +1171,184 @@ ALGODEF AlgoError algoGraphTopoSort(const AlgoGraph graph, int32_t outSortedVert
 #define ALGO_UNUSED(x) (void)(x)
 #define ALGO_INTERNAL static
 
+/******************************************
+ * Atomic operations (used by thread-safe containers)
+ ******************************************/
+
+#if defined(_MSC_VER)
+#	include <intrin.h>
+#	include <windows.h>
+#	define ALGO_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__) || defined(__clang__)
+#	include <sched.h>
+#	include <time.h>
+#	define ALGO_THREAD_LOCAL __thread
+#else
+#	error Unsupported compiler
+#endif
+
+#define ALGO_CACHE_LINE_SIZE 64
+
+/* Returns the value of *dest before the operation. */
+ALGO_INTERNAL ALGO_INLINE int32_t iAtomicCompareExchange32(volatile int32_t *dest, int32_t expected, int32_t desired)
+{
+#if defined(_MSC_VER)
+	return (int32_t)_InterlockedCompareExchange((volatile long*)dest, (long)desired, (long)expected);
+#else
+	return __sync_val_compare_and_swap(dest, expected, desired);
+#endif
+}
+ALGO_INTERNAL ALGO_INLINE int32_t iAtomicFetchAdd32(volatile int32_t *dest, int32_t val)
+{
+#if defined(_MSC_VER)
+	return (int32_t)_InterlockedExchangeAdd((volatile long*)dest, (long)val);
+#else
+	return __sync_fetch_and_add(dest, val);
+#endif
+}
+ALGO_INTERNAL ALGO_INLINE int32_t iAtomicFetchOr32(volatile int32_t *dest, int32_t val)
+{
+#if defined(_MSC_VER)
+	return (int32_t)_InterlockedOr((volatile long*)dest, (long)val);
+#else
+	return __sync_fetch_and_or(dest, val);
+#endif
+}
+/* Simple test-and-set lock. Returns non-zero if the lock was acquired. */
+ALGO_INTERNAL ALGO_INLINE int iTryLock(volatile int32_t *lock)
+{
+	return (*lock == 0 && iAtomicCompareExchange32(lock, 0, 1) == 0) ? 1 : 0;
+}
+ALGO_INTERNAL ALGO_INLINE void iUnlock(volatile int32_t *lock)
+{
+#if defined(_MSC_VER)
+	_InterlockedExchange((volatile long*)lock, 0);
+#else
+	__sync_lock_release(lock);
+#endif
+}
+/* Gives the rest of the calling thread's time slice to another thread; used while waiting on other threads. */
+ALGO_INTERNAL ALGO_INLINE void iThreadYield(void)
+{
+#if defined(_MSC_VER)
+	SwitchToThread();
+#else
+	sched_yield();
+#endif
+}
+/* Reusable barrier for a fixed number of threads. No thread returns from iBarrierWait() until all threadCount
+   threads have called it. */
+typedef struct IBarrier
+{
+	volatile int32_t arrivedCount;
+	volatile int32_t generation; /* incremented each time the barrier opens */
+	int32_t threadCount;
+} IBarrier;
+ALGO_INTERNAL void iBarrierInit(IBarrier *barrier, int32_t threadCount)
+{
+	barrier->arrivedCount = 0;
+	barrier->generation = 0;
+	barrier->threadCount = threadCount;
+}
+ALGO_INTERNAL void iBarrierWait(IBarrier *barrier)
+{
+	const int32_t generation = barrier->generation;
+	if (iAtomicFetchAdd32(&barrier->arrivedCount, 1) == barrier->threadCount-1)
+	{
+		barrier->arrivedCount = 0;
+		iAtomicFetchAdd32(&barrier->generation, 1); /* releases the waiting threads */
+	}
+	else
+	{
+		while(barrier->generation == generation)
+			iThreadYield();
+	}
+}
+
+/* Per-thread xorshift generator; avoids both rand()'s global state and any cross-thread contention. */
+ALGO_INTERNAL uint32_t iThreadRandom(void)
+{
+	static ALGO_THREAD_LOCAL uint32_t state = 0;
+	if (0 == state)
+	{
+		static volatile int32_t seedCounter = 0;
+		state = (uint32_t)(uintptr_t)&state ^ ((uint32_t)iAtomicFetchAdd32(&seedCounter, 1) * 0x9E3779B9U);
+		if (0 == state)
+			state = 1;
+	}
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+/******************************************
+ * Bit manipulation
+ ******************************************/
+
+/* Returns the index of the highest/lowest set bit in x, which must be non-zero. */
+ALGO_INTERNAL int iHighestBit64(uint64_t x)
+{
+	ALGO_ASSERT(x != 0);
+#if defined(_MSC_VER) && defined(_WIN64)
+	{
+		unsigned long index;
+		_BitScanReverse64(&index, x);
+		return (int)index;
+	}
+#elif defined(__GNUC__) || defined(__clang__)
+	return 63 - __builtin_clzll(x);
+#else
+	{
+		int index = 0;
+		while(x >>= 1)
+			index += 1;
+		return index;
+	}
+#endif
+}
+
+ALGO_INTERNAL int iLowestBit64(uint64_t x)
+{
+	ALGO_ASSERT(x != 0);
+#if defined(_MSC_VER) && defined(_WIN64)
+	{
+		unsigned long index;
+		_BitScanForward64(&index, x);
+		return (int)index;
+	}
+#elif defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(x);
+#else
+	{
+		int index = 0;
+		while(0 == (x & 1))
+		{
+			x >>= 1;
+			index += 1;
+		}
+		return index;
+	}
+#endif
+}
+
+/* Returns the number of set bits in x. */
+ALGO_INTERNAL int iPopCount64(uint64_t x)
+{
+#if defined(_MSC_VER) && defined(_WIN64)
+	return (int)__popcnt64(x);
+#elif defined(__GNUC__) || defined(__clang__)
+	return __builtin_popcountll(x);
+#else
+	{
+		int count = 0;
+		for(; 0 != x; x &= x-1)
+			count += 1;
+		return count;
+	}
+#endif
+}
+
 /******************************************
  * AlgoAllocPool
  ******************************************/
@@ -667,6 +1618,93 @@ AlgoError algoStackGetCurrentSize(const AlgoStack stack, int32_t *outSize)
 	return kAlgoErrorNone;
 }
 
+/******************************************
+ * Cache prefetching
+ ******************************************/
+
+/* Hints that the cache line containing addr will be read soon. addr need not be valid; it is never dereferenced. */
+ALGO_INTERNAL ALGO_INLINE void iPrefetch(const void *addr)
+{
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+	_mm_prefetch((const char*)addr, _MM_HINT_T0);
+#elif defined(__GNUC__) || defined(__clang__)
+	__builtin_prefetch(addr);
+#else
+	ALGO_UNUSED(addr);
+#endif
+}
+
+/******************************************
+ * SIMD dispatch
+ ******************************************/
+
+/* Vector kernels are compiled with per-function target attributes instead of relying on compiler flags, and are only
+   called after iGetCpuSimdLevel() has checked the CPU they're running on. */
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#	include <immintrin.h>
+#	define ALGO_HAS_X86_SIMD 1
+#	define ALGO_TARGET_AVX2   __attribute__((target("avx2")))
+#	define ALGO_TARGET_AVX512 __attribute__((target("avx512f")))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#	include <immintrin.h>
+#	define ALGO_HAS_X86_SIMD 1
+#	define ALGO_TARGET_AVX2
+#	define ALGO_TARGET_AVX512
+#else
+#	define ALGO_HAS_X86_SIMD 0
+#endif
+
+ALGO_INTERNAL AlgoSimdLevel iDetectCpuSimdLevel(void)
+{
+#if ALGO_HAS_X86_SIMD && defined(_MSC_VER)
+	/* The OS must also save the vector registers on context switches, as reported by XCR0. */
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return kAlgoSimdScalar;
+	__cpuid(info, 1);
+	if (0 == (info[2] & (1<<27)) || /* OSXSAVE */
+		0 == (info[2] & (1<<28)))   /* AVX */
+	{
+		return kAlgoSimdScalar;
+	}
+	const unsigned long long xcr0 = _xgetbv(0);
+	__cpuidex(info, 7, 0);
+	if ((info[1] & (1<<16)) && 0xE6 == (xcr0 & 0xE6)) /* AVX512F; opmask, ZMM and YMM state */
+		return kAlgoSimdAvx512;
+	if ((info[1] & (1<<5)) && 0x6 == (xcr0 & 0x6)) /* AVX2; YMM state */
+		return kAlgoSimdAvx2;
+	return kAlgoSimdScalar;
+#elif ALGO_HAS_X86_SIMD
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f"))
+		return kAlgoSimdAvx512;
+	if (__builtin_cpu_supports("avx2"))
+		return kAlgoSimdAvx2;
+	return kAlgoSimdScalar;
+#else
+	return kAlgoSimdScalar;
+#endif
+}
+/* CPUID is slow (and traps under some hypervisors), so the level is only detected once. Threads racing on the first
+   call all store the same value. */
+ALGO_INTERNAL AlgoSimdLevel iGetCpuSimdLevel(void)
+{
+	static volatile int32_t cachedLevel = -1;
+	if (cachedLevel < 0)
+		cachedLevel = (int32_t)iDetectCpuSimdLevel();
+	return (AlgoSimdLevel)cachedLevel;
+}
+AlgoError algoGetSupportedSimdLevel(AlgoSimdLevel *outLevel)
+{
+	if (NULL == outLevel)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outLevel = iGetCpuSimdLevel();
+	return kAlgoErrorNone;
+}
+
 /*****************************************
  * AlgoQueue
  *****************************************/
@@ -1089,121 +2127,175 @@ AlgoError algoHeapValidate(const AlgoHeap heap)
 	return kAlgoErrorNone;
 }
 
-/************************************************
- * AlgoGraph
- ************************************************/
-
-typedef struct AlgoGraphEdge
-{
-	int32_t destVertex; /* Adjacency info */
-	int32_t weight;
-	struct AlgoGraphEdge *next;
-} AlgoGraphEdge;
+/********************************************
+ * AlgoMinMaxHeap
+ ********************************************/
 
-typedef struct AlgoGraphImpl
+typedef struct AlgoMinMaxHeapImpl
 {
 	const void *thisBuffer;
 	size_t thisBufferSize;
-	int32_t vertexCapacity;
-	int32_t edgeCapacity;
-	int32_t currentVertexCount; /* 0..vertexCapacity */
-	int32_t currentEdgeCount; /* 0..edgeCapacity */
-	int32_t nextFreeVertexId; /* Used to manage the unused vertex pool in vertexData[] */
-	AlgoGraphEdgeMode edgeMode;
-	int32_t *vertexDegrees; /* degree (outgoing edge count) per vertex. Unused/invalid vertices have a degree of -1. */
-	AlgoData *vertexData; /* Arbitrary per-vertex data. One element per vertex. Unused elements used as a free list of unused vertices. */
-	int32_t *validVertexIds; /* unsorted list of valid vertex IDs. The first currentVertexCount elements are valid; the rest are undefined. */
-	int32_t *vertexIdToValidIndex; /* reverse-lookup from vertexId into validVertexIds[], to keep removal reasonably efficient. */
-	AlgoGraphEdge **vertexEdges; /* One edge list per vertex. */
-	AlgoAllocPool edgePool; /* pool from which edges are allocated. */
-} AlgoGraphImpl;
+	AlgoDataCompareFunc keyCompare;
+	int32_t capacity;
+	int32_t nextEmpty; /* 1-based, like AlgoHeap. Even levels (including the root) are min levels; odd levels are max levels. */
+	AlgoHeapNode *nodes;
+} AlgoMinMaxHeapImpl;
 
-ALGO_INTERNAL ALGO_INLINE int iGraphIsValidVertexId(const AlgoGraph graph, int32_t vertexId)
+/* Internal utilities */
+
+ALGO_INTERNAL int32_t iMinMaxHeapCurrentSize(AlgoMinMaxHeap heap)
 {
-	ALGO_ASSERT(NULL != graph);
-	return (
-		vertexId >= 0 &&
-		vertexId < graph->vertexCapacity &&
-		graph->vertexDegrees[vertexId] >= 0) ? 1 : 0;
+	ALGO_ASSERT(NULL != heap);
+	return heap->nextEmpty - kAlgoHeapRootIndex;
 }
 
-ALGO_INTERNAL int iGraphRemoveEdgeFromList(AlgoGraph graph, int32_t srcVertexId, int32_t destVertexId)
+ALGO_INTERNAL int iMinMaxHeapIsMinLevel(int32_t nodeIndex)
 {
-	/*  This function ONLY finds and removes a single edge, and decrements the source vertex's degree.
-		The following are the responsibility of the caller, where applicable:
-		- decrement the graph's edge count.
-		- remove matching dest->src edge for undirected graphs.
-		*/
-	int found = 0;
-	AlgoGraphEdge *edge = graph->vertexEdges[srcVertexId];
-	if (edge == NULL)
-		return 0; /* srcVertexId has no edges */
-	else if (edge->destVertex == destVertexId)
-	{
-		graph->vertexEdges[srcVertexId] = edge->next;
-		algoAllocPoolFree(graph->edgePool, edge);
-		found = 1;
-	}
-	else
+	int level = 0;
+	ALGO_ASSERT(nodeIndex >= kAlgoHeapRootIndex);
+	while(nodeIndex > 1)
 	{
-		while(NULL != edge->next)
-		{
-			if (edge->next->destVertex == destVertexId)
-			{
-				AlgoGraphEdge *toFree = edge->next;
-				edge->next = toFree->next;
-				algoAllocPoolFree(graph->edgePool, toFree);
-				found = 1;
-				break;
-			}
-			edge = edge->next;
-		}
+		nodeIndex >>= 1;
+		level += 1;
 	}
-	if (!found)
-		return 0;
-	graph->vertexDegrees[srcVertexId] -= 1;
-	return 1;
+	return (level & 1) == 0;
 }
 
-AlgoError algoGraphComputeBufferSize(size_t *outBufferSize, int32_t vertexCapacity, int32_t edgeCapacity,
-	const AlgoGraphEdgeMode edgeMode)
+ALGO_INTERNAL void iMinMaxHeapSwapNodes(AlgoMinMaxHeap heap, const int32_t index1, const int32_t index2)
 {
-	AlgoError err;
-	const size_t vertexDegreesSize        = vertexCapacity * sizeof(int32_t);
-	const size_t vertexDataSize           = vertexCapacity * sizeof(AlgoData);
-	const size_t validVertexIdsSize       = vertexCapacity * sizeof(int32_t);
-	const size_t vertexIdToValidIndexSize = vertexCapacity * sizeof(int32_t);
-	const size_t vertexEdgesSize          = vertexCapacity * sizeof(AlgoGraphEdge*); /* one edge list per vertex */
-	const int32_t nodesPerEdge = (edgeMode == kAlgoGraphEdgeDirected) ? 1 : 2; /* undirected edges store two nodes: x->y and y->x */
-	size_t edgePoolSize = 0;
-	if (NULL == outBufferSize ||
-		vertexCapacity < 0 ||
-		edgeCapacity < 0)
+	AlgoHeapNode tempNode;
+	ALGO_ASSERT(index1 >= kAlgoHeapRootIndex && index1 < heap->nextEmpty);
+	ALGO_ASSERT(index2 >= kAlgoHeapRootIndex && index2 < heap->nextEmpty);
+	tempNode = heap->nodes[index1];
+	heap->nodes[index1] = heap->nodes[index2];
+	heap->nodes[index2] = tempNode;
+}
+
+/* Compares two nodes from the point of view of a level. order=1 on min levels and -1 on max levels, so that
+   a negative result always means nodeL belongs closer to the root than nodeR. */
+ALGO_INTERNAL int iMinMaxHeapCompare(AlgoMinMaxHeap heap, int32_t nodeL, int32_t nodeR, int order)
+{
+	return order * heap->keyCompare(heap->nodes[nodeL].key, heap->nodes[nodeR].key);
+}
+
+/* Moves a node up through its grandparents, which are on the same kind of level as the node itself. */
+ALGO_INTERNAL void iMinMaxHeapBubbleUpGrandparents(AlgoMinMaxHeap heap, int32_t nodeIndex, int order)
+{
+	while(nodeIndex >= 4*kAlgoHeapRootIndex)
 	{
-		return kAlgoErrorInvalidArgument;
+		int32_t grandparentIndex = nodeIndex/4;
+		if (iMinMaxHeapCompare(heap, nodeIndex, grandparentIndex, order) >= 0)
+		{
+			break;
+		}
+		iMinMaxHeapSwapNodes(heap, nodeIndex, grandparentIndex);
+		nodeIndex = grandparentIndex;
 	}
-	err = algoAllocPoolComputeBufferSize(&edgePoolSize, sizeof(AlgoGraphEdge), edgeCapacity*nodesPerEdge);
-	if (err != kAlgoErrorNone)
+}
+
+/* Moves a node down through its children and grandchildren until the min-max heap condition holds again. */
+ALGO_INTERNAL void iMinMaxHeapBubbleDown(AlgoMinMaxHeap heap, int32_t nodeIndex)
+{
+	const int order = iMinMaxHeapIsMinLevel(nodeIndex) ? 1 : -1;
+	while(2*nodeIndex < heap->nextEmpty)
+	{
+		/* Find the best of the node's (up to) two children and four grandchildren. */
+		int32_t bestIndex = 2*nodeIndex;
+		int32_t candidates[5], iCandidate;
+		candidates[0] = 2*nodeIndex + 1;
+		candidates[1] = 4*nodeIndex;
+		candidates[2] = 4*nodeIndex + 1;
+		candidates[3] = 4*nodeIndex + 2;
+		candidates[4] = 4*nodeIndex + 3;
+		for(iCandidate=0; iCandidate<5; ++iCandidate)
+		{
+			if (candidates[iCandidate] >= heap->nextEmpty)
+			{
+				break;
+			}
+			if (iMinMaxHeapCompare(heap, candidates[iCandidate], bestIndex, order) < 0)
+			{
+				bestIndex = candidates[iCandidate];
+			}
+		}
+		if (iMinMaxHeapCompare(heap, bestIndex, nodeIndex, order) >= 0)
+		{
+			break; /* early out */
+		}
+		iMinMaxHeapSwapNodes(heap, bestIndex, nodeIndex);
+		if (bestIndex < 4*nodeIndex)
+		{
+			break; /* Swapped with a child; the child's subtree is already valid. */
+		}
+		/* Swapped with a grandchild; it may now be out of order with its parent, which is on the opposite kind of level. */
+		if (iMinMaxHeapCompare(heap, bestIndex, bestIndex/2, order) > 0)
+		{
+			iMinMaxHeapSwapNodes(heap, bestIndex, bestIndex/2);
+		}
+		nodeIndex = bestIndex;
+	}
+}
+
+ALGO_INTERNAL int32_t iMinMaxHeapMaxIndex(AlgoMinMaxHeap heap)
+{
+	int32_t maxIndex = kAlgoHeapRootIndex;
+	ALGO_ASSERT(iMinMaxHeapCurrentSize(heap) > 0);
+	if (heap->nextEmpty > 2*kAlgoHeapRootIndex)
 	{
-		return err;
+		maxIndex = 2*kAlgoHeapRootIndex;
+		if (heap->nextEmpty > 2*kAlgoHeapRootIndex + 1 &&
+			heap->keyCompare(heap->nodes[maxIndex+1].key, heap->nodes[maxIndex].key) > 0)
+		{
+			maxIndex += 1;
+		}
+	}
+	return maxIndex;
+}
+
+/* Removes the node at the specified index, replacing it with the last node in the heap. */
+ALGO_INTERNAL void iMinMaxHeapRemoveNode(AlgoMinMaxHeap heap, int32_t nodeIndex, AlgoData *outKey, AlgoData *outData)
+{
+	if (NULL != outKey)
+	{
+		*outKey = heap->nodes[nodeIndex].key;
+	}
+	if (NULL != outData)
+	{
+		*outData = heap->nodes[nodeIndex].data;
+	}
+	heap->nextEmpty -= 1;
+	heap->nodes[nodeIndex] = heap->nodes[heap->nextEmpty];
+	if (nodeIndex < heap->nextEmpty)
+	{
+		iMinMaxHeapBubbleDown(heap, nodeIndex);
+	}
+}
+
+/* public API functions */
+
+AlgoError algoMinMaxHeapComputeBufferSize(size_t *outSize, int32_t heapCapacity)
+{
+	if (NULL == outSize ||
+		heapCapacity < 0)
+	{
+		return kAlgoErrorInvalidArgument;
 	}
-	*outBufferSize = sizeof(AlgoGraphImpl) + vertexDegreesSize + vertexDataSize + validVertexIdsSize
-		+ vertexIdToValidIndexSize + vertexEdgesSize + edgePoolSize;
+	*outSize = sizeof(AlgoMinMaxHeapImpl) + (heapCapacity+kAlgoHeapRootIndex) * sizeof(AlgoHeapNode);
 	return kAlgoErrorNone;
 }
 
-AlgoError algoGraphCreate(AlgoGraph *outGraph, int32_t vertexCapacity, int32_t edgeCapacity,
-	const AlgoGraphEdgeMode edgeMode, void *buffer, size_t bufferSize)
+AlgoError algoMinMaxHeapCreate(AlgoMinMaxHeap *outHeap, int32_t heapCapacity, AlgoDataCompareFunc keyCompare,
+	void *buffer, size_t bufferSize)
 {
 	size_t minBufferSize = 0;
 	AlgoError err;
-	if (NULL == outGraph ||
-		vertexCapacity <= 0 ||
-		edgeCapacity <= 0)
+	uint8_t *bufferNext = (uint8_t*)buffer;
+	if (NULL == outHeap ||
+		NULL == keyCompare)
 	{
 		return kAlgoErrorInvalidArgument;
 	}
-	err = algoGraphComputeBufferSize(&minBufferSize, vertexCapacity, edgeCapacity, edgeMode);
+	err = algoMinMaxHeapComputeBufferSize(&minBufferSize, heapCapacity);
 	if (err != kAlgoErrorNone)
 	{
 		return err;
@@ -1214,516 +2306,5426 @@ AlgoError algoGraphCreate(AlgoGraph *outGraph, int32_t vertexCapacity, int32_t e
 		return kAlgoErrorInvalidArgument;
 	}
 
-	uint8_t *bufferNext = (uint8_t*)buffer;
-	*outGraph = (AlgoGraphImpl*)bufferNext;
-	bufferNext += sizeof(AlgoGraphImpl);
-
+	*outHeap = (AlgoMinMaxHeapImpl*)bufferNext;
+	bufferNext += sizeof(AlgoMinMaxHeapImpl);
+	(*outHeap)->thisBuffer = buffer;
+	(*outHeap)->thisBufferSize = bufferSize;
+	(*outHeap)->nodes = (AlgoHeapNode*)bufferNext;
+	bufferNext += (heapCapacity+kAlgoHeapRootIndex) * sizeof(AlgoHeapNode);
+	(*outHeap)->keyCompare = keyCompare;
+	(*outHeap)->capacity = heapCapacity;
+	(*outHeap)->nextEmpty = kAlgoHeapRootIndex;
+	ALGO_ASSERT( bufferNext-minBufferSize == buffer ); /* If this fails, algoMinMaxHeapComputeBufferSize() is out of date. */
+	return kAlgoErrorNone;
+}
 
-	const size_t vertexDegreeSize = vertexCapacity * sizeof(int32_t);
-	(*outGraph)->vertexDegrees = (int32_t*)bufferNext;
+AlgoError algoMinMaxHeapGetBufferSize(const AlgoMinMaxHeap heap, size_t *outBufferSize)
+{
+	if (NULL == heap ||
+		NULL == outBufferSize)
 	{
-		int32_t iVert;
-		for(iVert=0; iVert<vertexCapacity; iVert += 1)
-		{
-			(*outGraph)->vertexDegrees[iVert] = -1;
-		}
+		return kAlgoErrorInvalidArgument;
 	}
-	bufferNext += vertexDegreeSize;
+	*outBufferSize = heap->thisBufferSize;
+	return kAlgoErrorNone;
+}
 
-	const size_t vertexDataSize = vertexCapacity * sizeof(AlgoData);
-	(*outGraph)->vertexData = (AlgoData*)bufferNext;
+AlgoError algoMinMaxHeapGetCurrentSize(const AlgoMinMaxHeap heap, int32_t *outSize)
+{
+	if (NULL == heap ||
+		NULL == outSize)
 	{
-		int32_t iVert;
-		for(iVert=0; iVert<vertexCapacity-1; iVert += 1)
-		{
-			(*outGraph)->vertexData[iVert].asInt = iVert+1; /* store linked list of available vertices in the data fields */
-		}
-		(*outGraph)->vertexData[vertexCapacity-1].asInt = -1;
+		return kAlgoErrorInvalidArgument;
 	}
-	bufferNext += vertexDataSize;
-
-	const size_t validVertexIdsSize = vertexCapacity * sizeof(int32_t);
-	(*outGraph)->validVertexIds = (int32_t*)bufferNext;
-	bufferNext += validVertexIdsSize;
+	*outSize = iMinMaxHeapCurrentSize(heap);
+	return kAlgoErrorNone;
+}
 
-	const size_t vertexIdToValidIndexSize = vertexCapacity * sizeof(int32_t);
-	(*outGraph)->vertexIdToValidIndex = (int32_t*)bufferNext;
-	bufferNext += vertexIdToValidIndexSize;
+AlgoError algoMinMaxHeapGetCapacity(const AlgoMinMaxHeap heap, int32_t *outCapacity)
+{
+	if (NULL == heap ||
+		NULL == outCapacity)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outCapacity = heap->capacity;
+	return kAlgoErrorNone;
+}
 
-	const size_t vertexEdgesSize = vertexCapacity*sizeof(AlgoGraphEdge*); /* one linked list per vertex */
-	(*outGraph)->vertexEdges = (AlgoGraphEdge**)bufferNext;
+AlgoError algoMinMaxHeapInsert(AlgoMinMaxHeap heap, const AlgoData key, const AlgoData data)
+{
+	int32_t childIndex;
+	if (NULL == heap)
 	{
-		int32_t iVert;
-		for(iVert=0; iVert<vertexCapacity; iVert += 1)
+		return kAlgoErrorInvalidArgument;
+	}
+	if (iMinMaxHeapCurrentSize(heap) >= heap->capacity)
+	{
+		return kAlgoErrorOperationFailed; /* Can't insert if it's full! */
+	}
+	/* Insert new node at the end. */
+	childIndex = heap->nextEmpty;
+	heap->nextEmpty += 1;
+	heap->nodes[childIndex].key  = key;
+	heap->nodes[childIndex].data = data;
+	/* Bubble up: first decide whether the new node belongs on the min or max levels of its path to the root,
+	   then walk up through the grandparents on those levels. */
+	if (childIndex > kAlgoHeapRootIndex)
+	{
+		int32_t parentIndex = childIndex/2;
+		int order = iMinMaxHeapIsMinLevel(childIndex) ? 1 : -1;
+		if (iMinMaxHeapCompare(heap, childIndex, parentIndex, order) > 0)
 		{
-			(*outGraph)->vertexEdges[iVert] = NULL;
+			iMinMaxHeapSwapNodes(heap, childIndex, parentIndex);
+			childIndex = parentIndex;
+			order = -order;
 		}
+		iMinMaxHeapBubbleUpGrandparents(heap, childIndex, order);
 	}
-	bufferNext += vertexEdgesSize;
+	return kAlgoErrorNone;
+}
 
-	const int32_t nodesPerEdge = (edgeMode == kAlgoGraphEdgeDirected) ? 1 : 2; /* undirected edges store two nodes: x->y and y->x */
-	size_t edgePoolSize = 0;
-	err = algoAllocPoolComputeBufferSize(&edgePoolSize, sizeof(AlgoGraphEdge), edgeCapacity*nodesPerEdge);
-	if (err != kAlgoErrorNone)
+AlgoError algoMinMaxHeapPeekMin(const AlgoMinMaxHeap heap, AlgoData *outMinKey, AlgoData *outMinData)
+{
+	if (NULL == heap)
 	{
-		return err;
+		return kAlgoErrorInvalidArgument;
 	}
-	err = algoAllocPoolCreate(&((*outGraph)->edgePool), sizeof(AlgoGraphEdge), edgeCapacity*nodesPerEdge, bufferNext, edgePoolSize);
-	bufferNext += edgePoolSize;
-
-
-	ALGO_ASSERT( bufferNext-minBufferSize == buffer ); /* If this fails, algoGraphComputeBufferSize() is out of date. */
-
-	(*outGraph)->thisBuffer = buffer;
-	(*outGraph)->thisBufferSize = bufferSize;
-	(*outGraph)->vertexCapacity = vertexCapacity;
-	(*outGraph)->edgeCapacity   =   edgeCapacity;
-	(*outGraph)->currentVertexCount = 0;
-	(*outGraph)->currentEdgeCount   = 0;
-	(*outGraph)->edgeMode    = edgeMode;
-	(*outGraph)->nextFreeVertexId = 0;
+	if (0 == iMinMaxHeapCurrentSize(heap))
+	{
+		return kAlgoErrorOperationFailed; /* Can't peek an empty heap. */
+	}
+	if (NULL != outMinKey)
+	{
+		*outMinKey = heap->nodes[kAlgoHeapRootIndex].key;
+	}
+	if (NULL != outMinData)
+	{
+		*outMinData = heap->nodes[kAlgoHeapRootIndex].data;
+	}
+	return kAlgoErrorNone;
+}
 
+AlgoError algoMinMaxHeapPeekMax(const AlgoMinMaxHeap heap, AlgoData *outMaxKey, AlgoData *outMaxData)
+{
+	int32_t maxIndex;
+	if (NULL == heap)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	if (0 == iMinMaxHeapCurrentSize(heap))
+	{
+		return kAlgoErrorOperationFailed; /* Can't peek an empty heap. */
+	}
+	maxIndex = iMinMaxHeapMaxIndex(heap);
+	if (NULL != outMaxKey)
+	{
+		*outMaxKey = heap->nodes[maxIndex].key;
+	}
+	if (NULL != outMaxData)
+	{
+		*outMaxData = heap->nodes[maxIndex].data;
+	}
 	return kAlgoErrorNone;
 }
 
-AlgoError algoGraphGetBufferSize(const AlgoGraph graph, size_t *outBufferSize)
+AlgoError algoMinMaxHeapPopMin(AlgoMinMaxHeap heap, AlgoData *outMinKey, AlgoData *outMinData)
 {
-	if (NULL == graph ||
-		NULL == outBufferSize)
+	if (NULL == heap)
 	{
 		return kAlgoErrorInvalidArgument;
 	}
-	*outBufferSize = graph->thisBufferSize;
+	if (0 == iMinMaxHeapCurrentSize(heap))
+	{
+		return kAlgoErrorOperationFailed; /* Can't pop an empty heap. */
+	}
+	iMinMaxHeapRemoveNode(heap, kAlgoHeapRootIndex, outMinKey, outMinData);
 	return kAlgoErrorNone;
 }
 
-AlgoError algoGraphValidate(const AlgoGraph graph)
+AlgoError algoMinMaxHeapPopMax(AlgoMinMaxHeap heap, AlgoData *outMaxKey, AlgoData *outMaxData)
 {
-	int errorCode = 0;
-	if (NULL == graph)
+	if (NULL == heap)
 	{
-		errorCode = 1; /* graph must not be NULL. */
-		goto ALGO_GRAPH_VALIDATE_END;
+		return kAlgoErrorInvalidArgument;
 	}
-	if (graph->currentEdgeCount < 0 ||
-		graph->edgeCapacity > graph->edgeCapacity)
+	if (0 == iMinMaxHeapCurrentSize(heap))
 	{
-		errorCode = 2; /* edge count exceeds capacity. */
-		goto ALGO_GRAPH_VALIDATE_END;
+		return kAlgoErrorOperationFailed; /* Can't pop an empty heap. */
 	}
-	if (graph->currentVertexCount < 0 ||
-		graph->currentVertexCount > graph->vertexCapacity)
+	iMinMaxHeapRemoveNode(heap, iMinMaxHeapMaxIndex(heap), outMaxKey, outMaxData);
+	return kAlgoErrorNone;
+}
+
+AlgoError algoMinMaxHeapValidate(const AlgoMinMaxHeap heap)
+{
+	int32_t iNode;
+	/* Basic tests */
+	if (NULL == heap ||
+		NULL == heap->nodes)
 	{
-		errorCode = 3; /* vertex count exceeds capacity */
-		goto ALGO_GRAPH_VALIDATE_END;
+		return kAlgoErrorInvalidArgument; /* AlgoMinMaxHeap pointer(s) are NULL. */
 	}
-	/* Check edge lists */
+	if (heap->nextEmpty < kAlgoHeapRootIndex ||
+		heap->capacity < 0 ||
+		iMinMaxHeapCurrentSize(heap) > heap->capacity)
 	{
-		int validVertexCount = 0;
-		int validEdgeNodeCount = 0;
-		int iVertex;
-		const int32_t nodesPerEdge = (graph->edgeMode == kAlgoGraphEdgeDirected) ? 1 : 2; /* undirected edges store two nodes: x->y and y->x */
-		for(iVertex=0; iVertex<graph->vertexCapacity; iVertex += 1)
+		return kAlgoErrorInvalidArgument; /* AlgoMinMaxHeap size/capacity are invalid. */
+	}
+	/* Every node must be on the correct side of its parent and its grandparent; by induction, every node on a min
+	   level is then <= all of its descendants, and every node on a max level is >= all of its descendants. */
+	for(iNode=kAlgoHeapRootIndex+1; iNode<heap->nextEmpty; ++iNode)
+	{
+		int order = iMinMaxHeapIsMinLevel(iNode) ? 1 : -1;
+		if (iMinMaxHeapCompare(heap, iNode, iNode/2, order) > 0)
 		{
-			if (iGraphIsValidVertexId(graph, iVertex))
-			{
-				int edgeListLength = 0;
-				const AlgoGraphEdge *edge = graph->vertexEdges[iVertex];
-				while(edge)
-				{
-					if (!iGraphIsValidVertexId(graph, edge->destVertex))
-					{
-						errorCode = 4; /* edge's destination vertex is invalid. */
-						goto ALGO_GRAPH_VALIDATE_END;
-					}
-					validEdgeNodeCount += 1;
-					edgeListLength += 1;
-					edge = edge->next;
-				}
-				if (edgeListLength != graph->vertexDegrees[iVertex])
-				{
-					errorCode = 5; /* vertex degree doesn't match edge list length. */
-					goto ALGO_GRAPH_VALIDATE_END;
-				}
-				/* TODO: check for multiple edges to the same destination vertex. That's not currently supported. */
-				/* TODO: for undirected graphs, make sure every v1->v2 edge has a matching v2->v1 edge. */
-				validVertexCount += 1;
-			}
-			else
+			return kAlgoErrorInvalidArgument;
+		}
+		if (iNode >= 4*kAlgoHeapRootIndex &&
+			iMinMaxHeapCompare(heap, iNode, iNode/4, order) < 0)
+		{
+			return kAlgoErrorInvalidArgument;
+		}
+	}
+	return kAlgoErrorNone;
+}
+
+/********************************************
+ * AlgoPairingHeap
+ ********************************************/
+
+typedef struct AlgoPairingHeapNodeImpl
+{
+	struct AlgoPairingHeapNodeImpl *child; /* leftmost child */
+	struct AlgoPairingHeapNodeImpl *next; /* next sibling */
+	struct AlgoPairingHeapNodeImpl *prev; /* previous sibling, or parent if this is its parent's leftmost child. NULL for the root. */
+	AlgoData key;
+	AlgoData data;
+} AlgoPairingHeapNodeImpl;
+
+typedef struct AlgoPairingHeapImpl
+{
+	const void *thisBuffer;
+	size_t thisBufferSize;
+	AlgoDataCompareFunc keyCompare;
+	AlgoAllocPool nodePool;
+	int32_t currentSize;
+	AlgoPairingHeapNodeImpl *root;
+} AlgoPairingHeapImpl;
+
+/* Internal utilities */
+
+/* Links two detached trees, making the root with the lower-priority key the leftmost child of the other.
+   Returns the root of the combined tree. The caller is responsible for any sibling links of the inputs. */
+ALGO_INTERNAL AlgoPairingHeapNodeImpl *iPairingHeapLink(AlgoPairingHeap heap,
+	AlgoPairingHeapNodeImpl *a, AlgoPairingHeapNodeImpl *b)
+{
+	AlgoPairingHeapNodeImpl *temp;
+	ALGO_ASSERT(NULL != heap);
+	if (NULL == b)
+		return a;
+	if (NULL == a)
+		return b;
+	if (heap->keyCompare(b->key, a->key) < 0)
+	{
+		temp = a;
+		a = b;
+		b = temp;
+	}
+	b->next = a->child;
+	if (NULL != a->child)
+	{
+		a->child->prev = b;
+	}
+	b->prev = a;
+	a->child = b;
+	a->next = NULL;
+	a->prev = NULL;
+	return a;
+}
+
+/* Standard two-pass pairing: link siblings in pairs from left to right, then fold the pairs together from right to left. */
+ALGO_INTERNAL AlgoPairingHeapNodeImpl *iPairingHeapMergePairs(AlgoPairingHeap heap, AlgoPairingHeapNodeImpl *first)
+{
+	AlgoPairingHeapNodeImpl *pairs = NULL; /* singly-linked through next; most recently linked pair first. */
+	AlgoPairingHeapNodeImpl *result = NULL;
+	while(NULL != first)
+	{
+		AlgoPairingHeapNodeImpl *a = first;
+		AlgoPairingHeapNodeImpl *b = a->next;
+		AlgoPairingHeapNodeImpl *linked;
+		first = (NULL != b) ? b->next : NULL;
+		a->next = NULL;
+		a->prev = NULL;
+		if (NULL != b)
+		{
+			b->next = NULL;
+			b->prev = NULL;
+		}
+		linked = iPairingHeapLink(heap, a, b);
+		linked->next = pairs;
+		pairs = linked;
+	}
+	while(NULL != pairs)
+	{
+		AlgoPairingHeapNodeImpl *nextPair = pairs->next;
+		pairs->next = NULL;
+		result = iPairingHeapLink(heap, result, pairs);
+		pairs = nextPair;
+	}
+	return result;
+}
+
+/* public API functions */
+
+AlgoError algoPairingHeapComputeNodeSize(int32_t *outNodeSize)
+{
+	if (NULL == outNodeSize)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outNodeSize = (int32_t)sizeof(AlgoPairingHeapNodeImpl);
+	return kAlgoErrorNone;
+}
+
+AlgoError algoPairingHeapComputeBufferSize(size_t *outBufferSize)
+{
+	if (NULL == outBufferSize)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outBufferSize = sizeof(AlgoPairingHeapImpl);
+	return kAlgoErrorNone;
+}
+
+AlgoError algoPairingHeapCreate(AlgoPairingHeap *outHeap, AlgoDataCompareFunc keyCompare, AlgoAllocPool nodePool,
+	void *buffer, size_t bufferSize)
+{
+	size_t minBufferSize = 0;
+	int32_t poolElementSize = 0;
+	AlgoError err;
+	uint8_t *bufferNext = (uint8_t*)buffer;
+	if (NULL == outHeap ||
+		NULL == keyCompare ||
+		NULL == nodePool)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	err = algoAllocPoolGetElementSize(nodePool, &poolElementSize);
+	if (err != kAlgoErrorNone)
+	{
+		return err;
+	}
+	if (poolElementSize < (int32_t)sizeof(AlgoPairingHeapNodeImpl))
+	{
+		return kAlgoErrorInvalidArgument; /* pool elements are too small to hold heap nodes. */
+	}
+	err = algoPairingHeapComputeBufferSize(&minBufferSize);
+	if (err != kAlgoErrorNone)
+	{
+		return err;
+	}
+	if (NULL == buffer ||
+		bufferSize < minBufferSize)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+
+	*outHeap = (AlgoPairingHeapImpl*)bufferNext;
+	bufferNext += sizeof(AlgoPairingHeapImpl);
+	ALGO_ASSERT( bufferNext-minBufferSize == buffer ); /* If this fails, algoPairingHeapComputeBufferSize() is out of date. */
+	(*outHeap)->thisBuffer = buffer;
+	(*outHeap)->thisBufferSize = bufferSize;
+	(*outHeap)->keyCompare = keyCompare;
+	(*outHeap)->nodePool = nodePool;
+	(*outHeap)->currentSize = 0;
+	(*outHeap)->root = NULL;
+	return kAlgoErrorNone;
+}
+
+AlgoError algoPairingHeapGetBufferSize(const AlgoPairingHeap heap, size_t *outBufferSize)
+{
+	if (NULL == heap ||
+		NULL == outBufferSize)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outBufferSize = heap->thisBufferSize;
+	return kAlgoErrorNone;
+}
+
+AlgoError algoPairingHeapGetCurrentSize(const AlgoPairingHeap heap, int32_t *outSize)
+{
+	if (NULL == heap ||
+		NULL == outSize)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outSize = heap->currentSize;
+	return kAlgoErrorNone;
+}
+
+AlgoError algoPairingHeapInsert(AlgoPairingHeap heap, const AlgoData key, const AlgoData data, AlgoPairingHeapNode *outNode)
+{
+	AlgoPairingHeapNodeImpl *newNode = NULL;
+	AlgoError err;
+	if (NULL == heap)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	err = algoAllocPoolAlloc(heap->nodePool, (void**)&newNode);
+	if (err != kAlgoErrorNone)
+	{
+		return kAlgoErrorOperationFailed; /* node pool is exhausted */
+	}
+	newNode->child = NULL;
+	newNode->next = NULL;
+	newNode->prev = NULL;
+	newNode->key = key;
+	newNode->data = data;
+	heap->root = iPairingHeapLink(heap, heap->root, newNode);
+	heap->currentSize += 1;
+	if (NULL != outNode)
+	{
+		*outNode = newNode;
+	}
+	return kAlgoErrorNone;
+}
+
+AlgoError algoPairingHeapPeek(const AlgoPairingHeap heap, AlgoData *outTopKey, AlgoData *outTopData)
+{
+	if (NULL == heap)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	if (NULL == heap->root)
+	{
+		return kAlgoErrorOperationFailed; /* Can't peek an empty heap. */
+	}
+	if (NULL != outTopKey)
+	{
+		*outTopKey = heap->root->key;
+	}
+	if (NULL != outTopData)
+	{
+		*outTopData = heap->root->data;
+	}
+	return kAlgoErrorNone;
+}
+
+AlgoError algoPairingHeapPop(AlgoPairingHeap heap, AlgoData *outTopKey, AlgoData *outTopData)
+{
+	AlgoPairingHeapNodeImpl *oldRoot;
+	if (NULL == heap)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	if (NULL == heap->root)
+	{
+		return kAlgoErrorOperationFailed; /* Can't pop an empty heap. */
+	}
+	oldRoot = heap->root;
+	if (NULL != outTopKey)
+	{
+		*outTopKey = oldRoot->key;
+	}
+	if (NULL != outTopData)
+	{
+		*outTopData = oldRoot->data;
+	}
+	heap->root = iPairingHeapMergePairs(heap, oldRoot->child);
+	heap->currentSize -= 1;
+	algoAllocPoolFree(heap->nodePool, oldRoot);
+	return kAlgoErrorNone;
+}
+
+AlgoError algoPairingHeapDecreaseKey(AlgoPairingHeap heap, AlgoPairingHeapNode node, const AlgoData newKey)
+{
+	if (NULL == heap ||
+		NULL == node ||
+		NULL == heap->root)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	if (heap->keyCompare(newKey, node->key) > 0)
+	{
+		return kAlgoErrorInvalidArgument; /* new key must not be lower-priority than the current key. */
+	}
+	node->key = newKey;
+	if (node == heap->root)
+	{
+		return kAlgoErrorNone;
+	}
+	/* Detach node's subtree from its parent, then link it back in at the root. */
+	ALGO_ASSERT(NULL != node->prev); /* only the root has no prev link. */
+	if (node->prev->child == node)
+	{
+		node->prev->child = node->next;
+	}
+	else
+	{
+		node->prev->next = node->next;
+	}
+	if (NULL != node->next)
+	{
+		node->next->prev = node->prev;
+	}
+	node->next = NULL;
+	node->prev = NULL;
+	heap->root = iPairingHeapLink(heap, heap->root, node);
+	return kAlgoErrorNone;
+}
+
+AlgoError algoPairingHeapMeld(AlgoPairingHeap destHeap, AlgoPairingHeap srcHeap)
+{
+	if (NULL == destHeap ||
+		NULL == srcHeap ||
+		destHeap == srcHeap ||
+		destHeap->nodePool != srcHeap->nodePool ||
+		destHeap->keyCompare != srcHeap->keyCompare)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	destHeap->root = iPairingHeapLink(destHeap, destHeap->root, srcHeap->root);
+	destHeap->currentSize += srcHeap->currentSize;
+	srcHeap->root = NULL;
+	srcHeap->currentSize = 0;
+	return kAlgoErrorNone;
+}
+
+AlgoError algoPairingHeapGetNodeContents(const AlgoPairingHeap heap, const AlgoPairingHeapNode node, AlgoData *outKey, AlgoData *outData)
+{
+	if (NULL == heap ||
+		NULL == node)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	if (NULL != outKey)
+	{
+		*outKey = node->key;
+	}
+	if (NULL != outData)
+	{
+		*outData = node->data;
+	}
+	return kAlgoErrorNone;
+}
+
+AlgoError algoPairingHeapValidate(const AlgoPairingHeap heap)
+{
+	const AlgoPairingHeapNodeImpl *node;
+	int32_t nodeCount = 0;
+	if (NULL == heap ||
+		NULL == heap->keyCompare ||
+		NULL == heap->nodePool)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	if (NULL == heap->root)
+	{
+		return (heap->currentSize == 0) ? kAlgoErrorNone : kAlgoErrorInvalidArgument;
+	}
+	if (NULL != heap->root->prev ||
+		NULL != heap->root->next)
+	{
+		return kAlgoErrorInvalidArgument; /* root must not have siblings. */
+	}
+	/* Iterative pre-order walk; parents are recovered by following prev links back to the leftmost child. */
+	node = heap->root;
+	while(NULL != node)
+	{
+		nodeCount += 1;
+		if (nodeCount > heap->currentSize)
+		{
+			return kAlgoErrorInvalidArgument; /* more nodes than expected (or a cycle). */
+		}
+		if (NULL != node->child)
+		{
+			const AlgoPairingHeapNodeImpl *child;
+			if (node->child->prev != node)
+			{
+				return kAlgoErrorInvalidArgument; /* leftmost child must point back to its parent. */
+			}
+			for(child = node->child; NULL != child; child = child->next)
+			{
+				if (heap->keyCompare(child->key, node->key) < 0)
+				{
+					return kAlgoErrorInvalidArgument; /* heap condition violated. */
+				}
+				if (NULL != child->next && child->next->prev != child)
+				{
+					return kAlgoErrorInvalidArgument; /* sibling links are inconsistent. */
+				}
+			}
+			node = node->child;
+			continue;
+		}
+		while(NULL != node && NULL == node->next)
+		{
+			while(NULL != node->prev && node->prev->child != node)
+			{
+				node = node->prev;
+			}
+			node = node->prev;
+		}
+		if (NULL != node)
+		{
+			node = node->next;
+		}
+	}
+	if (nodeCount != heap->currentSize)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	return kAlgoErrorNone;
+}
+
+/********************************************
+ * AlgoMultiQueue
+ ********************************************/
+
+typedef struct AlgoMultiQueueSlotData
+{
+	volatile int32_t lock; /* 0 = unlocked, 1 = locked */
+	volatile int32_t heapSize; /* mirrors the heap's current size; updated under the lock, read without it. */
+	volatile AlgoData topKey; /* mirrors the heap's top key when heapSize > 0; updated under the lock, read without it. */
+	AlgoHeap heap;
+} AlgoMultiQueueSlotData;
+
+typedef union AlgoMultiQueueSlot
+{
+	AlgoMultiQueueSlotData s;
+	uint8_t padding[ALGO_CACHE_LINE_SIZE]; /* keep each slot's lock on its own cache line */
+} AlgoMultiQueueSlot;
+
+typedef struct AlgoMultiQueueImpl
+{
+	const void *thisBuffer;
+	size_t thisBufferSize;
+	AlgoDataCompareFunc keyCompare;
+	int32_t capacity;
+	int32_t heapCount;
+	int32_t heapCapacity; /* capacity of each internal heap */
+	volatile int32_t currentSize;
+	AlgoMultiQueueSlot *slots;
+} AlgoMultiQueueImpl;
+
+/* Internal utilities */
+
+ALGO_INTERNAL int32_t iMultiQueueHeapCapacity(int32_t capacity, int32_t heapCount)
+{
+	return (capacity + heapCount - 1) / heapCount;
+}
+
+/* Must be called with the slot's lock held. */
+ALGO_INTERNAL void iMultiQueueSlotRefresh(AlgoMultiQueueSlot *slot)
+{
+	int32_t heapSize = 0;
+	algoHeapGetCurrentSize(slot->s.heap, &heapSize);
+	if (heapSize > 0)
+	{
+		AlgoData topKey;
+		algoHeapPeek(slot->s.heap, &topKey, NULL);
+		slot->s.topKey = topKey;
+	}
+	slot->s.heapSize = heapSize;
+}
+
+/* public API functions */
+
+AlgoError algoMultiQueueComputeBufferSize(size_t *outBufferSize, int32_t capacity, int32_t threadCount, int32_t relaxationFactor)
+{
+	int32_t heapCount, heapCapacity;
+	size_t heapBufferSize = 0;
+	AlgoError err;
+	if (NULL == outBufferSize ||
+		capacity < 1 ||
+		threadCount < 1 ||
+		relaxationFactor < 1)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	heapCount = threadCount * relaxationFactor;
+	heapCapacity = iMultiQueueHeapCapacity(capacity, heapCount);
+	err = algoHeapComputeBufferSize(&heapBufferSize, heapCapacity);
+	if (err != kAlgoErrorNone)
+	{
+		return err;
+	}
+	/* The extra cache line leaves room to align the slot array. */
+	*outBufferSize = sizeof(AlgoMultiQueueImpl) + (ALGO_CACHE_LINE_SIZE-1) + heapCount*sizeof(AlgoMultiQueueSlot)
+		+ heapCount*heapBufferSize;
+	return kAlgoErrorNone;
+}
+
+AlgoError algoMultiQueueCreate(AlgoMultiQueue *outQueue, int32_t capacity, int32_t threadCount, int32_t relaxationFactor,
+	AlgoDataCompareFunc keyCompare, void *buffer, size_t bufferSize)
+{
+	size_t minBufferSize = 0, heapBufferSize = 0;
+	AlgoError err;
+	uint8_t *bufferNext = (uint8_t*)buffer;
+	int32_t heapCount, heapCapacity, iHeap;
+	if (NULL == outQueue ||
+		NULL == keyCompare)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	err = algoMultiQueueComputeBufferSize(&minBufferSize, capacity, threadCount, relaxationFactor);
+	if (err != kAlgoErrorNone)
+	{
+		return err;
+	}
+	if (NULL == buffer ||
+		bufferSize < minBufferSize)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	heapCount = threadCount * relaxationFactor;
+	heapCapacity = iMultiQueueHeapCapacity(capacity, heapCount);
+	err = algoHeapComputeBufferSize(&heapBufferSize, heapCapacity);
+	if (err != kAlgoErrorNone)
+	{
+		return err;
+	}
+
+	*outQueue = (AlgoMultiQueueImpl*)bufferNext;
+	bufferNext += sizeof(AlgoMultiQueueImpl);
+
+	bufferNext = (uint8_t*)( ((uintptr_t)bufferNext + (ALGO_CACHE_LINE_SIZE-1)) & ~(uintptr_t)(ALGO_CACHE_LINE_SIZE-1) );
+	(*outQueue)->slots = (AlgoMultiQueueSlot*)bufferNext;
+	bufferNext += heapCount*sizeof(AlgoMultiQueueSlot);
+
+	for(iHeap=0; iHeap<heapCount; ++iHeap)
+	{
+		AlgoMultiQueueSlot *slot = (*outQueue)->slots + iHeap;
+		err = algoHeapCreate(&slot->s.heap, heapCapacity, keyCompare, bufferNext, heapBufferSize);
+		if (err != kAlgoErrorNone)
+		{
+			return err;
+		}
+		bufferNext += heapBufferSize;
+		slot->s.lock = 0;
+		slot->s.heapSize = 0;
+		slot->s.topKey.asPtr = NULL;
+	}
+	/* Alignment padding may leave some of the buffer unused. */
+	ALGO_ASSERT( bufferNext <= (uint8_t*)buffer + minBufferSize ); /* If this fails, algoMultiQueueComputeBufferSize() is out of date. */
+
+	(*outQueue)->thisBuffer = buffer;
+	(*outQueue)->thisBufferSize = bufferSize;
+	(*outQueue)->keyCompare = keyCompare;
+	(*outQueue)->capacity = capacity;
+	(*outQueue)->heapCount = heapCount;
+	(*outQueue)->heapCapacity = heapCapacity;
+	(*outQueue)->currentSize = 0;
+	return kAlgoErrorNone;
+}
+
+AlgoError algoMultiQueueGetBufferSize(const AlgoMultiQueue queue, size_t *outBufferSize)
+{
+	if (NULL == queue ||
+		NULL == outBufferSize)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outBufferSize = queue->thisBufferSize;
+	return kAlgoErrorNone;
+}
+
+AlgoError algoMultiQueueInsert(AlgoMultiQueue queue, const AlgoData key, const AlgoData data)
+{
+	int32_t attempt;
+	if (NULL == queue)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	/* Reserve space up front. The heaps' combined capacity is at least queue->capacity, so once the reservation
+	   succeeds, some heap is guaranteed to have room. */
+	if (iAtomicFetchAdd32(&queue->currentSize, 1) >= queue->capacity)
+	{
+		iAtomicFetchAdd32(&queue->currentSize, -1);
+		return kAlgoErrorOperationFailed; /* queue is full */
+	}
+	/* Try random heaps until one is unlocked and not full. After enough misses, fall back to visiting
+	   each heap in turn, in case the only free space is concentrated in a few heaps. */
+	for(attempt=0; ; ++attempt)
+	{
+		AlgoMultiQueueSlot *slot = (attempt < 4*queue->heapCount)
+			? queue->slots + (iThreadRandom() % (uint32_t)queue->heapCount)
+			: queue->slots + (attempt % queue->heapCount);
+		if (slot->s.heapSize >= queue->heapCapacity ||
+			!iTryLock(&slot->s.lock))
+		{
+			continue;
+		}
+		if (kAlgoErrorNone == algoHeapInsert(slot->s.heap, key, data))
+		{
+			iMultiQueueSlotRefresh(slot);
+			iUnlock(&slot->s.lock);
+			return kAlgoErrorNone;
+		}
+		iUnlock(&slot->s.lock);
+	}
+}
+
+AlgoError algoMultiQueuePop(AlgoMultiQueue queue, AlgoData *outKey, AlgoData *outData)
+{
+	int32_t attempt, iHeap;
+	if (NULL == queue)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	/* Fast path: compare the tops of two random heaps, and pop from the better one if its lock is free. */
+	for(attempt=0; attempt<4*queue->heapCount && queue->currentSize > 0; ++attempt)
+	{
+		AlgoMultiQueueSlot *slot0 = queue->slots + (iThreadRandom() % (uint32_t)queue->heapCount);
+		AlgoMultiQueueSlot *slot1 = queue->slots + (iThreadRandom() % (uint32_t)queue->heapCount);
+		AlgoMultiQueueSlot *best = NULL;
+		if (slot0->s.heapSize == 0)
+		{
+			best = (slot1->s.heapSize > 0) ? slot1 : NULL;
+		}
+		else if (slot1->s.heapSize == 0)
+		{
+			best = slot0;
+		}
+		else
+		{
+			/* Unlocked reads; a stale key only affects the quality of the choice, not correctness. */
+			AlgoData key0 = slot0->s.topKey;
+			AlgoData key1 = slot1->s.topKey;
+			best = (queue->keyCompare(key1, key0) < 0) ? slot1 : slot0;
+		}
+		if (NULL == best ||
+			!iTryLock(&best->s.lock))
+		{
+			continue;
+		}
+		if (kAlgoErrorNone == algoHeapPop(best->s.heap, outKey, outData))
+		{
+			iMultiQueueSlotRefresh(best);
+			iUnlock(&best->s.lock);
+			iAtomicFetchAdd32(&queue->currentSize, -1);
+			return kAlgoErrorNone;
+		}
+		iUnlock(&best->s.lock);
+	}
+	/* Slow path: the queue is nearly empty (or heavily contended). Visit every heap in turn. */
+	for(iHeap=0; iHeap<queue->heapCount && queue->currentSize > 0; ++iHeap)
+	{
+		AlgoMultiQueueSlot *slot = queue->slots + iHeap;
+		if (slot->s.heapSize == 0)
+		{
+			continue;
+		}
+		while(!iTryLock(&slot->s.lock))
+		{
+			/* spin */
+		}
+		if (kAlgoErrorNone == algoHeapPop(slot->s.heap, outKey, outData))
+		{
+			iMultiQueueSlotRefresh(slot);
+			iUnlock(&slot->s.lock);
+			iAtomicFetchAdd32(&queue->currentSize, -1);
+			return kAlgoErrorNone;
+		}
+		iUnlock(&slot->s.lock);
+	}
+	return kAlgoErrorOperationFailed; /* queue is empty */
+}
+
+AlgoError algoMultiQueueGetCapacity(const AlgoMultiQueue queue, int32_t *outCapacity)
+{
+	if (NULL == queue ||
+		NULL == outCapacity)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outCapacity = queue->capacity;
+	return kAlgoErrorNone;
+}
+
+AlgoError algoMultiQueueGetCurrentSize(const AlgoMultiQueue queue, int32_t *outSize)
+{
+	if (NULL == queue ||
+		NULL == outSize)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outSize = queue->currentSize;
+	return kAlgoErrorNone;
+}
+
+AlgoError algoMultiQueueGetHeapCount(const AlgoMultiQueue queue, int32_t *outHeapCount)
+{
+	if (NULL == queue ||
+		NULL == outHeapCount)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outHeapCount = queue->heapCount;
+	return kAlgoErrorNone;
+}
+
+/********************************************
+ * AlgoTimerWheel
+ ********************************************/
+
+#define kAlgoTimerWheelSlotBits 6
+#define kAlgoTimerWheelSlotsPerLevel (1 << kAlgoTimerWheelSlotBits)
+#define kAlgoTimerWheelLevelCount ((64 + kAlgoTimerWheelSlotBits - 1) / kAlgoTimerWheelSlotBits) /* enough to cover any 64-bit deadline */
+
+typedef struct AlgoTimerWheelTimerImpl
+{
+	struct AlgoTimerWheelTimerImpl *next;
+	struct AlgoTimerWheelTimerImpl **prevNext; /* whichever pointer currently points at this timer */
+	uint64_t deadline;
+	AlgoData data;
+	int32_t slotIndex; /* level*kAlgoTimerWheelSlotsPerLevel + slot, or -1 if the timer is not pending. */
+} AlgoTimerWheelTimerImpl;
+
+typedef struct AlgoTimerWheelImpl
+{
+	const void *thisBuffer;
+	size_t thisBufferSize;
+	AlgoAllocPool timerPool;
+	uint64_t currentTime; /* Every timer with deadline <= currentTime has fired. */
+	int32_t capacity;
+	int32_t currentSize;
+	/* A timer lives in the level of the highest 6-bit digit in which its deadline differs from currentTime, in the
+	   slot given by that digit. Bit N of occupiedSlots[L] is set iff level L's slot N is non-empty. */
+	uint64_t occupiedSlots[kAlgoTimerWheelLevelCount];
+	AlgoTimerWheelTimerImpl *slots[kAlgoTimerWheelLevelCount*kAlgoTimerWheelSlotsPerLevel];
+} AlgoTimerWheelImpl;
+
+/* Internal utilities */
+
+/* Links a timer into the slot determined by its deadline and the wheel's current time. */
+ALGO_INTERNAL void iTimerWheelPlace(AlgoTimerWheel wheel, AlgoTimerWheelTimerImpl *timer)
+{
+	/* Overdue timers go in the next tick's slot. */
+	const uint64_t effectiveDeadline = (timer->deadline > wheel->currentTime) ? timer->deadline : wheel->currentTime+1;
+	const int level = iHighestBit64(effectiveDeadline ^ wheel->currentTime) / kAlgoTimerWheelSlotBits;
+	const int slot = (int)(effectiveDeadline >> (level*kAlgoTimerWheelSlotBits)) & (kAlgoTimerWheelSlotsPerLevel-1);
+	const int32_t slotIndex = level*kAlgoTimerWheelSlotsPerLevel + slot;
+	timer->next = wheel->slots[slotIndex];
+	if (NULL != timer->next)
+	{
+		timer->next->prevNext = &timer->next;
+	}
+	timer->prevNext = &wheel->slots[slotIndex];
+	wheel->slots[slotIndex] = timer;
+	wheel->occupiedSlots[level] |= 1ULL << slot;
+	timer->slotIndex = slotIndex;
+}
+
+ALGO_INTERNAL void iTimerWheelUnlink(AlgoTimerWheel wheel, AlgoTimerWheelTimerImpl *timer)
+{
+	const int32_t slotIndex = timer->slotIndex;
+	ALGO_ASSERT(slotIndex >= 0 && slotIndex < kAlgoTimerWheelLevelCount*kAlgoTimerWheelSlotsPerLevel);
+	*(timer->prevNext) = timer->next;
+	if (NULL != timer->next)
+	{
+		timer->next->prevNext = timer->prevNext;
+	}
+	if (NULL == wheel->slots[slotIndex])
+	{
+		wheel->occupiedSlots[slotIndex / kAlgoTimerWheelSlotsPerLevel] &= ~(1ULL << (slotIndex % kAlgoTimerWheelSlotsPerLevel));
+	}
+	timer->slotIndex = -1;
+}
+
+/* public API functions */
+
+AlgoError algoTimerWheelComputeBufferSize(size_t *outBufferSize, int32_t timerCapacity)
+{
+	size_t poolBufferSize = 0;
+	AlgoError err;
+	if (NULL == outBufferSize ||
+		timerCapacity < 1)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	err = algoAllocPoolComputeBufferSize(&poolBufferSize, sizeof(AlgoTimerWheelTimerImpl), timerCapacity);
+	if (kAlgoErrorNone != err)
+	{
+		return err;
+	}
+	*outBufferSize = sizeof(AlgoTimerWheelImpl) + poolBufferSize;
+	return kAlgoErrorNone;
+}
+
+AlgoError algoTimerWheelCreate(AlgoTimerWheel *outWheel, int32_t timerCapacity, uint64_t startTime,
+	void *buffer, size_t bufferSize)
+{
+	size_t minBufferSize = 0, poolBufferSize = 0;
+	AlgoError err;
+	uint8_t *bufferNext = (uint8_t*)buffer;
+	if (NULL == outWheel)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	err = algoTimerWheelComputeBufferSize(&minBufferSize, timerCapacity);
+	if (err != kAlgoErrorNone)
+	{
+		return err;
+	}
+	if (NULL == buffer ||
+		bufferSize < minBufferSize)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+
+	*outWheel = (AlgoTimerWheelImpl*)bufferNext;
+	bufferNext += sizeof(AlgoTimerWheelImpl);
+	ALGO_MEMSET(*outWheel, 0, sizeof(AlgoTimerWheelImpl));
+	(*outWheel)->thisBuffer = buffer;
+	(*outWheel)->thisBufferSize = bufferSize;
+	(*outWheel)->currentTime = startTime;
+	(*outWheel)->capacity = timerCapacity;
+	(*outWheel)->currentSize = 0;
+
+	algoAllocPoolComputeBufferSize(&poolBufferSize, sizeof(AlgoTimerWheelTimerImpl), timerCapacity);
+	err = algoAllocPoolCreate(&((*outWheel)->timerPool), sizeof(AlgoTimerWheelTimerImpl), timerCapacity, bufferNext, poolBufferSize);
+	if (err != kAlgoErrorNone)
+	{
+		return err;
+	}
+	bufferNext += poolBufferSize;
+	ALGO_ASSERT( bufferNext-minBufferSize == buffer ); /* If this fails, algoTimerWheelComputeBufferSize() is out of date. */
+	return kAlgoErrorNone;
+}
+
+AlgoError algoTimerWheelGetBufferSize(const AlgoTimerWheel wheel, size_t *outBufferSize)
+{
+	if (NULL == wheel ||
+		NULL == outBufferSize)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outBufferSize = wheel->thisBufferSize;
+	return kAlgoErrorNone;
+}
+
+AlgoError algoTimerWheelSchedule(AlgoTimerWheel wheel, uint64_t deadline, AlgoData timerData, AlgoTimerWheelTimer *outTimer)
+{
+	AlgoTimerWheelTimerImpl *timer = NULL;
+	if (NULL == wheel)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	if (kAlgoErrorNone != algoAllocPoolAlloc(wheel->timerPool, (void**)&timer))
+	{
+		return kAlgoErrorOperationFailed; /* Too many pending timers. */
+	}
+	timer->deadline = deadline;
+	timer->data = timerData;
+	iTimerWheelPlace(wheel, timer);
+	wheel->currentSize += 1;
+	if (NULL != outTimer)
+	{
+		*outTimer = timer;
+	}
+	return kAlgoErrorNone;
+}
+
+AlgoError algoTimerWheelCancel(AlgoTimerWheel wheel, AlgoTimerWheelTimer timer)
+{
+	if (NULL == wheel ||
+		NULL == timer ||
+		timer->slotIndex < 0)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	iTimerWheelUnlink(wheel, timer);
+	wheel->currentSize -= 1;
+	return algoAllocPoolFree(wheel->timerPool, timer);
+}
+
+AlgoError algoTimerWheelAdvance(AlgoTimerWheel wheel, uint64_t newTime, AlgoTimerWheelCallback expiredFunc, void *userData)
+{
+	if (NULL == wheel ||
+		NULL == expiredFunc ||
+		newTime < wheel->currentTime)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	for(;;)
+	{
+		/* The earliest pending deadlines are in the first occupied slot of the lowest occupied level: every timer in
+		   a level shares all higher digits with currentTime, and every occupied slot is ahead of currentTime's digit. */
+		int level, slot, slotShift;
+		uint64_t slotStart, higherDigitsMask;
+		AlgoTimerWheelTimerImpl **slotHead;
+		for(level=0; level<kAlgoTimerWheelLevelCount; ++level)
+		{
+			if (0 != wheel->occupiedSlots[level])
+			{
+				break;
+			}
+		}
+		if (level == kAlgoTimerWheelLevelCount)
+		{
+			break; /* no pending timers */
+		}
+		slot = iLowestBit64(wheel->occupiedSlots[level]);
+		slotShift = level*kAlgoTimerWheelSlotBits;
+		higherDigitsMask = (slotShift + kAlgoTimerWheelSlotBits >= 64) ? 0 : ~((1ULL << (slotShift + kAlgoTimerWheelSlotBits)) - 1);
+		slotStart = (wheel->currentTime & higherDigitsMask) | ((uint64_t)slot << slotShift);
+		if (slotStart > newTime)
+		{
+			break; /* nothing else expires before newTime */
+		}
+		/* Jump straight to the start of the slot. Its timers either expire now, or cascade into lower levels. */
+		wheel->currentTime = slotStart;
+		slotHead = &wheel->slots[level*kAlgoTimerWheelSlotsPerLevel + slot];
+		while(NULL != *slotHead)
+		{
+			AlgoTimerWheelTimerImpl *timer = *slotHead;
+			iTimerWheelUnlink(wheel, timer);
+			if (timer->deadline <= wheel->currentTime)
+			{
+				uint64_t deadline = timer->deadline;
+				AlgoData timerData = timer->data;
+				wheel->currentSize -= 1;
+				algoAllocPoolFree(wheel->timerPool, timer);
+				expiredFunc(wheel, deadline, timerData, userData);
+			}
+			else
+			{
+				iTimerWheelPlace(wheel, timer);
+			}
+		}
+	}
+	/* No pending timer is due by newTime, so moving there keeps every timer in its correct slot. */
+	wheel->currentTime = newTime;
+	return kAlgoErrorNone;
+}
+
+uint64_t algoTimerWheelClockTicks(void)
+{
+#if defined(_MSC_VER)
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+	/* Convert whole seconds and the remainder separately, so counter*1e9 can't overflow. */
+	const uint64_t seconds = (uint64_t)counter.QuadPart / (uint64_t)frequency.QuadPart;
+	const uint64_t remainder = (uint64_t)counter.QuadPart % (uint64_t)frequency.QuadPart;
+	return seconds*1000000000ULL + remainder*1000000000ULL / (uint64_t)frequency.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec*1000000000ULL + (uint64_t)now.tv_nsec;
+#else
+	/* Strict ISO C modes (e.g. -std=c99) hide the POSIX clocks; there is no portable monotonic clock to fall back on. */
+#	error algoTimerWheelClockTicks() needs clock_gettime(CLOCK_MONOTONIC): define _POSIX_C_SOURCE=199309L or use a GNU C dialect
+#endif
+}
+
+AlgoError algoTimerWheelAdvanceToNow(AlgoTimerWheel wheel, AlgoTimerWheelCallback expiredFunc, void *userData)
+{
+	return algoTimerWheelAdvance(wheel, ALGO_CLOCK_TICKS(), expiredFunc, userData);
+}
+
+AlgoError algoTimerWheelGetCurrentTime(const AlgoTimerWheel wheel, uint64_t *outTime)
+{
+	if (NULL == wheel ||
+		NULL == outTime)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outTime = wheel->currentTime;
+	return kAlgoErrorNone;
+}
+
+AlgoError algoTimerWheelGetTimerContents(const AlgoTimerWheel wheel, const AlgoTimerWheelTimer timer,
+	uint64_t *outDeadline, AlgoData *outTimerData)
+{
+	if (NULL == wheel ||
+		NULL == timer ||
+		timer->slotIndex < 0)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	if (NULL != outDeadline)
+	{
+		*outDeadline = timer->deadline;
+	}
+	if (NULL != outTimerData)
+	{
+		*outTimerData = timer->data;
+	}
+	return kAlgoErrorNone;
+}
+
+AlgoError algoTimerWheelValidate(const AlgoTimerWheel wheel)
+{
+	int32_t iSlot, timerCount = 0;
+	if (NULL == wheel ||
+		NULL == wheel->timerPool)
+	{
+		return kAlgoErrorInvalidArgument; /* AlgoTimerWheel pointer(s) are NULL. */
+	}
+	if (wheel->currentSize < 0 ||
+		wheel->currentSize > wheel->capacity)
+	{
+		return kAlgoErrorInvalidArgument; /* AlgoTimerWheel size/capacity are invalid. */
+	}
+	for(iSlot=0; iSlot<kAlgoTimerWheelLevelCount*kAlgoTimerWheelSlotsPerLevel; ++iSlot)
+	{
+		const int level = iSlot / kAlgoTimerWheelSlotsPerLevel;
+		const uint64_t slotBit = 1ULL << (iSlot % kAlgoTimerWheelSlotsPerLevel);
+		AlgoTimerWheelTimerImpl *const *prevNext = &wheel->slots[iSlot];
+		if ((NULL != wheel->slots[iSlot]) != (0 != (wheel->occupiedSlots[level] & slotBit)))
+		{
+			return kAlgoErrorInvalidArgument; /* occupancy bit is out of sync with slot contents */
+		}
+		while(NULL != *prevNext)
+		{
+			const AlgoTimerWheelTimerImpl *timer = *prevNext;
+			const uint64_t effectiveDeadline = (timer->deadline > wheel->currentTime) ? timer->deadline : wheel->currentTime+1;
+			if (timer->prevNext != prevNext ||
+				timer->slotIndex != iSlot ||
+				iHighestBit64(effectiveDeadline ^ wheel->currentTime) / kAlgoTimerWheelSlotBits != level)
+			{
+				return kAlgoErrorInvalidArgument; /* timer is linked incorrectly, or is in the wrong level */
+			}
+			timerCount += 1;
+			prevNext = &timer->next;
+		}
+	}
+	if (timerCount != wheel->currentSize)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	return kAlgoErrorNone;
+}
+
+AlgoError algoTimerWheelGetCapacity(const AlgoTimerWheel wheel, int32_t *outCapacity)
+{
+	if (NULL == wheel ||
+		NULL == outCapacity)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outCapacity = wheel->capacity;
+	return kAlgoErrorNone;
+}
+
+AlgoError algoTimerWheelGetCurrentSize(const AlgoTimerWheel wheel, int32_t *outSize)
+{
+	if (NULL == wheel ||
+		NULL == outSize)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outSize = wheel->currentSize;
+	return kAlgoErrorNone;
+}
+
+/************************************************
+ * AlgoGraph
+ ************************************************/
+
+/* Each vertex's outgoing edges are stored in 64-byte blocks, rather than one list node per edge. Full blocks hold
+   kAlgoGraphEdgeBlockCapacity destination IDs each, and are chained through their link field. The remaining
+   ((degree-1) % kAlgoGraphEdgeBlockCapacity) + 1 edges live in the list's head block, which is only as large as it needs
+   to be: head blocks come in four size classes (up to 1, 3, 7 or 15 edges, in 8, 16, 32 or 64 bytes), and the three
+   smaller classes are packed together into shared pool elements ("slabs"), so low-degree vertices don't each pay for a
+   mostly-empty block. A head block's link holds the ID of the vertex that owns it, so that blocks can be moved when a
+   slab is compacted.
+   Blocks are addressed by slot: the index of their first 32-bit word in the edge pool, so block->destVertices[i] is in
+   slot+1+i. In graphs created with kAlgoGraphEdgeWeights, edge weights are kept in a separate array with one entry per
+   slot, so traversals that don't need them never load them. */
+#define kAlgoGraphEdgeBlockCapacity 15
+#define kAlgoGraphEdgeBlockSlotCount (kAlgoGraphEdgeBlockCapacity+1)
+#define kAlgoGraphEdgeSlabClassCount 3 /* head block size classes that are packed into slabs; the last class is a full-size block */
+typedef struct AlgoGraphEdgeBlock
+{
+	int32_t link; /* full blocks: slot of the next full block, or -1. Head blocks: ID of the list's vertex. */
+	int32_t destVertices[kAlgoGraphEdgeBlockCapacity];
+} AlgoGraphEdgeBlock;
+typedef struct AlgoGraphEdgeList
+{
+	int32_t headBlock; /* slot of the head block, or -1 if the list is empty */
+	int32_t fullBlocks; /* slot of the first full block, or -1 */
+} AlgoGraphEdgeList;
+/* Each set of edge lists has at most one partially-used slab per size class; the rest are either full or free. */
+typedef struct AlgoGraphEdgeSlab
+{
+	int32_t slot; /* first slot of the slab, or -1 if every slab of this class is full */
+	int32_t usedCount; /* number of head blocks in the slab. They are always packed at the front. */
+} AlgoGraphEdgeSlab;
+
+typedef struct AlgoGraphImpl
+{
+	const void *thisBuffer;
+	size_t thisBufferSize;
+	int32_t vertexCapacity;
+	int32_t edgeCapacity;
+	int32_t currentVertexCount; /* 0..vertexCapacity */
+	int32_t currentEdgeCount; /* 0..edgeCapacity */
+	int32_t nextFreeVertexId; /* Used to manage the unused vertex pool in vertexData[] */
+	AlgoGraphEdgeMode edgeMode;
+	int32_t *vertexDegrees; /* degree (outgoing edge count) per vertex. Unused/invalid vertices have a degree of -1. */
+	AlgoData *vertexData; /* Arbitrary per-vertex data. One element per vertex. Unused elements used as a free list of unused vertices. */
+	int32_t *validVertexIds; /* unsorted list of valid vertex IDs. The first currentVertexCount elements are valid; the rest are undefined. */
+	int32_t *vertexIdToValidIndex; /* reverse-lookup from vertexId into validVertexIds[], to keep removal reasonably efficient. */
+	AlgoGraphEdgeList *vertexEdges; /* One edge list per vertex. */
+	AlgoAllocPool edgePool; /* pool from which edge blocks and slabs are allocated. */
+	int32_t *edgeSlots; /* the edge pool's elements, viewed as an array of slots */
+	int32_t *edgeWeights; /* edgeWeights[slot] is the weight of the edge whose destination is edgeSlots[slot]. NULL if the graph is unweighted. */
+	AlgoGraphEdgeSlab edgeSlabs[2][kAlgoGraphEdgeSlabClassCount]; /* partially-used slabs of the outgoing/incoming lists */
+	struct AlgoGraphEdgeIndexEntry *edgeIndex; /* hash index of every edge node. NULL if the graph has no edge index. */
+	uint32_t edgeIndexMask; /* edge index capacity - 1. The capacity is a power of two. */
+	AlgoGraphEdgeIndexMode edgeIndexMode;
+	uint32_t graphFlags; /* AlgoGraphFlags passed at creation */
+	AlgoGraphEdgeList *vertexInEdges; /* One incoming edge list per vertex. NULL unless the graph has in-edge lists. */
+	int32_t *vertexInDegrees; /* in-degree per vertex. NULL unless the graph has in-edge lists. */
+} AlgoGraphImpl;
+
+/* The edge index is an open-addressing hash table with linear probing, which maps each (src,dest) edge node to its
+   location in src's edge list. It is kept at most half full, and removals shift later entries back into the gap
+   instead of leaving tombstones, so lookups never have to probe far. */
+typedef struct AlgoGraphEdgeIndexEntry
+{
+	int32_t srcVertexId; /* -1 for empty entries */
+	int32_t destVertexId;
+	int32_t slot; /* the edge's destination is stored in edgeSlots[slot] */
+} AlgoGraphEdgeIndexEntry;
+
+ALGO_INTERNAL ALGO_INLINE int iGraphIsValidVertexId(const AlgoGraph graph, int32_t vertexId)
+{
+	ALGO_ASSERT(NULL != graph);
+	return (
+		vertexId >= 0 &&
+		vertexId < graph->vertexCapacity &&
+		graph->vertexDegrees[vertexId] >= 0) ? 1 : 0;
+}
+
+/* Returns the number of edges in the first block of a vertex's edge list, given the vertex's degree. */
+ALGO_INTERNAL ALGO_INLINE int32_t iGraphHeadBlockEdgeCount(int32_t vertexDegree)
+{
+	return (vertexDegree > 0) ? ((vertexDegree-1) % kAlgoGraphEdgeBlockCapacity) + 1 : 0;
+}
+/* Returns the size class of a head block holding edgeCount edges. Class c holds up to (2<<c)-1 edges in 2<<c slots. */
+ALGO_INTERNAL ALGO_INLINE int32_t iGraphEdgeBlockClass(int32_t edgeCount)
+{
+	ALGO_ASSERT(edgeCount > 0 && edgeCount <= kAlgoGraphEdgeBlockCapacity);
+	int32_t blockClass = 0;
+	while((2<<blockClass)-1 < edgeCount)
+		++blockClass;
+	return blockClass;
+}
+/* Worst-case number of pool elements used by one set of edge lists. A list with d>0 edges uses 16*floor((d-1)/15) slots of
+   full blocks, plus a 2-, 4-, 8- or 16-slot head block. That is at most 2*d slots, and at most (16*d+112)/15 slots, so
+   the whole set fits in min(2*E, (16*E+112*V)/15) slots, plus one partially-used slab per size class. */
+ALGO_INTERNAL int64_t iGraphEdgeListSetPoolCapacity(int32_t vertexCapacity, int64_t edgeNodeCapacity)
+{
+	const int64_t slotsByDegree = 2*edgeNodeCapacity;
+	const int64_t slotsByBlocks = (16*edgeNodeCapacity + 112*(int64_t)vertexCapacity + 14) / 15;
+	const int64_t slotCount = (slotsByDegree < slotsByBlocks) ? slotsByDegree : slotsByBlocks;
+	return (slotCount + kAlgoGraphEdgeBlockSlotCount-1) / kAlgoGraphEdgeBlockSlotCount + kAlgoGraphEdgeSlabClassCount;
+}
+ALGO_INTERNAL ALGO_INLINE int iGraphHasInEdgeLists(const AlgoGraphEdgeMode edgeMode, uint32_t graphFlags)
+{
+	return (edgeMode == kAlgoGraphEdgeDirected && (graphFlags & kAlgoGraphInEdges)) ? 1 : 0;
+}
+/* Smallest power-of-two edge index capacity that keeps the index at most half full. */
+ALGO_INTERNAL uint32_t iGraphEdgeIndexCapacity(int32_t edgeNodeCapacity)
+{
+	uint32_t capacity = 2;
+	while(capacity < 2*(uint32_t)edgeNodeCapacity)
+		capacity *= 2;
+	return capacity;
+}
+ALGO_INTERNAL ALGO_INLINE uint32_t iGraphEdgeIndexHash(int32_t srcVertexId, int32_t destVertexId)
+{
+	/* Fibonacci hashing of the packed (src,dest) pair; the high bits are the best mixed. */
+	const uint64_t key = ((uint64_t)(uint32_t)srcVertexId << 32) | (uint32_t)destVertexId;
+	return (uint32_t)((key * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+/* Returns the index entry for the srcVertexId->destVertexId edge, or NULL if no such edge exists. */
+ALGO_INTERNAL AlgoGraphEdgeIndexEntry *iGraphEdgeIndexFind(const AlgoGraph graph, int32_t srcVertexId, int32_t destVertexId)
+{
+	uint32_t iEntry = iGraphEdgeIndexHash(srcVertexId, destVertexId) & graph->edgeIndexMask;
+	for(;;)
+	{
+		AlgoGraphEdgeIndexEntry *entry = graph->edgeIndex + iEntry;
+		if (entry->srcVertexId < 0)
+			return NULL;
+		if (entry->srcVertexId == srcVertexId && entry->destVertexId == destVertexId)
+			return entry;
+		iEntry = (iEntry+1) & graph->edgeIndexMask;
+	}
+}
+ALGO_INTERNAL void iGraphEdgeIndexInsert(AlgoGraph graph, int32_t srcVertexId, int32_t destVertexId, int32_t slot)
+{
+	uint32_t iEntry = iGraphEdgeIndexHash(srcVertexId, destVertexId) & graph->edgeIndexMask;
+	while(graph->edgeIndex[iEntry].srcVertexId >= 0)
+	{
+		ALGO_ASSERT(graph->edgeIndex[iEntry].srcVertexId != srcVertexId || graph->edgeIndex[iEntry].destVertexId != destVertexId);
+		iEntry = (iEntry+1) & graph->edgeIndexMask;
+	}
+	graph->edgeIndex[iEntry].srcVertexId  = srcVertexId;
+	graph->edgeIndex[iEntry].destVertexId = destVertexId;
+	graph->edgeIndex[iEntry].slot         = slot;
+}
+ALGO_INTERNAL void iGraphEdgeIndexRemove(AlgoGraph graph, AlgoGraphEdgeIndexEntry *entry)
+{
+	/* Backward-shift deletion: move later entries in the same probe run into the gap, unless their home slot lies
+	   cyclically in (gap, entry]. */
+	uint32_t iGap = (uint32_t)(entry - graph->edgeIndex);
+	uint32_t iEntry = iGap;
+	for(;;)
+	{
+		iEntry = (iEntry+1) & graph->edgeIndexMask;
+		const AlgoGraphEdgeIndexEntry *next = graph->edgeIndex + iEntry;
+		if (next->srcVertexId < 0)
+			break;
+		const uint32_t iHome = iGraphEdgeIndexHash(next->srcVertexId, next->destVertexId) & graph->edgeIndexMask;
+		if ((iGap <= iEntry) ? (iGap < iHome && iHome <= iEntry) : (iGap < iHome || iHome <= iEntry))
+			continue;
+		graph->edgeIndex[iGap] = *next;
+		iGap = iEntry;
+	}
+	graph->edgeIndex[iGap].srcVertexId = -1;
+}
+ALGO_INTERNAL void iGraphEdgeIndexClear(AlgoGraph graph)
+{
+	for(uint32_t iEntry=0; iEntry<=graph->edgeIndexMask; ++iEntry)
+	{
+		graph->edgeIndex[iEntry].srcVertexId = -1;
+	}
+}
+/* Each vertex may have two edge lists: its outgoing edges (vertexEdges[]/vertexDegrees[]), and in directed graphs with
+   kAlgoGraphInEdges, its incoming edges (vertexInEdges[]/vertexInDegrees[]). The list helpers below work on either; in
+   incoming lists, destVertices[] holds the source vertex of each edge. Incoming entries are keyed in the hash index as
+   (destVertexId, srcVertexId | kAlgoGraphInEdgeIndexKeyFlag), so they never collide with outgoing ones. */
+#define kAlgoGraphInEdgeIndexKeyFlag INT32_MIN
+ALGO_INTERNAL ALGO_INLINE AlgoGraphEdgeList *iGraphEdgeLists(const AlgoGraph graph, int isInList)
+{
+	return isInList ? graph->vertexInEdges : graph->vertexEdges;
+}
+ALGO_INTERNAL ALGO_INLINE int32_t *iGraphEdgeListDegrees(const AlgoGraph graph, int isInList)
+{
+	return isInList ? graph->vertexInDegrees : graph->vertexDegrees;
+}
+ALGO_INTERNAL ALGO_INLINE int32_t iGraphEdgeIndexKey(int32_t otherVertexId, int isInList)
+{
+	return isInList ? (otherVertexId | kAlgoGraphInEdgeIndexKeyFlag) : otherVertexId;
+}
+ALGO_INTERNAL ALGO_INLINE AlgoGraphEdgeBlock *iGraphEdgeBlockAt(const AlgoGraph graph, int32_t slot)
+{
+	return (slot >= 0) ? (AlgoGraphEdgeBlock*)(graph->edgeSlots + slot) : NULL;
+}
+ALGO_INTERNAL ALGO_INLINE int32_t iGraphEdgeBlockSlot(const AlgoGraph graph, const AlgoGraphEdgeBlock *block)
+{
+	return (int32_t)((const int32_t*)block - graph->edgeSlots);
+}
+/* Returns the weights of a block's edges; weights[i] is the weight of the edge to block->destVertices[i]. Returns NULL if
+   the graph is unweighted, in which case every weight is 1. */
+ALGO_INTERNAL ALGO_INLINE int32_t *iGraphEdgeBlockWeights(const AlgoGraph graph, const AlgoGraphEdgeBlock *block)
+{
+	return (NULL != graph->edgeWeights) ? graph->edgeWeights + (block->destVertices - graph->edgeSlots) : NULL;
+}
+/* Returns the weight of the edge stored in a slot. */
+ALGO_INTERNAL ALGO_INLINE int32_t iGraphEdgeSlotWeight(const AlgoGraph graph, int32_t slot)
+{
+	return (NULL != graph->edgeWeights) ? graph->edgeWeights[slot] : 1;
+}
+/* A list is traversed starting with its head block, followed by its chain of full blocks. */
+ALGO_INTERNAL ALGO_INLINE AlgoGraphEdgeBlock *iGraphEdgeListHead(const AlgoGraph graph, const AlgoGraphEdgeList *list)
+{
+	return iGraphEdgeBlockAt(graph, list->headBlock);
+}
+ALGO_INTERNAL ALGO_INLINE AlgoGraphEdgeBlock *iGraphNextEdgeBlock(const AlgoGraph graph, const AlgoGraphEdgeList *list,
+	const AlgoGraphEdgeBlock *block)
+{
+	return iGraphEdgeBlockAt(graph, (iGraphEdgeBlockSlot(graph, block) == list->headBlock) ? list->fullBlocks : block->link);
+}
+/* Returns the slot holding otherVertexId in one of listVertexId's edge lists, or -1 if there is no such entry. */
+ALGO_INTERNAL int32_t iGraphFindListEdgeSlot(const AlgoGraph graph, int isInList, int32_t listVertexId, int32_t otherVertexId)
+{
+	if (NULL != graph->edgeIndex)
+	{
+		const AlgoGraphEdgeIndexEntry *entry = iGraphEdgeIndexFind(graph, listVertexId, iGraphEdgeIndexKey(otherVertexId, isInList));
+		return (NULL != entry) ? entry->slot : -1;
+	}
+	const AlgoGraphEdgeList *list = iGraphEdgeLists(graph, isInList) + listVertexId;
+	const AlgoGraphEdgeBlock *block = iGraphEdgeListHead(graph, list);
+	int32_t blockEdgeCount = iGraphHeadBlockEdgeCount(iGraphEdgeListDegrees(graph, isInList)[listVertexId]);
+	for(; NULL != block; block = iGraphNextEdgeBlock(graph, list, block), blockEdgeCount = kAlgoGraphEdgeBlockCapacity)
+	{
+		int32_t iEdge;
+		for(iEdge=0; iEdge<blockEdgeCount; ++iEdge)
+		{
+			if (block->destVertices[iEdge] == otherVertexId)
+				return iGraphEdgeBlockSlot(graph, block) + 1 + iEdge;
+		}
+	}
+	return -1;
+}
+/* Returns the slot holding the srcVertexId->destVertexId edge, or -1 if no such edge exists. */
+ALGO_INTERNAL ALGO_INLINE int32_t iGraphFindEdgeSlot(const AlgoGraph graph, int32_t srcVertexId, int32_t destVertexId)
+{
+	return iGraphFindListEdgeSlot(graph, 0, srcVertexId, destVertexId);
+}
+/* Stores an edge of listVertexId's list in a free slot, and indexes it. */
+ALGO_INTERNAL ALGO_INLINE void iGraphSetListEdge(AlgoGraph graph, int isInList, int32_t listVertexId, int32_t slot,
+	int32_t otherVertexId, int32_t weight)
+{
+	graph->edgeSlots[slot] = otherVertexId;
+	if (NULL != graph->edgeWeights)
+		graph->edgeWeights[slot] = weight;
+	if (NULL != graph->edgeIndex)
+		iGraphEdgeIndexInsert(graph, listVertexId, iGraphEdgeIndexKey(otherVertexId, isInList), slot);
+}
+/* Moves edgeCount edges of listVertexId's list from one range of slots to another, along with their weights and index
+   entries. */
+ALGO_INTERNAL void iGraphMoveListEdges(AlgoGraph graph, int isInList, int32_t listVertexId, int32_t fromSlot, int32_t toSlot,
+	int32_t edgeCount)
+{
+	int32_t iEdge;
+	for(iEdge=0; iEdge<edgeCount; ++iEdge)
+	{
+		const int32_t otherVertexId = graph->edgeSlots[fromSlot+iEdge];
+		graph->edgeSlots[toSlot+iEdge] = otherVertexId;
+		if (NULL != graph->edgeWeights)
+			graph->edgeWeights[toSlot+iEdge] = graph->edgeWeights[fromSlot+iEdge];
+		if (NULL != graph->edgeIndex)
+		{
+			AlgoGraphEdgeIndexEntry *entry = iGraphEdgeIndexFind(graph, listVertexId, iGraphEdgeIndexKey(otherVertexId, isInList));
+			ALGO_ASSERT(NULL != entry);
+			entry->slot = toSlot+iEdge;
+		}
+	}
+}
+/* Allocates a block of the given size class for one of a set of edge lists, and returns its slot, or -1 if the edge pool
+   is exhausted. Full-size blocks are whole pool elements; smaller head blocks are handed out in order from their class's
+   partially-used slab, and a new slab is started when there isn't one. */
+ALGO_INTERNAL int32_t iGraphAllocEdgeBlock(AlgoGraph graph, int isInList, int32_t blockClass)
+{
+	void *element = NULL;
+	if (kAlgoGraphEdgeSlabClassCount == blockClass)
+	{
+		if (kAlgoErrorNone != algoAllocPoolAlloc(graph->edgePool, &element))
+			return -1;
+		return (int32_t)((int32_t*)element - graph->edgeSlots);
+	}
+	const int32_t blockSlotCount = 2<<blockClass;
+	AlgoGraphEdgeSlab *slab = graph->edgeSlabs[isInList] + blockClass;
+	if (slab->slot < 0)
+	{
+		if (kAlgoErrorNone != algoAllocPoolAlloc(graph->edgePool, &element))
+			return -1;
+		slab->slot = (int32_t)((int32_t*)element - graph->edgeSlots);
+		slab->usedCount = 0;
+	}
+	const int32_t slot = slab->slot + slab->usedCount*blockSlotCount;
+	slab->usedCount += 1;
+	if (slab->usedCount == kAlgoGraphEdgeBlockSlotCount / blockSlotCount)
+		slab->slot = -1; /* slab is full */
+	return slot;
+}
+/* Returns a block to the edge pool. A freed head block is replaced by the last head block in its class's partially-used
+   slab, so every slab stays packed; a slab is returned to the pool once it empties. */
+ALGO_INTERNAL void iGraphFreeEdgeBlock(AlgoGraph graph, int isInList, int32_t slot, int32_t blockClass)
+{
+	if (kAlgoGraphEdgeSlabClassCount == blockClass)
+	{
+		algoAllocPoolFree(graph->edgePool, graph->edgeSlots + slot);
+		return;
+	}
+	const int32_t blockSlotCount = 2<<blockClass;
+	AlgoGraphEdgeSlab *slab = graph->edgeSlabs[isInList] + blockClass;
+	if (slab->slot < 0)
+	{
+		/* Every slab of this class is full, so the freed block's own slab becomes the partially-used one. */
+		slab->slot = slot & ~(kAlgoGraphEdgeBlockSlotCount-1);
+		slab->usedCount = kAlgoGraphEdgeBlockSlotCount / blockSlotCount;
+	}
+	slab->usedCount -= 1;
+	const int32_t lastSlot = slab->slot + slab->usedCount*blockSlotCount;
+	if (lastSlot != slot)
+	{
+		const int32_t ownerVertexId = iGraphEdgeBlockAt(graph, lastSlot)->link;
+		const int32_t ownerEdgeCount = iGraphHeadBlockEdgeCount(iGraphEdgeListDegrees(graph, isInList)[ownerVertexId]);
+		ALGO_ASSERT(iGraphEdgeLists(graph, isInList)[ownerVertexId].headBlock == lastSlot);
+		iGraphEdgeBlockAt(graph, slot)->link = ownerVertexId;
+		iGraphMoveListEdges(graph, isInList, ownerVertexId, lastSlot+1, slot+1, ownerEdgeCount);
+		iGraphEdgeLists(graph, isInList)[ownerVertexId].headBlock = slot;
+	}
+	if (0 == slab->usedCount)
+	{
+		algoAllocPoolFree(graph->edgePool, graph->edgeSlots + slab->slot);
+		slab->slot = -1;
+	}
+}
+/* Moves a list's head block to the size class for newEdgeCount edges, keeping its first min(oldEdgeCount,newEdgeCount)
+   edges. Returns 0 if the edge pool is exhausted. */
+ALGO_INTERNAL int iGraphResizeHeadBlock(AlgoGraph graph, int isInList, int32_t listVertexId, int32_t oldEdgeCount,
+	int32_t newEdgeCount)
+{
+	const int32_t oldClass = iGraphEdgeBlockClass(oldEdgeCount);
+	const int32_t newClass = iGraphEdgeBlockClass(newEdgeCount);
+	if (oldClass == newClass)
+		return 1;
+	const int32_t newSlot = iGraphAllocEdgeBlock(graph, isInList, newClass);
+	if (newSlot < 0)
+		return 0;
+	AlgoGraphEdgeList *list = iGraphEdgeLists(graph, isInList) + listVertexId;
+	const int32_t oldSlot = list->headBlock;
+	iGraphEdgeBlockAt(graph, newSlot)->link = listVertexId;
+	iGraphMoveListEdges(graph, isInList, listVertexId, oldSlot+1, newSlot+1,
+		(oldEdgeCount < newEdgeCount) ? oldEdgeCount : newEdgeCount);
+	list->headBlock = newSlot;
+	iGraphFreeEdgeBlock(graph, isInList, oldSlot, oldClass);
+	return 1;
+}
+ALGO_INTERNAL int iGraphAddEdgeToList(AlgoGraph graph, int isInList, int32_t listVertexId, int32_t otherVertexId, int32_t weight)
+{
+	/*  This function ONLY appends a single edge, and increments the list's degree.
+		Returns 0 if the edge block pool is exhausted. */
+	AlgoGraphEdgeList *list = iGraphEdgeLists(graph, isInList) + listVertexId;
+	int32_t *degrees = iGraphEdgeListDegrees(graph, isInList);
+	const int32_t headEdgeCount = iGraphHeadBlockEdgeCount(degrees[listVertexId]);
+	if (0 == headEdgeCount ||
+		kAlgoGraphEdgeBlockCapacity == headEdgeCount)
+	{
+		/* Start a new head block. A full head block joins the chain of full blocks. */
+		const int32_t newSlot = iGraphAllocEdgeBlock(graph, isInList, 0);
+		if (newSlot < 0)
+			return 0;
+		if (headEdgeCount > 0)
+		{
+			iGraphEdgeBlockAt(graph, list->headBlock)->link = list->fullBlocks;
+			list->fullBlocks = list->headBlock;
+		}
+		iGraphEdgeBlockAt(graph, newSlot)->link = listVertexId;
+		list->headBlock = newSlot;
+	}
+	else if (!iGraphResizeHeadBlock(graph, isInList, listVertexId, headEdgeCount, headEdgeCount+1))
+	{
+		return 0;
+	}
+	iGraphSetListEdge(graph, isInList, listVertexId, list->headBlock + 1 + (headEdgeCount % kAlgoGraphEdgeBlockCapacity),
+		otherVertexId, weight);
+	degrees[listVertexId] += 1;
+	return 1;
+}
+/* Appends edgeCount edges to a vertex's edge list, which is faster than adding them one at a time. The head block is
+   filled (and resized) first; the rest of the edges go into newly-allocated full blocks and, if needed, a new head block.
+   If weights is NULL, every new edge has a weight of 1. Increments the list's degree, but not the graph's edge count. */
+ALGO_INTERNAL void iGraphAppendEdgesToList(AlgoGraph graph, int isInList, int32_t listVertexId, const int32_t otherVertexIds[],
+	const int32_t weights[], int32_t edgeCount)
+{
+	AlgoGraphEdgeList *list = iGraphEdgeLists(graph, isInList) + listVertexId;
+	int32_t *degrees = iGraphEdgeListDegrees(graph, isInList);
+	int32_t headEdgeCount = iGraphHeadBlockEdgeCount(degrees[listVertexId]);
+	int32_t iEdge = 0;
+	/* The edge block pool is sized for the worst case, so these allocations can't fail while under edgeCapacity. */
+	if (headEdgeCount > 0 && headEdgeCount < kAlgoGraphEdgeBlockCapacity)
+	{
+		const int32_t fillCount = (edgeCount < kAlgoGraphEdgeBlockCapacity - headEdgeCount)
+			? edgeCount : kAlgoGraphEdgeBlockCapacity - headEdgeCount;
+		int resized = iGraphResizeHeadBlock(graph, isInList, listVertexId, headEdgeCount, headEdgeCount+fillCount);
+		ALGO_ASSERT(resized);
+		ALGO_UNUSED(resized);
+		for(; iEdge<fillCount; ++iEdge, ++headEdgeCount)
+		{
+			iGraphSetListEdge(graph, isInList, listVertexId, list->headBlock + 1 + headEdgeCount, otherVertexIds[iEdge],
+				(NULL != weights) ? weights[iEdge] : 1);
+		}
+	}
+	if (iEdge < edgeCount)
+	{
+		if (headEdgeCount > 0)
+		{
+			iGraphEdgeBlockAt(graph, list->headBlock)->link = list->fullBlocks;
+			list->fullBlocks = list->headBlock;
+		}
+		const int32_t newHeadEdgeCount = iGraphHeadBlockEdgeCount(edgeCount-iEdge);
+		while(iEdge < edgeCount)
+		{
+			const int isHead = (edgeCount-iEdge == newHeadEdgeCount);
+			const int32_t blockEdgeCount = isHead ? newHeadEdgeCount : kAlgoGraphEdgeBlockCapacity;
+			const int32_t slot = iGraphAllocEdgeBlock(graph, isInList, iGraphEdgeBlockClass(blockEdgeCount));
+			ALGO_ASSERT(slot >= 0);
+			if (isHead)
+			{
+				iGraphEdgeBlockAt(graph, slot)->link = listVertexId;
+				list->headBlock = slot;
+			}
+			else
+			{
+				iGraphEdgeBlockAt(graph, slot)->link = list->fullBlocks;
+				list->fullBlocks = slot;
+			}
+			for(int32_t iBlockEdge=0; iBlockEdge<blockEdgeCount; ++iBlockEdge, ++iEdge)
+			{
+				iGraphSetListEdge(graph, isInList, listVertexId, slot + 1 + iBlockEdge, otherVertexIds[iEdge],
+					(NULL != weights) ? weights[iEdge] : 1);
+			}
+		}
+	}
+	degrees[listVertexId] += edgeCount;
+}
+ALGO_INTERNAL int iGraphRemoveEdgeFromList(AlgoGraph graph, int isInList, int32_t listVertexId, int32_t otherVertexId)
+{
+	/*  This function ONLY finds and removes a single edge, and decrements the list's degree.
+		The following are the responsibility of the caller, where applicable:
+		- decrement the graph's edge count.
+		- remove matching dest->src edge for undirected graphs.
+		- remove the matching entry in the other list, for graphs with in-edge lists.
+		The removed edge is replaced by the last edge in the list's head block, so the list stays packed.
+		*/
+	AlgoGraphEdgeList *list = iGraphEdgeLists(graph, isInList) + listVertexId;
+	int32_t *degrees = iGraphEdgeListDegrees(graph, isInList);
+	int32_t edgeSlot = -1;
+	if (NULL != graph->edgeIndex)
+	{
+		AlgoGraphEdgeIndexEntry *entry = iGraphEdgeIndexFind(graph, listVertexId, iGraphEdgeIndexKey(otherVertexId, isInList));
+		if (NULL == entry)
+			return 0; /* no such edge */
+		edgeSlot = entry->slot;
+		iGraphEdgeIndexRemove(graph, entry);
+	}
+	else
+	{
+		edgeSlot = iGraphFindListEdgeSlot(graph, isInList, listVertexId, otherVertexId);
+		if (edgeSlot < 0)
+			return 0; /* no such edge */
+	}
+	const int32_t headEdgeCount = iGraphHeadBlockEdgeCount(degrees[listVertexId]);
+	const int32_t lastSlot = list->headBlock + headEdgeCount;
+	if (edgeSlot != lastSlot)
+		iGraphMoveListEdges(graph, isInList, listVertexId, lastSlot, edgeSlot, 1);
+	if (1 == headEdgeCount)
+	{
+		/* The head block is empty; the first full block (if any) becomes the new head. */
+		iGraphFreeEdgeBlock(graph, isInList, list->headBlock, 0);
+		list->headBlock = list->fullBlocks;
+		if (list->fullBlocks >= 0)
+		{
+			AlgoGraphEdgeBlock *newHead = iGraphEdgeBlockAt(graph, list->fullBlocks);
+			list->fullBlocks = newHead->link;
+			newHead->link = listVertexId;
+		}
+	}
+	else
+	{
+		/* The edge block pool has room for one extra block while a head block is resized, so this can't fail. */
+		int resized = iGraphResizeHeadBlock(graph, isInList, listVertexId, headEdgeCount, headEdgeCount-1);
+		ALGO_ASSERT(resized);
+		ALGO_UNUSED(resized);
+	}
+	degrees[listVertexId] -= 1;
+	return 1;
+}
+/* Returns every block in a vertex's edge list to the pool, and resets the list's degree to zero. */
+ALGO_INTERNAL void iGraphFreeEdgeList(AlgoGraph graph, int isInList, int32_t vertexId)
+{
+	AlgoGraphEdgeList *list = iGraphEdgeLists(graph, isInList) + vertexId;
+	int32_t *degrees = iGraphEdgeListDegrees(graph, isInList);
+	const int32_t headEdgeCount = iGraphHeadBlockEdgeCount(degrees[vertexId]);
+	if (NULL != graph->edgeIndex)
+	{
+		const AlgoGraphEdgeBlock *block = iGraphEdgeListHead(graph, list);
+		int32_t blockEdgeCount = headEdgeCount;
+		for(; NULL != block; block = iGraphNextEdgeBlock(graph, list, block), blockEdgeCount = kAlgoGraphEdgeBlockCapacity)
+		{
+			int32_t iEdge;
+			for(iEdge=0; iEdge<blockEdgeCount; ++iEdge)
+			{
+				AlgoGraphEdgeIndexEntry *entry = iGraphEdgeIndexFind(graph, vertexId, iGraphEdgeIndexKey(block->destVertices[iEdge], isInList));
+				ALGO_ASSERT(NULL != entry);
+				iGraphEdgeIndexRemove(graph, entry);
+			}
+		}
+	}
+	while(list->fullBlocks >= 0)
+	{
+		AlgoGraphEdgeBlock *block = iGraphEdgeBlockAt(graph, list->fullBlocks);
+		list->fullBlocks = block->link;
+		algoAllocPoolFree(graph->edgePool, block);
+	}
+	if (list->headBlock >= 0)
+		iGraphFreeEdgeBlock(graph, isInList, list->headBlock, iGraphEdgeBlockClass(headEdgeCount));
+	list->headBlock = -1;
+	degrees[vertexId] = 0;
+}
+/* Worst-case number of elements in a graph's edge pool, or -1 if the pool would be too large. Graphs with in-edge lists
+   need a second set of lists. One more element leaves room for a head block being resized, whose old and new blocks
+   briefly coexist. */
+ALGO_INTERNAL int32_t iGraphEdgePoolCapacity(int32_t vertexCapacity, int32_t edgeCapacity, const AlgoGraphEdgeMode edgeMode,
+	uint32_t graphFlags)
+{
+	const int64_t nodesPerEdge = (edgeMode == kAlgoGraphEdgeDirected) ? 1 : 2; /* undirected edges store two nodes: x->y and y->x */
+	int64_t elementCount = iGraphEdgeListSetPoolCapacity(vertexCapacity, edgeCapacity*nodesPerEdge) + 1;
+	if (iGraphHasInEdgeLists(edgeMode, graphFlags))
+		elementCount += iGraphEdgeListSetPoolCapacity(vertexCapacity, edgeCapacity);
+	return (elementCount <= INT32_MAX / (int64_t)sizeof(AlgoGraphEdgeBlock)) ? (int32_t)elementCount : -1;
+}
+
+AlgoError algoGraphComputeBufferSize(size_t *outBufferSize, int32_t vertexCapacity, int32_t edgeCapacity,
+	const AlgoGraphEdgeMode edgeMode)
+{
+	return algoGraphComputeBufferSizeWithEdgeIndex(outBufferSize, vertexCapacity, edgeCapacity, edgeMode, kAlgoGraphEdgeIndexNone);
+}
+AlgoError algoGraphComputeBufferSizeWithEdgeIndex(size_t *outBufferSize, int32_t vertexCapacity, int32_t edgeCapacity,
+	const AlgoGraphEdgeMode edgeMode, const AlgoGraphEdgeIndexMode indexMode)
+{
+	return algoGraphComputeBufferSizeWithFlags(outBufferSize, vertexCapacity, edgeCapacity, edgeMode, indexMode, kAlgoGraphDefault);
+}
+AlgoError algoGraphComputeBufferSizeWithFlags(size_t *outBufferSize, int32_t vertexCapacity, int32_t edgeCapacity,
+	const AlgoGraphEdgeMode edgeMode, const AlgoGraphEdgeIndexMode indexMode, uint32_t graphFlags)
+{
+	AlgoError err;
+	const size_t vertexDegreesSize        = vertexCapacity * sizeof(int32_t);
+	const size_t vertexDataSize           = vertexCapacity * sizeof(AlgoData);
+	const size_t validVertexIdsSize       = vertexCapacity * sizeof(int32_t);
+	const size_t vertexIdToValidIndexSize = vertexCapacity * sizeof(int32_t);
+	const size_t vertexEdgesSize          = vertexCapacity * sizeof(AlgoGraphEdgeList); /* one edge list per vertex */
+	const int32_t nodesPerEdge = (edgeMode == kAlgoGraphEdgeDirected) ? 1 : 2; /* undirected edges store two nodes: x->y and y->x */
+	size_t edgePoolSize = 0;
+	if (NULL == outBufferSize ||
+		vertexCapacity < 0 ||
+		edgeCapacity < 0 ||
+		indexMode < kAlgoGraphEdgeIndexNone ||
+		indexMode > kAlgoGraphEdgeIndexRejectDuplicates ||
+		0 != (graphFlags & ~(uint32_t)(kAlgoGraphInEdges | kAlgoGraphEdgeWeights)))
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	const int32_t listSetCount = iGraphHasInEdgeLists(edgeMode, graphFlags) ? 2 : 1;
+	const size_t edgeIndexSize = (kAlgoGraphEdgeIndexNone == indexMode) ? 0
+		: iGraphEdgeIndexCapacity(edgeCapacity*nodesPerEdge*listSetCount) * sizeof(AlgoGraphEdgeIndexEntry);
+	const size_t vertexInEdgesSize   = (listSetCount > 1) ? vertexCapacity * sizeof(AlgoGraphEdgeList) : 0;
+	const size_t vertexInDegreesSize = (listSetCount > 1) ? vertexCapacity * sizeof(int32_t) : 0;
+	const int32_t edgePoolCapacity = iGraphEdgePoolCapacity(vertexCapacity, edgeCapacity, edgeMode, graphFlags);
+	if (edgePoolCapacity < 0)
+	{
+		return kAlgoErrorInvalidArgument; /* too many edges */
+	}
+	err = algoAllocPoolComputeBufferSize(&edgePoolSize, sizeof(AlgoGraphEdgeBlock), edgePoolCapacity);
+	if (err != kAlgoErrorNone)
+	{
+		return err;
+	}
+	const size_t edgeWeightsSize = (graphFlags & kAlgoGraphEdgeWeights)
+		? (size_t)edgePoolCapacity * kAlgoGraphEdgeBlockSlotCount * sizeof(int32_t) : 0;
+	*outBufferSize = sizeof(AlgoGraphImpl) + edgeIndexSize + vertexDegreesSize + vertexDataSize + validVertexIdsSize
+		+ vertexIdToValidIndexSize + vertexEdgesSize + vertexInEdgesSize + vertexInDegreesSize + edgePoolSize + edgeWeightsSize;
+	return kAlgoErrorNone;
+}
+
+AlgoError algoGraphCreate(AlgoGraph *outGraph, int32_t vertexCapacity, int32_t edgeCapacity,
+	const AlgoGraphEdgeMode edgeMode, void *buffer, size_t bufferSize)
+{
+	return algoGraphCreateWithEdgeIndex(outGraph, vertexCapacity, edgeCapacity, edgeMode, kAlgoGraphEdgeIndexNone,
+		buffer, bufferSize);
+}
+AlgoError algoGraphCreateWithEdgeIndex(AlgoGraph *outGraph, int32_t vertexCapacity, int32_t edgeCapacity,
+	const AlgoGraphEdgeMode edgeMode, const AlgoGraphEdgeIndexMode indexMode, void *buffer, size_t bufferSize)
+{
+	return algoGraphCreateWithFlags(outGraph, vertexCapacity, edgeCapacity, edgeMode, indexMode, kAlgoGraphDefault,
+		buffer, bufferSize);
+}
+AlgoError algoGraphCreateWithFlags(AlgoGraph *outGraph, int32_t vertexCapacity, int32_t edgeCapacity,
+	const AlgoGraphEdgeMode edgeMode, const AlgoGraphEdgeIndexMode indexMode, uint32_t graphFlags, void *buffer, size_t bufferSize)
+{
+	size_t minBufferSize = 0;
+	AlgoError err;
+	if (NULL == outGraph ||
+		vertexCapacity <= 0 ||
+		edgeCapacity <= 0)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	err = algoGraphComputeBufferSizeWithFlags(&minBufferSize, vertexCapacity, edgeCapacity, edgeMode, indexMode, graphFlags);
+	if (err != kAlgoErrorNone)
+	{
+		return err;
+	}
+	if (NULL == buffer ||
+		bufferSize < minBufferSize)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+
+	uint8_t *bufferNext = (uint8_t*)buffer;
+	*outGraph = (AlgoGraphImpl*)bufferNext;
+	bufferNext += sizeof(AlgoGraphImpl);
+
+	const int32_t nodesPerEdge = (edgeMode == kAlgoGraphEdgeDirected) ? 1 : 2; /* undirected edges store two nodes: x->y and y->x */
+	const int32_t listSetCount = iGraphHasInEdgeLists(edgeMode, graphFlags) ? 2 : 1;
+	(*outGraph)->edgeIndex = NULL;
+	(*outGraph)->edgeIndexMask = 0;
+	if (kAlgoGraphEdgeIndexNone != indexMode)
+	{
+		const uint32_t edgeIndexCapacity = iGraphEdgeIndexCapacity(edgeCapacity*nodesPerEdge*listSetCount);
+		(*outGraph)->edgeIndex = (AlgoGraphEdgeIndexEntry*)bufferNext;
+		(*outGraph)->edgeIndexMask = edgeIndexCapacity-1;
+		iGraphEdgeIndexClear(*outGraph);
+		bufferNext += edgeIndexCapacity * sizeof(AlgoGraphEdgeIndexEntry);
+	}
+
+	/* The pool and the AlgoData array come first so that they stay 8-byte aligned; the int32_t arrays follow. */
+	size_t edgePoolSize = 0;
+	const int32_t edgePoolCapacity = iGraphEdgePoolCapacity(vertexCapacity, edgeCapacity, edgeMode, graphFlags);
+	err = algoAllocPoolComputeBufferSize(&edgePoolSize, sizeof(AlgoGraphEdgeBlock), edgePoolCapacity);
+	if (err != kAlgoErrorNone)
+	{
+		return err;
+	}
+	err = algoAllocPoolCreate(&((*outGraph)->edgePool), sizeof(AlgoGraphEdgeBlock), edgePoolCapacity, bufferNext, edgePoolSize);
+	if (err != kAlgoErrorNone)
+	{
+		return err;
+	}
+	(*outGraph)->edgeSlots = (int32_t*)(*outGraph)->edgePool->pool;
+	bufferNext += edgePoolSize;
+
+	(*outGraph)->edgeWeights = NULL;
+	if (graphFlags & kAlgoGraphEdgeWeights)
+	{
+		(*outGraph)->edgeWeights = (int32_t*)bufferNext;
+		bufferNext += (size_t)edgePoolCapacity * kAlgoGraphEdgeBlockSlotCount * sizeof(int32_t);
+	}
+	for(int32_t isInList=0; isInList<2; ++isInList)
+	{
+		for(int32_t blockClass=0; blockClass<kAlgoGraphEdgeSlabClassCount; ++blockClass)
+		{
+			(*outGraph)->edgeSlabs[isInList][blockClass].slot = -1;
+			(*outGraph)->edgeSlabs[isInList][blockClass].usedCount = 0;
+		}
+	}
+
+	const size_t vertexDataSize = vertexCapacity * sizeof(AlgoData);
+	(*outGraph)->vertexData = (AlgoData*)bufferNext;
+	{
+		int32_t iVert;
+		for(iVert=0; iVert<vertexCapacity-1; iVert += 1)
+		{
+			(*outGraph)->vertexData[iVert].asInt = iVert+1; /* store linked list of available vertices in the data fields */
+		}
+		(*outGraph)->vertexData[vertexCapacity-1].asInt = -1;
+	}
+	bufferNext += vertexDataSize;
+
+	const size_t vertexDegreeSize = vertexCapacity * sizeof(int32_t);
+	(*outGraph)->vertexDegrees = (int32_t*)bufferNext;
+	{
+		int32_t iVert;
+		for(iVert=0; iVert<vertexCapacity; iVert += 1)
+		{
+			(*outGraph)->vertexDegrees[iVert] = -1;
+		}
+	}
+	bufferNext += vertexDegreeSize;
+
+	const size_t validVertexIdsSize = vertexCapacity * sizeof(int32_t);
+	(*outGraph)->validVertexIds = (int32_t*)bufferNext;
+	bufferNext += validVertexIdsSize;
+
+	const size_t vertexIdToValidIndexSize = vertexCapacity * sizeof(int32_t);
+	(*outGraph)->vertexIdToValidIndex = (int32_t*)bufferNext;
+	bufferNext += vertexIdToValidIndexSize;
+
+	const size_t vertexEdgesSize = vertexCapacity*sizeof(AlgoGraphEdgeList); /* one edge list per vertex */
+	(*outGraph)->vertexEdges = (AlgoGraphEdgeList*)bufferNext;
+	{
+		int32_t iVert;
+		for(iVert=0; iVert<vertexCapacity; iVert += 1)
+		{
+			(*outGraph)->vertexEdges[iVert].headBlock  = -1;
+			(*outGraph)->vertexEdges[iVert].fullBlocks = -1;
+		}
+	}
+	bufferNext += vertexEdgesSize;
+
+	(*outGraph)->vertexInEdges = NULL;
+	(*outGraph)->vertexInDegrees = NULL;
+	if (listSetCount > 1)
+	{
+		(*outGraph)->vertexInEdges = (AlgoGraphEdgeList*)bufferNext;
+		bufferNext += vertexCapacity * sizeof(AlgoGraphEdgeList);
+		(*outGraph)->vertexInDegrees = (int32_t*)bufferNext;
+		bufferNext += vertexCapacity * sizeof(int32_t);
+		for(int32_t iVert=0; iVert<vertexCapacity; iVert += 1)
+		{
+			(*outGraph)->vertexInEdges[iVert].headBlock  = -1;
+			(*outGraph)->vertexInEdges[iVert].fullBlocks = -1;
+			(*outGraph)->vertexInDegrees[iVert] = 0;
+		}
+	}
+
+
+	ALGO_ASSERT( bufferNext-minBufferSize == buffer ); /* If this fails, algoGraphComputeBufferSizeWithEdgeIndex() is out of date. */
+
+	(*outGraph)->thisBuffer = buffer;
+	(*outGraph)->thisBufferSize = bufferSize;
+	(*outGraph)->vertexCapacity = vertexCapacity;
+	(*outGraph)->edgeCapacity   =   edgeCapacity;
+	(*outGraph)->currentVertexCount = 0;
+	(*outGraph)->currentEdgeCount   = 0;
+	(*outGraph)->edgeMode    = edgeMode;
+	(*outGraph)->nextFreeVertexId = 0;
+	(*outGraph)->edgeIndexMode = indexMode;
+	(*outGraph)->graphFlags = graphFlags;
+
+	return kAlgoErrorNone;
+}
+
+AlgoError algoGraphGetBufferSize(const AlgoGraph graph, size_t *outBufferSize)
+{
+	if (NULL == graph ||
+		NULL == outBufferSize)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outBufferSize = graph->thisBufferSize;
+	return kAlgoErrorNone;
+}
+
+AlgoError algoGraphValidate(const AlgoGraph graph)
+{
+	int errorCode = 0;
+	if (NULL == graph)
+	{
+		errorCode = 1; /* graph must not be NULL. */
+		goto ALGO_GRAPH_VALIDATE_END;
+	}
+	if (graph->currentEdgeCount < 0 ||
+		graph->edgeCapacity > graph->edgeCapacity)
+	{
+		errorCode = 2; /* edge count exceeds capacity. */
+		goto ALGO_GRAPH_VALIDATE_END;
+	}
+	if (graph->currentVertexCount < 0 ||
+		graph->currentVertexCount > graph->vertexCapacity)
+	{
+		errorCode = 3; /* vertex count exceeds capacity */
+		goto ALGO_GRAPH_VALIDATE_END;
+	}
+	/* Check edge lists */
+	{
+		int validVertexCount = 0;
+		int validEdgeNodeCount = 0;
+		int iVertex;
+		const int32_t nodesPerEdge = (graph->edgeMode == kAlgoGraphEdgeDirected) ? 1 : 2; /* undirected edges store two nodes: x->y and y->x */
+		for(iVertex=0; iVertex<graph->vertexCapacity; iVertex += 1)
+		{
+			if (iGraphIsValidVertexId(graph, iVertex))
+			{
+				int edgeListLength = 0;
+				const AlgoGraphEdgeList *edgeList = graph->vertexEdges + iVertex;
+				const AlgoGraphEdgeBlock *block = iGraphEdgeListHead(graph, edgeList);
+				int32_t blockEdgeCount = iGraphHeadBlockEdgeCount(graph->vertexDegrees[iVertex]);
+				if ((NULL != block) ? (block->link != iVertex) : (edgeList->fullBlocks >= 0))
+				{
+					errorCode = 17; /* edge list's head block is missing, or belongs to another vertex. */
+					goto ALGO_GRAPH_VALIDATE_END;
+				}
+				for(; NULL != block; block = iGraphNextEdgeBlock(graph, edgeList, block), blockEdgeCount = kAlgoGraphEdgeBlockCapacity)
+				{
+					int32_t iEdge;
+					for(iEdge=0; iEdge<blockEdgeCount; ++iEdge)
+					{
+						if (!iGraphIsValidVertexId(graph, block->destVertices[iEdge]))
+						{
+							errorCode = 4; /* edge's destination vertex is invalid. */
+							goto ALGO_GRAPH_VALIDATE_END;
+						}
+						if (NULL != graph->edgeIndex)
+						{
+							/* Each edge must have its own index entry, so this also catches duplicate edges. */
+							const AlgoGraphEdgeIndexEntry *entry = iGraphEdgeIndexFind(graph, iVertex, block->destVertices[iEdge]);
+							if (NULL == entry ||
+								entry->slot != iGraphEdgeBlockSlot(graph, block) + 1 + iEdge)
+							{
+								errorCode = 12; /* edge index entry is missing or points to the wrong edge. */
+								goto ALGO_GRAPH_VALIDATE_END;
+							}
+						}
+					}
+					validEdgeNodeCount += blockEdgeCount;
+					edgeListLength += blockEdgeCount;
+				}
+				if (edgeListLength != graph->vertexDegrees[iVertex])
+				{
+					errorCode = 5; /* vertex degree doesn't match edge list length. */
+					goto ALGO_GRAPH_VALIDATE_END;
+				}
+				/* TODO: check for multiple edges to the same destination vertex in graphs without an edge index. */
+				/* TODO: for undirected graphs, make sure every v1->v2 edge has a matching v2->v1 edge. */
+				validVertexCount += 1;
+			}
+			else
+			{
+				/* anything to check for invalid vertices? */
+			}
+		}
+		if (validEdgeNodeCount != graph->currentEdgeCount*nodesPerEdge)
+		{
+			errorCode = 6; /* actual valid edge count doesn't match expected value. */
+			goto ALGO_GRAPH_VALIDATE_END;
+		}
+		if (validVertexCount != graph->currentVertexCount)
+		{
+			errorCode = 7; /* actual valid vertex count doesn't match expected value. */
+			goto ALGO_GRAPH_VALIDATE_END;
+		}
+		if (NULL != graph->vertexInEdges)
+		{
+			/* Every incoming edge must match an outgoing one; with matching totals, the reverse holds as well. */
+			int32_t inEdgeNodeCount = 0;
+			for(iVertex=0; iVertex<graph->vertexCapacity; iVertex += 1)
+			{
+				if (!iGraphIsValidVertexId(graph, iVertex))
+					continue;
+				int32_t inListLength = 0;
+				const AlgoGraphEdgeList *edgeList = graph->vertexInEdges + iVertex;
+				const AlgoGraphEdgeBlock *block = iGraphEdgeListHead(graph, edgeList);
+				int32_t blockEdgeCount = iGraphHeadBlockEdgeCount(graph->vertexInDegrees[iVertex]);
+				if ((NULL != block) ? (block->link != iVertex) : (edgeList->fullBlocks >= 0))
+				{
+					errorCode = 17; /* edge list's head block is missing, or belongs to another vertex. */
+					goto ALGO_GRAPH_VALIDATE_END;
+				}
+				for(; NULL != block; block = iGraphNextEdgeBlock(graph, edgeList, block), blockEdgeCount = kAlgoGraphEdgeBlockCapacity)
+				{
+					int32_t iEdge;
+					for(iEdge=0; iEdge<blockEdgeCount; ++iEdge)
+					{
+						const int32_t outSlot = iGraphIsValidVertexId(graph, block->destVertices[iEdge])
+							? iGraphFindEdgeSlot(graph, block->destVertices[iEdge], iVertex) : -1;
+						if (outSlot < 0 ||
+							iGraphEdgeSlotWeight(graph, outSlot) != iGraphEdgeSlotWeight(graph, iGraphEdgeBlockSlot(graph, block) + 1 + iEdge))
+						{
+							errorCode = 14; /* incoming edge has no matching outgoing edge, or its weight doesn't match. */
+							goto ALGO_GRAPH_VALIDATE_END;
+						}
+						if (NULL != graph->edgeIndex)
+						{
+							const AlgoGraphEdgeIndexEntry *entry = iGraphEdgeIndexFind(graph, iVertex,
+								iGraphEdgeIndexKey(block->destVertices[iEdge], 1));
+							if (NULL == entry ||
+								entry->slot != iGraphEdgeBlockSlot(graph, block) + 1 + iEdge)
+							{
+								errorCode = 12; /* edge index entry is missing or points to the wrong edge. */
+								goto ALGO_GRAPH_VALIDATE_END;
+							}
+						}
+					}
+					inListLength += blockEdgeCount;
+				}
+				if (inListLength != graph->vertexInDegrees[iVertex])
+				{
+					errorCode = 15; /* vertex in-degree doesn't match in-edge list length. */
+					goto ALGO_GRAPH_VALIDATE_END;
+				}
+				inEdgeNodeCount += inListLength;
+			}
+			if (inEdgeNodeCount != validEdgeNodeCount)
+			{
+				errorCode = 16; /* incoming edge count doesn't match outgoing edge count. */
+				goto ALGO_GRAPH_VALIDATE_END;
+			}
+			validEdgeNodeCount += inEdgeNodeCount; /* for the edge index check below */
+		}
+		if (NULL != graph->edgeIndex)
+		{
+			int32_t indexEntryCount = 0;
+			for(uint32_t iEntry=0; iEntry<=graph->edgeIndexMask; ++iEntry)
+			{
+				indexEntryCount += (graph->edgeIndex[iEntry].srcVertexId >= 0) ? 1 : 0;
+			}
+			if (indexEntryCount != validEdgeNodeCount)
+			{
+				errorCode = 13; /* edge index contains stale entries. */
+				goto ALGO_GRAPH_VALIDATE_END;
+			}
+		}
+	}
+	/* Check free vertex list */
+	{
+		int32_t freeVertexCount = 0;
+		int32_t nextFreeVertexId = graph->nextFreeVertexId;
+		while(nextFreeVertexId >= 0)
+		{
+			if (iGraphIsValidVertexId(graph, nextFreeVertexId))
+			{
+				errorCode = 8; /* vertex in the free list thinks it's valid. */
+				goto ALGO_GRAPH_VALIDATE_END;
+			}
+			freeVertexCount += 1;
+			nextFreeVertexId = graph->vertexData[nextFreeVertexId].asInt;
+		}
+		if (graph->vertexCapacity - graph->currentVertexCount != freeVertexCount)
+		{
+			errorCode = 9; /* actual free vertex count doesn't match expected value. */
+			goto ALGO_GRAPH_VALIDATE_END;
+		}
+	}
+	/* Check valid vertex list */
+	{
+		for(int32_t iValidVert=0; iValidVert<graph->currentVertexCount; ++iValidVert)
+		{
+			int32_t validVertexId = graph->validVertexIds[iValidVert];
+			if (!iGraphIsValidVertexId(graph, validVertexId))
+			{
+				errorCode = 10; /* vertex in the valid list is invalid */
+				goto ALGO_GRAPH_VALIDATE_END;
+			}
+			if (graph->vertexIdToValidIndex[validVertexId] != iValidVert)
+			{
+				errorCode = 11; /* reverse lookup table mismatch */
+				goto ALGO_GRAPH_VALIDATE_END;
+			}
+		}
+	}
+
+ALGO_GRAPH_VALIDATE_END:
+	if (errorCode != 0)
+		return kAlgoErrorInvalidArgument;
+	return kAlgoErrorNone;
+}
+
+AlgoError algoGraphGetCurrentVertexCount(const AlgoGraph graph, int32_t *outCount)
+{
+	if (NULL == graph ||
+		NULL == outCount)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outCount = graph->currentVertexCount;
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphGetVertexCapacity(const AlgoGraph graph, int32_t *outCapacity)
+{
+	if (NULL == graph ||
+		NULL == outCapacity)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outCapacity = graph->vertexCapacity;
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphGetCurrentEdgeCount(const AlgoGraph graph, int32_t *outCount)
+{
+	if (NULL == graph ||
+		NULL == outCount)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outCount = graph->currentEdgeCount;
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphEdgeCapacity(const AlgoGraph graph, int32_t *outCapacity)
+{
+	if (NULL == graph ||
+		NULL == outCapacity)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outCapacity = graph->edgeCapacity;
+	return kAlgoErrorNone;
+}
+
+
+AlgoError algoGraphGetVertexDegree(const AlgoGraph graph, int32_t vertexId, int32_t *outDegree)
+{
+	if (NULL == graph ||
+		NULL == outDegree ||
+		0 == iGraphIsValidVertexId(graph, vertexId))
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outDegree = graph->vertexDegrees[vertexId];
+	ALGO_ASSERT( *outDegree >= 0); /* testing against upper bound is more complicated... */
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphGetVertexEdges(const AlgoGraph graph, int32_t srcVertexId, int32_t vertexDegree, int32_t outDestVertexIds[])
+{
+	const AlgoGraphEdgeList *edgeList;
+	const AlgoGraphEdgeBlock *block;
+	int32_t blockEdgeCount, edgeCount = 0;
+	if (NULL == graph ||
+		NULL == outDestVertexIds ||
+		0 == iGraphIsValidVertexId(graph, srcVertexId) ||
+		graph->vertexDegrees[srcVertexId] != vertexDegree)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	edgeList = graph->vertexEdges + srcVertexId;
+	block = iGraphEdgeListHead(graph, edgeList);
+	blockEdgeCount = iGraphHeadBlockEdgeCount(vertexDegree);
+	for(; NULL != block; block = iGraphNextEdgeBlock(graph, edgeList, block), blockEdgeCount = kAlgoGraphEdgeBlockCapacity)
+	{
+		ALGO_ASSERT(edgeCount + blockEdgeCount <= vertexDegree); /* edge list is longer than expected! */
+		ALGO_MEMCPY(outDestVertexIds + edgeCount, block->destVertices, blockEdgeCount*sizeof(int32_t));
+		edgeCount += blockEdgeCount;
+	}
+	ALGO_ASSERT(edgeCount == vertexDegree); /* edge list is shorter than expected! */
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphGetVertexInDegree(const AlgoGraph graph, int32_t vertexId, int32_t *outInDegree)
+{
+	if (NULL == graph ||
+		NULL == outInDegree ||
+		0 == iGraphIsValidVertexId(graph, vertexId))
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	if (kAlgoGraphEdgeUndirected == graph->edgeMode)
+	{
+		*outInDegree = graph->vertexDegrees[vertexId];
+		return kAlgoErrorNone;
+	}
+	if (NULL == graph->vertexInEdges)
+	{
+		return kAlgoErrorOperationFailed; /* no in-edge lists */
+	}
+	*outInDegree = graph->vertexInDegrees[vertexId];
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphGetVertexInEdges(const AlgoGraph graph, int32_t destVertexId, int32_t vertexInDegree, int32_t outSrcVertexIds[])
+{
+	const AlgoGraphEdgeList *edgeList;
+	const AlgoGraphEdgeBlock *block;
+	int32_t blockEdgeCount, edgeCount = 0;
+	if (NULL == graph ||
+		NULL == outSrcVertexIds ||
+		0 == iGraphIsValidVertexId(graph, destVertexId))
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	if (kAlgoGraphEdgeUndirected == graph->edgeMode)
+	{
+		return algoGraphGetVertexEdges(graph, destVertexId, vertexInDegree, outSrcVertexIds);
+	}
+	if (NULL == graph->vertexInEdges)
+	{
+		return kAlgoErrorOperationFailed; /* no in-edge lists */
+	}
+	if (graph->vertexInDegrees[destVertexId] != vertexInDegree)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	edgeList = graph->vertexInEdges + destVertexId;
+	block = iGraphEdgeListHead(graph, edgeList);
+	blockEdgeCount = iGraphHeadBlockEdgeCount(vertexInDegree);
+	for(; NULL != block; block = iGraphNextEdgeBlock(graph, edgeList, block), blockEdgeCount = kAlgoGraphEdgeBlockCapacity)
+	{
+		ALGO_ASSERT(edgeCount + blockEdgeCount <= vertexInDegree); /* edge list is longer than expected! */
+		ALGO_MEMCPY(outSrcVertexIds + edgeCount, block->destVertices, blockEdgeCount*sizeof(int32_t));
+		edgeCount += blockEdgeCount;
+	}
+	ALGO_ASSERT(edgeCount == vertexInDegree); /* edge list is shorter than expected! */
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphGetVertexInEdgeWeights(const AlgoGraph graph, int32_t destVertexId, int32_t vertexInDegree, int32_t outWeights[])
+{
+	const AlgoGraphEdgeList *edgeList;
+	const AlgoGraphEdgeBlock *block;
+	int32_t blockEdgeCount, edgeCount = 0;
+	int isInList;
+	if (NULL == graph ||
+		NULL == outWeights ||
+		0 == iGraphIsValidVertexId(graph, destVertexId))
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	if (kAlgoGraphEdgeDirected == graph->edgeMode && NULL == graph->vertexInEdges)
+	{
+		return kAlgoErrorOperationFailed; /* no in-edge lists */
+	}
+	/* Undirected edges are stored in both directions with the same weight, so the outgoing list serves as well. */
+	isInList = (kAlgoGraphEdgeDirected == graph->edgeMode) ? 1 : 0;
+	if (iGraphEdgeListDegrees(graph, isInList)[destVertexId] != vertexInDegree)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	edgeList = iGraphEdgeLists(graph, isInList) + destVertexId;
+	block = iGraphEdgeListHead(graph, edgeList);
+	blockEdgeCount = iGraphHeadBlockEdgeCount(vertexInDegree);
+	for(; NULL != block; block = iGraphNextEdgeBlock(graph, edgeList, block), blockEdgeCount = kAlgoGraphEdgeBlockCapacity)
+	{
+		ALGO_ASSERT(edgeCount + blockEdgeCount <= vertexInDegree); /* edge list is longer than expected! */
+		if (NULL != graph->edgeWeights)
+		{
+			ALGO_MEMCPY(outWeights + edgeCount, iGraphEdgeBlockWeights(graph, block), blockEdgeCount*sizeof(int32_t));
+		}
+		else
+		{
+			int32_t iEdge;
+			for(iEdge=0; iEdge<blockEdgeCount; ++iEdge)
+			{
+				outWeights[edgeCount + iEdge] = 1;
+			}
+		}
+		edgeCount += blockEdgeCount;
+	}
+	ALGO_ASSERT(edgeCount == vertexInDegree); /* edge list is shorter than expected! */
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphGetVertexData(const AlgoGraph graph, int32_t vertexId, AlgoData *outValue)
+{
+	if (NULL == graph ||
+		NULL == outValue ||
+		0 == iGraphIsValidVertexId(graph, vertexId))
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outValue = graph->vertexData[vertexId];
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphSetVertexData(AlgoGraph graph, int32_t vertexId, AlgoData value)
+{
+	if (NULL == graph ||
+		0 == iGraphIsValidVertexId(graph, vertexId))
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	graph->vertexData[vertexId] = value;
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphAddVertex(AlgoGraph graph, AlgoData vertexData, int32_t *outVertexId)
+{
+	int32_t newVertexId;
+	if (NULL == graph)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	if (graph->currentVertexCount >= graph->vertexCapacity)
+	{
+		return kAlgoErrorOperationFailed;
+	}
+	newVertexId = graph->nextFreeVertexId;
+	ALGO_ASSERT(newVertexId >= 0 && newVertexId < graph->vertexCapacity); /* <0 means the vertex pool is empty */
+	graph->nextFreeVertexId = graph->vertexData[newVertexId].asInt;
+	if (NULL != outVertexId)
+	{
+		*outVertexId = newVertexId;
+	}
+	graph->vertexDegrees[newVertexId] = 0;
+	graph->vertexEdges[newVertexId].headBlock  = -1;
+	graph->vertexEdges[newVertexId].fullBlocks = -1;
+	if (NULL != graph->vertexInEdges)
+	{
+		graph->vertexInDegrees[newVertexId] = 0;
+		graph->vertexInEdges[newVertexId].headBlock  = -1;
+		graph->vertexInEdges[newVertexId].fullBlocks = -1;
+	}
+	graph->vertexData[newVertexId] = vertexData;
+	graph->validVertexIds[graph->currentVertexCount] = newVertexId;
+	graph->vertexIdToValidIndex[newVertexId] = graph->currentVertexCount;
+	graph->currentVertexCount += 1;
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphRemoveVertex(AlgoGraph graph, int32_t vertexId)
+{
+	if (NULL == graph ||
+		0 == iGraphIsValidVertexId(graph, vertexId))
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	if (kAlgoGraphEdgeUndirected == graph->edgeMode)
+	{
+		/* Removing an edge from another vertex's list can compact a slab, and move this vertex's head block. So rather
+		   than iterating over this vertex's list, repeatedly take the last edge in its head block. */
+		while(graph->vertexDegrees[vertexId] > 0)
+		{
+			int removed = 0;
+			int32_t destVertexId = graph->edgeSlots[graph->vertexEdges[vertexId].headBlock
+				+ iGraphHeadBlockEdgeCount(graph->vertexDegrees[vertexId])];
+			/* remove incoming edge */
+			ALGO_ASSERT(graph->vertexDegrees[destVertexId] > 0); /* for undirected graphs, there must at least be an edge going back to vertexId! */
+			removed = iGraphRemoveEdgeFromList(graph, 0, destVertexId, vertexId);
+			ALGO_ASSERT(removed); /* this removal MUST succeed, or else an invariant has failed somewhere. */
+			/* Remove outgoing edge */
+			removed = iGraphRemoveEdgeFromList(graph, 0, vertexId, destVertexId);
+			ALGO_ASSERT(removed);
+			ALGO_UNUSED(removed);
+			graph->currentEdgeCount -= 1;
+		}
+	}
+	else if (NULL != graph->vertexInEdges)
+	{
+		/* Each outgoing edge has a twin in its destination's in-edge list, and each incoming edge has a twin in its
+		   source's outgoing list; only those lists need to be updated. The twins are in the other set of lists, so
+		   removing them never moves this vertex's blocks. */
+		int isInList;
+		for(isInList=0; isInList<2; ++isInList)
+		{
+			const AlgoGraphEdgeList *edgeList = iGraphEdgeLists(graph, isInList) + vertexId;
+			const AlgoGraphEdgeBlock *block = iGraphEdgeListHead(graph, edgeList);
+			int32_t blockEdgeCount = iGraphHeadBlockEdgeCount(iGraphEdgeListDegrees(graph, isInList)[vertexId]);
+			for(; NULL != block; block = iGraphNextEdgeBlock(graph, edgeList, block), blockEdgeCount = kAlgoGraphEdgeBlockCapacity)
+			{
+				int32_t iEdge;
+				for(iEdge=0; iEdge<blockEdgeCount; ++iEdge)
+				{
+					int removed = iGraphRemoveEdgeFromList(graph, !isInList, block->destVertices[iEdge], vertexId);
+					ALGO_ASSERT(removed); /* this removal MUST succeed, or else an invariant has failed somewhere. */
+					ALGO_UNUSED(removed);
+				}
+			}
+		}
+		graph->currentEdgeCount -= graph->vertexDegrees[vertexId] + graph->vertexInDegrees[vertexId];
+		iGraphFreeEdgeList(graph, 0, vertexId);
+		iGraphFreeEdgeList(graph, 1, vertexId);
+	}
+	else /* kAlgoGraphEdgeDirected == graph->edgeMode */
+	{
+		/* Remove all outgoing edges. This also prevents this vert's edge list from being searched in the loop below. */
+		int32_t iValidVert;
+		graph->currentEdgeCount -= graph->vertexDegrees[vertexId];
+		iGraphFreeEdgeList(graph, 0, vertexId);
+		/*	Search all other vertices for incoming edges, and remove them. This *really* sucks; graphs created with
+			kAlgoGraphInEdges avoid it, at the cost of O(E) more memory and some extra bookkeeping.
+			*/
+		for(iValidVert=0; iValidVert<graph->currentVertexCount; iValidVert += 1)
+		{
+			int32_t srcVertexId = graph->validVertexIds[iValidVert];
+			if (!iGraphIsValidVertexId(graph, srcVertexId))
+				continue;
+			int removed = iGraphRemoveEdgeFromList(graph, 0, srcVertexId, vertexId);
+			graph->currentEdgeCount -= (removed ? 1 : 0);
+		}
+	}
+	/* Finally, remove the vertex. */
+	graph->vertexData[vertexId].asInt = graph->nextFreeVertexId;
+	graph->nextFreeVertexId = vertexId;
+	{
+		/* Update the valid vertex list and reverse-lookup table */
+		int32_t destValidIndex = graph->vertexIdToValidIndex[vertexId];
+		int32_t finalValidVertexId = graph->validVertexIds[graph->currentVertexCount-1];
+		graph->validVertexIds[destValidIndex] = finalValidVertexId;
+		graph->vertexIdToValidIndex[finalValidVertexId] = destValidIndex;
+	}
+	graph->currentVertexCount -= 1;
+	graph->vertexDegrees[vertexId] = -1;
+	return kAlgoErrorNone;
+}
+ALGO_INTERNAL AlgoError iGraphAddEdge(AlgoGraph graph, int32_t srcVertexId, int32_t destVertexId, int32_t weight,
+	int overwriteWeight)
+{
+	if (NULL == graph ||
+		0 == iGraphIsValidVertexId(graph, srcVertexId) ||
+		0 == iGraphIsValidVertexId(graph, destVertexId) ||
+		srcVertexId == destVertexId /* no self-connecting edges */
+		)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+
+	/* check that a src->dest edge doesn't already exist; return immediately if so. Undirected edges are always
+	   added in pairs, so there's no need to check for the dest->src edge separately. */
+	int32_t existingSlot = iGraphFindEdgeSlot(graph, srcVertexId, destVertexId);
+	if (existingSlot >= 0)
+	{
+		if (!overwriteWeight && kAlgoGraphEdgeIndexRejectDuplicates == graph->edgeIndexMode)
+		{
+			return kAlgoErrorOperationFailed; /* duplicate edge */
+		}
+		if (overwriteWeight && NULL != graph->edgeWeights)
+		{
+			graph->edgeWeights[existingSlot] = weight;
+			if (graph->edgeMode == kAlgoGraphEdgeUndirected)
+			{
+				existingSlot = iGraphFindEdgeSlot(graph, destVertexId, srcVertexId);
+				ALGO_ASSERT(existingSlot >= 0);
+				graph->edgeWeights[existingSlot] = weight;
+			}
+			else if (NULL != graph->vertexInEdges)
+			{
+				existingSlot = iGraphFindListEdgeSlot(graph, 1, destVertexId, srcVertexId);
+				ALGO_ASSERT(existingSlot >= 0); /* every outgoing edge must have a matching incoming edge */
+				graph->edgeWeights[existingSlot] = weight;
+			}
+		}
+		return kAlgoErrorNone;
+	}
+	if (graph->currentEdgeCount >= graph->edgeCapacity)
+	{
+		return kAlgoErrorOperationFailed; /* exceeded edge capacity */
+	}
+
+	/* The edge block pool is sized for the worst case, so these allocations can't fail while under edgeCapacity. */
+	int added = iGraphAddEdgeToList(graph, 0, srcVertexId, destVertexId, weight);
+	ALGO_ASSERT(added);
+	if (graph->edgeMode == kAlgoGraphEdgeUndirected)
+	{
+		/* Add a second edge in the opposite direction */
+		ALGO_ASSERT(iGraphFindEdgeSlot(graph, destVertexId, srcVertexId) < 0);
+		added = iGraphAddEdgeToList(graph, 0, destVertexId, srcVertexId, weight);
+		ALGO_ASSERT(added);
+	}
+	else if (NULL != graph->vertexInEdges)
+	{
+		added = iGraphAddEdgeToList(graph, 1, destVertexId, srcVertexId, weight);
+		ALGO_ASSERT(added);
+	}
+	ALGO_UNUSED(added);
+
+	/* As implemented, this counts "logical" edges, not actual edge entries. An undirected
+		edge will store two entries, but only increment this value once. */
+	graph->currentEdgeCount += 1;
+
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphAddEdge(AlgoGraph graph, int32_t srcVertexId, int32_t destVertexId)
+{
+	return iGraphAddEdge(graph, srcVertexId, destVertexId, 1, 0);
+}
+AlgoError algoGraphAddWeightedEdge(AlgoGraph graph, int32_t srcVertexId, int32_t destVertexId, int32_t weight)
+{
+	if (weight < 0)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	if (NULL != graph && NULL == graph->edgeWeights)
+	{
+		return kAlgoErrorOperationFailed; /* graph doesn't store weights */
+	}
+	return iGraphAddEdge(graph, srcVertexId, destVertexId, weight, 1);
+}
+typedef struct IGraphBulkEdge
+{
+	int32_t srcVertexId;
+	int32_t destVertexId;
+	int32_t weight;
+} IGraphBulkEdge;
+AlgoError algoGraphAddEdgesComputeBufferSize(size_t *outBufferSize, const AlgoGraph graph, int32_t edgeCount)
+{
+	if (NULL == outBufferSize ||
+		NULL == graph ||
+		edgeCount < 0)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	const int32_t nodesPerEdge = (graph->edgeMode == kAlgoGraphEdgeDirected) ? 1 : 2; /* undirected edges store two nodes: x->y and y->x */
+	size_t edgesSize       = (size_t)edgeCount * nodesPerEdge * sizeof(IGraphBulkEdge);
+	size_t sortedEdgesSize = (size_t)edgeCount * nodesPerEdge * sizeof(IGraphBulkEdge);
+	size_t vertexMarksSize = graph->vertexCapacity * sizeof(int32_t);
+	*outBufferSize = edgesSize + sortedEdgesSize + vertexMarksSize;
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphAddEdges(AlgoGraph graph, int32_t edgeCount, const int32_t srcVertexIds[], const int32_t destVertexIds[],
+	const int32_t weights[], void *buffer, size_t bufferSize)
+{
+	if (NULL == graph ||
+		edgeCount < 0 ||
+		(edgeCount > 0 && (NULL == srcVertexIds || NULL == destVertexIds)) ||
+		NULL == buffer)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	size_t minBufferSize = 0;
+	AlgoError err = algoGraphAddEdgesComputeBufferSize(&minBufferSize, graph, edgeCount);
+	if (err != kAlgoErrorNone)
+	{
+		return err;
+	}
+	if (bufferSize < minBufferSize)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	if (NULL != weights && NULL == graph->edgeWeights)
+	{
+		return kAlgoErrorOperationFailed; /* graph doesn't store weights */
+	}
+	/* Validate the whole batch up front, so a bad edge can't leave the graph half-modified. */
+	for(int32_t iEdge=0; iEdge<edgeCount; ++iEdge)
+	{
+		if (0 == iGraphIsValidVertexId(graph, srcVertexIds[iEdge]) ||
+			0 == iGraphIsValidVertexId(graph, destVertexIds[iEdge]) ||
+			srcVertexIds[iEdge] == destVertexIds[iEdge] || /* no self-connecting edges */
+			(NULL != weights && weights[iEdge] < 0))
+		{
+			return kAlgoErrorInvalidArgument;
+		}
+	}
+
+	const int32_t nodesPerEdge = (graph->edgeMode == kAlgoGraphEdgeDirected) ? 1 : 2; /* undirected edges store two nodes: x->y and y->x */
+	const int32_t nodeCount = edgeCount*nodesPerEdge;
+	uint8_t *bufferNext = (uint8_t*)buffer;
+	IGraphBulkEdge *edges = (IGraphBulkEdge*)bufferNext;
+	bufferNext += nodeCount * sizeof(IGraphBulkEdge);
+	IGraphBulkEdge *sortedEdges = (IGraphBulkEdge*)bufferNext;
+	bufferNext += nodeCount * sizeof(IGraphBulkEdge);
+	int32_t *vertexMarks = (int32_t*)bufferNext;
+	bufferNext += graph->vertexCapacity * sizeof(int32_t);
+	ALGO_ASSERT( bufferNext-minBufferSize == buffer ); /* If this fails, algoGraphAddEdgesComputeBufferSize() is out of date */
+
+	for(int32_t iEdge=0; iEdge<edgeCount; ++iEdge)
+	{
+		IGraphBulkEdge *node = edges + iEdge*nodesPerEdge;
+		node[0].srcVertexId  = srcVertexIds[iEdge];
+		node[0].destVertexId = destVertexIds[iEdge];
+		node[0].weight       = (NULL != weights) ? weights[iEdge] : 1;
+		if (graph->edgeMode == kAlgoGraphEdgeUndirected)
+		{
+			node[1].srcVertexId  = destVertexIds[iEdge];
+			node[1].destVertexId = srcVertexIds[iEdge];
+			node[1].weight       = node[0].weight;
+		}
+	}
+	/* LSD radix sort by source vertex, one byte per pass, with only as many passes as the vertex capacity needs. The sort
+	   is stable, so each vertex's edges keep their order within the batch. */
+	const uint32_t maxVertexId = (uint32_t)(graph->vertexCapacity-1);
+	for(int32_t shift=0; shift<32 && (0 == shift || 0 != (maxVertexId >> shift)); shift += 8)
+	{
+		int32_t digitOffsets[256] = {0};
+		int32_t offset = 0;
+		for(int32_t iNode=0; iNode<nodeCount; ++iNode)
+		{
+			digitOffsets[((uint32_t)edges[iNode].srcVertexId >> shift) & 0xFF] += 1;
+		}
+		for(int32_t iDigit=0; iDigit<256; ++iDigit)
+		{
+			const int32_t digitCount = digitOffsets[iDigit];
+			digitOffsets[iDigit] = offset;
+			offset += digitCount;
+		}
+		for(int32_t iNode=0; iNode<nodeCount; ++iNode)
+		{
+			sortedEdges[digitOffsets[((uint32_t)edges[iNode].srcVertexId >> shift) & 0xFF]++] = edges[iNode];
+		}
+		IGraphBulkEdge *swap = edges;
+		edges = sortedEdges;
+		sortedEdges = swap;
+	}
+
+	/* Drop edges that already exist, or that were already seen earlier in the batch. While scanning a vertex's edges,
+	   vertexMarks[v] == srcVertexId means the srcVertexId->v edge is taken. Without an edge index, the vertex's existing
+	   edges are marked up front; with one, each batch edge is looked up instead. Undirected edges are always present in
+	   both lists (or neither), so both of their nodes are dropped or kept together. */
+	for(int32_t iVert=0; iVert<graph->vertexCapacity; ++iVert)
+	{
+		vertexMarks[iVert] = -1;
+	}
+	const int rejectDuplicates = (kAlgoGraphEdgeIndexRejectDuplicates == graph->edgeIndexMode);
+	int32_t keptNodeCount = 0;
+	for(int32_t iNode=0; iNode<nodeCount; )
+	{
+		const int32_t v0 = edges[iNode].srcVertexId;
+		if (NULL == graph->edgeIndex)
+		{
+			const AlgoGraphEdgeList *edgeList = graph->vertexEdges + v0;
+			const AlgoGraphEdgeBlock *block = iGraphEdgeListHead(graph, edgeList);
+			int32_t blockEdgeCount = iGraphHeadBlockEdgeCount(graph->vertexDegrees[v0]);
+			for(; NULL != block; block = iGraphNextEdgeBlock(graph, edgeList, block), blockEdgeCount = kAlgoGraphEdgeBlockCapacity)
+			{
+				int32_t iEdge;
+				for(iEdge=0; iEdge<blockEdgeCount; ++iEdge)
+				{
+					vertexMarks[block->destVertices[iEdge]] = v0;
+				}
+			}
+		}
+		for(; iNode<nodeCount && edges[iNode].srcVertexId == v0; ++iNode)
+		{
+			const int32_t v1 = edges[iNode].destVertexId;
+			if (vertexMarks[v1] == v0 ||
+				(NULL != graph->edgeIndex && iGraphFindEdgeSlot(graph, v0, v1) >= 0))
+			{
+				if (rejectDuplicates)
+				{
+					return kAlgoErrorOperationFailed; /* duplicate edge */
+				}
+				continue;
+			}
+			vertexMarks[v1] = v0;
+			edges[keptNodeCount++] = edges[iNode];
+		}
+	}
+	ALGO_ASSERT(0 == keptNodeCount % nodesPerEdge);
+	const int32_t newEdgeCount = keptNodeCount / nodesPerEdge;
+	if (newEdgeCount > graph->edgeCapacity - graph->currentEdgeCount)
+	{
+		return kAlgoErrorOperationFailed; /* exceeded edge capacity */
+	}
+
+	/* Each vertex's new edges are appended together. sortedEdges[] is no longer needed, so it holds the destinations and
+	   weights of the current vertex's edges. */
+	int32_t *appendDestVertexIds = (int32_t*)sortedEdges;
+	int32_t *appendWeights = appendDestVertexIds + keptNodeCount;
+	for(int32_t iNode=0; iNode<keptNodeCount; )
+	{
+		const int32_t v0 = edges[iNode].srcVertexId;
+		int32_t appendCount = 0;
+		for(; iNode<keptNodeCount && edges[iNode].srcVertexId == v0; ++iNode, ++appendCount)
+		{
+			appendDestVertexIds[appendCount] = edges[iNode].destVertexId;
+			appendWeights[appendCount] = edges[iNode].weight;
+		}
+		iGraphAppendEdgesToList(graph, 0, v0, appendDestVertexIds, appendWeights, appendCount);
+	}
+	if (NULL != graph->vertexInEdges)
+	{
+		for(int32_t iNode=0; iNode<keptNodeCount; ++iNode)
+		{
+			int added = iGraphAddEdgeToList(graph, 1, edges[iNode].destVertexId, edges[iNode].srcVertexId, edges[iNode].weight);
+			ALGO_ASSERT(added);
+			ALGO_UNUSED(added);
+		}
+	}
+	graph->currentEdgeCount += newEdgeCount;
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphGetEdgeWeight(const AlgoGraph graph, int32_t srcVertexId, int32_t destVertexId, int32_t *outWeight)
+{
+	if (NULL == graph ||
+		NULL == outWeight ||
+		0 == iGraphIsValidVertexId(graph, srcVertexId) ||
+		0 == iGraphIsValidVertexId(graph, destVertexId))
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	const int32_t slot = iGraphFindEdgeSlot(graph, srcVertexId, destVertexId);
+	if (slot < 0)
+	{
+		return kAlgoErrorOperationFailed; /* no such edge */
+	}
+	*outWeight = iGraphEdgeSlotWeight(graph, slot);
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphHasEdge(const AlgoGraph graph, int32_t srcVertexId, int32_t destVertexId, int *outHasEdge)
+{
+	if (NULL == graph ||
+		NULL == outHasEdge ||
+		0 == iGraphIsValidVertexId(graph, srcVertexId) ||
+		0 == iGraphIsValidVertexId(graph, destVertexId))
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outHasEdge = (iGraphFindEdgeSlot(graph, srcVertexId, destVertexId) >= 0) ? 1 : 0;
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphRemoveEdge(AlgoGraph graph, int32_t srcVertexId, int32_t destVertexId)
+{
+	if (NULL == graph ||
+		0 == iGraphIsValidVertexId(graph, srcVertexId) ||
+		0 == iGraphIsValidVertexId(graph, destVertexId))
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+
+	int removed = iGraphRemoveEdgeFromList(graph, 0, srcVertexId, destVertexId);
+	if (!removed)
+		return kAlgoErrorOperationFailed;
+	if (kAlgoGraphEdgeUndirected == graph->edgeMode)
+	{
+		removed = iGraphRemoveEdgeFromList(graph, 0, destVertexId, srcVertexId);
+		if (!removed)
+			return kAlgoErrorOperationFailed;
+	}
+	else if (NULL != graph->vertexInEdges)
+	{
+		removed = iGraphRemoveEdgeFromList(graph, 1, destVertexId, srcVertexId);
+		ALGO_ASSERT(removed); /* every outgoing edge must have a matching incoming edge */
+		ALGO_UNUSED(removed);
+	}
+	graph->currentEdgeCount -= 1;
+	return kAlgoErrorNone;
+}
+
+ALGO_INTERNAL ALGO_INLINE void iSetBit(int32_t *bits, size_t capacity, int32_t index)
+{
+	ALGO_ASSERT(index >= 0 && (size_t)index < capacity);
+	ALGO_UNUSED(capacity);
+	bits[index/32] |= 1<<(index%32);
+}
+ALGO_INTERNAL ALGO_INLINE void iClearBit(int32_t *bits, size_t capacity, int32_t index)
+{
+	ALGO_ASSERT(index >= 0 && (size_t)index < capacity);
+	ALGO_UNUSED(capacity);
+	bits[index/32] &= ~(1<<(index%32));
+}
+ALGO_INTERNAL ALGO_INLINE void iFlipBit(int32_t *bits, size_t capacity, int32_t index)
+{
+	ALGO_ASSERT(index >= 0 && (size_t)index < capacity);
+	ALGO_UNUSED(capacity);
+	bits[index/32] ^= 1<<(index%32);
+}
+ALGO_INTERNAL ALGO_INLINE int32_t iTestBit(const int32_t *bits, size_t capacity, int32_t index)
+{
+	ALGO_ASSERT(index >= 0 && (size_t)index < capacity);
+	ALGO_UNUSED(capacity);
+	return ( bits[index/32] & (1<<(index%32)) ) ? 1 : 0;
+}
+
+AlgoError algoGraphReorderComputeBufferSize(size_t *outBufferSize, const AlgoGraph graph)
+{
+	if (NULL == outBufferSize ||
+		NULL == graph)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	const int32_t nodesPerEdge = (graph->edgeMode == kAlgoGraphEdgeDirected) ? 1 : 2; /* undirected edges store two nodes: x->y and y->x */
+	int32_t vertexCapacityRounded = (graph->vertexCapacity+31) & ~31;
+	size_t offsetsSize      = (graph->vertexCapacity+1) * sizeof(int32_t);
+	size_t destVerticesSize = graph->currentEdgeCount * nodesPerEdge * sizeof(int32_t);
+	size_t weightsSize      = (NULL != graph->edgeWeights) ? graph->currentEdgeCount * nodesPerEdge * sizeof(int32_t) : 0;
+	size_t newToOldSize     = graph->vertexCapacity * sizeof(int32_t);
+	size_t byDegreeSize     = graph->vertexCapacity * sizeof(int32_t);
+	size_t degreeCountsSize = (graph->vertexCapacity+1) * sizeof(int32_t);
+	size_t isVisitedSize    = vertexCapacityRounded * sizeof(int32_t) / 32;
+	size_t vertexDataSize   = graph->vertexCapacity * sizeof(AlgoData);
+	*outBufferSize = vertexDataSize + offsetsSize + destVerticesSize + weightsSize + newToOldSize + byDegreeSize
+		+ degreeCountsSize + isVisitedSize;
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphReorder(AlgoGraph graph, AlgoGraphReorderStrategy strategy, int32_t outOldToNew[], void *buffer, size_t bufferSize)
+{
+	if (NULL == graph ||
+		NULL == outOldToNew ||
+		NULL == buffer ||
+		(kAlgoGraphReorderReverseCuthillMcKee != strategy &&
+		 kAlgoGraphReorderBfs != strategy &&
+		 kAlgoGraphReorderDegreeDescending != strategy))
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	size_t minBufferSize = 0;
+	AlgoError err = algoGraphReorderComputeBufferSize(&minBufferSize, graph);
+	if (bufferSize < minBufferSize ||
+		kAlgoErrorNone != err)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	const int32_t nodesPerEdge = (graph->edgeMode == kAlgoGraphEdgeDirected) ? 1 : 2;
+	const int32_t vertexCapacity = graph->vertexCapacity;
+	const int32_t vertexCount = graph->currentVertexCount;
+	int32_t vertexCapacityRounded = (vertexCapacity+31) & ~31;
+	uint8_t *bufferNext = (uint8_t*)buffer;
+	AlgoData *vertexData = (AlgoData*)bufferNext; /* first, so that it's 8-byte aligned */
+	bufferNext += vertexCapacity * sizeof(AlgoData);
+	int32_t *edgeOffsets = (int32_t*)bufferNext;
+	bufferNext += (vertexCapacity+1) * sizeof(int32_t);
+	int32_t *destVertices = (int32_t*)bufferNext;
+	bufferNext += graph->currentEdgeCount * nodesPerEdge * sizeof(int32_t);
+	int32_t *weights = NULL; /* only if the graph is weighted */
+	if (NULL != graph->edgeWeights)
+	{
+		weights = (int32_t*)bufferNext;
+		bufferNext += graph->currentEdgeCount * nodesPerEdge * sizeof(int32_t);
+	}
+	int32_t *newToOld = (int32_t*)bufferNext; /* also serves as the BFS queue */
+	bufferNext += vertexCapacity * sizeof(int32_t);
+	int32_t *byDegree = (int32_t*)bufferNext; /* valid vertex IDs, in order of increasing degree */
+	bufferNext += vertexCapacity * sizeof(int32_t);
+	int32_t *degreeCounts = (int32_t*)bufferNext;
+	bufferNext += (vertexCapacity+1) * sizeof(int32_t);
+	int32_t *isVisited = (int32_t*)bufferNext;
+	bufferNext += vertexCapacityRounded * sizeof(int32_t) / 32;
+	ALGO_ASSERT( bufferNext-minBufferSize == buffer ); /* If this fails, algoGraphReorderComputeBufferSize() is out of date */
+
+	/* Copy the edges (in old vertex IDs) out of the edge pool, one contiguous range per vertex. */
+	int32_t edgeNodeCount = 0;
+	for(int32_t v0=0; v0<vertexCapacity; ++v0)
+	{
+		edgeOffsets[v0] = edgeNodeCount;
+		const AlgoGraphEdgeList *edgeList = graph->vertexEdges + v0;
+		const AlgoGraphEdgeBlock *block = iGraphEdgeListHead(graph, edgeList);
+		int32_t blockEdgeCount = iGraphHeadBlockEdgeCount(graph->vertexDegrees[v0]);
+		for(; NULL != block; block = iGraphNextEdgeBlock(graph, edgeList, block), blockEdgeCount = kAlgoGraphEdgeBlockCapacity)
+		{
+			ALGO_MEMCPY(destVertices + edgeNodeCount, block->destVertices, blockEdgeCount*sizeof(int32_t));
+			if (NULL != weights)
+				ALGO_MEMCPY(weights + edgeNodeCount, iGraphEdgeBlockWeights(graph, block), blockEdgeCount*sizeof(int32_t));
+			edgeNodeCount += blockEdgeCount;
+		}
+	}
+	edgeOffsets[vertexCapacity] = edgeNodeCount;
+	ALGO_ASSERT(edgeNodeCount == graph->currentEdgeCount * nodesPerEdge);
+
+	/* Counting sort of the valid vertices by degree. Ties keep their current relative order. */
+	ALGO_MEMSET(degreeCounts, 0, (vertexCapacity+1) * sizeof(int32_t));
+	for(int32_t iValidVert=0; iValidVert<vertexCount; ++iValidVert)
+	{
+		degreeCounts[ graph->vertexDegrees[graph->validVertexIds[iValidVert]] ] += 1;
+	}
+	for(int32_t degree=0, total=0; degree<=vertexCapacity; ++degree)
+	{
+		const int32_t count = degreeCounts[degree];
+		degreeCounts[degree] = total;
+		total += count;
+	}
+	for(int32_t v0=0; v0<vertexCapacity; ++v0)
+	{
+		if (iGraphIsValidVertexId(graph, v0))
+			byDegree[ degreeCounts[graph->vertexDegrees[v0]]++ ] = v0;
+	}
+
+	/* Compute the new order. */
+	if (kAlgoGraphReorderDegreeDescending == strategy)
+	{
+		for(int32_t iVert=0; iVert<vertexCount; ++iVert)
+		{
+			newToOld[iVert] = byDegree[vertexCount-1-iVert];
+		}
+	}
+	else
+	{
+		/* Breadth-first traversal of each component in turn. Cuthill-McKee starts each component from its lowest-degree
+		   vertex, and visits each vertex's neighbors in order of increasing degree; the reverse of that order tends to
+		   have the smallest bandwidth. */
+		const int isCuthillMcKee = (kAlgoGraphReorderReverseCuthillMcKee == strategy);
+		int32_t queueSize = 0;
+		ALGO_MEMSET(isVisited, 0, vertexCapacityRounded * sizeof(int32_t) / 32);
+		for(int32_t iRoot=0; iRoot<vertexCapacity; ++iRoot)
+		{
+			const int32_t rootVertexId = isCuthillMcKee ? ((iRoot < vertexCount) ? byDegree[iRoot] : -1) : iRoot;
+			if (0 == iGraphIsValidVertexId(graph, rootVertexId) ||
+				iTestBit(isVisited, vertexCapacityRounded, rootVertexId))
+			{
+				continue;
+			}
+			iSetBit(isVisited, vertexCapacityRounded, rootVertexId);
+			int32_t queueHead = queueSize;
+			newToOld[queueSize++] = rootVertexId;
+			for(; queueHead<queueSize; ++queueHead)
+			{
+				const int32_t v0 = newToOld[queueHead];
+				const int32_t firstNewVertex = queueSize;
+				for(int32_t iEdge=edgeOffsets[v0]; iEdge<edgeOffsets[v0+1]; ++iEdge)
+				{
+					const int32_t v1 = destVertices[iEdge];
+					if (iTestBit(isVisited, vertexCapacityRounded, v1))
+						continue;
+					iSetBit(isVisited, vertexCapacityRounded, v1);
+					newToOld[queueSize++] = v1;
+				}
+				if (!isCuthillMcKee)
+					continue;
+				/* Insertion sort of the newly-enqueued neighbors by degree; most vertices only add a few. */
+				for(int32_t iNew=firstNewVertex+1; iNew<queueSize; ++iNew)
+				{
+					const int32_t v1 = newToOld[iNew];
+					int32_t iDest = iNew;
+					for(; iDest > firstNewVertex && graph->vertexDegrees[newToOld[iDest-1]] > graph->vertexDegrees[v1]; --iDest)
+					{
+						newToOld[iDest] = newToOld[iDest-1];
+					}
+					newToOld[iDest] = v1;
+				}
+			}
+		}
+		ALGO_ASSERT(queueSize == vertexCount);
+		if (isCuthillMcKee)
+		{
+			for(int32_t iVert=0; iVert<vertexCount/2; ++iVert)
+			{
+				const int32_t swap = newToOld[iVert];
+				newToOld[iVert] = newToOld[vertexCount-1-iVert];
+				newToOld[vertexCount-1-iVert] = swap;
+			}
+		}
+	}
+	for(int32_t v0=0; v0<vertexCapacity; ++v0)
+	{
+		outOldToNew[v0] = -1;
+	}
+	for(int32_t iVert=0; iVert<vertexCount; ++iVert)
+	{
+		outOldToNew[newToOld[iVert]] = iVert;
+	}
+
+	/* Rebuild the graph under the new IDs. Valid vertices become [0..vertexCount), and the edge pool is recreated so that
+	   each vertex's blocks are allocated in vertex order. */
+	for(int32_t iVert=0; iVert<vertexCount; ++iVert)
+	{
+		vertexData[iVert] = graph->vertexData[newToOld[iVert]];
+	}
+	size_t edgePoolSize = 0;
+	err = algoAllocPoolGetBufferSize(graph->edgePool, &edgePoolSize);
+	ALGO_ASSERT(kAlgoErrorNone == err);
+	err = algoAllocPoolCreate(&graph->edgePool, sizeof(AlgoGraphEdgeBlock),
+		iGraphEdgePoolCapacity(vertexCapacity, graph->edgeCapacity, graph->edgeMode, graph->graphFlags),
+		(void*)graph->edgePool, edgePoolSize);
+	ALGO_ASSERT(kAlgoErrorNone == err);
+	ALGO_ASSERT(graph->edgeSlots == (int32_t*)graph->edgePool->pool);
+	for(int32_t isInList=0; isInList<2; ++isInList)
+	{
+		for(int32_t blockClass=0; blockClass<kAlgoGraphEdgeSlabClassCount; ++blockClass)
+		{
+			graph->edgeSlabs[isInList][blockClass].slot = -1;
+		}
+	}
+	if (NULL != graph->edgeIndex)
+		iGraphEdgeIndexClear(graph);
+	if (NULL != graph->vertexInEdges)
+	{
+		for(int32_t v0=0; v0<vertexCapacity; ++v0)
+		{
+			graph->vertexInEdges[v0].headBlock  = -1;
+			graph->vertexInEdges[v0].fullBlocks = -1;
+			graph->vertexInDegrees[v0] = 0;
+		}
+	}
+	for(int32_t newVertexId=0; newVertexId<vertexCapacity; ++newVertexId)
+	{
+		if (newVertexId >= vertexCount)
+		{
+			graph->vertexDegrees[newVertexId] = -1;
+			graph->vertexEdges[newVertexId].headBlock  = -1;
+			graph->vertexEdges[newVertexId].fullBlocks = -1;
+			graph->vertexData[newVertexId].asInt = (newVertexId+1 < vertexCapacity) ? newVertexId+1 : -1; /* free list */
+			continue;
+		}
+		const int32_t oldVertexId = newToOld[newVertexId];
+		const int32_t degree = edgeOffsets[oldVertexId+1] - edgeOffsets[oldVertexId];
+		for(int32_t iEdge=edgeOffsets[oldVertexId]; iEdge<edgeOffsets[oldVertexId+1]; ++iEdge)
+		{
+			destVertices[iEdge] = outOldToNew[destVertices[iEdge]];
+		}
+		graph->vertexEdges[newVertexId].headBlock  = -1;
+		graph->vertexEdges[newVertexId].fullBlocks = -1;
+		graph->vertexDegrees[newVertexId] = 0;
+		iGraphAppendEdgesToList(graph, 0, newVertexId, destVertices + edgeOffsets[oldVertexId],
+			(NULL != weights) ? weights + edgeOffsets[oldVertexId] : NULL, degree);
+		graph->vertexData[newVertexId] = vertexData[newVertexId];
+		graph->validVertexIds[newVertexId] = newVertexId;
+		graph->vertexIdToValidIndex[newVertexId] = newVertexId;
+	}
+	graph->nextFreeVertexId = (vertexCount < vertexCapacity) ? vertexCount : -1;
+	if (NULL != graph->vertexInEdges)
+	{
+		/* The in-edge lists are rebuilt after all the outgoing lists, so they don't interleave in the pool. */
+		for(int32_t newVertexId=0; newVertexId<vertexCount; ++newVertexId)
+		{
+			const int32_t oldVertexId = newToOld[newVertexId];
+			for(int32_t iEdge=edgeOffsets[oldVertexId]; iEdge<edgeOffsets[oldVertexId+1]; ++iEdge)
+			{
+				int added = iGraphAddEdgeToList(graph, 1, destVertices[iEdge], newVertexId, (NULL != weights) ? weights[iEdge] : 1);
+				ALGO_ASSERT(added);
+				ALGO_UNUSED(added);
+			}
+		}
+	}
+	return kAlgoErrorNone;
+}
+
+typedef struct AlgoGraphBfsStateImpl
+{
+	const void *thisBuffer;
+	size_t thisBufferSize;
+	AlgoGraphImpl *graph;
+	int32_t *isVertexDiscovered;
+	int32_t *isVertexProcessed;
+	int32_t *vertexParents;
+	int32_t *vertexLevels; /* distance from the nearest root, or -1 if undiscovered */
+	AlgoQueue vertexQueue;
+	int32_t *frontierBits; /* the current frontier, during bottom-up steps of algoGraphBfsDirectionOptimizing(); otherwise empty */
+	int32_t *touchedVertices; /* every vertex discovered since the last create/reset, in discovery order */
+	volatile int32_t touchedCount;
+	/* If a control callback stopped the search partway through a vertex's edges, this is where algoGraphBfsResume() picks up. */
+	int32_t resumeVertex; /* -1 if the search was not stopped partway through a vertex */
+	const AlgoGraphEdgeBlock *resumeBlock;
+	int32_t resumeBlockEdgeCount;
+	int32_t resumeEdgeIndex;
+	int32_t isPrefetching; /* kAlgoGraphBfsStatePrefetch */
+} AlgoGraphBfsStateImpl;
+AlgoError algoGraphBfsStateComputeBufferSize(size_t *outBufferSize, const AlgoGraph graph)
+{
+	return algoGraphBfsStateComputeBufferSizeWithFlags(outBufferSize, graph, kAlgoGraphBfsStateDefault);
+}
+AlgoError algoGraphBfsStateComputeBufferSizeWithFlags(size_t *outBufferSize, const AlgoGraph graph, uint32_t stateFlags)
+{
+	if (NULL == outBufferSize ||
+		NULL == graph ||
+		0 != (stateFlags & ~kAlgoGraphBfsStatePrefetch))
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	int32_t vertexCapacityRounded = (graph->vertexCapacity+31) & ~31;
+	size_t discoveredSize         = vertexCapacityRounded * sizeof(int32_t)  / 32;
+	size_t processedSize          = vertexCapacityRounded * sizeof(int32_t)  / 32;
+	size_t parentsSize            = graph->vertexCapacity * sizeof(int32_t);
+	size_t queueSize              = 0;
+	size_t frontierSize           = vertexCapacityRounded * sizeof(int32_t)  / 32;
+	size_t touchedSize            = graph->vertexCapacity * sizeof(int32_t);
+	size_t levelsSize             = graph->vertexCapacity * sizeof(int32_t);
+	AlgoError err;
+	err = algoQueueComputeBufferSize(&queueSize, graph->vertexCapacity);
+	if (kAlgoErrorNone != err)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outBufferSize = sizeof(AlgoGraphBfsStateImpl) + discoveredSize + processedSize + parentsSize + queueSize + frontierSize
+		+ touchedSize + levelsSize;
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphBfsStateCreate(AlgoGraphBfsState *outState, const AlgoGraph graph, void *buffer, size_t bufferSize)
+{
+	return algoGraphBfsStateCreateWithFlags(outState, graph, kAlgoGraphBfsStateDefault, buffer, bufferSize);
+}
+AlgoError algoGraphBfsStateCreateWithFlags(AlgoGraphBfsState *outState, const AlgoGraph graph, uint32_t stateFlags,
+	void *buffer, size_t bufferSize)
+{
+	if (NULL == outState ||
+		NULL == graph ||
+		NULL == buffer)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	size_t minBufferSize = 0;
+	AlgoError err;
+	uint8_t *bufferNext = (uint8_t*)buffer;
+	err = algoGraphBfsStateComputeBufferSizeWithFlags(&minBufferSize, graph, stateFlags);
+	if (bufferSize < minBufferSize ||
+		kAlgoErrorNone != err)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+
+	int32_t vertexCapacityRounded = (graph->vertexCapacity+31) & ~31;
+	size_t discoveredSize         = vertexCapacityRounded * sizeof(int32_t) / 32;
+	size_t processedSize          = vertexCapacityRounded * sizeof(int32_t)  / 32;
+	size_t parentsSize            = graph->vertexCapacity * sizeof(int32_t);
+	size_t queueSize              = 0;
+	size_t frontierSize           = vertexCapacityRounded * sizeof(int32_t)  / 32;
+	size_t touchedSize            = graph->vertexCapacity * sizeof(int32_t);
+	size_t levelsSize             = graph->vertexCapacity * sizeof(int32_t);
+
+	(*outState) = (AlgoGraphBfsStateImpl *)bufferNext;
+	bufferNext += sizeof(AlgoGraphBfsStateImpl);
+
+	int32_t *discovered = (int32_t*)bufferNext;
+	bufferNext += discoveredSize;
+
+	int32_t *processed = (int32_t*)bufferNext;
+	bufferNext += processedSize;
+
+	int32_t *parents = (int32_t*)bufferNext;
+	bufferNext += parentsSize;
+
+	err = algoQueueComputeBufferSize(&queueSize, graph->vertexCapacity);
+	if (kAlgoErrorNone != err)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	AlgoQueue vertexQueue;
+	err = algoQueueCreate(&vertexQueue, graph->vertexCapacity, bufferNext, queueSize);
+	if (kAlgoErrorNone != err)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	bufferNext += queueSize;
+
+	int32_t *frontier = (int32_t*)bufferNext;
+	bufferNext += frontierSize;
+
+	int32_t *touched = (int32_t*)bufferNext;
+	bufferNext += touchedSize;
+
+	int32_t *levels = (int32_t*)bufferNext;
+	bufferNext += levelsSize;
+
+	ALGO_ASSERT( bufferNext-minBufferSize == buffer ); /* If this fails, algoGraphBfsStateComputeBufferSizeWithFlags() is out of date */
+	(*outState)->thisBuffer         = buffer;
+(	 *outState)->thisBufferSize     = bufferSize;
+	(*outState)->graph              = graph;
+	(*outState)->isVertexDiscovered = discovered;
+	(*outState)->isVertexProcessed  = processed;
+	(*outState)->vertexParents      = parents;
+	(*outState)->vertexLevels       = levels;
+	(*outState)->vertexQueue        = vertexQueue;
+	(*outState)->frontierBits       = frontier;
+	(*outState)->touchedVertices    = touched;
+	(*outState)->touchedCount       = 0;
+	(*outState)->resumeVertex       = -1;
+	(*outState)->resumeBlock        = NULL;
+	(*outState)->isPrefetching      = (0 != (stateFlags & kAlgoGraphBfsStatePrefetch));
+
+	ALGO_MEMSET(discovered, 0, discoveredSize);
+	ALGO_MEMSET(processed,  0, processedSize);
+	ALGO_MEMSET(frontier,   0, frontierSize);
+	for(int iVertex=0; iVertex<graph->vertexCapacity; ++iVertex)
+	{
+		parents[iVertex] = -1;
+		levels[iVertex] = -1;
+	}
+	return kAlgoErrorNone;
+}
+
+AlgoError algoGraphBfsStateGetBufferSize(const AlgoGraphBfsState bfsState, size_t *outBufferSize)
+{
+	if (NULL == bfsState ||
+		NULL == outBufferSize)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outBufferSize = bfsState->thisBufferSize;
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphBfsStateReset(AlgoGraphBfsState bfsState)
+{
+	if (NULL == bfsState)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	/* Every bit and parent written by a search belongs to a discovered vertex, and every discovered vertex is in touchedVertices[].
+	   The frontier bitmap is already empty when a search returns, as is the queue unless the search was stopped. Clearing
+	   whole words is safe, since every other bit in the word was either cleared already or belongs to another touched vertex. */
+	int32_t queueSize = 0;
+	algoQueueGetCurrentSize(bfsState->vertexQueue, &queueSize);
+	for(; queueSize > 0; --queueSize)
+	{
+		AlgoData queueElem;
+		algoQueueRemove(bfsState->vertexQueue, &queueElem);
+	}
+	bfsState->resumeVertex = -1;
+	bfsState->resumeBlock = NULL;
+	const int32_t touchedCount = bfsState->touchedCount;
+	for(int32_t iTouched=0; iTouched<touchedCount; ++iTouched)
+	{
+		const int32_t v = bfsState->touchedVertices[iTouched];
+		bfsState->isVertexDiscovered[v/32] = 0;
+		bfsState->isVertexProcessed[v/32] = 0;
+		bfsState->vertexParents[v] = -1;
+		bfsState->vertexLevels[v] = -1;
+	}
+	bfsState->touchedCount = 0;
+	return kAlgoErrorNone;
+}
+
+AlgoError algoGraphBfsStateIsVertexDiscovered(const AlgoGraphBfsState bfsState, int32_t vertexId, int *outIsDiscovered)
+{
+	if (NULL == bfsState ||
+		NULL == outIsDiscovered ||
+		vertexId < 0 || vertexId >= bfsState->graph->vertexCapacity)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outIsDiscovered = iTestBit(bfsState->isVertexDiscovered, bfsState->graph->vertexCapacity, vertexId);
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphBfsStateIsVertexProcessed(const AlgoGraphBfsState bfsState, int32_t vertexId, int *outIsProcessed)
+{
+	if (NULL == bfsState ||
+		NULL == outIsProcessed ||
+		vertexId < 0 || vertexId >= bfsState->graph->vertexCapacity)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outIsProcessed = iTestBit(bfsState->isVertexProcessed, bfsState->graph->vertexCapacity, vertexId);
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphBfsStateGetVertexParent(const AlgoGraphBfsState bfsState, int32_t vertexId, int32_t *outParentVertexId)
+{
+	if (NULL == bfsState ||
+		NULL == outParentVertexId ||
+		!iGraphIsValidVertexId(bfsState->graph, vertexId))
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outParentVertexId = bfsState->vertexParents[vertexId];
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphBfsStateGetVertexLevel(const AlgoGraphBfsState bfsState, int32_t vertexId, int32_t *outLevel)
+{
+	if (NULL == bfsState ||
+		NULL == outLevel ||
+		!iGraphIsValidVertexId(bfsState->graph, vertexId))
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outLevel = bfsState->vertexLevels[vertexId];
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphBfsStateGetLevels(const AlgoGraphBfsState bfsState, const int32_t **outLevels, int32_t *outVertexCount)
+{
+	if (NULL == bfsState ||
+		NULL == outLevels ||
+		NULL == outVertexCount)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outLevels = bfsState->vertexLevels;
+	*outVertexCount = bfsState->graph->vertexCapacity;
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphBfsStateGetParents(const AlgoGraphBfsState bfsState, const int32_t **outParents, int32_t *outVertexCount)
+{
+	if (NULL == bfsState ||
+		NULL == outParents ||
+		NULL == outVertexCount)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outParents = bfsState->vertexParents;
+	*outVertexCount = bfsState->graph->vertexCapacity;
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphBfsStateGetPath(const AlgoGraphBfsState bfsState, int32_t targetVertexId, int32_t outPath[],
+	int32_t pathCapacity, int32_t *outPathLength)
+{
+	if (NULL == bfsState ||
+		!iGraphIsValidVertexId(bfsState->graph, targetVertexId) ||
+		NULL == outPath ||
+		NULL == outPathLength)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	/* The target's level gives the path length up front, so the path can be written back-to-front in a single pass. */
+	const int32_t pathLength = bfsState->vertexLevels[targetVertexId] + 1;
+	*outPathLength = pathLength;
+	if (pathLength > pathCapacity)
+	{
+		return kAlgoErrorOperationFailed;
+	}
+	int32_t v = targetVertexId;
+	for(int32_t iPath=pathLength-1; iPath>=0; --iPath)
+	{
+		outPath[iPath] = v;
+		v = bfsState->vertexParents[v];
+	}
+	ALGO_ASSERT(pathLength == 0 || v < 0); /* the path must start at a root */
+	return kAlgoErrorNone;
+}
+
+
+#define kAlgoGraphBfsPrefetchDistance 8 /* queue positions between each stage of iGraphBfsPrefetch() */
+/* Called whenever a BFS with kAlgoGraphBfsStatePrefetch pops a vertex. Each vertex in the queue passes every position
+   once, so it is prefetched in three stages, each of which only dereferences what the stage before it brought into the
+   cache: its edge list head, degree and level at 3*kAlgoGraphBfsPrefetchDistance places behind the head of the queue, its
+   head edge block at 2*kAlgoGraphBfsPrefetchDistance, and its neighbors' visited bits, parents and levels (which are
+   written if they are discovered) at kAlgoGraphBfsPrefetchDistance. */
+ALGO_INTERNAL void iGraphBfsPrefetch(const AlgoGraph graph, const AlgoGraphBfsState bfsState)
+{
+	const AlgoQueueImpl *queue = bfsState->vertexQueue;
+	const int32_t queueSize = (queue->tail - queue->head + queue->nodeCount) % queue->nodeCount;
+	if (queueSize > 3*kAlgoGraphBfsPrefetchDistance)
+	{
+		const int32_t v = queue->nodes[(queue->head + 3*kAlgoGraphBfsPrefetchDistance) % queue->nodeCount].asInt;
+		iPrefetch(graph->vertexEdges + v);
+		iPrefetch(graph->vertexDegrees + v);
+		iPrefetch(bfsState->vertexLevels + v);
+	}
+	if (queueSize > 2*kAlgoGraphBfsPrefetchDistance)
+	{
+		const int32_t v = queue->nodes[(queue->head + 2*kAlgoGraphBfsPrefetchDistance) % queue->nodeCount].asInt;
+		iPrefetch(iGraphEdgeListHead(graph, graph->vertexEdges + v));
+	}
+	if (queueSize > kAlgoGraphBfsPrefetchDistance)
+	{
+		const int32_t v = queue->nodes[(queue->head + kAlgoGraphBfsPrefetchDistance) % queue->nodeCount].asInt;
+		const AlgoGraphEdgeBlock *block = iGraphEdgeListHead(graph, graph->vertexEdges + v);
+		const int32_t blockEdgeCount = iGraphHeadBlockEdgeCount(graph->vertexDegrees[v]);
+		for(int32_t iEdge=0; iEdge<blockEdgeCount; ++iEdge)
+		{
+			const int32_t v1 = block->destVertices[iEdge];
+			iPrefetch(bfsState->isVertexProcessed + v1/32);
+			iPrefetch(bfsState->isVertexDiscovered + v1/32);
+			iPrefetch(bfsState->vertexParents + v1);
+			iPrefetch(bfsState->vertexLevels + v1);
+		}
+		if (graph->vertexEdges[v].fullBlocks >= 0)
+			iPrefetch(iGraphEdgeBlockAt(graph, graph->vertexEdges[v].fullBlocks));
+	}
+}
+/* Shared by algoGraphBfs(), algoGraphBfsMulti() and algoGraphBfsResume(). Arguments must already be validated. */
+ALGO_INTERNAL AlgoError iGraphBfs(const AlgoGraph graph, AlgoGraphBfsState bfsState, int32_t rootCount, const int32_t rootVertexIds[],
+	AlgoGraphBfsCallbacks callbacks)
+{
+	int32_t vertexCapacityRounded = (graph->vertexCapacity+31) & ~31;
+	for(int32_t iRoot=0; iRoot<rootCount; ++iRoot)
+	{
+		const int32_t rootVertexId = rootVertexIds[iRoot];
+		if (iTestBit(bfsState->isVertexDiscovered, vertexCapacityRounded, rootVertexId))
+			continue;
+		algoQueueInsert(bfsState->vertexQueue, algoDataFromInt(rootVertexId));
+		iSetBit(bfsState->isVertexDiscovered, vertexCapacityRounded, rootVertexId);
+		bfsState->vertexLevels[rootVertexId] = 0;
+		bfsState->touchedVertices[bfsState->touchedCount++] = rootVertexId;
+	}
+	for(;;)
+	{
+		int32_t v0 = bfsState->resumeVertex;
+		const AlgoGraphEdgeBlock *block = NULL;
+		int32_t blockEdgeCount = 0, firstEdge = 0;
+		if (v0 >= 0)
+		{
+			/* Pick up partway through the edges of the vertex where the search was stopped. */
+			block = bfsState->resumeBlock;
+			blockEdgeCount = bfsState->resumeBlockEdgeCount;
+			firstEdge = bfsState->resumeEdgeIndex;
+			bfsState->resumeVertex = -1;
+		}
+		else
+		{
+			AlgoData queueElem;
+			int32_t currentQueueSize = 0;
+			algoQueueGetCurrentSize(bfsState->vertexQueue, &currentQueueSize);
+			if (0 == currentQueueSize)
+				break;
+			/* Pop the next vertex and process it. */
+			algoQueueRemove(bfsState->vertexQueue, &queueElem);
+			v0 = queueElem.asInt;
+			ALGO_ASSERT( 1 == iGraphIsValidVertexId(graph, v0) );
+			if (bfsState->isPrefetching)
+				iGraphBfsPrefetch(graph, bfsState);
+			if (NULL != callbacks.vertexFuncEarly)
+				callbacks.vertexFuncEarly(graph, bfsState, v0, callbacks.vertexFuncEarlyUserData);
+			ALGO_ASSERT(0 == iTestBit(bfsState->isVertexProcessed, vertexCapacityRounded, v0));
+			iSetBit(bfsState->isVertexProcessed, vertexCapacityRounded, v0); /* must be set here to prevent undirected edges from looping infinitely. */
+			block = iGraphEdgeListHead(graph, graph->vertexEdges + v0);
+			blockEdgeCount = iGraphHeadBlockEdgeCount(graph->vertexDegrees[v0]);
+			if (NULL != callbacks.vertexControlFunc)
+			{
+				AlgoGraphSearchControl control = callbacks.vertexControlFunc(graph, bfsState, v0, callbacks.vertexControlFuncUserData);
+				if (kAlgoGraphSearchStop == control)
+				{
+					bfsState->resumeVertex = v0;
+					bfsState->resumeBlock = block;
+					bfsState->resumeBlockEdgeCount = blockEdgeCount;
+					bfsState->resumeEdgeIndex = 0;
+					return kAlgoErrorNone;
+				}
+				else if (kAlgoGraphSearchSkip == control)
+				{
+					block = NULL;
+				}
+			}
+		}
+		/* Explore v0's edges. */
+		for(; NULL != block; block = iGraphNextEdgeBlock(graph, graph->vertexEdges + v0, block),
+			blockEdgeCount = kAlgoGraphEdgeBlockCapacity, firstEdge = 0)
+		{
+			int32_t iEdge;
+			for(iEdge=firstEdge; iEdge<blockEdgeCount; ++iEdge)
+			{
+				int32_t v1 = block->destVertices[iEdge];
+				AlgoGraphSearchControl control = kAlgoGraphSearchContinue;
+				ALGO_ASSERT( 1 == iGraphIsValidVertexId(graph, v1) );
+				/* Run the edge functions, if this is the first time we've seen it. */
+				if (0 == iTestBit(bfsState->isVertexProcessed, vertexCapacityRounded, v1) ||
+					graph->edgeMode == kAlgoGraphEdgeDirected)
+				{
+					if (NULL != callbacks.edgeFunc)
+						callbacks.edgeFunc(graph, bfsState, v0, v1, callbacks.edgeFuncUserData);
+					if (NULL != callbacks.edgeControlFunc)
+						control = callbacks.edgeControlFunc(graph, bfsState, v0, v1, callbacks.edgeControlFuncUserData);
+				}
+				/* Enqueue v1, if we haven't seen it before. */
+				if (kAlgoGraphSearchSkip != control &&
+					0 == iTestBit(bfsState->isVertexDiscovered, vertexCapacityRounded, v1))
+				{
+					ALGO_ASSERT(0 == iTestBit(bfsState->isVertexProcessed, vertexCapacityRounded, v1));
+					iSetBit(bfsState->isVertexDiscovered, vertexCapacityRounded, v1);
+					algoQueueInsert(bfsState->vertexQueue, algoDataFromInt(v1));
+					bfsState->vertexParents[v1] = v0;
+					bfsState->vertexLevels[v1] = bfsState->vertexLevels[v0] + 1;
+					bfsState->touchedVertices[bfsState->touchedCount++] = v1;
+				}
+				if (kAlgoGraphSearchStop == control)
+				{
+					bfsState->resumeVertex = v0;
+					bfsState->resumeBlock = block;
+					bfsState->resumeBlockEdgeCount = blockEdgeCount;
+					bfsState->resumeEdgeIndex = iEdge+1;
+					return kAlgoErrorNone;
+				}
+			}
+		}
+		/* Run the late vertex function after all edges are processed. */
+		if (NULL != callbacks.vertexFuncLate)
+			callbacks.vertexFuncLate(graph, bfsState, v0, callbacks.vertexFuncLateUserData);
+	}
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphBfs(const AlgoGraph graph, AlgoGraphBfsState bfsState, int32_t rootVertexId, AlgoGraphBfsCallbacks callbacks)
+{
+	if (NULL == graph ||
+		NULL == bfsState ||
+		graph != bfsState->graph ||
+		0 == iGraphIsValidVertexId(graph, rootVertexId))
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	return iGraphBfs(graph, bfsState, 1, &rootVertexId, callbacks);
+}
+AlgoError algoGraphBfsMulti(const AlgoGraph graph, AlgoGraphBfsState bfsState, int32_t rootCount, const int32_t rootVertexIds[],
+	AlgoGraphBfsCallbacks callbacks)
+{
+	if (NULL == graph ||
+		NULL == bfsState ||
+		graph != bfsState->graph ||
+		rootCount < 0 ||
+		(rootCount > 0 && NULL == rootVertexIds))
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	for(int32_t iRoot=0; iRoot<rootCount; ++iRoot)
+	{
+		if (0 == iGraphIsValidVertexId(graph, rootVertexIds[iRoot]))
+		{
+			return kAlgoErrorInvalidArgument;
+		}
+	}
+	return iGraphBfs(graph, bfsState, rootCount, rootVertexIds, callbacks);
+}
+AlgoError algoGraphBfsResume(const AlgoGraph graph, AlgoGraphBfsState bfsState, AlgoGraphBfsCallbacks callbacks)
+{
+	if (NULL == graph ||
+		NULL == bfsState ||
+		graph != bfsState->graph)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	return iGraphBfs(graph, bfsState, 0, NULL, callbacks);
+}
+
+AlgoError algoGraphBfsDirectionOptimizing(const AlgoGraph graph, AlgoGraphBfsState bfsState, int32_t rootVertexId,
+	int32_t alpha, int32_t beta)
+{
+	if (NULL == graph ||
+		NULL == bfsState ||
+		graph != bfsState->graph ||
+		0 == iGraphIsValidVertexId(graph, rootVertexId) ||
+		alpha < 0 ||
+		beta < 0)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	if (0 == alpha)
+		alpha = kAlgoGraphBfsDefaultAlpha;
+	if (0 == beta)
+		beta = kAlgoGraphBfsDefaultBeta;
+	const int32_t nodesPerEdge = (graph->edgeMode == kAlgoGraphEdgeDirected) ? 1 : 2; /* undirected edges store two nodes: x->y and y->x */
+	/* Bottom-up steps walk each undiscovered vertex's incoming edges: the in-edge lists of a directed graph, or the ordinary
+	   lists of an undirected graph, where every edge is stored in both directions. */
+	const int bottomUpIsInList = (graph->edgeMode == kAlgoGraphEdgeDirected) ? 1 : 0;
+	const int canSearchBottomUp = !bottomUpIsInList || NULL != graph->vertexInEdges;
+	const AlgoGraphEdgeList *inEdgeLists = canSearchBottomUp ? iGraphEdgeLists(graph, bottomUpIsInList) : NULL;
+	const int32_t *inDegrees = canSearchBottomUp ? iGraphEdgeListDegrees(graph, bottomUpIsInList) : graph->vertexDegrees;
+	int32_t vertexCapacityRounded = (graph->vertexCapacity+31) & ~31;
+	const int32_t wordCount = vertexCapacityRounded / 32;
+	int32_t *discovered = bfsState->isVertexDiscovered;
+	int32_t *frontierBits = bfsState->frontierBits;
+	int32_t *touched = bfsState->touchedVertices;
+
+	/* Beamer's heuristic compares the number of edges leaving the frontier with the number of edges entering
+	   undiscovered vertices, which are the edges a top-down and a bottom-up step would (at most) check. */
+	int64_t unexploredEdgeCount = (int64_t)graph->currentEdgeCount * nodesPerEdge - inDegrees[rootVertexId];
+	int64_t frontierEdgeCount = graph->vertexDegrees[rootVertexId];
+	int32_t previousFrontierSize = 0;
+	int isBottomUp = 0;
+	iSetBit(discovered, vertexCapacityRounded, rootVertexId);
+	bfsState->vertexLevels[rootVertexId] = 0;
+	/* Vertices are appended to touchedVertices[] in the order they're discovered, one level after another, so the current
+	   frontier is always the range [levelBegin, touchedCount) of the previous level's discoveries. */
+	int32_t levelBegin = bfsState->touchedCount;
+	touched[bfsState->touchedCount++] = rootVertexId;
+	while(levelBegin < bfsState->touchedCount)
+	{
+		const int32_t levelEnd = bfsState->touchedCount;
+		const int32_t frontierSize = levelEnd - levelBegin;
+		const int isGrowing = (frontierSize > previousFrontierSize);
+		if (!isBottomUp)
+			isBottomUp = canSearchBottomUp && isGrowing && frontierEdgeCount > unexploredEdgeCount / alpha;
+		else
+			isBottomUp = isGrowing || (int64_t)frontierSize * beta >= graph->currentVertexCount;
+		int64_t nextFrontierEdgeCount = 0;
+		if (!isBottomUp)
+		{
+			/* Top-down: every frontier vertex claims its undiscovered neighbors. */
+			for(int32_t iQueue=levelBegin; iQueue<levelEnd; ++iQueue)
+			{
+				const int32_t v0 = touched[iQueue];
+				const AlgoGraphEdgeList *edgeList = graph->vertexEdges + v0;
+				const AlgoGraphEdgeBlock *block = iGraphEdgeListHead(graph, edgeList);
+				int32_t blockEdgeCount = iGraphHeadBlockEdgeCount(graph->vertexDegrees[v0]);
+				for(; NULL != block; block = iGraphNextEdgeBlock(graph, edgeList, block), blockEdgeCount = kAlgoGraphEdgeBlockCapacity)
+				{
+					int32_t iEdge;
+					for(iEdge=0; iEdge<blockEdgeCount; ++iEdge)
+					{
+						const int32_t v1 = block->destVertices[iEdge];
+						if (0 == iTestBit(discovered, vertexCapacityRounded, v1))
+						{
+							iSetBit(discovered, vertexCapacityRounded, v1);
+							bfsState->vertexParents[v1] = v0;
+							bfsState->vertexLevels[v1] = bfsState->vertexLevels[v0] + 1;
+							touched[bfsState->touchedCount++] = v1;
+							nextFrontierEdgeCount += graph->vertexDegrees[v1];
+							unexploredEdgeCount -= inDegrees[v1];
+						}
+					}
+				}
+			}
+		}
+		else
+		{
+			/* Bottom-up: every undiscovered vertex looks for a parent in the frontier, which is marked in a bitmap for the
+			   duration of the step. Undiscovered vertices are found a word of the discovered bitmap at a time. */
+			for(int32_t iQueue=levelBegin; iQueue<levelEnd; ++iQueue)
+			{
+				iSetBit(frontierBits, vertexCapacityRounded, touched[iQueue]);
+			}
+			for(int32_t iWord=0; iWord<wordCount; ++iWord)
+			{
+				uint32_t bits = ~(uint32_t)discovered[iWord];
+				for(; 0 != bits; bits &= bits-1)
+				{
+					const int32_t v0 = iWord*32 + iLowestBit64(bits);
+					if (v0 >= graph->vertexCapacity ||
+						inDegrees[v0] <= 0)
+					{
+						continue; /* invalid vertices and vertices without incoming edges have nothing to check */
+					}
+					const AlgoGraphEdgeList *edgeList = inEdgeLists + v0;
+					const AlgoGraphEdgeBlock *block = iGraphEdgeListHead(graph, edgeList);
+					int32_t blockEdgeCount = iGraphHeadBlockEdgeCount(inDegrees[v0]);
+					int32_t parent = -1;
+					for(; NULL != block && parent < 0; block = iGraphNextEdgeBlock(graph, edgeList, block), blockEdgeCount = kAlgoGraphEdgeBlockCapacity)
+					{
+						int32_t iEdge;
+						for(iEdge=0; iEdge<blockEdgeCount; ++iEdge)
+						{
+							/* stop at the first neighbor in the frontier. */
+							if (iTestBit(frontierBits, vertexCapacityRounded, block->destVertices[iEdge]))
+							{
+								parent = block->destVertices[iEdge];
+								break;
+							}
+						}
+					}
+					if (parent >= 0)
+					{
+						iSetBit(discovered, vertexCapacityRounded, v0);
+						bfsState->vertexParents[v0] = parent;
+						bfsState->vertexLevels[v0] = bfsState->vertexLevels[parent] + 1;
+						touched[bfsState->touchedCount++] = v0;
+						nextFrontierEdgeCount += graph->vertexDegrees[v0];
+						unexploredEdgeCount -= inDegrees[v0];
+					}
+				}
+			}
+			for(int32_t iQueue=levelBegin; iQueue<levelEnd; ++iQueue)
+			{
+				iClearBit(frontierBits, vertexCapacityRounded, touched[iQueue]);
+			}
+		}
+		/* The current level is now fully processed; the next level becomes the frontier. */
+		for(int32_t iQueue=levelBegin; iQueue<levelEnd; ++iQueue)
+		{
+			iSetBit(bfsState->isVertexProcessed, vertexCapacityRounded, touched[iQueue]);
+		}
+		frontierEdgeCount = nextFrontierEdgeCount;
+		previousFrontierSize = frontierSize;
+		levelBegin = levelEnd;
+	}
+	return kAlgoErrorNone;
+}
+
+#define kAlgoGraphBfsParallelChunkSize 64 /* frontier vertices claimed by a thread at a time */
+#define kAlgoGraphBfsParallelLocalCapacity 256 /* newly-discovered vertices buffered by each thread before merging */
+typedef struct AlgoGraphBfsParallelImpl
+{
+	const void *thisBuffer;
+	size_t thisBufferSize;
+	AlgoGraphImpl *graph;
+	AlgoGraphBfsStateImpl *bfsState;
+	int32_t threadCount;
+	int32_t *levelVertices[2]; /* the current and next frontier; the current level's frontier is levelVertices[level%2] */
+	volatile int32_t levelSizes[2];
+	volatile int32_t nextChunk; /* index of the next unclaimed vertex in the current frontier */
+	IBarrier barrier;
+	int32_t *localVertices; /* kAlgoGraphBfsParallelLocalCapacity elements per thread */
+} AlgoGraphBfsParallelImpl;
+
+AlgoError algoGraphBfsParallelComputeBufferSize(size_t *outBufferSize, const AlgoGraph graph, int32_t threadCount)
+{
+	if (NULL == outBufferSize ||
+		NULL == graph ||
+		threadCount <= 0)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	size_t levelSize = graph->vertexCapacity * sizeof(int32_t);
+	size_t localSize = threadCount * kAlgoGraphBfsParallelLocalCapacity * sizeof(int32_t);
+	*outBufferSize = sizeof(AlgoGraphBfsParallelImpl) + 2*levelSize + localSize;
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphBfsParallelCreate(AlgoGraphBfsParallel *outSearch, const AlgoGraph graph, AlgoGraphBfsState bfsState,
+	int32_t rootVertexId, int32_t threadCount, void *buffer, size_t bufferSize)
+{
+	if (NULL == outSearch ||
+		NULL == graph ||
+		NULL == bfsState ||
+		graph != bfsState->graph ||
+		0 == iGraphIsValidVertexId(graph, rootVertexId) ||
+		NULL == buffer)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	size_t minBufferSize = 0;
+	AlgoError err;
+	uint8_t *bufferNext = (uint8_t*)buffer;
+	err = algoGraphBfsParallelComputeBufferSize(&minBufferSize, graph, threadCount);
+	if (bufferSize < minBufferSize ||
+		kAlgoErrorNone != err)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+
+	size_t levelSize = graph->vertexCapacity * sizeof(int32_t);
+	size_t localSize = threadCount * kAlgoGraphBfsParallelLocalCapacity * sizeof(int32_t);
+
+	(*outSearch) = (AlgoGraphBfsParallelImpl*)bufferNext;
+	bufferNext += sizeof(AlgoGraphBfsParallelImpl);
+
+	int32_t *levelVertices0 = (int32_t*)bufferNext;
+	bufferNext += levelSize;
+
+	int32_t *levelVertices1 = (int32_t*)bufferNext;
+	bufferNext += levelSize;
+
+	int32_t *localVertices = (int32_t*)bufferNext;
+	bufferNext += localSize;
+
+	ALGO_ASSERT( bufferNext-minBufferSize == buffer ); /* If this fails, algoGraphBfsParallelComputeBufferSize() is out of date */
+	(*outSearch)->thisBuffer       = buffer;
+	(*outSearch)->thisBufferSize   = bufferSize;
+	(*outSearch)->graph            = graph;
+	(*outSearch)->bfsState         = bfsState;
+	(*outSearch)->threadCount      = threadCount;
+	(*outSearch)->levelVertices[0] = levelVertices0;
+	(*outSearch)->levelVertices[1] = levelVertices1;
+	(*outSearch)->levelSizes[0]    = 1;
+	(*outSearch)->levelSizes[1]    = 0;
+	(*outSearch)->nextChunk        = 0;
+	(*outSearch)->localVertices    = localVertices;
+	iBarrierInit(&(*outSearch)->barrier, threadCount);
+
+	int32_t vertexCapacityRounded = (graph->vertexCapacity+31) & ~31;
+	levelVertices0[0] = rootVertexId;
+	iSetBit(bfsState->isVertexDiscovered, vertexCapacityRounded, rootVertexId);
+	bfsState->vertexLevels[rootVertexId] = 0;
+	bfsState->touchedVertices[bfsState->touchedCount++] = rootVertexId;
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphBfsParallelGetBufferSize(const AlgoGraphBfsParallel search, size_t *outBufferSize)
+{
+	if (NULL == search ||
+		NULL == outBufferSize)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outBufferSize = search->thisBufferSize;
+	return kAlgoErrorNone;
+}
+
+/* Appends this thread's buffered vertices to the next level's frontier, and to the state's list of touched vertices. */
+ALGO_INTERNAL void iGraphBfsParallelFlush(AlgoGraphBfsParallel search, int32_t nextLevelIndex, const int32_t *localVertices,
+	int32_t localCount)
+{
+	if (0 == localCount)
+		return;
+	int32_t firstIndex = iAtomicFetchAdd32(&search->levelSizes[nextLevelIndex], localCount);
+	ALGO_ASSERT(firstIndex + localCount <= search->graph->vertexCapacity);
+	ALGO_MEMCPY(search->levelVertices[nextLevelIndex] + firstIndex, localVertices, localCount*sizeof(int32_t));
+	int32_t firstTouched = iAtomicFetchAdd32(&search->bfsState->touchedCount, localCount);
+	ALGO_ASSERT(firstTouched + localCount <= search->graph->vertexCapacity);
+	ALGO_MEMCPY(search->bfsState->touchedVertices + firstTouched, localVertices, localCount*sizeof(int32_t));
+}
+
+AlgoError algoGraphBfsParallel(AlgoGraphBfsParallel search, int32_t threadIndex)
+{
+	if (NULL == search ||
+		threadIndex < 0 || threadIndex >= search->threadCount)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	AlgoGraphImpl *graph = search->graph;
+	AlgoGraphBfsStateImpl *bfsState = search->bfsState;
+	int32_t *localVertices = search->localVertices + threadIndex*kAlgoGraphBfsParallelLocalCapacity;
+	int32_t levelIndex = 0;
+	for(;;)
+	{
+		const int32_t nextLevelIndex = levelIndex ^ 1;
+		const int32_t levelSize = search->levelSizes[levelIndex];
+		const int32_t *levelVertices = search->levelVertices[levelIndex];
+		int32_t localCount = 0;
+		int32_t chunkBegin;
+		while( (chunkBegin = iAtomicFetchAdd32(&search->nextChunk, kAlgoGraphBfsParallelChunkSize)) < levelSize )
+		{
+			const int32_t chunkEnd = (chunkBegin + kAlgoGraphBfsParallelChunkSize < levelSize)
+				? chunkBegin + kAlgoGraphBfsParallelChunkSize : levelSize;
+			int32_t iVert;
+			for(iVert=chunkBegin; iVert<chunkEnd; ++iVert)
+			{
+				const int32_t v0 = levelVertices[iVert];
+				ALGO_ASSERT( 1 == iGraphIsValidVertexId(graph, v0) );
+				iAtomicFetchOr32(bfsState->isVertexProcessed + v0/32, 1<<(v0%32));
+				const AlgoGraphEdgeList *edgeList = graph->vertexEdges + v0;
+				const AlgoGraphEdgeBlock *block = iGraphEdgeListHead(graph, edgeList);
+				int32_t blockEdgeCount = iGraphHeadBlockEdgeCount(graph->vertexDegrees[v0]);
+				for(; NULL != block; block = iGraphNextEdgeBlock(graph, edgeList, block), blockEdgeCount = kAlgoGraphEdgeBlockCapacity)
+				{
+					int32_t iEdge;
+					for(iEdge=0; iEdge<blockEdgeCount; ++iEdge)
+					{
+						const int32_t v1 = block->destVertices[iEdge];
+						const int32_t mask = 1<<(v1%32);
+						volatile int32_t *discoveredWord = bfsState->isVertexDiscovered + v1/32;
+						/* Test before claiming, so that already-discovered vertices don't cost an atomic operation. */
+						if (0 != (*discoveredWord & mask) ||
+							0 != (iAtomicFetchOr32(discoveredWord, mask) & mask))
+						{
+							continue;
+						}
+						bfsState->vertexParents[v1] = v0;
+						bfsState->vertexLevels[v1] = bfsState->vertexLevels[v0] + 1;
+						if (localCount == kAlgoGraphBfsParallelLocalCapacity)
+						{
+							iGraphBfsParallelFlush(search, nextLevelIndex, localVertices, localCount);
+							localCount = 0;
+						}
+						localVertices[localCount++] = v1;
+					}
+				}
+			}
+		}
+		iGraphBfsParallelFlush(search, nextLevelIndex, localVertices, localCount);
+		iBarrierWait(&search->barrier);
+		/* The next level is complete. Once every thread has read its size, thread 0 recycles the current level's
+		   storage for the level after it. */
+		if (0 == search->levelSizes[nextLevelIndex])
+			break;
+		if (0 == threadIndex)
+		{
+			search->levelSizes[levelIndex] = 0;
+			search->nextChunk = 0;
+		}
+		iBarrierWait(&search->barrier);
+		levelIndex = nextLevelIndex;
+	}
+	return kAlgoErrorNone;
+}
+
+AlgoError algoGraphMultiSourceBfsComputeBufferSize(size_t *outBufferSize, const AlgoGraph graph)
+{
+	if (NULL == outBufferSize ||
+		NULL == graph)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	size_t seenSize      = graph->vertexCapacity * sizeof(uint64_t);
+	size_t visitSize     = graph->vertexCapacity * sizeof(uint64_t);
+	size_t visitNextSize = graph->vertexCapacity * sizeof(uint64_t);
+	*outBufferSize = seenSize + visitSize + visitNextSize;
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphMultiSourceBfs(const AlgoGraph graph, const int32_t rootVertexIds[], int32_t rootCount, int32_t outDistances[],
+	void *buffer, size_t bufferSize)
+{
+	if (NULL == graph ||
+		NULL == rootVertexIds ||
+		rootCount < 0 ||
+		NULL == outDistances ||
+		NULL == buffer)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	size_t minBufferSize = 0;
+	AlgoError err = algoGraphMultiSourceBfsComputeBufferSize(&minBufferSize, graph);
+	if (bufferSize < minBufferSize ||
+		kAlgoErrorNone != err)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	for(int32_t iRoot=0; iRoot<rootCount; ++iRoot)
+	{
+		if (0 == iGraphIsValidVertexId(graph, rootVertexIds[iRoot]))
+			return kAlgoErrorInvalidArgument;
+	}
+	const int32_t vertexCapacity = graph->vertexCapacity;
+	/* Bit N of each vertex's word refers to root N of the current batch. */
+	uint64_t *seen      = (uint64_t*)buffer;
+	uint64_t *visit     = seen + vertexCapacity;
+	uint64_t *visitNext = visit + vertexCapacity;
+	for(size_t iDist=0; iDist<(size_t)rootCount*vertexCapacity; ++iDist)
+	{
+		outDistances[iDist] = -1;
+	}
+	for(int32_t batchBegin=0; batchBegin<rootCount; batchBegin += kAlgoGraphMultiSourceBfsBatchSize)
+	{
+		const int32_t batchSize = (rootCount-batchBegin < kAlgoGraphMultiSourceBfsBatchSize)
+			? rootCount-batchBegin : kAlgoGraphMultiSourceBfsBatchSize;
+		int32_t *batchDistances = outDistances + (size_t)batchBegin*vertexCapacity;
+		ALGO_MEMSET(seen,      0, vertexCapacity*sizeof(uint64_t));
+		ALGO_MEMSET(visit,     0, vertexCapacity*sizeof(uint64_t));
+		ALGO_MEMSET(visitNext, 0, vertexCapacity*sizeof(uint64_t));
+		for(int32_t iRoot=0; iRoot<batchSize; ++iRoot)
+		{
+			const int32_t rootVertexId = rootVertexIds[batchBegin+iRoot];
+			seen[rootVertexId]  |= (uint64_t)1 << iRoot;
+			visit[rootVertexId] |= (uint64_t)1 << iRoot;
+			batchDistances[(size_t)iRoot*vertexCapacity + rootVertexId] = 0;
+		}
+		int isFrontierEmpty = 0;
+		for(int32_t level=1; !isFrontierEmpty; ++level)
+		{
+			/* Each vertex passes the set of roots whose frontier contains it along all of its edges at once. */
+			for(int32_t v0=0; v0<vertexCapacity; ++v0)
+			{
+				const uint64_t roots = visit[v0];
+				if (0 == roots)
+					continue;
+				const AlgoGraphEdgeList *edgeList = graph->vertexEdges + v0;
+				const AlgoGraphEdgeBlock *block = iGraphEdgeListHead(graph, edgeList);
+				int32_t blockEdgeCount = iGraphHeadBlockEdgeCount(graph->vertexDegrees[v0]);
+				for(; NULL != block; block = iGraphNextEdgeBlock(graph, edgeList, block), blockEdgeCount = kAlgoGraphEdgeBlockCapacity)
+				{
+					int32_t iEdge;
+					for(iEdge=0; iEdge<blockEdgeCount; ++iEdge)
+					{
+						visitNext[block->destVertices[iEdge]] |= roots;
+					}
+				}
+			}
+			/* Keep only the roots that haven't reached each vertex yet; those form the next frontier. */
+			isFrontierEmpty = 1;
+			for(int32_t v1=0; v1<vertexCapacity; ++v1)
+			{
+				uint64_t newRoots = visitNext[v1] & ~seen[v1];
+				visitNext[v1] = 0;
+				visit[v1] = newRoots;
+				if (0 == newRoots)
+					continue;
+				isFrontierEmpty = 0;
+				seen[v1] |= newRoots;
+				for(; 0 != newRoots; newRoots &= newRoots-1)
+				{
+					batchDistances[(size_t)iLowestBit64(newRoots)*vertexCapacity + v1] = level;
+				}
+			}
+		}
+	}
+	return kAlgoErrorNone;
+}
+
+typedef union IGraphDfsCursor
+{
+	struct
+	{
+		const AlgoGraphEdgeBlock *block; /* block containing the next edge to visit in an AlgoGraph edge list */
+		int32_t nextIndex; /* index of the next edge to visit in block->destVertices[] */
+		int32_t blockEdgeCount; /* number of valid edges in block */
+	} list;
+	const int32_t *csrEdge; /* next destination to visit in an AlgoGraphCsr's destVertices[] */
+} IGraphDfsCursor;
+/* One vertex on the current path of a lightweight DFS, and its next edge to visit. A list cursor's block edge count isn't
+   stored; only a vertex's head block can be partially full. */
+typedef struct IGraphDfsFrame
+{
+	union
+	{
+		const AlgoGraphEdgeBlock *block; /* block containing the next edge to visit in an AlgoGraph edge list */
+		const int32_t *csrEdge; /* next destination to visit in an AlgoGraphCsr's destVertices[] */
+	} next;
+	int32_t vertexId; /* not discovered yet, if this frame was pushed just before the search was stopped */
+	int32_t nextIndex; /* index of the next edge to visit in next.block->destVertices[] */
+} IGraphDfsFrame;
+typedef struct AlgoGraphDfsStateImpl
+{
+	const void *thisBuffer;
+	size_t thisBufferSize;
+	int32_t currentTime;
+	AlgoGraphImpl *graph;
+	int32_t *isVertexDiscovered;
+	int32_t *isVertexProcessed;
+	int32_t *vertexParents;
+	int32_t *vertexEntryTime;
+	int32_t *vertexExitTime;
+	IGraphDfsCursor *vertexNextEdge; /* initialized when each vertex is discovered */
+	AlgoStack vertexStack;
+	int32_t *touchedVertices; /* every vertex discovered since the last create/reset, in discovery order */
+	int32_t touchedCount;
+	/* Lightweight states (kAlgoGraphDfsStateLightweight) use these instead of vertexStack, vertexNextEdge[] and everything
+	   else above that is indexed by vertex ID (which is left NULL). */
+	IGraphDfsFrame *frames;
+	int32_t frameCount;
+} AlgoGraphDfsStateImpl;
+AlgoError algoGraphDfsStateComputeBufferSize(size_t *outBufferSize, const AlgoGraph graph)
+{
+	return algoGraphDfsStateComputeBufferSizeWithFlags(outBufferSize, graph, kAlgoGraphDfsStateDefault);
+}
+AlgoError algoGraphDfsStateComputeBufferSizeWithFlags(size_t *outBufferSize, const AlgoGraph graph, uint32_t stateFlags)
+{
+	if (NULL == outBufferSize ||
+		NULL == graph ||
+		0 != (stateFlags & ~kAlgoGraphDfsStateLightweight))
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	int32_t vertexCapacityRounded = (graph->vertexCapacity+31) & ~31;
+	size_t discoveredSize         = vertexCapacityRounded * sizeof(int32_t)  / 32;
+	size_t processedSize          = vertexCapacityRounded * sizeof(int32_t)  / 32;
+	if (stateFlags & kAlgoGraphDfsStateLightweight)
+	{
+		size_t framesSize = graph->vertexCapacity * sizeof(IGraphDfsFrame);
+		*outBufferSize = sizeof(AlgoGraphDfsStateImpl) + discoveredSize + processedSize + framesSize;
+		return kAlgoErrorNone;
+	}
+	size_t parentsSize            = graph->vertexCapacity * sizeof(int32_t);
+	size_t entryTimeSize          = graph->vertexCapacity * sizeof(int32_t);
+	size_t exitTimeSize           = graph->vertexCapacity * sizeof(int32_t);
+	size_t nextEdgeSize           = graph->vertexCapacity * sizeof(IGraphDfsCursor);
+	size_t touchedSize            = graph->vertexCapacity * sizeof(int32_t);
+	size_t stackSize = 0;
+	algoStackComputeBufferSize(&stackSize, graph->vertexCapacity);
+	*outBufferSize = sizeof(AlgoGraphDfsStateImpl) + discoveredSize + processedSize + parentsSize
+		+ entryTimeSize + exitTimeSize + nextEdgeSize + stackSize + touchedSize;
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphDfsStateCreate(AlgoGraphDfsState *outState, const AlgoGraph graph, void *buffer, size_t bufferSize)
+{
+	return algoGraphDfsStateCreateWithFlags(outState, graph, kAlgoGraphDfsStateDefault, buffer, bufferSize);
+}
+AlgoError algoGraphDfsStateCreateWithFlags(AlgoGraphDfsState *outState, const AlgoGraph graph, uint32_t stateFlags,
+	void *buffer, size_t bufferSize)
+{
+	size_t minBufferSize = 0;
+	AlgoError err;
+	uint8_t *bufferNext = (uint8_t*)buffer;
+	if (NULL == outState ||
+		NULL == graph ||
+		NULL == buffer)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	err = algoGraphDfsStateComputeBufferSizeWithFlags(&minBufferSize, graph, stateFlags);
+	if (bufferSize < minBufferSize ||
+		kAlgoErrorNone != err)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+
+	const int isLightweight = (0 != (stateFlags & kAlgoGraphDfsStateLightweight));
+	int32_t vertexCapacityRounded = (graph->vertexCapacity+31) & ~31;
+	size_t discoveredSize         = vertexCapacityRounded * sizeof(int32_t)  / 32;
+	size_t processedSize          = vertexCapacityRounded * sizeof(int32_t)  / 32;
+	size_t parentsSize            = isLightweight ? 0 : graph->vertexCapacity * sizeof(int32_t);
+	size_t entryTimeSize          = isLightweight ? 0 : graph->vertexCapacity * sizeof(int32_t);
+	size_t exitTimeSize           = isLightweight ? 0 : graph->vertexCapacity * sizeof(int32_t);
+	size_t nextEdgeSize           = isLightweight ? 0 : graph->vertexCapacity * sizeof(IGraphDfsCursor);
+	size_t touchedSize            = isLightweight ? 0 : graph->vertexCapacity * sizeof(int32_t);
+	size_t framesSize             = isLightweight ? graph->vertexCapacity * sizeof(IGraphDfsFrame) : 0;
+	size_t stackSize              = 0;
+
+	*outState = (AlgoGraphDfsStateImpl *)bufferNext;
+	bufferNext += sizeof(AlgoGraphDfsStateImpl);
+
+	int32_t *discovered = (int32_t*)bufferNext;
+	bufferNext += discoveredSize;
+
+	int32_t *processed = (int32_t*)bufferNext;
+	bufferNext += processedSize;
+
+	int32_t *vertexParents = isLightweight ? NULL : (int32_t*)bufferNext;
+	bufferNext += parentsSize;
+
+	int32_t *entryTime = isLightweight ? NULL : (int32_t*)bufferNext;
+	bufferNext += entryTimeSize;
+
+	int32_t *exitTime = isLightweight ? NULL : (int32_t*)bufferNext;
+	bufferNext += exitTimeSize;
+
+	IGraphDfsCursor *vertexNextEdge = isLightweight ? NULL : (IGraphDfsCursor*)bufferNext;
+	bufferNext += nextEdgeSize;
+
+	AlgoStack vertexStack = NULL;
+	if (!isLightweight)
+	{
+		err = algoStackComputeBufferSize(&stackSize, graph->vertexCapacity);
+		err = algoStackCreate(&vertexStack, graph->vertexCapacity, bufferNext, stackSize);
+		bufferNext += stackSize;
+	}
+
+	int32_t *touched = isLightweight ? NULL : (int32_t*)bufferNext;
+	bufferNext += touchedSize;
+
+	IGraphDfsFrame *frames = isLightweight ? (IGraphDfsFrame*)bufferNext : NULL;
+	bufferNext += framesSize;
+
+	ALGO_ASSERT( bufferNext-minBufferSize == buffer ); /* If this fails, algoGraphDfsStateComputeBufferSizeWithFlags() is out of date */
+	(*outState)->thisBuffer         = buffer;
+	(*outState)->thisBufferSize     = bufferSize;
+	(*outState)->graph              = graph;
+	(*outState)->isVertexDiscovered = discovered;
+	(*outState)->isVertexProcessed  = processed;
+	(*outState)->vertexParents      = vertexParents;
+	(*outState)->vertexEntryTime    = entryTime;
+	(*outState)->vertexExitTime     = exitTime;
+	(*outState)->vertexNextEdge     = vertexNextEdge;
+	(*outState)->vertexStack        = vertexStack;
+	(*outState)->currentTime        = 0;
+	(*outState)->touchedVertices    = touched;
+	(*outState)->touchedCount       = 0;
+	(*outState)->frames             = frames;
+	(*outState)->frameCount         = 0;
+
+	ALGO_MEMSET(discovered, 0, discoveredSize);
+	ALGO_MEMSET(processed, 0, processedSize);
+	if (isLightweight)
+	{
+		return kAlgoErrorNone;
+	}
+	ALGO_MEMSET(entryTime, 0, entryTimeSize); /* TODO: lazily initialize just-in-time? Better for sparse graphs. */
+	ALGO_MEMSET(exitTime,  0, exitTimeSize); /* TODO: lazily initialize just-in-time? Better for sparse graphs. */
+	for(int iVertex=0; iVertex<graph->vertexCapacity; ++iVertex)
+	{
+		vertexParents[iVertex] = -1;
+	}
+	return kAlgoErrorNone;
+}
+
+AlgoError algoGraphDfsStateGetBufferSize(const AlgoGraphDfsState dfsState, size_t *outBufferSize)
+{
+	if (NULL == dfsState ||
+		NULL == outBufferSize)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outBufferSize = dfsState->thisBufferSize;
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphDfsStateReset(AlgoGraphDfsState dfsState)
+{
+	if (NULL == dfsState)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	if (NULL != dfsState->frames)
+	{
+		/* Lightweight states don't keep a touched-vertex list, so just clear the bitmaps. */
+		const int32_t vertexCapacityRounded = (dfsState->graph->vertexCapacity+31) & ~31;
+		ALGO_MEMSET(dfsState->isVertexDiscovered, 0, vertexCapacityRounded * sizeof(int32_t) / 32);
+		ALGO_MEMSET(dfsState->isVertexProcessed,  0, vertexCapacityRounded * sizeof(int32_t) / 32);
+		dfsState->frameCount = 0;
+		return kAlgoErrorNone;
+	}
+	/* As in algoGraphBfsStateReset(), only touched vertices have anything to clear. vertexNextEdge[] is initialized on discovery,
+	   so it can be left alone. The stack is empty unless the search was stopped, in which case its top vertex may have a
+	   parent without having been discovered yet. */
+	AlgoData stackElem;
+	while(kAlgoErrorNone == algoStackPop(dfsState->vertexStack, &stackElem))
+	{
+		dfsState->vertexParents[stackElem.asInt] = -1;
+	}
+	for(int32_t iTouched=0; iTouched<dfsState->touchedCount; ++iTouched)
+	{
+		const int32_t v = dfsState->touchedVertices[iTouched];
+		dfsState->isVertexDiscovered[v/32] = 0;
+		dfsState->isVertexProcessed[v/32] = 0;
+		dfsState->vertexParents[v] = -1;
+		dfsState->vertexEntryTime[v] = 0;
+		dfsState->vertexExitTime[v] = 0;
+	}
+	dfsState->touchedCount = 0;
+	dfsState->currentTime = 0;
+	return kAlgoErrorNone;
+}
+
+AlgoError algoGraphDfsStateIsVertexDiscovered(const AlgoGraphDfsState dfsState, int32_t vertexId, int *outIsDiscovered)
+{
+	if (NULL == dfsState ||
+		NULL == outIsDiscovered ||
+		vertexId < 0 || vertexId >= dfsState->graph->vertexCapacity)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outIsDiscovered = iTestBit(dfsState->isVertexDiscovered, dfsState->graph->vertexCapacity, vertexId);
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphDfsStateIsVertexProcessed(const AlgoGraphDfsState dfsState, int32_t vertexId, int *outIsProcessed)
+{
+	if (NULL == dfsState ||
+		NULL == outIsProcessed ||
+		vertexId < 0 || vertexId >= dfsState->graph->vertexCapacity)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outIsProcessed = iTestBit(dfsState->isVertexProcessed, dfsState->graph->vertexCapacity, vertexId);
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphDfsStateGetVertexParent(const AlgoGraphDfsState dfsState, int32_t vertexId, int32_t *outVertexParentId)
+{
+	if (NULL == dfsState ||
+		NULL == outVertexParentId ||
+		!iGraphIsValidVertexId(dfsState->graph, vertexId))
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	if (NULL == dfsState->vertexParents)
+	{
+		return kAlgoErrorOperationFailed; /* lightweight state */
+	}
+	*outVertexParentId = dfsState->vertexParents[vertexId];
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphDfsStateGetVertexEntryTime(const AlgoGraphDfsState dfsState, int32_t vertexId, int32_t *outEntryTime)
+{
+	if (NULL == dfsState ||
+		NULL == outEntryTime ||
+		vertexId < 0 || vertexId >= dfsState->graph->vertexCapacity)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	if (NULL == dfsState->vertexEntryTime)
+	{
+		return kAlgoErrorOperationFailed; /* lightweight state */
+	}
+	*outEntryTime = dfsState->vertexEntryTime[vertexId];
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphDfsStateGetVertexExitTime(const AlgoGraphDfsState dfsState, int32_t vertexId, int32_t *outExitTime)
+{
+	if (NULL == dfsState ||
+		NULL == outExitTime ||
+		vertexId < 0 || vertexId >= dfsState->graph->vertexCapacity)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	if (NULL == dfsState->vertexExitTime)
+	{
+		return kAlgoErrorOperationFailed; /* lightweight state */
+	}
+	*outExitTime = dfsState->vertexExitTime[vertexId];
+	return kAlgoErrorNone;
+}
+
+/* Lightweight equivalent of iGraphDfs(), for states created with kAlgoGraphDfsStateLightweight. If csr is non-NULL, it is
+   traversed instead of the graph's edge lists. The top frame's vertex may not have been discovered yet (it is pushed
+   first, and discovered when it reaches the top of the loop), but every frame below it has been. Rather than returning to
+   the top of the loop after every edge, a vertex's edges are visited until one of them pushes a new frame. */
+ALGO_INTERNAL int iGraphDfsLightweight(const AlgoGraph graph, const AlgoGraphCsr csr, AlgoGraphDfsState dfsState,
+	AlgoGraphDfsCallbacks callbacks);
+/* Runs the DFS until the stack is empty, and returns 0. If a control callback stops the search, returns 1 instead,
+   leaving the stack as it was so that the search can be resumed. */
+ALGO_INTERNAL int iGraphDfs(const AlgoGraph graph, AlgoGraphDfsState dfsState, AlgoGraphDfsCallbacks callbacks)
+{
+	if (NULL != dfsState->frames)
+		return iGraphDfsLightweight(graph, NULL, dfsState, callbacks);
+	int32_t currentStackSize = -1;
+	algoStackGetCurrentSize(dfsState->vertexStack, &currentStackSize);
+	while(currentStackSize > 0)
+	{
+		AlgoData stackElem;
+		algoStackPop(dfsState->vertexStack, &stackElem);
+		int32_t v0 = stackElem.asInt;
+		ALGO_ASSERT( iGraphIsValidVertexId(graph, v0) );
+		if ( 0 == iTestBit(dfsState->isVertexDiscovered, graph->vertexCapacity, v0) )
+		{
+			/* discovered! */
+			iSetBit(dfsState->isVertexDiscovered, graph->vertexCapacity, v0);
+			dfsState->touchedVertices[dfsState->touchedCount++] = v0;
+			dfsState->currentTime += 1;
+			dfsState->vertexEntryTime[v0] = dfsState->currentTime;
+			dfsState->vertexNextEdge[v0].list.block = iGraphEdgeListHead(graph, graph->vertexEdges + v0);
+			dfsState->vertexNextEdge[v0].list.nextIndex = 0;
+			dfsState->vertexNextEdge[v0].list.blockEdgeCount = iGraphHeadBlockEdgeCount(graph->vertexDegrees[v0]);
+			if (NULL != callbacks.vertexFuncEarly)
+				callbacks.vertexFuncEarly(graph, dfsState, v0, callbacks.vertexFuncEarlyUserData);
+			if (NULL != callbacks.vertexControlFunc)
+			{
+				AlgoGraphSearchControl control = callbacks.vertexControlFunc(graph, dfsState, v0, callbacks.vertexControlFuncUserData);
+				if (kAlgoGraphSearchStop == control)
+				{
+					algoStackPush(dfsState->vertexStack, algoDataFromInt(v0)); /* its edges are explored when the search resumes */
+					return 1;
+				}
+				else if (kAlgoGraphSearchSkip == control)
+				{
+					dfsState->vertexNextEdge[v0].list.block = NULL;
+				}
+			}
+		}
+		if (NULL != dfsState->vertexNextEdge[v0].list.block)
+		{
+			IGraphDfsCursor *cursor = dfsState->vertexNextEdge + v0;
+			int32_t v1 = cursor->list.block->destVertices[cursor->list.nextIndex];
+			cursor->list.nextIndex += 1;
+			if (cursor->list.nextIndex == cursor->list.blockEdgeCount)
+			{
+				cursor->list.block = iGraphNextEdgeBlock(graph, graph->vertexEdges + v0, cursor->list.block);
+				cursor->list.nextIndex = 0;
+				cursor->list.blockEdgeCount = kAlgoGraphEdgeBlockCapacity;
+			}
+			algoStackPush(dfsState->vertexStack, algoDataFromInt(v0));
+			AlgoGraphSearchControl control = kAlgoGraphSearchContinue;
+			if (0 == iTestBit(dfsState->isVertexDiscovered, graph->vertexCapacity, v1))
+			{
+				ALGO_ASSERT(dfsState->vertexParents[v1] < 0);
+				dfsState->vertexParents[v1] = v0;
+				if (NULL != callbacks.edgeFunc)
+					callbacks.edgeFunc(graph, dfsState, v0, v1, callbacks.edgeFuncUserData);
+				if (NULL != callbacks.edgeControlFunc)
+					control = callbacks.edgeControlFunc(graph, dfsState, v0, v1, callbacks.edgeControlFuncUserData);
+				if (kAlgoGraphSearchSkip == control)
+					dfsState->vertexParents[v1] = -1; /* v1 may still be reached through another edge */
+				else
+					algoStackPush(dfsState->vertexStack, algoDataFromInt(v1));
+			}
+			else if ((0 == iTestBit(dfsState->isVertexProcessed, graph->vertexCapacity, v1) && dfsState->vertexParents[v0] != v1) ||
+					 kAlgoGraphEdgeDirected == graph->edgeMode)
+			{
+				if (NULL != callbacks.edgeFunc)
+					callbacks.edgeFunc(graph, dfsState, v0, v1, callbacks.edgeFuncUserData);
+				if (NULL != callbacks.edgeControlFunc)
+					control = callbacks.edgeControlFunc(graph, dfsState, v0, v1, callbacks.edgeControlFuncUserData);
+			}
+			if (kAlgoGraphSearchStop == control)
+				return 1;
+		}
+		else
+		{
+			/* v0 has no more edges to visit; it is now fully processed. */
+			if (NULL != callbacks.vertexFuncLate)
+				callbacks.vertexFuncLate(graph, dfsState, v0, callbacks.vertexFuncLateUserData);
+			ALGO_ASSERT( 0 == iTestBit(dfsState->isVertexProcessed, graph->vertexCapacity, v0) );
+			dfsState->currentTime += 1;
+			dfsState->vertexExitTime[v0] = dfsState->currentTime;
+			iSetBit(dfsState->isVertexProcessed, graph->vertexCapacity, v0);
+		}
+		algoStackGetCurrentSize(dfsState->vertexStack, &currentStackSize);
+	}
+	return 0;
+}
+AlgoError algoGraphDfs(const AlgoGraph graph, AlgoGraphDfsState dfsState, int32_t rootVertexId, AlgoGraphDfsCallbacks callbacks)
+{
+	if (NULL == graph ||
+		NULL == dfsState ||
+		0 == iGraphIsValidVertexId(graph, rootVertexId))
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	return algoGraphDfsMulti(graph, dfsState, 1, &rootVertexId, callbacks);
+}
+AlgoError algoGraphDfsMulti(const AlgoGraph graph, AlgoGraphDfsState dfsState, int32_t rootCount, const int32_t rootVertexIds[],
+	AlgoGraphDfsCallbacks callbacks)
+{
+	if (NULL == graph ||
+		NULL == dfsState ||
+		graph != dfsState->graph ||
+		rootCount < 0 ||
+		(rootCount > 0 && NULL == rootVertexIds))
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	for(int32_t iRoot=0; iRoot<rootCount; ++iRoot)
+	{
+		if (0 == iGraphIsValidVertexId(graph, rootVertexIds[iRoot]))
+		{
+			return kAlgoErrorInvalidArgument;
+		}
+	}
+	/* Finish the tree of a stopped search first; the stack must be empty before a new tree starts. */
+	if (iGraphDfs(graph, dfsState, callbacks))
+		return kAlgoErrorNone;
+	for(int32_t iRoot=0; iRoot<rootCount; ++iRoot)
+	{
+		if (iTestBit(dfsState->isVertexDiscovered, graph->vertexCapacity, rootVertexIds[iRoot]))
+			continue;
+		if (NULL != dfsState->frames)
+			dfsState->frames[dfsState->frameCount++].vertexId = rootVertexIds[iRoot];
+		else
+			algoStackPush(dfsState->vertexStack, algoDataFromInt(rootVertexIds[iRoot]));
+		if (iGraphDfs(graph, dfsState, callbacks))
+			return kAlgoErrorNone;
+	}
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphDfsResume(const AlgoGraph graph, AlgoGraphDfsState dfsState, AlgoGraphDfsCallbacks callbacks)
+{
+	if (NULL == graph ||
+		NULL == dfsState ||
+		graph != dfsState->graph)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	iGraphDfs(graph, dfsState, callbacks);
+	return kAlgoErrorNone;
+}
+
+typedef struct AlgoGraphCsrImpl
+{
+	const void *thisBuffer;
+	size_t thisBufferSize;
+	AlgoGraphImpl *graph; /* source graph; passed to traversal callbacks */
+	int32_t vertexCapacity;
+	int32_t vertexCount;
+	int32_t edgeNodeCount; /* number of elements in destVertices[]. Undirected edges are stored in both directions. */
+	AlgoGraphEdgeMode edgeMode;
+	int32_t *vertexEdgeOffsets; /* vertexCapacity+1 elements; vertex V's edges are destVertices[offsets[V] .. offsets[V+1]-1]. */
+	int32_t *destVertices;
+	int32_t *validVertexIds; /* vertexCount elements, in the same order as the source graph's list. */
+	int32_t *isVertexValid; /* bit array */
+} AlgoGraphCsrImpl;
+
+ALGO_INTERNAL ALGO_INLINE int iGraphCsrIsValidVertexId(const AlgoGraphCsr csr, int32_t vertexId)
+{
+	ALGO_ASSERT(NULL != csr);
+	return (
+		vertexId >= 0 &&
+		vertexId < csr->vertexCapacity &&
+		iTestBit(csr->isVertexValid, csr->vertexCapacity, vertexId)) ? 1 : 0;
+}
+
+AlgoError algoGraphFreezeComputeBufferSize(size_t *outBufferSize, const AlgoGraph graph)
+{
+	if (NULL == outBufferSize ||
+		NULL == graph)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	const int32_t nodesPerEdge = (graph->edgeMode == kAlgoGraphEdgeDirected) ? 1 : 2; /* undirected edges store two nodes: x->y and y->x */
+	int32_t vertexCapacityRounded = (graph->vertexCapacity+31) & ~31;
+	size_t offsetsSize        = (graph->vertexCapacity+1) * sizeof(int32_t);
+	size_t destVerticesSize   = graph->currentEdgeCount * nodesPerEdge * sizeof(int32_t);
+	size_t validVertexIdsSize = graph->currentVertexCount * sizeof(int32_t);
+	size_t isValidSize        = vertexCapacityRounded * sizeof(int32_t) / 32;
+	*outBufferSize = sizeof(AlgoGraphCsrImpl) + offsetsSize + destVerticesSize + validVertexIdsSize + isValidSize;
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphFreeze(const AlgoGraph graph, AlgoGraphCsr *outCsr, void *buffer, size_t bufferSize)
+{
+	size_t minBufferSize = 0;
+	AlgoError err;
+	uint8_t *bufferNext = (uint8_t*)buffer;
+	if (NULL == graph ||
+		NULL == outCsr)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	err = algoGraphFreezeComputeBufferSize(&minBufferSize, graph);
+	if (kAlgoErrorNone != err)
+	{
+		return err;
+	}
+	if (NULL == buffer ||
+		bufferSize < minBufferSize)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+
+	const int32_t nodesPerEdge = (graph->edgeMode == kAlgoGraphEdgeDirected) ? 1 : 2;
+	int32_t vertexCapacityRounded = (graph->vertexCapacity+31) & ~31;
+	size_t offsetsSize        = (graph->vertexCapacity+1) * sizeof(int32_t);
+	size_t destVerticesSize   = graph->currentEdgeCount * nodesPerEdge * sizeof(int32_t);
+	size_t validVertexIdsSize = graph->currentVertexCount * sizeof(int32_t);
+	size_t isValidSize        = vertexCapacityRounded * sizeof(int32_t) / 32;
+
+	AlgoGraphCsrImpl *csr = (AlgoGraphCsrImpl*)bufferNext;
+	bufferNext += sizeof(AlgoGraphCsrImpl);
+	csr->vertexEdgeOffsets = (int32_t*)bufferNext;
+	bufferNext += offsetsSize;
+	csr->destVertices = (int32_t*)bufferNext;
+	bufferNext += destVerticesSize;
+	csr->validVertexIds = (int32_t*)bufferNext;
+	bufferNext += validVertexIdsSize;
+	csr->isVertexValid = (int32_t*)bufferNext;
+	bufferNext += isValidSize;
+	ALGO_ASSERT( bufferNext-minBufferSize == buffer ); /* If this fails, algoGraphFreezeComputeBufferSize() is out of date */
+
+	csr->thisBuffer     = buffer;
+	csr->thisBufferSize = bufferSize;
+	csr->graph          = graph;
+	csr->vertexCapacity = graph->vertexCapacity;
+	csr->vertexCount    = graph->currentVertexCount;
+	csr->edgeNodeCount  = graph->currentEdgeCount * nodesPerEdge;
+	csr->edgeMode       = graph->edgeMode;
+	ALGO_MEMCPY(csr->validVertexIds, graph->validVertexIds, validVertexIdsSize);
+	ALGO_MEMSET(csr->isVertexValid, 0, isValidSize);
+	{
+		int32_t iVertex, nextOffset = 0;
+		for(iVertex=0; iVertex<graph->vertexCapacity; ++iVertex)
+		{
+			csr->vertexEdgeOffsets[iVertex] = nextOffset;
+			if (iGraphIsValidVertexId(graph, iVertex))
+			{
+				const int32_t degree = graph->vertexDegrees[iVertex];
+				iSetBit(csr->isVertexValid, vertexCapacityRounded, iVertex);
+				ALGO_ASSERT(nextOffset + degree <= csr->edgeNodeCount);
+				algoGraphGetVertexEdges(graph, iVertex, degree, csr->destVertices + nextOffset);
+				nextOffset += degree;
+			}
+		}
+		csr->vertexEdgeOffsets[graph->vertexCapacity] = nextOffset;
+		ALGO_ASSERT(nextOffset == csr->edgeNodeCount);
+	}
+	*outCsr = csr;
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphCsrGetBufferSize(const AlgoGraphCsr csr, size_t *outBufferSize)
+{
+	if (NULL == csr ||
+		NULL == outBufferSize)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outBufferSize = csr->thisBufferSize;
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphCsrGetGraph(const AlgoGraphCsr csr, AlgoGraph *outGraph)
+{
+	if (NULL == csr ||
+		NULL == outGraph)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outGraph = csr->graph;
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphCsrGetVertexDegree(const AlgoGraphCsr csr, int32_t vertexId, int32_t *outDegree)
+{
+	if (NULL == csr ||
+		NULL == outDegree ||
+		0 == iGraphCsrIsValidVertexId(csr, vertexId))
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outDegree = csr->vertexEdgeOffsets[vertexId+1] - csr->vertexEdgeOffsets[vertexId];
+	return kAlgoErrorNone;
+}
+AlgoError algoGraphCsrGetVertexEdges(const AlgoGraphCsr csr, int32_t srcVertexId, const int32_t **outDestVertexIds,
+	int32_t *outDegree)
+{
+	if (NULL == csr ||
+		NULL == outDestVertexIds ||
+		0 == iGraphCsrIsValidVertexId(csr, srcVertexId))
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	*outDestVertexIds = csr->destVertices + csr->vertexEdgeOffsets[srcVertexId];
+	if (NULL != outDegree)
+	{
+		*outDegree = csr->vertexEdgeOffsets[srcVertexId+1] - csr->vertexEdgeOffsets[srcVertexId];
+	}
+	return kAlgoErrorNone;
+}
+
+/* CSR equivalent of iGraphBfsPrefetch(). A vertex's edge offsets take the place of its edge list head and degree, and the
+   start of its destVertices[] range takes the place of its head edge block. As with the head block, only the neighbors in
+   the cache line fetched by the previous stage are prefetched; the rest of a high-degree vertex's range would cost four
+   prefetches per edge and evict more than it brings in. */
+ALGO_INTERNAL void iGraphCsrBfsPrefetch(const AlgoGraphCsr csr, const AlgoGraphBfsState bfsState)
+{
+	const AlgoQueueImpl *queue = bfsState->vertexQueue;
+	const int32_t queueSize = (queue->tail - queue->head + queue->nodeCount) % queue->nodeCount;
+	if (queueSize > 3*kAlgoGraphBfsPrefetchDistance)
+	{
+		const int32_t v = queue->nodes[(queue->head + 3*kAlgoGraphBfsPrefetchDistance) % queue->nodeCount].asInt;
+		iPrefetch(csr->vertexEdgeOffsets + v);
+		iPrefetch(bfsState->vertexLevels + v);
+	}
+	if (queueSize > 2*kAlgoGraphBfsPrefetchDistance)
+	{
+		const int32_t v = queue->nodes[(queue->head + 2*kAlgoGraphBfsPrefetchDistance) % queue->nodeCount].asInt;
+		iPrefetch(csr->destVertices + csr->vertexEdgeOffsets[v]);
+	}
+	if (queueSize > kAlgoGraphBfsPrefetchDistance)
+	{
+		const int32_t v = queue->nodes[(queue->head + kAlgoGraphBfsPrefetchDistance) % queue->nodeCount].asInt;
+		const int32_t *dest    = csr->destVertices + csr->vertexEdgeOffsets[v];
+		const int32_t *destEnd = csr->destVertices + csr->vertexEdgeOffsets[v+1];
+		const int32_t *lineEnd = (const int32_t*)( ((uintptr_t)dest + ALGO_CACHE_LINE_SIZE) & ~(uintptr_t)(ALGO_CACHE_LINE_SIZE-1) );
+		if (destEnd > lineEnd)
+			destEnd = lineEnd;
+		for(; dest < destEnd; ++dest)
+		{
+			iPrefetch(bfsState->isVertexProcessed + *dest/32);
+			iPrefetch(bfsState->isVertexDiscovered + *dest/32);
+			iPrefetch(bfsState->vertexParents + *dest);
+			iPrefetch(bfsState->vertexLevels + *dest);
+		}
+	}
+}
+AlgoError algoGraphCsrBfs(const AlgoGraphCsr csr, AlgoGraphBfsState bfsState, int32_t rootVertexId, AlgoGraphBfsCallbacks callbacks)
+{
+	if (NULL == csr ||
+		NULL == bfsState ||
+		csr->graph != bfsState->graph ||
+		0 == iGraphCsrIsValidVertexId(csr, rootVertexId) ||
+		NULL != callbacks.vertexControlFunc ||
+		NULL != callbacks.edgeControlFunc)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	AlgoGraph graph = csr->graph;
+	int32_t vertexCapacityRounded = (csr->vertexCapacity+31) & ~31;
+	algoQueueInsert(bfsState->vertexQueue, algoDataFromInt(rootVertexId));
+	iSetBit(bfsState->isVertexDiscovered, vertexCapacityRounded, rootVertexId);
+	bfsState->vertexLevels[rootVertexId] = 0;
+	bfsState->touchedVertices[bfsState->touchedCount++] = rootVertexId;
+	int32_t currentQueueSize = 1;
+	do
+	{
+		AlgoData queueElem;
+		int32_t v0 = -1;
+		/* Pop the next vertex and process it. */
+		algoQueueRemove(bfsState->vertexQueue, &queueElem);
+		v0 = queueElem.asInt;
+		ALGO_ASSERT( 1 == iGraphCsrIsValidVertexId(csr, v0) );
+		if (bfsState->isPrefetching)
+			iGraphCsrBfsPrefetch(csr, bfsState);
+		if (NULL != callbacks.vertexFuncEarly)
+			callbacks.vertexFuncEarly(graph, bfsState, v0, callbacks.vertexFuncEarlyUserData);
+		ALGO_ASSERT(0 == iTestBit(bfsState->isVertexProcessed, vertexCapacityRounded, v0));
+		iSetBit(bfsState->isVertexProcessed, vertexCapacityRounded, v0); /* must be set here to prevent undirected edges from looping infinitely. */
+		/* Explore v0's edges. */
+		const int32_t *dest    = csr->destVertices + csr->vertexEdgeOffsets[v0];
+		const int32_t *destEnd = csr->destVertices + csr->vertexEdgeOffsets[v0+1];
+		for(; dest != destEnd; ++dest)
+		{
+			int32_t v1 = *dest;
+			ALGO_ASSERT( 1 == iGraphCsrIsValidVertexId(csr, v1) );
+			/* Run the edge function, if this is the first time we've seen it. */
+			if (0 == iTestBit(bfsState->isVertexProcessed, vertexCapacityRounded, v1) ||
+				csr->edgeMode == kAlgoGraphEdgeDirected)
 			{
-				/* anything to check for invalid vertices? */
+				if (NULL != callbacks.edgeFunc)
+					callbacks.edgeFunc(graph, bfsState, v0, v1, callbacks.edgeFuncUserData);
+			}
+			/* Enqueue v1, if we haven't seen it before. */
+			if (0 == iTestBit(bfsState->isVertexDiscovered, vertexCapacityRounded, v1))
+			{
+				ALGO_ASSERT(0 == iTestBit(bfsState->isVertexProcessed, vertexCapacityRounded, v1));
+				iSetBit(bfsState->isVertexDiscovered, vertexCapacityRounded, v1);
+				algoQueueInsert(bfsState->vertexQueue, algoDataFromInt(v1));
+				bfsState->vertexParents[v1] = v0;
+				bfsState->vertexLevels[v1] = bfsState->vertexLevels[v0] + 1;
+				bfsState->touchedVertices[bfsState->touchedCount++] = v1;
 			}
 		}
-		if (validEdgeNodeCount != graph->currentEdgeCount*nodesPerEdge)
+		/* Run the late vertex function after all edges are processed. */
+		if (NULL != callbacks.vertexFuncLate)
+			callbacks.vertexFuncLate(graph, bfsState, v0, callbacks.vertexFuncLateUserData);
+		algoQueueGetCurrentSize(bfsState->vertexQueue, &currentQueueSize);
+	}
+	while (currentQueueSize > 0);
+	return kAlgoErrorNone;
+}
+
+/* Advances a lightweight DFS frame's cursor to its vertex's next edge. Returns 0 if v0 has no more edges to visit. */
+ALGO_INTERNAL ALGO_INLINE int iGraphDfsFrameNextEdge(const AlgoGraph graph, const AlgoGraphCsr csr, IGraphDfsFrame *frame,
+	int32_t *outV1)
+{
+	if (NULL != csr)
+	{
+		if (frame->next.csrEdge == csr->destVertices + csr->vertexEdgeOffsets[frame->vertexId+1])
+			return 0;
+		*outV1 = *(frame->next.csrEdge++);
+		return 1;
+	}
+	if (NULL == frame->next.block)
+		return 0;
+	const AlgoGraphEdgeList *edgeList = graph->vertexEdges + frame->vertexId;
+	const int32_t blockEdgeCount = (iGraphEdgeBlockSlot(graph, frame->next.block) == edgeList->headBlock)
+		? iGraphHeadBlockEdgeCount(graph->vertexDegrees[frame->vertexId]) : kAlgoGraphEdgeBlockCapacity;
+	*outV1 = frame->next.block->destVertices[frame->nextIndex++];
+	if (frame->nextIndex == blockEdgeCount)
+	{
+		frame->next.block = iGraphNextEdgeBlock(graph, edgeList, frame->next.block);
+		frame->nextIndex = 0;
+	}
+	return 1;
+}
+ALGO_INTERNAL int iGraphDfsLightweight(const AlgoGraph graph, const AlgoGraphCsr csr, AlgoGraphDfsState dfsState,
+	AlgoGraphDfsCallbacks callbacks)
+{
+	IGraphDfsFrame *frames = dfsState->frames;
+	while(dfsState->frameCount > 0)
+	{
+		IGraphDfsFrame *frame = frames + dfsState->frameCount - 1;
+		const int32_t v0 = frame->vertexId;
+		ALGO_ASSERT( iGraphIsValidVertexId(graph, v0) );
+		if ( 0 == iTestBit(dfsState->isVertexDiscovered, graph->vertexCapacity, v0) )
 		{
-			errorCode = 6; /* actual valid edge count doesn't match expected value. */
-			goto ALGO_GRAPH_VALIDATE_END;
+			/* discovered! */
+			iSetBit(dfsState->isVertexDiscovered, graph->vertexCapacity, v0);
+			if (NULL != csr)
+				frame->next.csrEdge = csr->destVertices + csr->vertexEdgeOffsets[v0];
+			else
+				frame->next.block = iGraphEdgeListHead(graph, graph->vertexEdges + v0);
+			frame->nextIndex = 0;
+			if (NULL != callbacks.vertexFuncEarly)
+				callbacks.vertexFuncEarly(graph, dfsState, v0, callbacks.vertexFuncEarlyUserData);
+			if (NULL != callbacks.vertexControlFunc)
+			{
+				AlgoGraphSearchControl control = callbacks.vertexControlFunc(graph, dfsState, v0, callbacks.vertexControlFuncUserData);
+				if (kAlgoGraphSearchStop == control)
+					return 1; /* its edges are explored when the search resumes */
+				else if (kAlgoGraphSearchSkip == control && NULL != csr)
+					frame->next.csrEdge = csr->destVertices + csr->vertexEdgeOffsets[v0+1];
+				else if (kAlgoGraphSearchSkip == control)
+					frame->next.block = NULL;
+			}
 		}
-		if (validVertexCount != graph->currentVertexCount)
+		/* v0's parent is the vertex below it on the path, if any. */
+		const int32_t parent = (dfsState->frameCount > 1) ? frame[-1].vertexId : -1;
+		int32_t v1 = -1;
+		int isFramePushed = 0;
+		while(!isFramePushed && iGraphDfsFrameNextEdge(graph, csr, frame, &v1))
 		{
-			errorCode = 7; /* actual valid vertex count doesn't match expected value. */
-			goto ALGO_GRAPH_VALIDATE_END;
+			AlgoGraphSearchControl control = kAlgoGraphSearchContinue;
+			if (0 == iTestBit(dfsState->isVertexDiscovered, graph->vertexCapacity, v1))
+			{
+				if (NULL != callbacks.edgeFunc)
+					callbacks.edgeFunc(graph, dfsState, v0, v1, callbacks.edgeFuncUserData);
+				if (NULL != callbacks.edgeControlFunc)
+					control = callbacks.edgeControlFunc(graph, dfsState, v0, v1, callbacks.edgeControlFuncUserData);
+				if (kAlgoGraphSearchSkip != control)
+				{
+					ALGO_ASSERT(dfsState->frameCount < graph->vertexCapacity);
+					frames[dfsState->frameCount++].vertexId = v1;
+					isFramePushed = 1;
+				}
+			}
+			else if ((0 == iTestBit(dfsState->isVertexProcessed, graph->vertexCapacity, v1) && parent != v1) ||
+					 kAlgoGraphEdgeDirected == graph->edgeMode)
+			{
+				if (NULL != callbacks.edgeFunc)
+					callbacks.edgeFunc(graph, dfsState, v0, v1, callbacks.edgeFuncUserData);
+				if (NULL != callbacks.edgeControlFunc)
+					control = callbacks.edgeControlFunc(graph, dfsState, v0, v1, callbacks.edgeControlFuncUserData);
+			}
+			if (kAlgoGraphSearchStop == control)
+				return 1;
+		}
+		if (!isFramePushed)
+		{
+			/* v0 has no more edges to visit; it is now fully processed. */
+			if (NULL != callbacks.vertexFuncLate)
+				callbacks.vertexFuncLate(graph, dfsState, v0, callbacks.vertexFuncLateUserData);
+			ALGO_ASSERT( 0 == iTestBit(dfsState->isVertexProcessed, graph->vertexCapacity, v0) );
+			iSetBit(dfsState->isVertexProcessed, graph->vertexCapacity, v0);
+			dfsState->frameCount -= 1;
 		}
 	}
-	/* Check free vertex list */
+	return 0;
+}
+#define kAlgoGraphBfsSimdChunkSize 64 /* neighbors filtered at a time by algoGraphCsrBfsSimd(); a multiple of every vector width */
+/* Copies the vertices in dests[] whose bits are clear in isVertexDiscovered[] to outCandidates[], in order, and returns
+   how many were copied. A candidate may still be discovered by an earlier candidate in the same batch (e.g. a duplicate
+   edge), so the caller must test each one again as it visits them. */
+ALGO_INTERNAL int32_t iGraphFilterUndiscoveredScalar(const int32_t *dests, int32_t destCount, const int32_t *isVertexDiscovered,
+	int32_t *outCandidates)
+{
+	int32_t candidateCount = 0;
+	for(int32_t iDest=0; iDest<destCount; ++iDest)
 	{
-		int32_t freeVertexCount = 0;
-		int32_t nextFreeVertexId = graph->nextFreeVertexId;
-		while(nextFreeVertexId >= 0)
+		const int32_t v = dests[iDest];
+		outCandidates[candidateCount] = v;
+		candidateCount += (0 == (isVertexDiscovered[v/32] & (1<<(v%32)))) ? 1 : 0;
+	}
+	return candidateCount;
+}
+#if ALGO_HAS_X86_SIMD
+ALGO_TARGET_AVX2 ALGO_INTERNAL int32_t iGraphFilterUndiscoveredAvx2(const int32_t *dests, int32_t destCount,
+	const int32_t *isVertexDiscovered, int32_t *outCandidates)
+{
+	const __m256i one = _mm256_set1_epi32(1), bitIndexMask = _mm256_set1_epi32(31), zero = _mm256_setzero_si256();
+	int32_t candidateCount = 0, iDest = 0;
+	for(; iDest+8 <= destCount; iDest += 8)
+	{
+		const __m256i v = _mm256_loadu_si256((const __m256i*)(dests+iDest));
+		const __m256i words = _mm256_i32gather_epi32((const int*)isVertexDiscovered, _mm256_srli_epi32(v, 5), 4);
+		const __m256i bits = _mm256_sllv_epi32(one, _mm256_and_si256(v, bitIndexMask));
+		const __m256i isClear = _mm256_cmpeq_epi32(_mm256_and_si256(words, bits), zero);
+		/* AVX2 has no compress instruction, so walk the mask's set bits instead. */
+		uint32_t mask = (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(isClear));
+		for(; 0 != mask; mask &= mask-1)
 		{
-			if (iGraphIsValidVertexId(graph, nextFreeVertexId))
+			outCandidates[candidateCount++] = dests[iDest + iLowestBit64(mask)];
+		}
+	}
+	return candidateCount + iGraphFilterUndiscoveredScalar(dests+iDest, destCount-iDest, isVertexDiscovered,
+		outCandidates+candidateCount);
+}
+ALGO_TARGET_AVX512 ALGO_INTERNAL int32_t iGraphFilterUndiscoveredAvx512(const int32_t *dests, int32_t destCount,
+	const int32_t *isVertexDiscovered, int32_t *outCandidates)
+{
+	const __m512i one = _mm512_set1_epi32(1), bitIndexMask = _mm512_set1_epi32(31);
+	int32_t candidateCount = 0, iDest = 0;
+	for(; iDest+16 <= destCount; iDest += 16)
+	{
+		const __m512i v = _mm512_loadu_si512((const void*)(dests+iDest));
+		const __m512i words = _mm512_i32gather_epi32(_mm512_srli_epi32(v, 5), (const void*)isVertexDiscovered, 4);
+		const __m512i bits = _mm512_sllv_epi32(one, _mm512_and_si512(v, bitIndexMask));
+		const __mmask16 isClear = _mm512_testn_epi32_mask(words, bits);
+		_mm512_mask_compressstoreu_epi32((void*)(outCandidates+candidateCount), isClear, v);
+		candidateCount += iPopCount64(isClear);
+	}
+	return candidateCount + iGraphFilterUndiscoveredScalar(dests+iDest, destCount-iDest, isVertexDiscovered,
+		outCandidates+candidateCount);
+}
+#endif
+AlgoError algoGraphCsrBfsSimd(const AlgoGraphCsr csr, AlgoGraphBfsState bfsState, int32_t rootVertexId,
+	AlgoSimdLevel maxSimdLevel)
+{
+	if (NULL == csr ||
+		NULL == bfsState ||
+		csr->graph != bfsState->graph ||
+		0 == iGraphCsrIsValidVertexId(csr, rootVertexId) ||
+		maxSimdLevel < kAlgoSimdScalar || maxSimdLevel > kAlgoSimdAvx512)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	AlgoSimdLevel simdLevel = iGetCpuSimdLevel();
+	if (simdLevel > maxSimdLevel)
+		simdLevel = maxSimdLevel;
+	int32_t vertexCapacityRounded = (csr->vertexCapacity+31) & ~31;
+	if (iTestBit(bfsState->isVertexDiscovered, vertexCapacityRounded, rootVertexId))
+		return kAlgoErrorNone;
+	iSetBit(bfsState->isVertexDiscovered, vertexCapacityRounded, rootVertexId);
+	bfsState->vertexLevels[rootVertexId] = 0;
+	bfsState->touchedVertices[bfsState->touchedCount++] = rootVertexId;
+	/* Vertices are appended to touchedVertices[] as they're discovered, so each level of the search is a contiguous range
+	   of it, and the next level is whatever has been appended by the time the current one is finished. Visiting the
+	   frontier and each vertex's candidates in order finds the same parents as algoGraphCsrBfs()'s queue. */
+	int32_t candidates[kAlgoGraphBfsSimdChunkSize];
+	int32_t levelBegin = bfsState->touchedCount-1;
+	while(levelBegin < bfsState->touchedCount)
+	{
+		const int32_t levelEnd = bfsState->touchedCount;
+		for(int32_t iFrontier=levelBegin; iFrontier<levelEnd; ++iFrontier)
+		{
+			const int32_t v0 = bfsState->touchedVertices[iFrontier];
+			const int32_t nextLevel = bfsState->vertexLevels[v0] + 1;
+			ALGO_ASSERT(0 == iTestBit(bfsState->isVertexProcessed, vertexCapacityRounded, v0));
+			iSetBit(bfsState->isVertexProcessed, vertexCapacityRounded, v0);
+			const int32_t *dest    = csr->destVertices + csr->vertexEdgeOffsets[v0];
+			const int32_t *destEnd = csr->destVertices + csr->vertexEdgeOffsets[v0+1];
+			while(dest != destEnd)
 			{
-				errorCode = 8; /* vertex in the free list thinks it's valid. */
-				goto ALGO_GRAPH_VALIDATE_END;
+				const int32_t destCount = (destEnd - dest < kAlgoGraphBfsSimdChunkSize)
+					? (int32_t)(destEnd - dest) : kAlgoGraphBfsSimdChunkSize;
+				int32_t candidateCount = 0;
+				switch(simdLevel)
+				{
+#if ALGO_HAS_X86_SIMD
+				case kAlgoSimdAvx512:
+					candidateCount = iGraphFilterUndiscoveredAvx512(dest, destCount, bfsState->isVertexDiscovered, candidates);
+					break;
+				case kAlgoSimdAvx2:
+					candidateCount = iGraphFilterUndiscoveredAvx2(dest, destCount, bfsState->isVertexDiscovered, candidates);
+					break;
+#endif
+				default:
+					candidateCount = iGraphFilterUndiscoveredScalar(dest, destCount, bfsState->isVertexDiscovered, candidates);
+					break;
+				}
+				for(int32_t iCandidate=0; iCandidate<candidateCount; ++iCandidate)
+				{
+					const int32_t v1 = candidates[iCandidate];
+					ALGO_ASSERT( 1 == iGraphCsrIsValidVertexId(csr, v1) );
+					if (0 == iTestBit(bfsState->isVertexDiscovered, vertexCapacityRounded, v1))
+					{
+						iSetBit(bfsState->isVertexDiscovered, vertexCapacityRounded, v1);
+						bfsState->vertexParents[v1] = v0;
+						bfsState->vertexLevels[v1] = nextLevel;
+						bfsState->touchedVertices[bfsState->touchedCount++] = v1;
+					}
+				}
+				dest += destCount;
 			}
-			freeVertexCount += 1;
-			nextFreeVertexId = graph->vertexData[nextFreeVertexId].asInt;
 		}
-		if (graph->vertexCapacity - graph->currentVertexCount != freeVertexCount)
+		levelBegin = levelEnd;
+	}
+	return kAlgoErrorNone;
+}
+
+AlgoError algoGraphCsrDfs(const AlgoGraphCsr csr, AlgoGraphDfsState dfsState, int32_t rootVertexId, AlgoGraphDfsCallbacks callbacks)
+{
+	if (NULL == csr ||
+		NULL == dfsState ||
+		csr->graph != dfsState->graph ||
+		0 == iGraphCsrIsValidVertexId(csr, rootVertexId) ||
+		NULL != callbacks.vertexControlFunc ||
+		NULL != callbacks.edgeControlFunc)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+	AlgoGraph graph = csr->graph;
+	if (NULL != dfsState->frames)
+	{
+		if (0 == iTestBit(dfsState->isVertexDiscovered, csr->vertexCapacity, rootVertexId))
 		{
-			errorCode = 9; /* actual free vertex count doesn't match expected value. */
-			goto ALGO_GRAPH_VALIDATE_END;
+			dfsState->frames[dfsState->frameCount++].vertexId = rootVertexId;
+			iGraphDfsLightweight(graph, csr, dfsState, callbacks);
 		}
+		return kAlgoErrorNone;
 	}
-	/* Check valid vertex list */
+
+	algoStackPush(dfsState->vertexStack, algoDataFromInt(rootVertexId));
+	int32_t currentStackSize = -1;
+	algoStackGetCurrentSize(dfsState->vertexStack, &currentStackSize);
+	while(currentStackSize > 0)
 	{
-		for(int32_t iValidVert=0; iValidVert<graph->currentVertexCount; ++iValidVert)
+		AlgoData stackElem;
+		algoStackPop(dfsState->vertexStack, &stackElem);
+		int32_t v0 = stackElem.asInt;
+		ALGO_ASSERT( iGraphCsrIsValidVertexId(csr, v0) );
+		if ( 0 == iTestBit(dfsState->isVertexDiscovered, csr->vertexCapacity, v0) )
 		{
-			int32_t validVertexId = graph->validVertexIds[iValidVert];
-			if (!iGraphIsValidVertexId(graph, validVertexId))
+			/* discovered! */
+			iSetBit(dfsState->isVertexDiscovered, csr->vertexCapacity, v0);
+			dfsState->touchedVertices[dfsState->touchedCount++] = v0;
+			dfsState->currentTime += 1;
+			dfsState->vertexEntryTime[v0] = dfsState->currentTime;
+			dfsState->vertexNextEdge[v0].csrEdge = csr->destVertices + csr->vertexEdgeOffsets[v0];
+			if (NULL != callbacks.vertexFuncEarly)
+				callbacks.vertexFuncEarly(graph, dfsState, v0, callbacks.vertexFuncEarlyUserData);
+		}
+		if (dfsState->vertexNextEdge[v0].csrEdge != csr->destVertices + csr->vertexEdgeOffsets[v0+1])
+		{
+			int32_t v1 = *(dfsState->vertexNextEdge[v0].csrEdge);
+			dfsState->vertexNextEdge[v0].csrEdge += 1;
+			algoStackPush(dfsState->vertexStack, algoDataFromInt(v0));
+			if (0 == iTestBit(dfsState->isVertexDiscovered, csr->vertexCapacity, v1))
 			{
-				errorCode = 10; /* vertex in the valid list is invalid */
-				goto ALGO_GRAPH_VALIDATE_END;
+				ALGO_ASSERT(dfsState->vertexParents[v1] < 0);
+				dfsState->vertexParents[v1] = v0;
+				if (NULL != callbacks.edgeFunc)
+					callbacks.edgeFunc(graph, dfsState, v0, v1, callbacks.edgeFuncUserData);
+				algoStackPush(dfsState->vertexStack, algoDataFromInt(v1));
 			}
-			if (graph->vertexIdToValidIndex[validVertexId] != iValidVert)
+			else if ((0 == iTestBit(dfsState->isVertexProcessed, csr->vertexCapacity, v1) && dfsState->vertexParents[v0] != v1) ||
+					 kAlgoGraphEdgeDirected == csr->edgeMode)
 			{
-				errorCode = 11; /* reverse lookup table mismatch */
-				goto ALGO_GRAPH_VALIDATE_END;
+				if (NULL != callbacks.edgeFunc)
+					callbacks.edgeFunc(graph, dfsState, v0, v1, callbacks.edgeFuncUserData);
 			}
 		}
+		else
+		{
+			/* v0 has no more edges to visit; it is now fully processed. */
+			if (NULL != callbacks.vertexFuncLate)
+				callbacks.vertexFuncLate(graph, dfsState, v0, callbacks.vertexFuncLateUserData);
+			ALGO_ASSERT( 0 == iTestBit(dfsState->isVertexProcessed, csr->vertexCapacity, v0) );
+			dfsState->currentTime += 1;
+			dfsState->vertexExitTime[v0] = dfsState->currentTime;
+			iSetBit(dfsState->isVertexProcessed, csr->vertexCapacity, v0);
+		}
+		algoStackGetCurrentSize(dfsState->vertexStack, &currentStackSize);
 	}
 
-ALGO_GRAPH_VALIDATE_END:
-	if (errorCode != 0)
-		return kAlgoErrorInvalidArgument;
 	return kAlgoErrorNone;
 }
 
-AlgoError algoGraphGetCurrentVertexCount(const AlgoGraph graph, int32_t *outCount)
+typedef enum IGraphEdgeType
 {
-	if (NULL == graph ||
-		NULL == outCount)
+	kGraphEdgeTypeTree    = 0,
+	kGraphEdgeTypeBack    = 1,
+	kGraphEdgeTypeForward = 2,
+	kGraphEdgeTypeCross   = 3,
+} IGraphEdgeType;
+ALGO_INTERNAL void iGraphTopoSortEdge(AlgoGraph graph, AlgoGraphDfsState dfsState, int32_t v0, int32_t v1, void *userData)
+{
+	ALGO_UNUSED(v0);
+	ALGO_UNUSED(userData);
+	/** All we're doing here is making sure there are no BACK edges. I'll leave in the full edge classification
+		in case I need it later; it needs a default (non-lightweight) DFS state for the parents and entry times.
+		*/
+	IGraphEdgeType edgeType = kGraphEdgeTypeTree;
+#if 1
+	if ( iTestBit(dfsState->isVertexDiscovered, graph->vertexCapacity, v1) && 
+		!iTestBit(dfsState->isVertexProcessed,  graph->vertexCapacity, v1))
 	{
-		return kAlgoErrorInvalidArgument;
+		edgeType = kGraphEdgeTypeBack;
 	}
-	*outCount = graph->currentVertexCount;
-	return kAlgoErrorNone;
+#else
+	if (dfsState->vertexParents[v1] == v0)
+	{
+		edgeType = kGraphEdgeTypeTree;
+	}
+	else if ( iTestBit(dfsState->isVertexDiscovered, graph->vertexCapacity, v1) && 
+			 !iTestBit(dfsState->isVertexProcessed,  graph->vertexCapacity, v1))
+	{
+		edgeType = kGraphEdgeTypeBack;
+	}
+	else if (iTestBit(dfsState->isVertexProcessed, graph->vertexCapacity, v1) &&
+			 dfsState->vertexEntryTime[v1] > dfsState->vertexEntryTime[v0])
+	{
+		edgeType = kGraphEdgeTypeForward;
+	}
+	else if (iTestBit(dfsState->isVertexProcessed, graph->vertexCapacity, v1) &&
+			 dfsState->vertexEntryTime[v1] < dfsState->vertexEntryTime[v0])
+	{
+		edgeType = kGraphEdgeTypeCross;
+	}
+	else
+	{
+		ALGO_ASSERT(0); /* unclassified edge from v0 to v1 */
+	}
+#endif
+	ALGO_ASSERT(edgeType != kGraphEdgeTypeBack);
+}
+typedef struct IGraphTopoSortResults
+{
+	int32_t *sortedVertices;
+	int32_t nextFreeIndex; /* Next free index in the sortedVertices array. */
+} IGraphTopoSortResults;
+ALGO_INTERNAL void iGraphTopoSortVertexLate(AlgoGraph graph, AlgoGraphDfsState dfsState, int32_t vertexId, void *userData)
+{
+	ALGO_UNUSED(graph);
+	ALGO_UNUSED(dfsState);
+	IGraphTopoSortResults *results = (IGraphTopoSortResults*)userData;
+	ALGO_ASSERT(results->nextFreeIndex >= 0 && results->nextFreeIndex < graph->currentVertexCount);
+	results->sortedVertices[results->nextFreeIndex] = vertexId;
+	results->nextFreeIndex -= 1;
 }
-AlgoError algoGraphGetVertexCapacity(const AlgoGraph graph, int32_t *outCapacity)
+AlgoError algoGraphTopoSortComputeBufferSize(size_t *outBufferSize, const AlgoGraph graph)
 {
+	AlgoError err;
 	if (NULL == graph ||
-		NULL == outCapacity)
+		NULL == outBufferSize)
 	{
 		return kAlgoErrorInvalidArgument;
 	}
-	*outCapacity = graph->vertexCapacity;
+	size_t dfsStateBufferSize = 0;
+	err = algoGraphDfsStateComputeBufferSizeWithFlags(&dfsStateBufferSize, graph, kAlgoGraphDfsStateLightweight);
+	if (kAlgoErrorNone != err)
+		return err;
+	*outBufferSize = dfsStateBufferSize;
 	return kAlgoErrorNone;
 }
-AlgoError algoGraphGetCurrentEdgeCount(const AlgoGraph graph, int32_t *outCount)
+/* Shared implementation of algoGraphTopoSort() and algoGraphCsrTopoSort(). If csr is non-NULL, it is traversed
+   instead of the graph's edge lists. Arguments have already been validated. */
+ALGO_INTERNAL AlgoError iGraphTopoSort(const AlgoGraph graph, const AlgoGraphCsr csr, int32_t outSortedVertices[],
+	void *buffer, size_t bufferSize)
 {
-	if (NULL == graph ||
-		NULL == outCount)
+	AlgoError err;
+	size_t dfsStateBufferSize = 0;
+	err = algoGraphDfsStateComputeBufferSizeWithFlags(&dfsStateBufferSize, graph, kAlgoGraphDfsStateLightweight);
+	ALGO_ASSERT(dfsStateBufferSize <= bufferSize);
+	ALGO_UNUSED(bufferSize);
+	AlgoGraphDfsState dfsState;
+	err = algoGraphDfsStateCreateWithFlags(&dfsState, graph, kAlgoGraphDfsStateLightweight, buffer, dfsStateBufferSize);
+	if (kAlgoErrorNone != err)
+		return err;
+
+	const int32_t vertexCount = (NULL != csr) ? csr->vertexCount : graph->currentVertexCount;
+	const int32_t *validVertexIds = (NULL != csr) ? csr->validVertexIds : graph->validVertexIds;
+	IGraphTopoSortResults sortResults;
+	sortResults.sortedVertices = outSortedVertices;
+	sortResults.nextFreeIndex = vertexCount-1;
+	AlgoGraphDfsCallbacks dfsCallbacks = {
+		NULL, NULL,
+		iGraphTopoSortEdge, NULL,
+		iGraphTopoSortVertexLate, NULL,
+		NULL, NULL,
+		NULL, NULL
+	};
+	dfsCallbacks.vertexFuncLateUserData = &sortResults;
+	for(int iValidVert=0; iValidVert<vertexCount; ++iValidVert)
 	{
-		return kAlgoErrorInvalidArgument;
+		int32_t vertexId = validVertexIds[iValidVert];
+		int isVertexSorted = 0;
+		err = algoGraphDfsStateIsVertexProcessed(dfsState, vertexId, &isVertexSorted);
+		if (!isVertexSorted)
+		{
+			if (NULL != csr)
+				err = algoGraphCsrDfs(csr, dfsState, vertexId, dfsCallbacks);
+			else
+				err = algoGraphDfs(graph, dfsState, vertexId, dfsCallbacks);
+			if (kAlgoErrorNone != err)
+				return err;
+			if (sortResults.nextFreeIndex < 0)
+				break;
+		}
 	}
-	*outCount = graph->currentEdgeCount;
 	return kAlgoErrorNone;
 }
-AlgoError algoGraphEdgeCapacity(const AlgoGraph graph, int32_t *outCapacity)
+AlgoError algoGraphTopoSort(const AlgoGraph graph, int32_t outSortedVertices[], size_t sortedVertexCount, 
+	void *buffer, size_t bufferSize)
 {
 	if (NULL == graph ||
-		NULL == outCapacity)
+		NULL == outSortedVertices ||
+		sortedVertexCount < (size_t)graph->currentVertexCount)
 	{
 		return kAlgoErrorInvalidArgument;
 	}
-	*outCapacity = graph->edgeCapacity;
-	return kAlgoErrorNone;
-}
-
-
-AlgoError algoGraphGetVertexDegree(const AlgoGraph graph, int32_t vertexId, int32_t *outDegree)
-{
-	if (NULL == graph ||
-		NULL == outDegree ||
-		0 == iGraphIsValidVertexId(graph, vertexId))
+	if (kAlgoGraphEdgeUndirected == graph->edgeMode)
+	{
+		return kAlgoErrorOperationFailed;
+	}
+	size_t minBufferSize = 0;
+	AlgoError err;
+	err = algoGraphTopoSortComputeBufferSize(&minBufferSize, graph);
+	if (NULL == buffer ||
+		bufferSize < minBufferSize ||
+		kAlgoErrorNone != err)
 	{
 		return kAlgoErrorInvalidArgument;
 	}
-	*outDegree = graph->vertexDegrees[vertexId];
-	ALGO_ASSERT( *outDegree >= 0); /* testing against upper bound is more complicated... */
-	return kAlgoErrorNone;
+	return iGraphTopoSort(graph, NULL, outSortedVertices, buffer, bufferSize);
 }
-AlgoError algoGraphGetVertexEdges(const AlgoGraph graph, int32_t srcVertexId, int32_t vertexDegree, int32_t outDestVertexIds[])
+AlgoError algoGraphCsrTopoSort(const AlgoGraphCsr csr, int32_t outSortedVertices[], size_t sortedVertexCount,
+	void *buffer, size_t bufferSize)
 {
-	const AlgoGraphEdge *nextEdge;
-	int32_t edgeCount, iEdge;
-	if (NULL == graph ||
-		NULL == outDestVertexIds ||
-		0 == iGraphIsValidVertexId(graph, srcVertexId) ||
-		graph->vertexDegrees[srcVertexId] != vertexDegree)
+	if (NULL == csr ||
+		NULL == outSortedVertices ||
+		sortedVertexCount < (size_t)csr->vertexCount)
 	{
 		return kAlgoErrorInvalidArgument;
 	}
-	nextEdge = graph->vertexEdges[srcVertexId];
-	edgeCount = graph->vertexDegrees[srcVertexId];
-	for(iEdge=0; iEdge<edgeCount; iEdge += 1)
+	if (kAlgoGraphEdgeUndirected == csr->edgeMode)
 	{
-		ALGO_ASSERT(NULL != nextEdge); /* edge list is shorter than expected! */
-		outDestVertexIds[iEdge] = nextEdge->destVertex;
-		nextEdge = nextEdge->next;
+		return kAlgoErrorOperationFailed;
 	}
-	ALGO_ASSERT(NULL == nextEdge); /* edge list is longer than expected! */
-	return kAlgoErrorNone;
-}
-AlgoError algoGraphGetVertexData(const AlgoGraph graph, int32_t vertexId, AlgoData *outValue)
-{
-	if (NULL == graph ||
-		NULL == outValue ||
-		0 == iGraphIsValidVertexId(graph, vertexId))
+	size_t minBufferSize = 0;
+	AlgoError err;
+	err = algoGraphTopoSortComputeBufferSize(&minBufferSize, csr->graph);
+	if (NULL == buffer ||
+		bufferSize < minBufferSize ||
+		kAlgoErrorNone != err)
 	{
 		return kAlgoErrorInvalidArgument;
 	}
-	*outValue = graph->vertexData[vertexId];
-	return kAlgoErrorNone;
+	return iGraphTopoSort(csr->graph, csr, outSortedVertices, buffer, bufferSize);
 }
-AlgoError algoGraphSetVertexData(AlgoGraph graph, int32_t vertexId, AlgoData value)
+
+#define kAlgoGraphTopoSortParallelChunkSize 64 /* vertices claimed by a thread at a time */
+#define kAlgoGraphTopoSortParallelLocalCapacity 256 /* newly-ready vertices buffered by each thread before merging */
+typedef struct AlgoGraphTopoSortParallelImpl
 {
-	if (NULL == graph ||
-		0 == iGraphIsValidVertexId(graph, vertexId))
+	const void *thisBuffer;
+	size_t thisBufferSize;
+	AlgoGraphImpl *graph;
+	int32_t threadCount;
+	int32_t *sortedVertices; /* also serves as the queue of ready vertices; each level is a contiguous range */
+	int32_t *vertexLevels; /* may be NULL */
+	volatile int32_t *vertexInDegrees; /* remaining unsorted predecessors of each vertex */
+	volatile int32_t sortedCount;
+	volatile int32_t nextChunk; /* index of the next unclaimed vertex in the current level */
+	IBarrier barrier;
+	int32_t *localVertices; /* kAlgoGraphTopoSortParallelLocalCapacity elements per thread */
+} AlgoGraphTopoSortParallelImpl;
+
+AlgoError algoGraphTopoSortParallelComputeBufferSize(size_t *outBufferSize, const AlgoGraph graph, int32_t threadCount)
+{
+	if (NULL == outBufferSize ||
+		NULL == graph ||
+		threadCount <= 0)
 	{
 		return kAlgoErrorInvalidArgument;
 	}
-	graph->vertexData[vertexId] = value;
+	size_t inDegreesSize = graph->vertexCapacity * sizeof(int32_t);
+	size_t localSize     = threadCount * kAlgoGraphTopoSortParallelLocalCapacity * sizeof(int32_t);
+	*outBufferSize = sizeof(AlgoGraphTopoSortParallelImpl) + inDegreesSize + localSize;
 	return kAlgoErrorNone;
 }
-AlgoError algoGraphAddVertex(AlgoGraph graph, AlgoData vertexData, int32_t *outVertexId)
+AlgoError algoGraphTopoSortParallelCreate(AlgoGraphTopoSortParallel *outSort, const AlgoGraph graph, int32_t threadCount,
+	int32_t outSortedVertices[], size_t sortedVertexCount, int32_t outVertexLevels[], void *buffer, size_t bufferSize)
 {
-	int32_t newVertexId;
-	if (NULL == graph)
+	if (NULL == outSort ||
+		NULL == graph ||
+		NULL == outSortedVertices ||
+		sortedVertexCount < (size_t)graph->currentVertexCount ||
+		NULL == buffer)
 	{
 		return kAlgoErrorInvalidArgument;
 	}
-	if (graph->currentVertexCount >= graph->vertexCapacity)
+	if (kAlgoGraphEdgeUndirected == graph->edgeMode)
 	{
 		return kAlgoErrorOperationFailed;
 	}
-	newVertexId = graph->nextFreeVertexId;
-	ALGO_ASSERT(newVertexId >= 0 && newVertexId < graph->vertexCapacity); /* <0 means the vertex pool is empty */
-	graph->nextFreeVertexId = graph->vertexData[newVertexId].asInt;
-	if (NULL != outVertexId)
+	size_t minBufferSize = 0;
+	AlgoError err;
+	uint8_t *bufferNext = (uint8_t*)buffer;
+	err = algoGraphTopoSortParallelComputeBufferSize(&minBufferSize, graph, threadCount);
+	if (bufferSize < minBufferSize ||
+		kAlgoErrorNone != err)
 	{
-		*outVertexId = newVertexId;
+		return kAlgoErrorInvalidArgument;
 	}
-	graph->vertexDegrees[newVertexId] = 0;
-	graph->vertexEdges[newVertexId] = 0;
-	graph->vertexData[newVertexId] = vertexData;
-	graph->validVertexIds[graph->currentVertexCount] = newVertexId;
-	graph->vertexIdToValidIndex[newVertexId] = graph->currentVertexCount;
-	graph->currentVertexCount += 1;
+
+	size_t inDegreesSize = graph->vertexCapacity * sizeof(int32_t);
+	size_t localSize     = threadCount * kAlgoGraphTopoSortParallelLocalCapacity * sizeof(int32_t);
+
+	(*outSort) = (AlgoGraphTopoSortParallelImpl*)bufferNext;
+	bufferNext += sizeof(AlgoGraphTopoSortParallelImpl);
+
+	int32_t *inDegrees = (int32_t*)bufferNext;
+	bufferNext += inDegreesSize;
+
+	int32_t *localVertices = (int32_t*)bufferNext;
+	bufferNext += localSize;
+
+	ALGO_ASSERT( bufferNext-minBufferSize == buffer ); /* If this fails, algoGraphTopoSortParallelComputeBufferSize() is out of date */
+	(*outSort)->thisBuffer      = buffer;
+	(*outSort)->thisBufferSize  = bufferSize;
+	(*outSort)->graph           = graph;
+	(*outSort)->threadCount     = threadCount;
+	(*outSort)->sortedVertices  = outSortedVertices;
+	(*outSort)->vertexLevels    = outVertexLevels;
+	(*outSort)->vertexInDegrees = inDegrees;
+	(*outSort)->sortedCount     = 0;
+	(*outSort)->nextChunk       = 0;
+	(*outSort)->localVertices   = localVertices;
+	iBarrierInit(&(*outSort)->barrier, threadCount);
 	return kAlgoErrorNone;
 }
-AlgoError algoGraphRemoveVertex(AlgoGraph graph, int32_t vertexId)
+AlgoError algoGraphTopoSortParallelGetBufferSize(const AlgoGraphTopoSortParallel sort, size_t *outBufferSize)
 {
-	if (NULL == graph ||
-		0 == iGraphIsValidVertexId(graph, vertexId))
+	if (NULL == sort ||
+		NULL == outBufferSize)
 	{
 		return kAlgoErrorInvalidArgument;
 	}
-	if (kAlgoGraphEdgeUndirected == graph->edgeMode)
-	{
-		AlgoGraphEdge *outEdge = graph->vertexEdges[vertexId];
-		while(outEdge != NULL)
-		{
-			int removed = 0;
-			int32_t destVertexId = outEdge->destVertex;
-			/* remove incoming edge */
-			ALGO_ASSERT(graph->vertexEdges[destVertexId]); /* for undirected graphs, there must at least be an edge going back to vertexId! */
-			removed = iGraphRemoveEdgeFromList(graph, destVertexId, vertexId);
-			ALGO_ASSERT(removed); /* this removal MUST succeed, or else an invariant has failed somewhere. */
-			/* Remove outgoing edge */
-			AlgoGraphEdge *outToFree = outEdge;
-			outEdge = outEdge->next;
-			algoAllocPoolFree(graph->edgePool, outToFree);
-			graph->currentEdgeCount -= 1;
-		}
-	}
-	else /* kAlgoGraphEdgeDirected == graph->edgeMode */
-	{
-		/* Remove all outgoing edges */
-		AlgoGraphEdge *outEdge = graph->vertexEdges[vertexId];
-		int32_t iValidVert;
-		while(outEdge != NULL)
-		{
-			AlgoGraphEdge *outToFree = outEdge;
-			outEdge = outEdge->next;
-			algoAllocPoolFree(graph->edgePool, outToFree);
-			graph->currentEdgeCount -= 1;
-		}
-		/* Prevent this vert's edge list from being searched in the loop below */
-		graph->vertexDegrees[vertexId] = 0;
-		graph->vertexEdges[vertexId] = NULL;
-		/*	Search all other vertices for incoming edges, and remove them. This *really* sucks, but to avoid it I'd need:
-			-	a per-vertex list of vertices with edges linking to that vertex, which uses O(E) more memory but reduces running time to
-				O(1) expected / O(E) worst-case, and adds a lot of extra bookkeeping.
-			*/
-		for(iValidVert=0; iValidVert<graph->currentVertexCount; iValidVert += 1)
-		{
-			int32_t srcVertexId = graph->validVertexIds[iValidVert];
-			if (!iGraphIsValidVertexId(graph, srcVertexId))
-				continue;
-			int removed = iGraphRemoveEdgeFromList(graph, srcVertexId, vertexId);
-			graph->currentEdgeCount -= (removed ? 1 : 0);
-		}
-	}
-	/* Finally, remove the vertex. */
-	graph->vertexData[vertexId].asInt = graph->nextFreeVertexId;
-	graph->nextFreeVertexId = vertexId;
-	{
-		/* Update the valid vertex list and reverse-lookup table */
-		int32_t destValidIndex = graph->vertexIdToValidIndex[vertexId];
-		int32_t finalValidVertexId = graph->validVertexIds[graph->currentVertexCount-1];
-		graph->validVertexIds[destValidIndex] = finalValidVertexId;
-		graph->vertexIdToValidIndex[finalValidVertexId] = destValidIndex;
-	}
-	graph->currentVertexCount -= 1;
-	graph->vertexDegrees[vertexId] = -1;
-	graph->vertexEdges[vertexId] = NULL;
+	*outBufferSize = sort->thisBufferSize;
 	return kAlgoErrorNone;
 }
-AlgoError algoGraphAddEdge(AlgoGraph graph, int32_t srcVertexId, int32_t destVertexId)
+
+/* Appends this thread's buffered vertices to the end of the sorted list. */
+ALGO_INTERNAL void iGraphTopoSortParallelFlush(AlgoGraphTopoSortParallel sort, const int32_t *localVertices, int32_t localCount)
 {
-	if (NULL == graph ||
-		0 == iGraphIsValidVertexId(graph, srcVertexId) ||
-		0 == iGraphIsValidVertexId(graph, destVertexId) ||
-		srcVertexId == destVertexId /* no self-connecting edges */
-		)
+	if (0 == localCount)
+		return;
+	int32_t firstIndex = iAtomicFetchAdd32(&sort->sortedCount, localCount);
+	ALGO_ASSERT(firstIndex + localCount <= sort->graph->currentVertexCount);
+	ALGO_MEMCPY(sort->sortedVertices + firstIndex, localVertices, localCount*sizeof(int32_t));
+}
+
+AlgoError algoGraphTopoSortParallel(AlgoGraphTopoSortParallel sort, int32_t threadIndex)
+{
+	if (NULL == sort ||
+		threadIndex < 0 || threadIndex >= sort->threadCount)
 	{
 		return kAlgoErrorInvalidArgument;
 	}
-
-	{
-		/* check that a src->dest edge doesn't already exist; return immediately if so. */
-		for(AlgoGraphEdge *edge = graph->vertexEdges[srcVertexId];
-			edge != NULL;
-			edge = edge->next)
+	AlgoGraphImpl *graph = sort->graph;
+	volatile int32_t *inDegrees = sort->vertexInDegrees;
+	int32_t *localVertices = sort->localVertices + threadIndex*kAlgoGraphTopoSortParallelLocalCapacity;
+	int32_t localCount = 0;
+	/* Each thread initializes and counts the edges of its own slice of the vertices. */
+	const int32_t capacityBegin = (int32_t)((int64_t)graph->vertexCapacity *  threadIndex    / sort->threadCount);
+	const int32_t capacityEnd   = (int32_t)((int64_t)graph->vertexCapacity * (threadIndex+1) / sort->threadCount);
+	const int32_t validBegin    = (int32_t)((int64_t)graph->currentVertexCount *  threadIndex    / sort->threadCount);
+	const int32_t validEnd      = (int32_t)((int64_t)graph->currentVertexCount * (threadIndex+1) / sort->threadCount);
+	for(int32_t v=capacityBegin; v<capacityEnd; ++v)
+	{
+		inDegrees[v] = 0;
+		if (NULL != sort->vertexLevels)
+			sort->vertexLevels[v] = -1;
+	}
+	iBarrierWait(&sort->barrier);
+	for(int32_t iValidVert=validBegin; iValidVert<validEnd; ++iValidVert)
+	{
+		const int32_t v0 = graph->validVertexIds[iValidVert];
+		const AlgoGraphEdgeList *edgeList = graph->vertexEdges + v0;
+		const AlgoGraphEdgeBlock *block = iGraphEdgeListHead(graph, edgeList);
+		int32_t blockEdgeCount = iGraphHeadBlockEdgeCount(graph->vertexDegrees[v0]);
+		for(; NULL != block; block = iGraphNextEdgeBlock(graph, edgeList, block), blockEdgeCount = kAlgoGraphEdgeBlockCapacity)
 		{
-			if (edge->destVertex == destVertexId)
-				return kAlgoErrorNone;
-		}
-
-		AlgoGraphEdge *newEdge = NULL;
-		AlgoError err = algoAllocPoolAlloc(graph->edgePool, (void**)&newEdge);
-		if (err != kAlgoErrorNone)
-		{
-			return kAlgoErrorOperationFailed; /* exceeded edge capacity */
+			int32_t iEdge;
+			for(iEdge=0; iEdge<blockEdgeCount; ++iEdge)
+			{
+				iAtomicFetchAdd32(inDegrees + block->destVertices[iEdge], 1);
+			}
 		}
-		newEdge->weight = 0;
-		newEdge->destVertex = destVertexId;
-		newEdge->next = graph->vertexEdges[srcVertexId];
-		graph->vertexEdges[srcVertexId] = newEdge;
-		graph->vertexDegrees[srcVertexId] += 1;
 	}
-
-	if (graph->edgeMode == kAlgoGraphEdgeUndirected)
+	iBarrierWait(&sort->barrier);
+	/* Vertices with no predecessors form level 0. */
+	for(int32_t iValidVert=validBegin; iValidVert<validEnd; ++iValidVert)
 	{
-		/* check that a dest->src edge doesn't already exist; return immediately if so. */
-		for(AlgoGraphEdge *edge = graph->vertexEdges[destVertexId];
-			edge != NULL;
-			edge = edge->next)
+		const int32_t v0 = graph->validVertexIds[iValidVert];
+		if (0 != inDegrees[v0])
+			continue;
+		if (NULL != sort->vertexLevels)
+			sort->vertexLevels[v0] = 0;
+		if (localCount == kAlgoGraphTopoSortParallelLocalCapacity)
 		{
-			if (edge->destVertex == srcVertexId)
-				return kAlgoErrorNone;
+			iGraphTopoSortParallelFlush(sort, localVertices, localCount);
+			localCount = 0;
 		}
-
-		/* Add a second edge in the opposite direction */
-		AlgoGraphEdge *newEdge = NULL;
-		AlgoError err = algoAllocPoolAlloc(graph->edgePool, (void**)&newEdge);
-		if (err != kAlgoErrorNone)
+		localVertices[localCount++] = v0;
+	}
+	iGraphTopoSortParallelFlush(sort, localVertices, localCount);
+	localCount = 0;
+
+	/* Sort one level at a time. Level L occupies sortedVertices[levelBegin..levelEnd); removing its vertices' edges
+	   leaves exactly the vertices of level L+1 with no remaining predecessors. */
+	int32_t levelBegin = 0, levelEnd = 0;
+	for(int32_t level=0; ; ++level)
+	{
+		/* Wait for the previous level to be merged, then make sure every thread has read its extent before anyone
+		   starts appending the next one. */
+		iBarrierWait(&sort->barrier);
+		levelBegin = levelEnd;
+		levelEnd = sort->sortedCount;
+		if (0 == threadIndex)
+			sort->nextChunk = levelBegin;
+		iBarrierWait(&sort->barrier);
+		if (levelBegin == levelEnd)
+			break;
+		int32_t chunkBegin;
+		while( (chunkBegin = iAtomicFetchAdd32(&sort->nextChunk, kAlgoGraphTopoSortParallelChunkSize)) < levelEnd )
 		{
-			/* TODO: free previous edge? or just assert that this can't happen? */
-			return kAlgoErrorOperationFailed; /* exceeded edge capacity */
+			const int32_t chunkEnd = (chunkBegin + kAlgoGraphTopoSortParallelChunkSize < levelEnd)
+				? chunkBegin + kAlgoGraphTopoSortParallelChunkSize : levelEnd;
+			int32_t iSorted;
+			for(iSorted=chunkBegin; iSorted<chunkEnd; ++iSorted)
+			{
+				const int32_t v0 = sort->sortedVertices[iSorted];
+				const AlgoGraphEdgeList *edgeList = graph->vertexEdges + v0;
+				const AlgoGraphEdgeBlock *block = iGraphEdgeListHead(graph, edgeList);
+				int32_t blockEdgeCount = iGraphHeadBlockEdgeCount(graph->vertexDegrees[v0]);
+				for(; NULL != block; block = iGraphNextEdgeBlock(graph, edgeList, block), blockEdgeCount = kAlgoGraphEdgeBlockCapacity)
+				{
+					int32_t iEdge;
+					for(iEdge=0; iEdge<blockEdgeCount; ++iEdge)
+					{
+						const int32_t v1 = block->destVertices[iEdge];
+						if (1 != iAtomicFetchAdd32(inDegrees + v1, -1))
+							continue; /* v1 still has unsorted predecessors */
+						if (NULL != sort->vertexLevels)
+							sort->vertexLevels[v1] = level+1;
+						if (localCount == kAlgoGraphTopoSortParallelLocalCapacity)
+						{
+							iGraphTopoSortParallelFlush(sort, localVertices, localCount);
+							localCount = 0;
+						}
+						localVertices[localCount++] = v1;
+					}
+				}
+			}
 		}
-		newEdge->weight = 0;
-		newEdge->destVertex = srcVertexId;
-		newEdge->next = graph->vertexEdges[destVertexId];
-		graph->vertexEdges[destVertexId] = newEdge;
-		graph->vertexDegrees[destVertexId] += 1;
-	}
-
-	/* As implemented, this counts "logical" edges, not actual AlgoGraphEdge objects. An undirected
-		edge will allocate two AlgoGraphEdge objects, but only increment this value once. */
-	graph->currentEdgeCount += 1;
-
-	return kAlgoErrorNone;
-}
-AlgoError algoGraphRemoveEdge(AlgoGraph graph, int32_t srcVertexId, int32_t destVertexId)
-{
-	if (NULL == graph ||
-		0 == iGraphIsValidVertexId(graph, srcVertexId) ||
-		0 == iGraphIsValidVertexId(graph, destVertexId))
-	{
-		return kAlgoErrorInvalidArgument;
-	}
-
-	int removed = iGraphRemoveEdgeFromList(graph, srcVertexId, destVertexId);
-	if (!removed)
-		return kAlgoErrorOperationFailed;
-	if (kAlgoGraphEdgeUndirected == graph->edgeMode)
-	{
-		removed = iGraphRemoveEdgeFromList(graph, destVertexId, srcVertexId);
-		if (!removed)
-			return kAlgoErrorOperationFailed;
+		iGraphTopoSortParallelFlush(sort, localVertices, localCount);
+		localCount = 0;
 	}
-	graph->currentEdgeCount -= 1;
-	return kAlgoErrorNone;
+	/* Vertices on (or downstream of) a cycle never run out of predecessors. */
+	return (levelEnd == graph->currentVertexCount) ? kAlgoErrorNone : kAlgoErrorOperationFailed;
 }
 
-ALGO_INTERNAL ALGO_INLINE void iSetBit(int32_t *bits, size_t capacity, int32_t index)
-{
-	ALGO_ASSERT(index >= 0 && (size_t)index < capacity);
-	ALGO_UNUSED(capacity);
-	bits[index/32] |= 1<<(index%32);
-}
-ALGO_INTERNAL ALGO_INLINE void iClearBit(int32_t *bits, size_t capacity, int32_t index)
-{
-	ALGO_ASSERT(index >= 0 && (size_t)index < capacity);
-	ALGO_UNUSED(capacity);
-	bits[index/32] &= ~(1<<(index%32));
-}
-ALGO_INTERNAL ALGO_INLINE void iFlipBit(int32_t *bits, size_t capacity, int32_t index)
-{
-	ALGO_ASSERT(index >= 0 && (size_t)index < capacity);
-	ALGO_UNUSED(capacity);
-	bits[index/32] ^= 1<<(index%32);
-}
-ALGO_INTERNAL ALGO_INLINE int32_t iTestBit(const int32_t *bits, size_t capacity, int32_t index)
-{
-	ALGO_ASSERT(index >= 0 && (size_t)index < capacity);
-	ALGO_UNUSED(capacity);
-	return ( bits[index/32] & (1<<(index%32)) ) ? 1 : 0;
-}
+/* algoGraphTopoOrderAddEdge() only reorders with Pearce & Kelly's backward search while the affected vertices stay
+   below 1/kAlgoGraphTopoOrderRegionFraction of the region between the new edge's endpoints. */
+#define kAlgoGraphTopoOrderRegionFraction 8
 
-typedef struct AlgoGraphBfsStateImpl
+typedef struct AlgoGraphTopoOrderImpl
 {
 	const void *thisBuffer;
 	size_t thisBufferSize;
 	AlgoGraphImpl *graph;
-	int32_t *isVertexDiscovered;
-	int32_t *isVertexProcessed;
-	int32_t *vertexParents;
-	AlgoQueue vertexQueue;
-} AlgoGraphBfsStateImpl;
-AlgoError algoGraphBfsStateComputeBufferSize(size_t *outBufferSize, const AlgoGraph graph)
+	int32_t *vertexIndices; /* position of each vertex ID in the order */
+	int32_t *indexVertices; /* vertex ID at each position; the inverse of vertexIndices */
+	int32_t *isVertexReached; /* bit array; scratch space for algoGraphTopoOrderAddEdge() */
+	int32_t *vertexStack; /* scratch space for algoGraphTopoOrderAddEdge() */
+	int32_t *affectedVertices; /* vertices found by the forward & backward searches; scratch space for algoGraphTopoOrderAddEdge() */
+} AlgoGraphTopoOrderImpl;
+
+AlgoError algoGraphTopoOrderComputeBufferSize(size_t *outBufferSize, const AlgoGraph graph)
 {
 	if (NULL == outBufferSize ||
 		NULL == graph)
@@ -1731,31 +7733,31 @@ AlgoError algoGraphBfsStateComputeBufferSize(size_t *outBufferSize, const AlgoGr
 		return kAlgoErrorInvalidArgument;
 	}
 	int32_t vertexCapacityRounded = (graph->vertexCapacity+31) & ~31;
-	size_t discoveredSize         = vertexCapacityRounded * sizeof(int32_t)  / 32;
-	size_t processedSize          = vertexCapacityRounded * sizeof(int32_t)  / 32;
-	size_t parentsSize            = graph->vertexCapacity * sizeof(int32_t);
-	size_t queueSize              = 0;
-	AlgoError err;
-	err = algoQueueComputeBufferSize(&queueSize, graph->vertexCapacity);
-	if (kAlgoErrorNone != err)
-	{
-		return kAlgoErrorInvalidArgument;
-	}
-	*outBufferSize = sizeof(AlgoGraphBfsStateImpl) + discoveredSize + processedSize + parentsSize + queueSize;
+	size_t vertexIndicesSize = graph->vertexCapacity * sizeof(int32_t);
+	size_t indexVerticesSize = graph->vertexCapacity * sizeof(int32_t);
+	size_t reachedSize       = vertexCapacityRounded * sizeof(int32_t) / 32;
+	size_t stackSize         = graph->vertexCapacity * sizeof(int32_t);
+	size_t affectedSize      = graph->vertexCapacity * sizeof(int32_t);
+	*outBufferSize = sizeof(AlgoGraphTopoOrderImpl) + vertexIndicesSize + indexVerticesSize + reachedSize + stackSize
+		+ affectedSize;
 	return kAlgoErrorNone;
 }
-AlgoError algoGraphBfsStateCreate(AlgoGraphBfsState *outState, const AlgoGraph graph, void *buffer, size_t bufferSize)
+AlgoError algoGraphTopoOrderCreate(AlgoGraphTopoOrder *outOrder, AlgoGraph graph, void *buffer, size_t bufferSize)
 {
-	if (NULL == outState ||
+	if (NULL == outOrder ||
 		NULL == graph ||
 		NULL == buffer)
 	{
 		return kAlgoErrorInvalidArgument;
 	}
+	if (kAlgoGraphEdgeUndirected == graph->edgeMode)
+	{
+		return kAlgoErrorOperationFailed;
+	}
 	size_t minBufferSize = 0;
 	AlgoError err;
 	uint8_t *bufferNext = (uint8_t*)buffer;
-	err = algoGraphBfsStateComputeBufferSize(&minBufferSize, graph);
+	err = algoGraphTopoOrderComputeBufferSize(&minBufferSize, graph);
 	if (bufferSize < minBufferSize ||
 		kAlgoErrorNone != err)
 	{
@@ -1763,499 +7765,647 @@ AlgoError algoGraphBfsStateCreate(AlgoGraphBfsState *outState, const AlgoGraph g
 	}
 
 	int32_t vertexCapacityRounded = (graph->vertexCapacity+31) & ~31;
-	size_t discoveredSize         = vertexCapacityRounded * sizeof(int32_t) / 32;
-	size_t processedSize          = vertexCapacityRounded * sizeof(int32_t)  / 32;
-	size_t parentsSize            = graph->vertexCapacity * sizeof(int32_t);
-	size_t queueSize              = 0;
+	size_t vertexIndicesSize = graph->vertexCapacity * sizeof(int32_t);
+	size_t indexVerticesSize = graph->vertexCapacity * sizeof(int32_t);
+	size_t reachedSize       = vertexCapacityRounded * sizeof(int32_t) / 32;
+	size_t stackSize         = graph->vertexCapacity * sizeof(int32_t);
+	size_t affectedSize      = graph->vertexCapacity * sizeof(int32_t);
 
-	(*outState) = (AlgoGraphBfsStateImpl *)bufferNext;
-	bufferNext += sizeof(AlgoGraphBfsStateImpl);
+	(*outOrder) = (AlgoGraphTopoOrderImpl*)bufferNext;
+	bufferNext += sizeof(AlgoGraphTopoOrderImpl);
 
-	int32_t *discovered = (int32_t*)bufferNext;
-	bufferNext += discoveredSize;
+	int32_t *vertexIndices = (int32_t*)bufferNext;
+	bufferNext += vertexIndicesSize;
 
-	int32_t *processed = (int32_t*)bufferNext;
-	bufferNext += processedSize;
+	int32_t *indexVertices = (int32_t*)bufferNext;
+	bufferNext += indexVerticesSize;
 
-	int32_t *parents = (int32_t*)bufferNext;
-	bufferNext += parentsSize;
+	int32_t *reached = (int32_t*)bufferNext;
+	bufferNext += reachedSize;
 
-	err = algoQueueComputeBufferSize(&queueSize, graph->vertexCapacity);
-	if (kAlgoErrorNone != err)
+	int32_t *stack = (int32_t*)bufferNext;
+	bufferNext += stackSize;
+
+	int32_t *affected = (int32_t*)bufferNext;
+	bufferNext += affectedSize;
+
+	ALGO_ASSERT( bufferNext-minBufferSize == buffer ); /* If this fails, algoGraphTopoOrderComputeBufferSize() is out of date */
+	(*outOrder)->thisBuffer      = buffer;
+	(*outOrder)->thisBufferSize  = bufferSize;
+	(*outOrder)->graph           = graph;
+	(*outOrder)->vertexIndices   = vertexIndices;
+	(*outOrder)->indexVertices   = indexVertices;
+	(*outOrder)->isVertexReached = reached;
+	(*outOrder)->vertexStack     = stack;
+	(*outOrder)->affectedVertices = affected;
+	ALGO_MEMSET(reached, 0, reachedSize);
+
+	/* Compute the initial order with Kahn's algorithm, using the stack to count each vertex's incoming edges and the
+	   order itself as the queue. Unused vertex IDs have no edges, so they're placed at the end; that way, vertices
+	   added to the graph later already have a valid position. */
+	int32_t *inDegrees = stack;
+	ALGO_MEMSET(inDegrees, 0, stackSize);
+	for(int32_t iValidVert=0; iValidVert<graph->currentVertexCount; ++iValidVert)
+	{
+		const int32_t v0 = graph->validVertexIds[iValidVert];
+		const AlgoGraphEdgeList *edgeList = graph->vertexEdges + v0;
+		const AlgoGraphEdgeBlock *block = iGraphEdgeListHead(graph, edgeList);
+		int32_t blockEdgeCount = iGraphHeadBlockEdgeCount(graph->vertexDegrees[v0]);
+		for(; NULL != block; block = iGraphNextEdgeBlock(graph, edgeList, block), blockEdgeCount = kAlgoGraphEdgeBlockCapacity)
+		{
+			int32_t iEdge;
+			for(iEdge=0; iEdge<blockEdgeCount; ++iEdge)
+			{
+				inDegrees[block->destVertices[iEdge]] += 1;
+			}
+		}
+	}
+	int32_t orderSize = 0;
+	for(int32_t iValidVert=0; iValidVert<graph->currentVertexCount; ++iValidVert)
 	{
-		return kAlgoErrorInvalidArgument;
+		if (0 == inDegrees[graph->validVertexIds[iValidVert]])
+			indexVertices[orderSize++] = graph->validVertexIds[iValidVert];
 	}
-	AlgoQueue vertexQueue;
-	err = algoQueueCreate(&vertexQueue, graph->vertexCapacity, bufferNext, queueSize);
-	if (kAlgoErrorNone != err)
+	for(int32_t iIndex=0; iIndex<orderSize; ++iIndex)
 	{
-		return kAlgoErrorInvalidArgument;
+		const int32_t v0 = indexVertices[iIndex];
+		const AlgoGraphEdgeList *edgeList = graph->vertexEdges + v0;
+		const AlgoGraphEdgeBlock *block = iGraphEdgeListHead(graph, edgeList);
+		int32_t blockEdgeCount = iGraphHeadBlockEdgeCount(graph->vertexDegrees[v0]);
+		for(; NULL != block; block = iGraphNextEdgeBlock(graph, edgeList, block), blockEdgeCount = kAlgoGraphEdgeBlockCapacity)
+		{
+			int32_t iEdge;
+			for(iEdge=0; iEdge<blockEdgeCount; ++iEdge)
+			{
+				const int32_t v1 = block->destVertices[iEdge];
+				inDegrees[v1] -= 1;
+				if (0 == inDegrees[v1])
+					indexVertices[orderSize++] = v1;
+			}
+		}
 	}
-	bufferNext += queueSize;
-
-	ALGO_ASSERT( bufferNext-minBufferSize == buffer ); /* If this fails, algoGraphBfsStateComputeBufferSize() is out of date */
-	(*outState)->thisBuffer         = buffer;
-(	 *outState)->thisBufferSize     = bufferSize;
-	(*outState)->graph              = graph;
-	(*outState)->isVertexDiscovered = discovered;
-	(*outState)->isVertexProcessed  = processed;
-	(*outState)->vertexParents      = parents;
-	(*outState)->vertexQueue        = vertexQueue;
-
-	ALGO_MEMSET(discovered, 0, discoveredSize);
-	ALGO_MEMSET(processed,  0, processedSize);
-	for(int iParent=0; iParent<graph->vertexCapacity; ++iParent)
+	if (orderSize != graph->currentVertexCount)
+	{
+		return kAlgoErrorOperationFailed; /* the graph contains a cycle */
+	}
+	for(int32_t vertexId=0; vertexId<graph->vertexCapacity; ++vertexId)
 	{
-		parents[iParent] = -1;
+		if (graph->vertexDegrees[vertexId] < 0) /* unused vertex ID */
+			indexVertices[orderSize++] = vertexId;
+	}
+	ALGO_ASSERT(orderSize == graph->vertexCapacity);
+	for(int32_t iIndex=0; iIndex<orderSize; ++iIndex)
+	{
+		vertexIndices[indexVertices[iIndex]] = iIndex;
 	}
 	return kAlgoErrorNone;
 }
-
-AlgoError algoGraphBfsStateGetBufferSize(const AlgoGraphBfsState bfsState, size_t *outBufferSize)
+AlgoError algoGraphTopoOrderGetBufferSize(const AlgoGraphTopoOrder order, size_t *outBufferSize)
 {
-	if (NULL == bfsState ||
+	if (NULL == order ||
 		NULL == outBufferSize)
 	{
 		return kAlgoErrorInvalidArgument;
 	}
-	*outBufferSize = bfsState->thisBufferSize;
+	*outBufferSize = order->thisBufferSize;
 	return kAlgoErrorNone;
 }
 
-AlgoError algoGraphBfsStateIsVertexDiscovered(const AlgoGraphBfsState bfsState, int32_t vertexId, int *outIsDiscovered)
+/* Sorts vertices[] by their current positions in the order, with a heapsort. */
+ALGO_INTERNAL void iGraphTopoOrderSiftDown(const int32_t vertexIndices[], int32_t vertices[], int32_t root, int32_t count)
 {
-	if (NULL == bfsState ||
-		NULL == outIsDiscovered ||
-		vertexId < 0 || vertexId >= bfsState->graph->vertexCapacity)
+	const int32_t vertexId = vertices[root];
+	for(;;)
 	{
-		return kAlgoErrorInvalidArgument;
+		int32_t child = 2*root + 1;
+		if (child >= count)
+			break;
+		if (child+1 < count && vertexIndices[vertices[child+1]] > vertexIndices[vertices[child]])
+			child += 1;
+		if (vertexIndices[vertices[child]] <= vertexIndices[vertexId])
+			break;
+		vertices[root] = vertices[child];
+		root = child;
 	}
-	*outIsDiscovered = iTestBit(bfsState->isVertexDiscovered, bfsState->graph->vertexCapacity, vertexId);
-	return kAlgoErrorNone;
+	vertices[root] = vertexId;
 }
-AlgoError algoGraphBfsStateIsVertexProcessed(const AlgoGraphBfsState bfsState, int32_t vertexId, int *outIsProcessed)
+ALGO_INTERNAL void iGraphTopoOrderSortVertices(const int32_t vertexIndices[], int32_t vertices[], int32_t count)
 {
-	if (NULL == bfsState ||
-		NULL == outIsProcessed ||
-		vertexId < 0 || vertexId >= bfsState->graph->vertexCapacity)
+	for(int32_t iRoot=count/2-1; iRoot>=0; --iRoot)
 	{
-		return kAlgoErrorInvalidArgument;
+		iGraphTopoOrderSiftDown(vertexIndices, vertices, iRoot, count);
 	}
-	*outIsProcessed = iTestBit(bfsState->isVertexProcessed, bfsState->graph->vertexCapacity, vertexId);
-	return kAlgoErrorNone;
-}
-AlgoError algoGraphBfsStateGetVertexParent(const AlgoGraphBfsState bfsState, int32_t vertexId, int32_t *outParentVertexId)
-{
-	if (NULL == bfsState ||
-		NULL == outParentVertexId ||
-		!iGraphIsValidVertexId(bfsState->graph, vertexId))
+	for(int32_t iEnd=count-1; iEnd>0; --iEnd)
 	{
-		return kAlgoErrorInvalidArgument;
+		const int32_t largest = vertices[0];
+		vertices[0] = vertices[iEnd];
+		vertices[iEnd] = largest;
+		iGraphTopoOrderSiftDown(vertexIndices, vertices, 0, iEnd);
 	}
-	*outParentVertexId = bfsState->vertexParents[vertexId];
-	return kAlgoErrorNone;
 }
 
-
-AlgoError algoGraphBfs(const AlgoGraph graph, AlgoGraphBfsState bfsState, int32_t rootVertexId, AlgoGraphBfsCallbacks callbacks)
+AlgoError algoGraphTopoOrderAddEdge(AlgoGraphTopoOrder order, int32_t srcVertexId, int32_t destVertexId)
 {
-	if (NULL == graph ||
-		NULL == bfsState ||
-		graph != bfsState->graph ||
-		0 == iGraphIsValidVertexId(graph, rootVertexId))
+	if (NULL == order ||
+		0 == iGraphIsValidVertexId(order->graph, srcVertexId) ||
+		0 == iGraphIsValidVertexId(order->graph, destVertexId) ||
+		srcVertexId == destVertexId)
 	{
 		return kAlgoErrorInvalidArgument;
 	}
-	AlgoError err;
+	AlgoGraphImpl *graph = order->graph;
+	const int32_t lowerBound = order->vertexIndices[destVertexId];
+	const int32_t upperBound = order->vertexIndices[srcVertexId];
+	if (upperBound < lowerBound)
+	{
+		return algoGraphAddEdge(graph, srcVertexId, destVertexId); /* the order is already valid */
+	}
+	/* The new edge points backwards. Only vertices between dest and src in the current order can be affected. Search
+	   forward from dest for the ones it reaches; if src is one of them, the new edge would close a cycle. */
 	int32_t vertexCapacityRounded = (graph->vertexCapacity+31) & ~31;
-	err = algoQueueInsert(bfsState->vertexQueue, algoDataFromInt(rootVertexId));
-	iSetBit(bfsState->isVertexDiscovered, vertexCapacityRounded, rootVertexId);
-	int32_t currentQueueSize = 1;
-	do
+	int32_t *reached = order->isVertexReached;
+	int32_t *stack = order->vertexStack;
+	int32_t *affected = order->affectedVertices;
+	int32_t stackSize = 0, forwardCount = 0;
+	int isCycle = 0;
+	iSetBit(reached, vertexCapacityRounded, destVertexId);
+	affected[forwardCount++] = destVertexId;
+	stack[stackSize++] = destVertexId;
+	while(stackSize > 0 && !isCycle)
+	{
+		const int32_t v0 = stack[--stackSize];
+		const AlgoGraphEdgeList *edgeList = graph->vertexEdges + v0;
+		const AlgoGraphEdgeBlock *block = iGraphEdgeListHead(graph, edgeList);
+		int32_t blockEdgeCount = iGraphHeadBlockEdgeCount(graph->vertexDegrees[v0]);
+		for(; NULL != block; block = iGraphNextEdgeBlock(graph, edgeList, block), blockEdgeCount = kAlgoGraphEdgeBlockCapacity)
+		{
+			int32_t iEdge;
+			for(iEdge=0; iEdge<blockEdgeCount; ++iEdge)
+			{
+				const int32_t v1 = block->destVertices[iEdge];
+				if (order->vertexIndices[v1] > upperBound ||
+					iTestBit(reached, vertexCapacityRounded, v1))
+				{
+					continue; /* already placed after src, or already visited */
+				}
+				if (v1 == srcVertexId)
+					isCycle = 1;
+				iSetBit(reached, vertexCapacityRounded, v1);
+				affected[forwardCount++] = v1;
+				stack[stackSize++] = v1;
+			}
+		}
+	}
+	if (isCycle)
 	{
-		AlgoData queueElem;
-		int32_t v0 = -1;
-		int32_t edgeCount = 0;
-		/* Pop the next vertex and process it. */
-		const AlgoGraphEdge *e = NULL;
-		err = algoQueueRemove(bfsState->vertexQueue, &queueElem);
-		v0 = queueElem.asInt;
-		ALGO_ASSERT( 1 == iGraphIsValidVertexId(graph, v0) );
-		if (NULL != callbacks.vertexFuncEarly)
-			callbacks.vertexFuncEarly(graph, bfsState, v0, callbacks.vertexFuncEarlyUserData);
-		ALGO_ASSERT(0 == iTestBit(bfsState->isVertexProcessed, vertexCapacityRounded, v0));
-		iSetBit(bfsState->isVertexProcessed, vertexCapacityRounded, v0); /* must be set here to prevent undirected edges from looping infinitely. */
-		/* Explore v0's edges. */
-		e = graph->vertexEdges[v0];
-		while(NULL != e)
+		for(int32_t iAffected=0; iAffected<forwardCount; ++iAffected)
 		{
-			edgeCount += 1;
-			ALGO_ASSERT(edgeCount <= graph->vertexDegrees[v0]);
-			int32_t v1 = e->destVertex;
-			ALGO_ASSERT( 1 == iGraphIsValidVertexId(graph, v1) );
-			/* Run the edge function, if this is the first time we've seen it. */
-			if (0 == iTestBit(bfsState->isVertexProcessed, vertexCapacityRounded, v1) ||
-				graph->edgeMode == kAlgoGraphEdgeDirected)
+			iClearBit(reached, vertexCapacityRounded, affected[iAffected]);
+		}
+		return kAlgoErrorOperationFailed; /* the order is unchanged */
+	}
+
+	/* Search backward from src over incoming edges for the vertices that reach it and currently follow dest. None of
+	   them were reached by the forward search, or the new edge would have closed a cycle. Reassigning the two groups'
+	   positions costs O(n log n) in their size, so once they grow past a fraction of the region between dest and src,
+	   the search is abandoned in favor of the linear shift below. */
+	const int32_t affectedLimit = (upperBound - lowerBound + 1) / kAlgoGraphTopoOrderRegionFraction;
+	int32_t affectedCount = forwardCount;
+	int isBackwardSearchDone = 0;
+	if (NULL != graph->vertexInEdges &&
+		forwardCount < affectedLimit)
+	{
+		const AlgoGraphEdgeList *inEdgeLists = iGraphEdgeLists(graph, 1);
+		const int32_t *inDegrees = iGraphEdgeListDegrees(graph, 1);
+		iSetBit(reached, vertexCapacityRounded, srcVertexId);
+		affected[affectedCount++] = srcVertexId;
+		stackSize = 0;
+		stack[stackSize++] = srcVertexId;
+		while(stackSize > 0 && affectedCount <= affectedLimit)
+		{
+			const int32_t v0 = stack[--stackSize];
+			const AlgoGraphEdgeList *edgeList = inEdgeLists + v0;
+			const AlgoGraphEdgeBlock *block = iGraphEdgeListHead(graph, edgeList);
+			int32_t blockEdgeCount = iGraphHeadBlockEdgeCount(inDegrees[v0]);
+			for(; NULL != block; block = iGraphNextEdgeBlock(graph, edgeList, block), blockEdgeCount = kAlgoGraphEdgeBlockCapacity)
 			{
-				if (NULL != callbacks.edgeFunc)
-					callbacks.edgeFunc(graph, bfsState, v0, v1, callbacks.edgeFuncUserData);
+				int32_t iEdge;
+				for(iEdge=0; iEdge<blockEdgeCount; ++iEdge)
+				{
+					const int32_t v1 = block->destVertices[iEdge]; /* the edge's source */
+					if (order->vertexIndices[v1] < lowerBound ||
+						iTestBit(reached, vertexCapacityRounded, v1))
+					{
+						continue; /* already placed before dest, or already visited */
+					}
+					ALGO_ASSERT(v1 != destVertexId);
+					iSetBit(reached, vertexCapacityRounded, v1);
+					affected[affectedCount++] = v1;
+					stack[stackSize++] = v1;
+				}
 			}
-			/* Enqueue v1, if we haven't seen it before. */
-			if (0 == iTestBit(bfsState->isVertexDiscovered, vertexCapacityRounded, v1))
+		}
+		isBackwardSearchDone = (0 == stackSize);
+		if (!isBackwardSearchDone)
+		{
+			for(int32_t iAffected=forwardCount; iAffected<affectedCount; ++iAffected)
 			{
-				ALGO_ASSERT(0 == iTestBit(bfsState->isVertexProcessed, vertexCapacityRounded, v1));
-				iSetBit(bfsState->isVertexDiscovered, vertexCapacityRounded, v1);
-				err = algoQueueInsert(bfsState->vertexQueue, algoDataFromInt(v1));
-				bfsState->vertexParents[v1] = v0;
+				iClearBit(reached, vertexCapacityRounded, affected[iAffected]);
 			}
-			e = e->next;
 		}
-		ALGO_ASSERT(edgeCount == graph->vertexDegrees[v0]);
-		/* Run the late vertex function after all edges are processed. */
-		if (NULL != callbacks.vertexFuncLate)
-			callbacks.vertexFuncLate(graph, bfsState, v0, callbacks.vertexFuncLateUserData);
-		err = algoQueueGetCurrentSize(bfsState->vertexQueue, &currentQueueSize);
 	}
-	while (currentQueueSize > 0);
-	return kAlgoErrorNone;
-}
 
-typedef struct AlgoGraphDfsStateImpl
-{
-	const void *thisBuffer;
-	size_t thisBufferSize;
-	int32_t currentTime;
-	AlgoGraphImpl *graph;
-	int32_t *isVertexDiscovered;
-	int32_t *isVertexProcessed;
-	int32_t *vertexParents;
-	int32_t *vertexEntryTime;
-	int32_t *vertexExitTime;
-	AlgoGraphEdge **vertexNextEdge;
-	AlgoStack vertexStack;
-} AlgoGraphDfsStateImpl;
-AlgoError algoGraphDfsStateComputeBufferSize(size_t *outBufferSize, const AlgoGraph graph)
-{
-	if (NULL == outBufferSize ||
-		NULL == graph)
+	if (!isBackwardSearchDone)
 	{
-		return kAlgoErrorInvalidArgument;
+		/* Shift the vertices reached by the forward search after the rest of the region, keeping the relative order of
+		   both groups. Any edge leaving a reached vertex ends at another reached vertex or beyond the region, so the order
+		   stays valid. */
+		int32_t nextIndex = lowerBound, reachedIndex = 0;
+		for(int32_t iIndex=lowerBound; iIndex<=upperBound; ++iIndex)
+		{
+			const int32_t vertexId = order->indexVertices[iIndex];
+			if (iTestBit(reached, vertexCapacityRounded, vertexId))
+			{
+				iClearBit(reached, vertexCapacityRounded, vertexId);
+				stack[reachedIndex++] = vertexId;
+			}
+			else
+			{
+				order->indexVertices[nextIndex] = vertexId;
+				order->vertexIndices[vertexId] = nextIndex++;
+			}
+		}
+		ALGO_ASSERT(reachedIndex == forwardCount);
+		for(int32_t iReached=0; iReached<forwardCount; ++iReached)
+		{
+			order->indexVertices[nextIndex] = stack[iReached];
+			order->vertexIndices[stack[iReached]] = nextIndex++;
+		}
+		ALGO_ASSERT(nextIndex == upperBound+1);
+		return algoGraphAddEdge(graph, srcVertexId, destVertexId);
+	}
+
+	/* Pool the positions of both groups, then hand them out in order: first to the backward group, then to the forward
+	   group, each keeping its relative order. Every vertex that reaches src now precedes every vertex reachable from
+	   dest, and no other vertex moves. */
+	int32_t *forwardVertices = affected;
+	int32_t *backwardVertices = affected + forwardCount;
+	const int32_t backwardCount = affectedCount - forwardCount;
+	iGraphTopoOrderSortVertices(order->vertexIndices, forwardVertices, forwardCount);
+	iGraphTopoOrderSortVertices(order->vertexIndices, backwardVertices, backwardCount);
+	int32_t *positions = stack;
+	int32_t iForward = 0, iBackward = 0;
+	for(int32_t iPosition=0; iPosition<affectedCount; ++iPosition)
+	{
+		if (iBackward == backwardCount ||
+			(iForward < forwardCount && order->vertexIndices[forwardVertices[iForward]] < order->vertexIndices[backwardVertices[iBackward]]))
+		{
+			positions[iPosition] = order->vertexIndices[forwardVertices[iForward++]];
+		}
+		else
+		{
+			positions[iPosition] = order->vertexIndices[backwardVertices[iBackward++]];
+		}
 	}
-	int32_t vertexCapacityRounded = (graph->vertexCapacity+31) & ~31;
-	size_t discoveredSize         = vertexCapacityRounded * sizeof(int32_t)  / 32;
-	size_t processedSize          = vertexCapacityRounded * sizeof(int32_t)  / 32;
-	size_t parentsSize            = graph->vertexCapacity * sizeof(int32_t);
-	size_t entryTimeSize          = graph->vertexCapacity * sizeof(int32_t);
-	size_t exitTimeSize           = graph->vertexCapacity * sizeof(int32_t);
-	size_t nextEdgeSize           = graph->vertexCapacity * sizeof(AlgoGraphEdge*);
-	size_t stackSize = 0;
-	algoStackComputeBufferSize(&stackSize, graph->vertexCapacity);
-	*outBufferSize = sizeof(AlgoGraphDfsStateImpl) + discoveredSize + processedSize + parentsSize
-		+ entryTimeSize + exitTimeSize + nextEdgeSize + stackSize;
-	return kAlgoErrorNone;
-}
-AlgoError algoGraphDfsStateCreate(AlgoGraphDfsState *outState, const AlgoGraph graph, void *buffer, size_t bufferSize)
-{
-	size_t minBufferSize = 0;
-	AlgoError err;
-	uint8_t *bufferNext = (uint8_t*)buffer;
-	if (NULL == outState ||
-		NULL == graph ||
-		NULL == buffer)
+	for(int32_t iPosition=0; iPosition<affectedCount; ++iPosition)
 	{
-		return kAlgoErrorInvalidArgument;
+		const int32_t vertexId = (iPosition < backwardCount) ? backwardVertices[iPosition] : forwardVertices[iPosition-backwardCount];
+		iClearBit(reached, vertexCapacityRounded, vertexId);
+		order->indexVertices[positions[iPosition]] = vertexId;
+		order->vertexIndices[vertexId] = positions[iPosition];
 	}
-	err = algoGraphDfsStateComputeBufferSize(&minBufferSize, graph);
-	if (bufferSize < minBufferSize ||
-		kAlgoErrorNone != err)
+	return algoGraphAddEdge(graph, srcVertexId, destVertexId);
+}
+AlgoError algoGraphTopoOrderGetVertexIndex(const AlgoGraphTopoOrder order, int32_t vertexId, int32_t *outIndex)
+{
+	if (NULL == order ||
+		NULL == outIndex ||
+		0 == iGraphIsValidVertexId(order->graph, vertexId))
 	{
 		return kAlgoErrorInvalidArgument;
 	}
-
-	int32_t vertexCapacityRounded = (graph->vertexCapacity+31) & ~31;
-	size_t discoveredSize         = vertexCapacityRounded * sizeof(int32_t)  / 32;
-	size_t processedSize          = vertexCapacityRounded * sizeof(int32_t)  / 32;
-	size_t parentsSize            = graph->vertexCapacity * sizeof(int32_t);
-	size_t entryTimeSize          = graph->vertexCapacity * sizeof(int32_t);
-	size_t exitTimeSize           = graph->vertexCapacity * sizeof(int32_t);
-	size_t nextEdgeSize           = graph->vertexCapacity * sizeof(AlgoGraphEdge*);
-	size_t stackSize              = 0;
-
-	*outState = (AlgoGraphDfsStateImpl *)bufferNext;
-	bufferNext += sizeof(AlgoGraphDfsStateImpl);
-
-	int32_t *discovered = (int32_t*)bufferNext;
-	bufferNext += discoveredSize;
-
-	int32_t *processed = (int32_t*)bufferNext;
-	bufferNext += processedSize;
-
-	int32_t *vertexParents = (int32_t*)bufferNext;
-	bufferNext += parentsSize;
-
-	int32_t *entryTime = (int32_t*)bufferNext;
-	bufferNext += entryTimeSize;
-
-	int32_t *exitTime = (int32_t*)bufferNext;
-	bufferNext += exitTimeSize;
-
-	AlgoGraphEdge **vertexNextEdge = (AlgoGraphEdge**)bufferNext;
-	bufferNext += nextEdgeSize;
-
-	err = algoStackComputeBufferSize(&stackSize, graph->vertexCapacity);
-	AlgoStack vertexStack;
-	err = algoStackCreate(&vertexStack, graph->vertexCapacity, bufferNext, stackSize);
-	bufferNext += stackSize;
-
-	ALGO_ASSERT( bufferNext-minBufferSize == buffer ); /* If this fails, algoGraphDfsStateComputeBufferSize() is out of date */
-	(*outState)->thisBuffer         = buffer;
-	(*outState)->thisBufferSize     = bufferSize;
-	(*outState)->graph              = graph;
-	(*outState)->isVertexDiscovered = discovered;
-	(*outState)->isVertexProcessed  = processed;
-	(*outState)->vertexParents      = vertexParents;
-	(*outState)->vertexEntryTime    = entryTime;
-	(*outState)->vertexExitTime     = exitTime;
-	(*outState)->vertexNextEdge     = vertexNextEdge;
-	(*outState)->vertexStack        = vertexStack;
-	(*outState)->currentTime        = 0;
-
-	ALGO_MEMSET(discovered, 0, discoveredSize);
-	ALGO_MEMSET(processed, 0, processedSize);
-	ALGO_MEMSET(entryTime, 0, entryTimeSize); /* TODO: lazily initialize just-in-time? Better for sparse graphs. */
-	ALGO_MEMSET(exitTime,  0, exitTimeSize); /* TODO: lazily initialize just-in-time? Better for sparse graphs. */
-	for(int iVertex=0; iVertex<graph->vertexCapacity; ++iVertex)
-	{
-		vertexParents[iVertex] = -1;
-	}
-	ALGO_MEMCPY(vertexNextEdge, graph->vertexEdges, nextEdgeSize); /* TODO: lazily initialize just-in-time? Better for sparse graphs. */
+	*outIndex = order->vertexIndices[vertexId];
 	return kAlgoErrorNone;
 }
-
-AlgoError algoGraphDfsStateGetBufferSize(const AlgoGraphDfsState dfsState, size_t *outBufferSize)
+AlgoError algoGraphTopoOrderGetSortedVertices(const AlgoGraphTopoOrder order, int32_t outSortedVertices[], size_t sortedVertexCount)
 {
-	if (NULL == dfsState ||
-		NULL == outBufferSize)
+	if (NULL == order ||
+		NULL == outSortedVertices ||
+		sortedVertexCount < (size_t)order->graph->currentVertexCount)
 	{
 		return kAlgoErrorInvalidArgument;
 	}
-	*outBufferSize = dfsState->thisBufferSize;
+	int32_t sortedCount = 0;
+	for(int32_t iIndex=0; iIndex<order->graph->vertexCapacity; ++iIndex)
+	{
+		const int32_t vertexId = order->indexVertices[iIndex];
+		if (iGraphIsValidVertexId(order->graph, vertexId))
+			outSortedVertices[sortedCount++] = vertexId;
+	}
+	ALGO_ASSERT(sortedCount == order->graph->currentVertexCount);
 	return kAlgoErrorNone;
 }
 
-AlgoError algoGraphDfsStateIsVertexDiscovered(const AlgoGraphDfsState dfsState, int32_t vertexId, int *outIsDiscovered)
+typedef struct AlgoGraphDijkstraStateImpl
 {
-	if (NULL == dfsState ||
-		NULL == outIsDiscovered ||
-		vertexId < 0 || vertexId >= dfsState->graph->vertexCapacity)
+	const void *thisBuffer;
+	size_t thisBufferSize;
+	AlgoGraphImpl *graph;
+	int32_t *isVertexSettled; /* bit array */
+	int32_t *vertexDistances; /* -1 for vertices that haven't been reached yet */
+	int32_t *vertexParents;
+	AlgoPairingHeapNode *vertexHeapNodes; /* each reached-but-unsettled vertex's node in vertexHeap, for decrease-key */
+	AlgoAllocPool heapNodePool;
+	AlgoPairingHeap vertexHeap; /* key: tentative distance. data: vertex ID. */
+} AlgoGraphDijkstraStateImpl;
+AlgoError algoGraphDijkstraStateComputeBufferSize(size_t *outBufferSize, const AlgoGraph graph)
+{
+	if (NULL == outBufferSize ||
+		NULL == graph)
 	{
 		return kAlgoErrorInvalidArgument;
 	}
-	*outIsDiscovered = iTestBit(dfsState->isVertexDiscovered, dfsState->graph->vertexCapacity, vertexId);
+	int32_t vertexCapacityRounded = (graph->vertexCapacity+31) & ~31;
+	size_t settledSize            = vertexCapacityRounded * sizeof(int32_t)  / 32;
+	size_t distancesSize          = graph->vertexCapacity * sizeof(int32_t);
+	size_t parentsSize            = graph->vertexCapacity * sizeof(int32_t);
+	size_t heapNodesSize          = graph->vertexCapacity * sizeof(AlgoPairingHeapNode);
+	size_t poolSize = 0, heapSize = 0;
+	int32_t nodeSize = 0;
+	algoPairingHeapComputeNodeSize(&nodeSize);
+	algoAllocPoolComputeBufferSize(&poolSize, nodeSize, graph->vertexCapacity);
+	algoPairingHeapComputeBufferSize(&heapSize);
+	*outBufferSize = sizeof(AlgoGraphDijkstraStateImpl) + settledSize + distancesSize + parentsSize + heapNodesSize
+		+ poolSize + heapSize;
 	return kAlgoErrorNone;
 }
-AlgoError algoGraphDfsStateIsVertexProcessed(const AlgoGraphDfsState dfsState, int32_t vertexId, int *outIsProcessed)
+AlgoError algoGraphDijkstraStateCreate(AlgoGraphDijkstraState *outState, const AlgoGraph graph, void *buffer, size_t bufferSize)
 {
-	if (NULL == dfsState ||
-		NULL == outIsProcessed ||
-		vertexId < 0 || vertexId >= dfsState->graph->vertexCapacity)
+	size_t minBufferSize = 0;
+	AlgoError err;
+	uint8_t *bufferNext = (uint8_t*)buffer;
+	if (NULL == outState ||
+		NULL == graph ||
+		NULL == buffer)
 	{
 		return kAlgoErrorInvalidArgument;
 	}
-	*outIsProcessed = iTestBit(dfsState->isVertexProcessed, dfsState->graph->vertexCapacity, vertexId);
+	err = algoGraphDijkstraStateComputeBufferSize(&minBufferSize, graph);
+	if (bufferSize < minBufferSize ||
+		kAlgoErrorNone != err)
+	{
+		return kAlgoErrorInvalidArgument;
+	}
+
+	int32_t vertexCapacityRounded = (graph->vertexCapacity+31) & ~31;
+	size_t settledSize            = vertexCapacityRounded * sizeof(int32_t)  / 32;
+	size_t distancesSize          = graph->vertexCapacity * sizeof(int32_t);
+	size_t parentsSize            = graph->vertexCapacity * sizeof(int32_t);
+	size_t heapNodesSize          = graph->vertexCapacity * sizeof(AlgoPairingHeapNode);
+	size_t poolSize = 0, heapSize = 0;
+	int32_t nodeSize = 0;
+
+	*outState = (AlgoGraphDijkstraStateImpl *)bufferNext;
+	bufferNext += sizeof(AlgoGraphDijkstraStateImpl);
+
+	/* Pointer-sized data first, so that it stays aligned; the int32_t arrays follow. */
+	AlgoPairingHeapNode *heapNodes = (AlgoPairingHeapNode*)bufferNext;
+	bufferNext += heapNodesSize;
+
+	err = algoPairingHeapComputeNodeSize(&nodeSize);
+	if (kAlgoErrorNone != err)
+	{
+		return err;
+	}
+	err = algoAllocPoolComputeBufferSize(&poolSize, nodeSize, graph->vertexCapacity);
+	if (kAlgoErrorNone != err)
+	{
+		return err;
+	}
+	AlgoAllocPool heapNodePool;
+	err = algoAllocPoolCreate(&heapNodePool, nodeSize, graph->vertexCapacity, bufferNext, poolSize);
+	if (kAlgoErrorNone != err)
+	{
+		return err;
+	}
+	bufferNext += poolSize;
+
+	err = algoPairingHeapComputeBufferSize(&heapSize);
+	if (kAlgoErrorNone != err)
+	{
+		return err;
+	}
+	AlgoPairingHeap vertexHeap;
+	err = algoPairingHeapCreate(&vertexHeap, algoDataCompareIntAscending, heapNodePool, bufferNext, heapSize);
+	if (kAlgoErrorNone != err)
+	{
+		return err;
+	}
+	bufferNext += heapSize;
+
+	int32_t *settled = (int32_t*)bufferNext;
+	ALGO_MEMSET(settled, 0, settledSize);
+	bufferNext += settledSize;
+
+	int32_t *distances = (int32_t*)bufferNext;
+	bufferNext += distancesSize;
+
+	int32_t *parents = (int32_t*)bufferNext;
+	bufferNext += parentsSize;
+	for(int iVert=0; iVert<graph->vertexCapacity; ++iVert)
+	{
+		distances[iVert] = -1;
+		parents[iVert] = -1;
+		heapNodes[iVert] = NULL;
+	}
+
+	ALGO_ASSERT( bufferNext-minBufferSize == buffer ); /* If this fails, algoGraphDijkstraStateComputeBufferSize() is out of date */
+	(*outState)->thisBuffer      = buffer;
+	(*outState)->thisBufferSize  = bufferSize;
+	(*outState)->graph           = graph;
+	(*outState)->isVertexSettled = settled;
+	(*outState)->vertexDistances = distances;
+	(*outState)->vertexParents   = parents;
+	(*outState)->vertexHeapNodes = heapNodes;
+	(*outState)->heapNodePool    = heapNodePool;
+	(*outState)->vertexHeap      = vertexHeap;
 	return kAlgoErrorNone;
 }
-AlgoError algoGraphDfsStateGetVertexParent(const AlgoGraphDfsState dfsState, int32_t vertexId, int32_t *outVertexParentId)
+AlgoError algoGraphDijkstraStateGetBufferSize(const AlgoGraphDijkstraState dijkstraState, size_t *outBufferSize)
 {
-	if (NULL == dfsState ||
-		NULL == outVertexParentId ||
-		!iGraphIsValidVertexId(dfsState->graph, vertexId))
+	if (NULL == dijkstraState ||
+		NULL == outBufferSize)
 	{
 		return kAlgoErrorInvalidArgument;
 	}
-	*outVertexParentId = dfsState->vertexParents[vertexId];
+	*outBufferSize = dijkstraState->thisBufferSize;
 	return kAlgoErrorNone;
 }
-AlgoError algoGraphDfsStateGetVertexEntryTime(const AlgoGraphDfsState dfsState, int32_t vertexId, int32_t *outEntryTime)
+AlgoError algoGraphDijkstraStateIsVertexSettled(const AlgoGraphDijkstraState dijkstraState, int32_t vertexId, int *outIsSettled)
 {
-	if (NULL == dfsState ||
-		NULL == outEntryTime ||
-		vertexId < 0 || vertexId >= dfsState->graph->vertexCapacity)
+	if (NULL == dijkstraState ||
+		NULL == outIsSettled ||
+		0 == iGraphIsValidVertexId(dijkstraState->graph, vertexId))
 	{
 		return kAlgoErrorInvalidArgument;
 	}
-	*outEntryTime = dfsState->vertexEntryTime[vertexId];
+	*outIsSettled = iTestBit(dijkstraState->isVertexSettled, dijkstraState->graph->vertexCapacity, vertexId);
 	return kAlgoErrorNone;
 }
-AlgoError algoGraphDfsStateGetVertexExitTime(const AlgoGraphDfsState dfsState, int32_t vertexId, int32_t *outExitTime)
+AlgoError algoGraphDijkstraStateGetVertexDistance(const AlgoGraphDijkstraState dijkstraState, int32_t vertexId, int32_t *outDistance)
 {
-	if (NULL == dfsState ||
-		NULL == outExitTime ||
-		vertexId < 0 || vertexId >= dfsState->graph->vertexCapacity)
+	if (NULL == dijkstraState ||
+		NULL == outDistance ||
+		0 == iGraphIsValidVertexId(dijkstraState->graph, vertexId))
 	{
 		return kAlgoErrorInvalidArgument;
 	}
-	*outExitTime = dfsState->vertexExitTime[vertexId];
+	*outDistance = dijkstraState->vertexDistances[vertexId];
 	return kAlgoErrorNone;
 }
-
-AlgoError algoGraphDfs(const AlgoGraph graph, AlgoGraphDfsState dfsState, int32_t rootVertexId, AlgoGraphDfsCallbacks callbacks)
+AlgoError algoGraphDijkstraStateGetVertexParent(const AlgoGraphDijkstraState dijkstraState, int32_t vertexId, int32_t *outParentVertexId)
 {
-	if (NULL == graph ||
-		NULL == dfsState ||
-		0 == iGraphIsValidVertexId(graph, rootVertexId))
+	if (NULL == dijkstraState ||
+		NULL == outParentVertexId ||
+		0 == iGraphIsValidVertexId(dijkstraState->graph, vertexId))
 	{
 		return kAlgoErrorInvalidArgument;
 	}
-
-	algoStackPush(dfsState->vertexStack, algoDataFromInt(rootVertexId));
-	int32_t currentStackSize = -1;
-	algoStackGetCurrentSize(dfsState->vertexStack, &currentStackSize);
-	while(currentStackSize > 0)
-	{
-		AlgoData stackElem;
-		algoStackPop(dfsState->vertexStack, &stackElem);
-		int32_t v0 = stackElem.asInt;
-		ALGO_ASSERT( iGraphIsValidVertexId(graph, v0) );
-		if ( 0 == iTestBit(dfsState->isVertexDiscovered, graph->vertexCapacity, v0) )
-		{
-			/* discovered! */
-			iSetBit(dfsState->isVertexDiscovered, graph->vertexCapacity, v0);
-			dfsState->currentTime += 1;
-			dfsState->vertexEntryTime[v0] = dfsState->currentTime;
-			if (NULL != callbacks.vertexFuncEarly)
-				callbacks.vertexFuncEarly(graph, dfsState, v0, callbacks.vertexFuncEarlyUserData);
-		}
-		if (NULL != dfsState->vertexNextEdge[v0])
+	*outParentVertexId = dijkstraState->vertexParents[vertexId];
+	return kAlgoErrorNone;
+}
+/* Shared implementation of algoGraphDijkstra() and algoGraphAStar(). Arguments have already been validated. */
+ALGO_INTERNAL AlgoError iGraphShortestPath(const AlgoGraph graph, AlgoGraphDijkstraState dijkstraState, int32_t sourceVertexId,
+	int32_t targetVertexId, AlgoGraphAStarHeuristicFunc heuristicFunc, void *userData)
+{
+	AlgoError err;
+	int32_t *distances = dijkstraState->vertexDistances;
+	const int32_t vertexCapacity = graph->vertexCapacity;
+	if (distances[sourceVertexId] < 0)
+	{
+		const int32_t h = (NULL != heuristicFunc) ? heuristicFunc(graph, sourceVertexId, targetVertexId, userData) : 0;
+		ALGO_ASSERT(h >= 0);
+		distances[sourceVertexId] = 0;
+		err = algoPairingHeapInsert(dijkstraState->vertexHeap, algoDataFromInt(h), algoDataFromInt(sourceVertexId),
+			dijkstraState->vertexHeapNodes + sourceVertexId);
+		ALGO_ASSERT(kAlgoErrorNone == err);
+	}
+	for(;;)
+	{
+		AlgoData heapData;
+		if (kAlgoErrorNone != algoPairingHeapPop(dijkstraState->vertexHeap, NULL, &heapData))
+			break; /* every reachable vertex has been settled */
+		const int32_t v0 = heapData.asInt;
+		const int32_t d0 = distances[v0];
+		ALGO_ASSERT( 1 == iGraphIsValidVertexId(graph, v0) );
+		dijkstraState->vertexHeapNodes[v0] = NULL;
+		iSetBit(dijkstraState->isVertexSettled, vertexCapacity, v0);
+		if (v0 == targetVertexId)
+			break;
+		/* Relax v0's edges. */
+		const AlgoGraphEdgeList *edgeList = graph->vertexEdges + v0;
+		const AlgoGraphEdgeBlock *block = iGraphEdgeListHead(graph, edgeList);
+		int32_t blockEdgeCount = iGraphHeadBlockEdgeCount(graph->vertexDegrees[v0]);
+		for(; NULL != block; block = iGraphNextEdgeBlock(graph, edgeList, block), blockEdgeCount = kAlgoGraphEdgeBlockCapacity)
 		{
-			AlgoGraphEdge *edge = dfsState->vertexNextEdge[v0];
-			dfsState->vertexNextEdge[v0] = edge->next;
-			algoStackPush(dfsState->vertexStack, algoDataFromInt(v0));
-			if (0 == iTestBit(dfsState->isVertexDiscovered, graph->vertexCapacity, edge->destVertex))
-			{
-				assert(dfsState->vertexParents[edge->destVertex] < 0);
-				dfsState->vertexParents[edge->destVertex] = v0;
-				if (NULL != callbacks.edgeFunc)
-					callbacks.edgeFunc(graph, dfsState, v0, edge->destVertex, callbacks.edgeFuncUserData);
-				algoStackPush(dfsState->vertexStack, algoDataFromInt(edge->destVertex));
-			}
-			else if ((0 == iTestBit(dfsState->isVertexProcessed, graph->vertexCapacity, edge->destVertex) && dfsState->vertexParents[v0] != edge->destVertex) ||
-					 kAlgoGraphEdgeDirected == graph->edgeMode)
+			const int32_t *blockWeights = iGraphEdgeBlockWeights(graph, block);
+			int32_t iEdge;
+			for(iEdge=0; iEdge<blockEdgeCount; ++iEdge)
 			{
-				if (NULL != callbacks.edgeFunc)
-					callbacks.edgeFunc(graph, dfsState, v0, edge->destVertex, callbacks.edgeFuncUserData);
+				const int32_t v1 = block->destVertices[iEdge];
+				const int32_t weight = (NULL != blockWeights) ? blockWeights[iEdge] : 1;
+				ALGO_ASSERT(weight >= 0);
+				if (d0 > INT32_MAX - weight)
+					return kAlgoErrorOperationFailed; /* path length overflow */
+				const int32_t d1 = d0 + weight;
+				if (distances[v1] >= 0 && d1 >= distances[v1])
+					continue; /* no improvement. This includes every settled vertex, unless the A* heuristic is inconsistent. */
+				/* A settled vertex can only improve if an inconsistent heuristic settled it too early; reopen it. */
+				iClearBit(dijkstraState->isVertexSettled, vertexCapacity, v1);
+				const int32_t h1 = (NULL != heuristicFunc) ? heuristicFunc(graph, v1, targetVertexId, userData) : 0;
+				ALGO_ASSERT(h1 >= 0);
+				if (d1 > INT32_MAX - h1)
+					return kAlgoErrorOperationFailed; /* path length overflow */
+				if (NULL == dijkstraState->vertexHeapNodes[v1])
+				{
+					err = algoPairingHeapInsert(dijkstraState->vertexHeap, algoDataFromInt(d1 + h1), algoDataFromInt(v1),
+						dijkstraState->vertexHeapNodes + v1);
+					ALGO_ASSERT(kAlgoErrorNone == err); /* the node pool has room for every vertex */
+				}
+				else
+				{
+					err = algoPairingHeapDecreaseKey(dijkstraState->vertexHeap, dijkstraState->vertexHeapNodes[v1],
+						algoDataFromInt(d1 + h1));
+					ALGO_ASSERT(kAlgoErrorNone == err);
+				}
+				distances[v1] = d1;
+				dijkstraState->vertexParents[v1] = v0;
 			}
 		}
-		else
-		{
-			/* v0 has no more edges to visit; it is now fully processed. */
-			if (NULL != callbacks.vertexFuncLate)
-				callbacks.vertexFuncLate(graph, dfsState, v0, callbacks.vertexFuncLateUserData);
-			ALGO_ASSERT( 0 == iTestBit(dfsState->isVertexProcessed, graph->vertexCapacity, v0) );
-			dfsState->currentTime += 1;
-			dfsState->vertexExitTime[v0] = dfsState->currentTime;
-			iSetBit(dfsState->isVertexProcessed, graph->vertexCapacity, v0);
-		}
-		algoStackGetCurrentSize(dfsState->vertexStack, &currentStackSize);
 	}
-
+	ALGO_UNUSED(err);
 	return kAlgoErrorNone;
 }
-
-typedef enum IGraphEdgeType
-{
-	kGraphEdgeTypeTree    = 0,
-	kGraphEdgeTypeBack    = 1,
-	kGraphEdgeTypeForward = 2,
-	kGraphEdgeTypeCross   = 3,
-} IGraphEdgeType;
-ALGO_INTERNAL void iGraphTopoSortEdge(AlgoGraph graph, AlgoGraphDfsState dfsState, int32_t v0, int32_t v1, void *userData)
+AlgoError algoGraphDijkstra(const AlgoGraph graph, AlgoGraphDijkstraState dijkstraState, int32_t sourceVertexId,
+	int32_t targetVertexId)
 {
-	ALGO_UNUSED(v0);
-	ALGO_UNUSED(userData);
-	/** All we're doing here is making sure there are no BACK edges. I'll leave in the full edge classification
-		in case I need it later.
-		*/
-	IGraphEdgeType edgeType = kGraphEdgeTypeTree;
-#if 0
-	if ( iTestBit(dfsState->isVertexDiscovered, graph->vertexCapacity, v1) && 
-		!iTestBit(dfsState->isVertexProcessed,  graph->vertexCapacity, v1))
-	{
-		edgeType = kGraphEdgeTypeBack;
-	}
-#else
-	if (dfsState->vertexParents[v1] == v0)
-	{
-		edgeType = kGraphEdgeTypeTree;
-	}
-	else if ( iTestBit(dfsState->isVertexDiscovered, graph->vertexCapacity, v1) && 
-			 !iTestBit(dfsState->isVertexProcessed,  graph->vertexCapacity, v1))
-	{
-		edgeType = kGraphEdgeTypeBack;
-	}
-	else if (iTestBit(dfsState->isVertexProcessed, graph->vertexCapacity, v1) &&
-			 dfsState->vertexEntryTime[v1] > dfsState->vertexEntryTime[v0])
-	{
-		edgeType = kGraphEdgeTypeForward;
-	}
-	else if (iTestBit(dfsState->isVertexProcessed, graph->vertexCapacity, v1) &&
-			 dfsState->vertexEntryTime[v1] < dfsState->vertexEntryTime[v0])
+	if (NULL == graph ||
+		NULL == dijkstraState ||
+		graph != dijkstraState->graph ||
+		0 == iGraphIsValidVertexId(graph, sourceVertexId) ||
+		(targetVertexId >= 0 && 0 == iGraphIsValidVertexId(graph, targetVertexId)))
 	{
-		edgeType = kGraphEdgeTypeCross;
+		return kAlgoErrorInvalidArgument;
 	}
-	else
+	return iGraphShortestPath(graph, dijkstraState, sourceVertexId, targetVertexId, NULL, NULL);
+}
+AlgoError algoGraphAStar(const AlgoGraph graph, AlgoGraphDijkstraState dijkstraState, int32_t sourceVertexId,
+	int32_t goalVertexId, AlgoGraphAStarHeuristicFunc heuristicFunc, void *userData)
+{
+	if (NULL == graph ||
+		NULL == dijkstraState ||
+		graph != dijkstraState->graph ||
+		0 == iGraphIsValidVertexId(graph, sourceVertexId) ||
+		0 == iGraphIsValidVertexId(graph, goalVertexId))
 	{
-		ALGO_ASSERT(0); /* unclassified edge from v0 to v1 */
+		return kAlgoErrorInvalidArgument;
 	}
-#endif
-	ALGO_ASSERT(edgeType != kGraphEdgeTypeBack);
+	return iGraphShortestPath(graph, dijkstraState, sourceVertexId, goalVertexId, heuristicFunc, userData);
 }
-typedef struct IGraphTopoSortResults
-{
-	int32_t *sortedVertices;
-	int32_t nextFreeIndex; /* Next free index in the sortedVertices array. */
-} IGraphTopoSortResults;
-ALGO_INTERNAL void iGraphTopoSortVertexLate(AlgoGraph graph, AlgoGraphDfsState dfsState, int32_t vertexId, void *userData)
+
+/* Per-direction state for algoGraphShortestPathBidirectional(). */
+typedef struct IGraphBidirectionalSide
 {
-	ALGO_UNUSED(graph);
-	ALGO_UNUSED(dfsState);
-	IGraphTopoSortResults *results = (IGraphTopoSortResults*)userData;
-	ALGO_ASSERT(results->nextFreeIndex >= 0 && results->nextFreeIndex < graph->currentVertexCount);
-	results->sortedVertices[results->nextFreeIndex] = vertexId;
-	results->nextFreeIndex -= 1;
-}
-AlgoError algoGraphTopoSortComputeBufferSize(size_t *outBufferSize, const AlgoGraph graph)
+	int32_t *distances; /* -1 for vertices this side hasn't reached */
+	int32_t *parents; /* toward this side's root */
+	int32_t *queue; /* every vertex this side has reached, in BFS order. [levelBegin..queueEnd) is the current frontier. */
+	int32_t levelBegin;
+	int32_t queueEnd;
+} IGraphBidirectionalSide;
+AlgoError algoGraphShortestPathBidirectionalComputeBufferSize(size_t *outBufferSize, const AlgoGraph graph)
 {
-	AlgoError err;
-	if (NULL == graph ||
-		NULL == outBufferSize)
+	if (NULL == outBufferSize ||
+		NULL == graph)
 	{
 		return kAlgoErrorInvalidArgument;
 	}
-	size_t dfsStateBufferSize = 0;
-	err = algoGraphDfsStateComputeBufferSize(&dfsStateBufferSize, graph);
-	if (kAlgoErrorNone != err)
-		return err;
-	*outBufferSize = dfsStateBufferSize;
+	/* distances, parents and queue for each of the two directions */
+	*outBufferSize = 2 * 3 * graph->vertexCapacity * sizeof(int32_t);
 	return kAlgoErrorNone;
 }
-AlgoError algoGraphTopoSort(const AlgoGraph graph, int32_t outSortedVertices[], size_t sortedVertexCount, 
-	void *buffer, size_t bufferSize)
+AlgoError algoGraphShortestPathBidirectional(const AlgoGraph graph, int32_t sourceVertexId, int32_t goalVertexId,
+	int32_t outPath[], int32_t pathCapacity, int32_t *outPathLength, void *buffer, size_t bufferSize)
 {
 	if (NULL == graph ||
-		NULL == outSortedVertices ||
-		sortedVertexCount < graph->currentVertexCount)
+		NULL == outPath ||
+		NULL == outPathLength ||
+		0 == iGraphIsValidVertexId(graph, sourceVertexId) ||
+		0 == iGraphIsValidVertexId(graph, goalVertexId))
 	{
 		return kAlgoErrorInvalidArgument;
 	}
-	if (kAlgoGraphEdgeUndirected == graph->edgeMode)
-	{
-		return kAlgoErrorOperationFailed;
-	}
 	size_t minBufferSize = 0;
-	AlgoError err;
-	uint8_t *bufferNext = (uint8_t*)buffer;
-	err = algoGraphTopoSortComputeBufferSize(&minBufferSize, graph);
+	AlgoError err = algoGraphShortestPathBidirectionalComputeBufferSize(&minBufferSize, graph);
 	if (NULL == buffer ||
 		bufferSize < minBufferSize ||
 		kAlgoErrorNone != err)
@@ -2263,42 +8413,123 @@ AlgoError algoGraphTopoSort(const AlgoGraph graph, int32_t outSortedVertices[],
 		return kAlgoErrorInvalidArgument;
 	}
 
-	size_t dfsStateBufferSize = 0;
-	err = algoGraphDfsStateComputeBufferSize(&dfsStateBufferSize, graph);
-	void *dfsStateBuffer = bufferNext;
-	bufferNext += dfsStateBufferSize;
-
-	ALGO_ASSERT( bufferNext-minBufferSize == buffer ); /* If this fails, algoGraphTopoSortComputeBufferSize() is out of date */
-	AlgoGraphDfsState dfsState;
-	err = algoGraphDfsStateCreate(&dfsState, graph, dfsStateBuffer, dfsStateBufferSize);
-	if (kAlgoErrorNone != err)
-		return err;
-
-	IGraphTopoSortResults sortResults;
-	sortResults.sortedVertices = outSortedVertices;
-	sortResults.nextFreeIndex = graph->currentVertexCount-1;
-	AlgoGraphDfsCallbacks dfsCallbacks = {
-		NULL, NULL,
-		iGraphTopoSortEdge, NULL,
-		iGraphTopoSortVertexLate, NULL
-	};
-	dfsCallbacks.vertexFuncLateUserData = &sortResults;
-	for(int iValidVert=0; iValidVert<graph->currentVertexCount; ++iValidVert)
+	const int32_t vertexCapacity = graph->vertexCapacity;
+	IGraphBidirectionalSide sides[2]; /* 0: forward from the source, 1: backward from the goal */
+	int32_t *bufferNext = (int32_t*)buffer;
+	for(int iSide=0; iSide<2; ++iSide)
 	{
-		int32_t vertexId = graph->validVertexIds[iValidVert];
-		int isVertexSorted = 0;
-		err = algoGraphDfsStateIsVertexProcessed(dfsState, vertexId, &isVertexSorted);
-		if (iGraphIsValidVertexId(graph, vertexId) &&
-			!isVertexSorted)
+		sides[iSide].distances = bufferNext;
+		bufferNext += vertexCapacity;
+		sides[iSide].parents = bufferNext;
+		bufferNext += vertexCapacity;
+		sides[iSide].queue = bufferNext;
+		bufferNext += vertexCapacity;
+		for(int iVert=0; iVert<vertexCapacity; ++iVert)
 		{
-			err = algoGraphDfs(graph, dfsState, vertexId, dfsCallbacks);
-			if (kAlgoErrorNone != err)
-				return err;
-			if (sortResults.nextFreeIndex < 0)
-				break;
+			sides[iSide].distances[iVert] = -1;
+		}
+		sides[iSide].levelBegin = 0;
+		sides[iSide].queueEnd = 1;
+	}
+	ALGO_ASSERT( (uint8_t*)bufferNext - minBufferSize == buffer );
+	sides[0].queue[0] = sourceVertexId;
+	sides[0].distances[sourceVertexId] = 0;
+	sides[0].parents[sourceVertexId] = -1;
+	sides[1].queue[0] = goalVertexId;
+	sides[1].distances[goalVertexId] = 0;
+	sides[1].parents[goalVertexId] = -1;
+
+	/* The backward side walks the graph's edges in reverse: through the in-edge lists in directed graphs, or the ordinary
+	   lists in undirected graphs, where every edge is stored in both directions. */
+	const int backwardIsInList = (kAlgoGraphEdgeDirected == graph->edgeMode) ? 1 : 0;
+	const int canSearchBackward = !backwardIsInList || NULL != graph->vertexInEdges;
+
+	/* The best meeting point found so far: an edge from forwardEnd (reached by the forward side) to backwardEnd (reached
+	   by the backward side). */
+	int32_t bestLength = (sourceVertexId == goalVertexId) ? 0 : -1;
+	int32_t forwardEnd = sourceVertexId, backwardEnd = goalVertexId;
+	while(bestLength < 0)
+	{
+		/* Expand the smaller frontier by one full level. Every meeting point found during this level is considered,
+		   since they may differ in their distance from the other side's root. */
+		int32_t iSide = 0;
+		if (canSearchBackward &&
+			sides[1].queueEnd - sides[1].levelBegin < sides[0].queueEnd - sides[0].levelBegin)
+		{
+			iSide = 1;
+		}
+		IGraphBidirectionalSide *side = sides + iSide;
+		const IGraphBidirectionalSide *otherSide = sides + (1-iSide);
+		const int isInList = (1 == iSide) ? backwardIsInList : 0;
+		const AlgoGraphEdgeList *edgeLists = iGraphEdgeLists(graph, isInList);
+		const int32_t *degrees = iGraphEdgeListDegrees(graph, isInList);
+		const int32_t levelEnd = side->queueEnd;
+		if (side->levelBegin == levelEnd)
+			break; /* this side's frontier is empty; the goal is unreachable. */
+		for(int32_t iQueue = side->levelBegin; iQueue < levelEnd; ++iQueue)
+		{
+			const int32_t v0 = side->queue[iQueue];
+			const AlgoGraphEdgeList *edgeList = edgeLists + v0;
+			const AlgoGraphEdgeBlock *block = iGraphEdgeListHead(graph, edgeList);
+			int32_t blockEdgeCount = iGraphHeadBlockEdgeCount(degrees[v0]);
+			for(; NULL != block; block = iGraphNextEdgeBlock(graph, edgeList, block), blockEdgeCount = kAlgoGraphEdgeBlockCapacity)
+			{
+				int32_t iEdge;
+				for(iEdge=0; iEdge<blockEdgeCount; ++iEdge)
+				{
+					const int32_t v1 = block->destVertices[iEdge];
+					if (side->distances[v1] < 0)
+					{
+						side->distances[v1] = side->distances[v0] + 1;
+						side->parents[v1] = v0;
+						side->queue[side->queueEnd++] = v1;
+					}
+					if (otherSide->distances[v1] >= 0)
+					{
+						const int32_t length = side->distances[v0] + 1 + otherSide->distances[v1];
+						if (bestLength < 0 || length < bestLength)
+						{
+							bestLength = length;
+							forwardEnd  = (0 == iSide) ? v0 : v1;
+							backwardEnd = (0 == iSide) ? v1 : v0;
+						}
+					}
+				}
+			}
 		}
+		side->levelBegin = levelEnd;
 	}
 
+	if (bestLength < 0)
+	{
+		*outPathLength = 0;
+		return kAlgoErrorNone;
+	}
+	*outPathLength = bestLength + 1;
+	if (bestLength + 1 > pathCapacity)
+	{
+		return kAlgoErrorOperationFailed;
+	}
+	/* Forward half: walk forwardEnd's parents back to the source, filling the path from the middle outward. */
+	int32_t forwardCount = sides[0].distances[forwardEnd] + 1;
+	int32_t v = forwardEnd;
+	for(int32_t iPath = forwardCount-1; iPath >= 0; --iPath)
+	{
+		outPath[iPath] = v;
+		v = sides[0].parents[v];
+	}
+	ALGO_ASSERT(outPath[0] == sourceVertexId);
+	/* Backward half: walk backwardEnd's parents forward to the goal. */
+	if (bestLength > 0)
+	{
+		v = backwardEnd;
+		for(int32_t iPath = forwardCount; iPath <= bestLength; ++iPath)
+		{
+			outPath[iPath] = v;
+			v = sides[1].parents[v];
+		}
+	}
+	ALGO_ASSERT(outPath[bestLength] == goalVertexId);
 	return kAlgoErrorNone;
 }
 
@@ -149,6 +149,8 @@ extern "C"
 #   define ZOMBO_POPCNT32(x) _mm_popcnt_u32(x)
 #   define ZOMBO_POPCNT64(x) _mm_popcnt_u64(x)
 #elif defined(__GNUC__)
+#   define ZOMBO_POPCNT32(x) __builtin_popcount(x)
+#   define ZOMBO_POPCNT64(x) __builtin_popcountll(x)
 #endif
 
 
@@ -249,6 +251,38 @@ ZOMBO_DEF ZOMBO_INLINE void zomboSleepMsec(uint32_t msec)
 #endif
 }
 
+// zomboThreadCreate(), zomboThreadJoin()
+#ifdef _MSC_VER
+typedef HANDLE ZomboThread;
+typedef DWORD ZomboThreadReturn;
+#   define ZOMBO_THREAD_CALL WINAPI
+#elif defined(__GNUC__) || defined(__clang__)
+typedef pthread_t ZomboThread;
+typedef void *ZomboThreadReturn;
+#   define ZOMBO_THREAD_CALL
+#else
+#   error Unsupported compiler
+#endif
+typedef ZomboThreadReturn (ZOMBO_THREAD_CALL *ZomboThreadProc)(void *args);
+ZOMBO_DEF ZOMBO_INLINE int zomboThreadCreate(ZomboThread *outThread, ZomboThreadProc proc, void *args)
+{
+#ifdef _MSC_VER
+    *outThread = CreateThread(NULL, 0, (LPTHREAD_START_ROUTINE)proc, args, 0, NULL);
+    return (*outThread != NULL) ? 0 : -1;
+#else
+    return pthread_create(outThread, NULL, proc, args);
+#endif
+}
+ZOMBO_DEF ZOMBO_INLINE void zomboThreadJoin(ZomboThread thread)
+{
+#ifdef _MSC_VER
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#else
+    pthread_join(thread, NULL);
+#endif
+}
+
 // zomboFopen()
 ZOMBO_DEF ZOMBO_INLINE FILE *zomboFopen(const char *path, const char *mode)
 {
@@ -0,0 +1,335 @@
+#include "test_common.h"
+
+typedef struct WeightedEdge
+{
+	int32_t v0, v1, weight;
+} WeightedEdge;
+
+/* Reference single-source shortest paths (Bellman-Ford), computed from a flat edge list. */
+static void computeReferenceDistances(const WeightedEdge *edges, int32_t edgeCount, AlgoGraphEdgeMode edgeMode,
+	int32_t vertexCount, int32_t sourceVertexId, int64_t outDistances[])
+{
+	int32_t iVert, iEdge, changed = 1;
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		outDistances[iVert] = -1;
+	}
+	outDistances[sourceVertexId] = 0;
+	while(changed)
+	{
+		changed = 0;
+		for(iEdge=0; iEdge<edgeCount; ++iEdge)
+		{
+			int32_t iDir;
+			for(iDir=0; iDir<((edgeMode == kAlgoGraphEdgeUndirected) ? 2 : 1); ++iDir)
+			{
+				int32_t src  = (iDir == 0) ? edges[iEdge].v0 : edges[iEdge].v1;
+				int32_t dest = (iDir == 0) ? edges[iEdge].v1 : edges[iEdge].v0;
+				if (outDistances[src] < 0)
+					continue;
+				if (outDistances[dest] < 0 || outDistances[src] + edges[iEdge].weight < outDistances[dest])
+				{
+					outDistances[dest] = outDistances[src] + edges[iEdge].weight;
+					changed = 1;
+				}
+			}
+		}
+	}
+}
+
+static void testDijkstra(AlgoGraphEdgeMode edgeMode, int32_t vertexCount, int32_t edgeCount, int32_t maxWeight)
+{
+	size_t graphBufferSize = 0, stateBufferSize = 0;
+	void *graphBuffer = NULL, *stateBuffer = NULL;
+	AlgoGraph graph;
+	AlgoGraphDijkstraState dijkstraState;
+	WeightedEdge *edges = malloc(edgeCount*sizeof(WeightedEdge));
+	int64_t *expectedDistances = malloc(vertexCount*sizeof(int64_t));
+	int32_t iVert, iEdge, actualEdgeCount = 0;
+	printf("Testing algoGraphDijkstra (%s, %d vertices, %d edges)\n",
+		(edgeMode == kAlgoGraphEdgeDirected) ? "directed" : "undirected", vertexCount, edgeCount);
+
+	ALGO_VALIDATE( algoGraphComputeBufferSizeWithFlags(&graphBufferSize, vertexCount, edgeCount, edgeMode,
+		kAlgoGraphEdgeIndexNone, kAlgoGraphEdgeWeights) );
+	graphBuffer = malloc(graphBufferSize);
+	ALGO_VALIDATE( algoGraphCreateWithFlags(&graph, vertexCount, edgeCount, edgeMode, kAlgoGraphEdgeIndexNone,
+		kAlgoGraphEdgeWeights, graphBuffer, graphBufferSize) );
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		int32_t vertexId = -1;
+		ALGO_VALIDATE( algoGraphAddVertex(graph, algoDataFromInt(iVert), &vertexId) );
+	}
+	for(iEdge=0; iEdge<edgeCount; ++iEdge)
+	{
+		int32_t previousWeight = -1;
+		edges[iEdge].v0 = rand() % vertexCount;
+		edges[iEdge].v1 = rand() % vertexCount;
+		edges[iEdge].weight = rand() % (maxWeight+1);
+		if (edges[iEdge].v0 == edges[iEdge].v1)
+			edges[iEdge].v1 = (edges[iEdge].v0 + 1) % vertexCount;
+		/* Re-adding an existing edge replaces its weight; keep the reference edge list in sync. */
+		if (kAlgoErrorNone == algoGraphGetEdgeWeight(graph, edges[iEdge].v0, edges[iEdge].v1, &previousWeight))
+		{
+			int32_t iPrev;
+			for(iPrev=0; iPrev<iEdge; ++iPrev)
+			{
+				if ((edges[iPrev].v0 == edges[iEdge].v0 && edges[iPrev].v1 == edges[iEdge].v1) ||
+					(edgeMode == kAlgoGraphEdgeUndirected && edges[iPrev].v0 == edges[iEdge].v1 && edges[iPrev].v1 == edges[iEdge].v0))
+				{
+					edges[iPrev].weight = edges[iEdge].weight;
+				}
+			}
+		}
+		ALGO_VALIDATE( algoGraphAddWeightedEdge(graph, edges[iEdge].v0, edges[iEdge].v1, edges[iEdge].weight) );
+	}
+	ALGO_VALIDATE( algoGraphValidate(graph) );
+	ALGO_VALIDATE( algoGraphGetCurrentEdgeCount(graph, &actualEdgeCount) );
+	for(iEdge=0; iEdge<edgeCount; ++iEdge)
+	{
+		int32_t weight = -1;
+		ALGO_VALIDATE( algoGraphGetEdgeWeight(graph, edges[iEdge].v0, edges[iEdge].v1, &weight) );
+		ZOMBO_ASSERT(weight == edges[iEdge].weight, "edge %d->%d has weight %d; expected %d", edges[iEdge].v0, edges[iEdge].v1,
+			weight, edges[iEdge].weight);
+		if (edgeMode == kAlgoGraphEdgeUndirected)
+		{
+			ALGO_VALIDATE( algoGraphGetEdgeWeight(graph, edges[iEdge].v1, edges[iEdge].v0, &weight) );
+			ZOMBO_ASSERT(weight == edges[iEdge].weight, "reverse edge %d->%d has the wrong weight", edges[iEdge].v1, edges[iEdge].v0);
+		}
+	}
+	AlgoError err = algoGraphAddWeightedEdge(graph, edges[0].v0, edges[0].v1, -1);
+	ZOMBO_ASSERT(kAlgoErrorInvalidArgument == err, "a negative edge weight returned %d (expected %d)", err, kAlgoErrorInvalidArgument);
+
+	ALGO_VALIDATE( algoGraphDijkstraStateComputeBufferSize(&stateBufferSize, graph) );
+	stateBuffer = malloc(stateBufferSize);
+	size_t reportedSize;
+	ALGO_VALIDATE( algoGraphDijkstraStateCreate(&dijkstraState, graph, stateBuffer, stateBufferSize) );
+	ALGO_VALIDATE( algoGraphDijkstraStateGetBufferSize(dijkstraState, &reportedSize) );
+	ZOMBO_ASSERT(reportedSize == stateBufferSize, "reported size does not match input buffer size");
+
+	/* Full search: every distance must match the reference, and every parent must lie on a shortest path. */
+	const int32_t sourceVertexId = rand() % vertexCount;
+	uint64_t startTicks = zomboClockTicks();
+	ALGO_VALIDATE( algoGraphDijkstra(graph, dijkstraState, sourceVertexId, -1) );
+	double dijkstraMs = 1000.0 * zomboTicksToSeconds(zomboClockTicks() - startTicks);
+	computeReferenceDistances(edges, edgeCount, edgeMode, vertexCount, sourceVertexId, expectedDistances);
+	int32_t reachedCount = 0;
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		int32_t distance = -2, parent = -2;
+		int isSettled = 0;
+		ALGO_VALIDATE( algoGraphDijkstraStateGetVertexDistance(dijkstraState, iVert, &distance) );
+		ALGO_VALIDATE( algoGraphDijkstraStateGetVertexParent(dijkstraState, iVert, &parent) );
+		ALGO_VALIDATE( algoGraphDijkstraStateIsVertexSettled(dijkstraState, iVert, &isSettled) );
+		ZOMBO_ASSERT(distance == expectedDistances[iVert], "vertex %d: distance is %d; expected %lld", iVert, distance,
+			(long long)expectedDistances[iVert]);
+		ZOMBO_ASSERT(isSettled == (distance >= 0), "vertex %d: settled flag is incorrect", iVert);
+		if (distance < 0 || iVert == sourceVertexId)
+		{
+			ZOMBO_ASSERT(parent == -1, "vertex %d should have no parent", iVert);
+			continue;
+		}
+		int32_t parentDistance = -1, edgeWeight = -1;
+		ALGO_VALIDATE( algoGraphDijkstraStateGetVertexDistance(dijkstraState, parent, &parentDistance) );
+		ALGO_VALIDATE( algoGraphGetEdgeWeight(graph, parent, iVert, &edgeWeight) );
+		ZOMBO_ASSERT(parentDistance + edgeWeight == distance, "vertex %d: parent %d is not on a shortest path", iVert, parent);
+		reachedCount += 1;
+	}
+	printf("\t%d vertices reached in %.3f ms\n", reachedCount+1, dijkstraMs);
+
+	/* Early exit: the target's distance must be final, and no vertex further away than the target may be settled. */
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		if (expectedDistances[iVert] > 0)
+			break;
+	}
+	if (iVert < vertexCount)
+	{
+		const int32_t targetVertexId = iVert;
+		int32_t distance = -1, settledCount = 0;
+		ALGO_VALIDATE( algoGraphDijkstraStateCreate(&dijkstraState, graph, stateBuffer, stateBufferSize) );
+		ALGO_VALIDATE( algoGraphDijkstra(graph, dijkstraState, sourceVertexId, targetVertexId) );
+		ALGO_VALIDATE( algoGraphDijkstraStateGetVertexDistance(dijkstraState, targetVertexId, &distance) );
+		ZOMBO_ASSERT(distance == expectedDistances[targetVertexId], "target distance is %d; expected %lld", distance,
+			(long long)expectedDistances[targetVertexId]);
+		for(iVert=0; iVert<vertexCount; ++iVert)
+		{
+			int isSettled = 0;
+			ALGO_VALIDATE( algoGraphDijkstraStateIsVertexSettled(dijkstraState, iVert, &isSettled) );
+			if (isSettled)
+			{
+				ZOMBO_ASSERT(expectedDistances[iVert] <= distance, "vertex %d was settled beyond the target", iVert);
+				settledCount += 1;
+			}
+		}
+		printf("\tearly exit at distance %d settled %d vertices\n", distance, settledCount);
+	}
+
+	free(stateBuffer);
+	free(graphBuffer);
+	free(expectedDistances);
+	free(edges);
+}
+
+/* Graphs created without kAlgoGraphEdgeWeights store no weights; every edge weighs 1, so distances count edges. */
+static void testDijkstraUnweighted(void)
+{
+	const int32_t vertexCount = 16;
+	size_t graphBufferSize = 0, weightedBufferSize = 0, stateBufferSize = 0;
+	void *graphBuffer = NULL, *stateBuffer = NULL;
+	AlgoGraph graph;
+	AlgoGraphDijkstraState dijkstraState;
+	int32_t iVert, weight = -1;
+	AlgoError err;
+	printf("Testing algoGraphDijkstra (unweighted path, %d vertices)\n", vertexCount);
+
+	ALGO_VALIDATE( algoGraphComputeBufferSize(&graphBufferSize, vertexCount, vertexCount, kAlgoGraphEdgeDirected) );
+	ALGO_VALIDATE( algoGraphComputeBufferSizeWithFlags(&weightedBufferSize, vertexCount, vertexCount, kAlgoGraphEdgeDirected,
+		kAlgoGraphEdgeIndexNone, kAlgoGraphEdgeWeights) );
+	ZOMBO_ASSERT(graphBufferSize < weightedBufferSize, "unweighted graph (%d bytes) should be smaller than a weighted one (%d bytes)",
+		(int)graphBufferSize, (int)weightedBufferSize);
+	graphBuffer = malloc(graphBufferSize);
+	ALGO_VALIDATE( algoGraphCreate(&graph, vertexCount, vertexCount, kAlgoGraphEdgeDirected, graphBuffer, graphBufferSize) );
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		ALGO_VALIDATE( algoGraphAddVertex(graph, algoDataFromInt(iVert), NULL) );
+	}
+	for(iVert=0; iVert+1<vertexCount; ++iVert)
+	{
+		ALGO_VALIDATE( algoGraphAddEdge(graph, iVert, iVert+1) );
+	}
+	err = algoGraphAddWeightedEdge(graph, 0, 1, 5);
+	ZOMBO_ASSERT(err == kAlgoErrorOperationFailed, "algoGraphAddWeightedEdge() on an unweighted graph returned %d (expected %d)",
+		err, kAlgoErrorOperationFailed);
+	{
+		const int32_t srcIds[1] = {1}, destIds[1] = {0}, weights[1] = {5};
+		size_t addBufferSize = 0;
+		ALGO_VALIDATE( algoGraphAddEdgesComputeBufferSize(&addBufferSize, graph, 1) );
+		void *addBuffer = malloc(addBufferSize);
+		err = algoGraphAddEdges(graph, 1, srcIds, destIds, weights, addBuffer, addBufferSize);
+		ZOMBO_ASSERT(err == kAlgoErrorOperationFailed, "algoGraphAddEdges() with weights on an unweighted graph returned %d (expected %d)",
+			err, kAlgoErrorOperationFailed);
+		free(addBuffer);
+	}
+	ALGO_VALIDATE( algoGraphGetEdgeWeight(graph, 0, 1, &weight) );
+	ZOMBO_ASSERT(weight == 1, "unweighted edge has weight %d; expected 1", weight);
+
+	ALGO_VALIDATE( algoGraphDijkstraStateComputeBufferSize(&stateBufferSize, graph) );
+	stateBuffer = malloc(stateBufferSize);
+	ALGO_VALIDATE( algoGraphDijkstraStateCreate(&dijkstraState, graph, stateBuffer, stateBufferSize) );
+	ALGO_VALIDATE( algoGraphDijkstra(graph, dijkstraState, 0, -1) );
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		int32_t distance = -1;
+		ALGO_VALIDATE( algoGraphDijkstraStateGetVertexDistance(dijkstraState, iVert, &distance) );
+		ZOMBO_ASSERT(distance == iVert, "vertex %d: distance is %d; expected %d", iVert, distance, iVert);
+	}
+
+	free(stateBuffer);
+	free(graphBuffer);
+}
+
+typedef struct GridInfo
+{
+	int32_t width;
+	int32_t inconsistency; /* if non-zero, the heuristic randomly underestimates (still admissible, but not consistent) */
+} GridInfo;
+
+/* Manhattan distance, scaled by the minimum edge weight (1). */
+static int32_t gridHeuristic(AlgoGraph graph, int32_t vertexId, int32_t goalVertexId, void *userData)
+{
+	const GridInfo *grid = (const GridInfo*)userData;
+	int32_t dx = abs(vertexId % grid->width - goalVertexId % grid->width);
+	int32_t dy = abs(vertexId / grid->width - goalVertexId / grid->width);
+	(void)graph;
+	if (grid->inconsistency)
+		return (int32_t)(((uint32_t)vertexId * 2654435761u) % (uint32_t)(dx+dy+1));
+	return dx + dy;
+}
+
+/* A* on a grid with random weights: paths must be exactly as long as Dijkstra's, while settling fewer vertices. */
+static void testAStar(int32_t width, int32_t height, int32_t queryCount)
+{
+	const int32_t vertexCount = width*height;
+	size_t graphBufferSize = 0, stateBufferSize = 0;
+	void *graphBuffer = NULL, *stateBuffer = NULL;
+	AlgoGraph graph;
+	AlgoGraphDijkstraState dijkstraState;
+	GridInfo grid;
+	int32_t iVert, iQuery, iPass;
+	int64_t settledCounts[3] = {0,0,0};
+	printf("Testing algoGraphAStar (%dx%d grid, %d queries)\n", width, height, queryCount);
+
+	ALGO_VALIDATE( algoGraphComputeBufferSizeWithFlags(&graphBufferSize, vertexCount, 2*vertexCount, kAlgoGraphEdgeUndirected,
+		kAlgoGraphEdgeIndexNone, kAlgoGraphEdgeWeights) );
+	graphBuffer = malloc(graphBufferSize);
+	ALGO_VALIDATE( algoGraphCreateWithFlags(&graph, vertexCount, 2*vertexCount, kAlgoGraphEdgeUndirected, kAlgoGraphEdgeIndexNone,
+		kAlgoGraphEdgeWeights, graphBuffer, graphBufferSize) );
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		int32_t vertexId = -1;
+		ALGO_VALIDATE( algoGraphAddVertex(graph, algoDataFromInt(iVert), &vertexId) );
+	}
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		if ((iVert % width) < width-1)
+			ALGO_VALIDATE( algoGraphAddWeightedEdge(graph, iVert, iVert+1, 1 + rand() % 9) );
+		if (iVert / width < height-1)
+			ALGO_VALIDATE( algoGraphAddWeightedEdge(graph, iVert, iVert+width, 1 + rand() % 9) );
+	}
+	ALGO_VALIDATE( algoGraphDijkstraStateComputeBufferSize(&stateBufferSize, graph) );
+	stateBuffer = malloc(stateBufferSize);
+	grid.width = width;
+
+	for(iQuery=0; iQuery<queryCount; ++iQuery)
+	{
+		const int32_t sourceVertexId = rand() % vertexCount;
+		const int32_t goalVertexId = rand() % vertexCount;
+		int32_t distances[3];
+		for(iPass=0; iPass<3; ++iPass)
+		{
+			ALGO_VALIDATE( algoGraphDijkstraStateCreate(&dijkstraState, graph, stateBuffer, stateBufferSize) );
+			grid.inconsistency = (iPass == 2);
+			ALGO_VALIDATE( algoGraphAStar(graph, dijkstraState, sourceVertexId, goalVertexId,
+				(iPass == 0) ? NULL : gridHeuristic, &grid) );
+			ALGO_VALIDATE( algoGraphDijkstraStateGetVertexDistance(dijkstraState, goalVertexId, distances+iPass) );
+			for(iVert=0; iVert<vertexCount; ++iVert)
+			{
+				int isSettled = 0;
+				ALGO_VALIDATE( algoGraphDijkstraStateIsVertexSettled(dijkstraState, iVert, &isSettled) );
+				settledCounts[iPass] += isSettled;
+			}
+			/* Walk the goal's parent chain back to the source, checking that the edge weights add up. */
+			int32_t pathLength = 0, vertexId = goalVertexId;
+			while(vertexId != sourceVertexId)
+			{
+				int32_t parent = -1, weight = -1;
+				ALGO_VALIDATE( algoGraphDijkstraStateGetVertexParent(dijkstraState, vertexId, &parent) );
+				ALGO_VALIDATE( algoGraphGetEdgeWeight(graph, parent, vertexId, &weight) );
+				pathLength += weight;
+				vertexId = parent;
+			}
+			ZOMBO_ASSERT(pathLength == distances[iPass], "path length (%d) does not match distance (%d)", pathLength, distances[iPass]);
+		}
+		ZOMBO_ASSERT(distances[1] == distances[0], "A* distance (%d) should be %d", distances[1], distances[0]);
+		ZOMBO_ASSERT(distances[2] == distances[0], "A* distance with inconsistent heuristic (%d) should be %d", distances[2], distances[0]);
+	}
+	printf("\tmean vertices settled: %.1f (no heuristic), %.1f (Manhattan), %.1f (inconsistent)\n",
+		(double)settledCounts[0] / queryCount, (double)settledCounts[1] / queryCount, (double)settledCounts[2] / queryCount);
+
+	free(stateBuffer);
+	free(graphBuffer);
+}
+
+int main(void)
+{
+	unsigned int randomSeed = (unsigned int)time(NULL);
+	printf("Random seed: 0x%08X\n", randomSeed);
+	srand(randomSeed);
+
+	testDijkstra(kAlgoGraphEdgeDirected, 2000, 12000, 1000);
+	testDijkstra(kAlgoGraphEdgeUndirected, 2000, 6000, 1000);
+	testDijkstra(kAlgoGraphEdgeDirected, 500, 4000, 0); /* all-zero weights */
+	testDijkstraUnweighted();
+	testDijkstra(kAlgoGraphEdgeDirected, 64*1024, 512*1024, 1000000);
+	testAStar(256, 256, 50);
+}
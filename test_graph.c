@@ -88,8 +88,2091 @@ static void dfsProcessPersonLate(AlgoGraph graph, AlgoGraphDfsState dfsState, in
 	printf(" done processing %s\n", people[personId].name);
 }
 
-int main(void)
+/* Randomly adds and removes edges and vertices on a small, dense graph (so most vertices span several edge blocks),
+   checking every vertex's edge list against an adjacency matrix. */
+static void testEdgeMutation(AlgoGraphEdgeMode edgeMode, int32_t opCount)
 {
+	const int32_t kVertexCount = 48;
+	const int32_t kEdgeCapacity = 600;
+	size_t graphBufferSize = 0;
+	void *graphBuffer = NULL;
+	AlgoGraph graph;
+	uint8_t *isEdge = calloc(kVertexCount*kVertexCount, sizeof(uint8_t)); /* isEdge[src*kVertexCount+dest] */
+	int32_t edgeCount = 0, iVert, iOp;
+	printf("Testing AlgoGraph edge mutation (%s, %d ops)\n", (edgeMode == kAlgoGraphEdgeDirected) ? "directed" : "undirected", opCount);
+
+	ALGO_VALIDATE( algoGraphComputeBufferSize(&graphBufferSize, kVertexCount, kEdgeCapacity, edgeMode) );
+	graphBuffer = malloc(graphBufferSize);
+	ALGO_VALIDATE( algoGraphCreate(&graph, kVertexCount, kEdgeCapacity, edgeMode, graphBuffer, graphBufferSize) );
+	for(iVert=0; iVert<kVertexCount; ++iVert)
+	{
+		int32_t vertexId = -1;
+		ALGO_VALIDATE( algoGraphAddVertex(graph, algoDataFromInt(iVert), &vertexId) );
+		ZOMBO_ASSERT(vertexId == iVert, "vertex IDs should be assigned in order");
+	}
+	for(iOp=0; iOp<opCount; ++iOp)
+	{
+		int32_t v0 = rand() % kVertexCount, v1 = rand() % kVertexCount;
+		int32_t op = rand() % 100;
+		if (v0 == v1)
+			continue;
+		if (op < 60)
+		{
+			AlgoError addResult = algoGraphAddEdge(graph, v0, v1);
+			if (!isEdge[v0*kVertexCount+v1])
+			{
+				if (edgeCount == kEdgeCapacity)
+				{
+					ZOMBO_ASSERT(kAlgoErrorOperationFailed == addResult, "adding an edge to a full graph should fail");
+					continue;
+				}
+				edgeCount += 1;
+			}
+			ALGO_VALIDATE( addResult );
+			isEdge[v0*kVertexCount+v1] = 1;
+			if (edgeMode == kAlgoGraphEdgeUndirected)
+				isEdge[v1*kVertexCount+v0] = 1;
+		}
+		else if (op < 99)
+		{
+			AlgoError removeResult = algoGraphRemoveEdge(graph, v0, v1);
+			if (isEdge[v0*kVertexCount+v1])
+			{
+				ALGO_VALIDATE( removeResult );
+				edgeCount -= 1;
+			}
+			else
+				ZOMBO_ASSERT(kAlgoErrorOperationFailed == removeResult, "removing a nonexistent edge should fail");
+			isEdge[v0*kVertexCount+v1] = 0;
+			if (edgeMode == kAlgoGraphEdgeUndirected)
+				isEdge[v1*kVertexCount+v0] = 0;
+		}
+		else
+		{
+			/* Remove a vertex and immediately add it back (it'll reuse the same ID), without any edges. */
+			int32_t vertexId = -1;
+			ALGO_VALIDATE( algoGraphRemoveVertex(graph, v0) );
+			ALGO_VALIDATE( algoGraphAddVertex(graph, algoDataFromInt(v0), &vertexId) );
+			ZOMBO_ASSERT(vertexId == v0, "re-added vertex should reuse ID %d (got %d)", v0, vertexId);
+			for(iVert=0; iVert<kVertexCount; ++iVert)
+			{
+				edgeCount -= isEdge[v0*kVertexCount+iVert];
+				if (edgeMode == kAlgoGraphEdgeDirected)
+					edgeCount -= isEdge[iVert*kVertexCount+v0];
+				isEdge[v0*kVertexCount+iVert] = 0;
+				isEdge[iVert*kVertexCount+v0] = 0;
+			}
+		}
+
+		if ((iOp % 64) == 0)
+		{
+			int32_t actualEdgeCount = -1;
+			ALGO_VALIDATE( algoGraphValidate(graph) );
+			ALGO_VALIDATE( algoGraphGetCurrentEdgeCount(graph, &actualEdgeCount) );
+			ZOMBO_ASSERT(actualEdgeCount == edgeCount, "edge count (%d) should be %d", actualEdgeCount, edgeCount);
+			for(iVert=0; iVert<kVertexCount; ++iVert)
+			{
+				int32_t degree = -1, expectedDegree = 0, iEdge;
+				int32_t destVertexIds[48];
+				for(iEdge=0; iEdge<kVertexCount; ++iEdge)
+					expectedDegree += isEdge[iVert*kVertexCount+iEdge];
+				ALGO_VALIDATE( algoGraphGetVertexDegree(graph, iVert, &degree) );
+				ZOMBO_ASSERT(degree == expectedDegree, "vertex %d has degree %d; expected %d", iVert, degree, expectedDegree);
+				ALGO_VALIDATE( algoGraphGetVertexEdges(graph, iVert, degree, destVertexIds) );
+				for(iEdge=0; iEdge<degree; ++iEdge)
+				{
+					ZOMBO_ASSERT(isEdge[iVert*kVertexCount+destVertexIds[iEdge]], "unexpected edge %d->%d", iVert, destVertexIds[iEdge]);
+				}
+			}
+		}
+	}
+	free(graphBuffer);
+	free(isEdge);
+}
+
+/* Compares bidirectional shortest paths against the depth of the goal in a full BFS from the source. */
+static void testShortestPathBidirectional(AlgoGraphEdgeMode edgeMode, uint32_t graphFlags, int32_t vertexCount, int32_t edgeCount,
+	int32_t queryCount)
+{
+	size_t graphBufferSize = 0, bfsStateBufferSize = 0, pathBufferSize = 0;
+	void *graphBuffer = NULL, *bfsStateBuffer = NULL, *pathBuffer = NULL;
+	AlgoGraph graph;
+	AlgoGraphBfsState bfsState;
+	AlgoGraphBfsCallbacks bfsCallbacks = {NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
+	int32_t *path = malloc(vertexCount*sizeof(int32_t));
+	int32_t iVert, iEdge, iQuery, foundCount = 0;
+	uint64_t startTicks, bfsTicks = 0, bidirectionalTicks = 0;
+	AlgoError err;
+	printf("Testing algoGraphShortestPathBidirectional (%s%s, %d vertices, %d edges)\n",
+		(edgeMode == kAlgoGraphEdgeDirected) ? "directed" : "undirected", (graphFlags & kAlgoGraphInEdges) ? " with in-edges" : "",
+		vertexCount, edgeCount);
+
+	ALGO_VALIDATE( algoGraphComputeBufferSizeWithFlags(&graphBufferSize, vertexCount, edgeCount, edgeMode, kAlgoGraphEdgeIndexNone,
+		graphFlags) );
+	graphBuffer = malloc(graphBufferSize);
+	ALGO_VALIDATE( algoGraphCreateWithFlags(&graph, vertexCount, edgeCount, edgeMode, kAlgoGraphEdgeIndexNone, graphFlags,
+		graphBuffer, graphBufferSize) );
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		int32_t vertexId = -1;
+		ALGO_VALIDATE( algoGraphAddVertex(graph, algoDataFromInt(iVert), &vertexId) );
+	}
+	for(iEdge=0; iEdge<edgeCount; ++iEdge)
+	{
+		int32_t v0 = rand() % vertexCount, v1 = rand() % vertexCount;
+		if (v0 != v1)
+			ALGO_VALIDATE( algoGraphAddEdge(graph, v0, v1) );
+	}
+	ALGO_VALIDATE( algoGraphBfsStateComputeBufferSize(&bfsStateBufferSize, graph) );
+	bfsStateBuffer = malloc(bfsStateBufferSize);
+	ALGO_VALIDATE( algoGraphShortestPathBidirectionalComputeBufferSize(&pathBufferSize, graph) );
+	pathBuffer = malloc(pathBufferSize);
+
+	for(iQuery=0; iQuery<queryCount; ++iQuery)
+	{
+		const int32_t sourceVertexId = rand() % vertexCount;
+		const int32_t goalVertexId = (iQuery == 0) ? sourceVertexId : rand() % vertexCount;
+		int32_t pathLength = -1, expectedPathLength = 0, parent = -1;
+		startTicks = zomboClockTicks();
+		ALGO_VALIDATE( algoGraphBfsStateCreate(&bfsState, graph, bfsStateBuffer, bfsStateBufferSize) );
+		ALGO_VALIDATE( algoGraphBfs(graph, bfsState, sourceVertexId, bfsCallbacks) );
+		bfsTicks += zomboClockTicks() - startTicks;
+		int isReachable = 0;
+		ALGO_VALIDATE( algoGraphBfsStateIsVertexDiscovered(bfsState, goalVertexId, &isReachable) );
+		if (isReachable)
+		{
+			for(iVert=goalVertexId; iVert != -1; iVert = parent)
+			{
+				ALGO_VALIDATE( algoGraphBfsStateGetVertexParent(bfsState, iVert, &parent) );
+				expectedPathLength += 1;
+			}
+		}
+
+		startTicks = zomboClockTicks();
+		ALGO_VALIDATE( algoGraphShortestPathBidirectional(graph, sourceVertexId, goalVertexId, path, vertexCount, &pathLength,
+			pathBuffer, pathBufferSize) );
+		bidirectionalTicks += zomboClockTicks() - startTicks;
+		ZOMBO_ASSERT(pathLength == expectedPathLength, "%d->%d: path has %d vertices; expected %d", sourceVertexId, goalVertexId,
+			pathLength, expectedPathLength);
+		if (pathLength == 0)
+			continue;
+		foundCount += 1;
+		ZOMBO_ASSERT(path[0] == sourceVertexId && path[pathLength-1] == goalVertexId, "path has the wrong endpoints");
+		for(iVert=1; iVert<pathLength; ++iVert)
+		{
+			int32_t weight = 0;
+			ALGO_VALIDATE( algoGraphGetEdgeWeight(graph, path[iVert-1], path[iVert], &weight) ); /* fails if there's no such edge */
+		}
+		if (pathLength > 1)
+		{
+			err = algoGraphShortestPathBidirectional(graph, sourceVertexId, goalVertexId, path, pathLength-1, &pathLength,
+				pathBuffer, pathBufferSize);
+			ZOMBO_ASSERT(err == kAlgoErrorOperationFailed, "a path that doesn't fit returned %d (expected %d)",
+				err, kAlgoErrorOperationFailed);
+			ZOMBO_ASSERT(pathLength == expectedPathLength, "required path length should still be reported");
+		}
+	}
+	printf("\t%d/%d goals reachable; full BFS: %.3f ms/query, bidirectional: %.3f ms/query\n", foundCount, queryCount,
+		1000.0 * zomboTicksToSeconds(bfsTicks) / queryCount, 1000.0 * zomboTicksToSeconds(bidirectionalTicks) / queryCount);
+
+	free(pathBuffer);
+	free(bfsStateBuffer);
+	free(graphBuffer);
+	free(path);
+}
+
+/* Computes each vertex's depth in a completed BFS, or -1 for undiscovered vertices. */
+static void computeBfsDepths(AlgoGraphBfsState bfsState, int32_t rootVertexId, int32_t vertexCount, int32_t depths[])
+{
+	int32_t iVert;
+	/* Parents always precede their children in BFS order, but not necessarily in vertex ID order, so walk up each
+	   vertex's parent chain until it reaches a vertex whose depth is already known. */
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		depths[iVert] = -2; /* unknown */
+	}
+	depths[rootVertexId] = 0;
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		int32_t v = iVert, chainLength = 0, parent = -1;
+		int isDiscovered = 0;
+		ALGO_VALIDATE( algoGraphBfsStateIsVertexDiscovered(bfsState, iVert, &isDiscovered) );
+		if (!isDiscovered)
+		{
+			depths[iVert] = -1;
+			continue;
+		}
+		for(; depths[v] == -2; v = parent, ++chainLength)
+		{
+			ALGO_VALIDATE( algoGraphBfsStateGetVertexParent(bfsState, v, &parent) );
+		}
+		const int32_t knownDepth = depths[v];
+		for(v = iVert; depths[v] == -2; v = parent, --chainLength)
+		{
+			ALGO_VALIDATE( algoGraphBfsStateGetVertexParent(bfsState, v, &parent) );
+			depths[v] = knownDepth + chainLength;
+		}
+	}
+}
+
+/* Checks that a BFS reached the vertices at the given depths (and recorded them as their levels), through valid edges, with
+   every parent one level up. */
+static void checkBfsParents(AlgoGraph graph, AlgoGraphBfsState bfsState, int32_t rootVertexId, int32_t vertexCount, const int32_t depths[])
+{
+	int32_t iVert;
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		int isDiscovered = 0, isProcessed = 0;
+		int32_t parent = -1, weight = 0, level = 0;
+		ALGO_VALIDATE( algoGraphBfsStateIsVertexDiscovered(bfsState, iVert, &isDiscovered) );
+		ALGO_VALIDATE( algoGraphBfsStateIsVertexProcessed(bfsState, iVert, &isProcessed) );
+		ALGO_VALIDATE( algoGraphBfsStateGetVertexLevel(bfsState, iVert, &level) );
+		ZOMBO_ASSERT(isDiscovered == (depths[iVert] >= 0), "vertex %d: discovered=%d, but its depth is %d", iVert, isDiscovered, depths[iVert]);
+		ZOMBO_ASSERT(level == depths[iVert], "vertex %d: level is %d, but its depth is %d", iVert, level, depths[iVert]);
+		ZOMBO_ASSERT(isProcessed == isDiscovered, "vertex %d: processed=%d, discovered=%d", iVert, isProcessed, isDiscovered);
+		if (!isDiscovered || iVert == rootVertexId)
+			continue;
+		ALGO_VALIDATE( algoGraphBfsStateGetVertexParent(bfsState, iVert, &parent) );
+		ZOMBO_ASSERT(parent >= 0 && depths[parent] == depths[iVert]-1, "vertex %d (depth %d): parent %d has depth %d", iVert,
+			depths[iVert], parent, (parent >= 0) ? depths[parent] : -1);
+		ALGO_VALIDATE( algoGraphGetEdgeWeight(graph, parent, iVert, &weight) ); /* fails if there's no such edge */
+	}
+}
+
+/* Adds vertexCount vertices and about vertexCount*averageDegree random edges to an empty graph. */
+static void addRandomEdges(AlgoGraph graph, int32_t vertexCount, int32_t averageDegree)
+{
+	int32_t iVert, iEdge;
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		int32_t vertexId = -1;
+		ALGO_VALIDATE( algoGraphAddVertex(graph, algoDataFromInt(iVert), &vertexId) );
+	}
+	for(iEdge=0; iEdge<vertexCount*averageDegree; ++iEdge)
+	{
+		int32_t v0 = (int32_t)(((uint32_t)rand() * 32768u + (uint32_t)rand()) % (uint32_t)vertexCount);
+		int32_t v1 = (int32_t)(((uint32_t)rand() * 32768u + (uint32_t)rand()) % (uint32_t)vertexCount);
+		if (v0 != v1) /* no self-connecting edges */
+			ALGO_VALIDATE( algoGraphAddEdge(graph, v0, v1) );
+	}
+}
+
+/* A graph built by addRandomEdges(), plus a BFS state for it; shared setup for the BFS tests below. */
+typedef struct BfsFixture
+{
+	AlgoGraph graph;
+	AlgoGraphBfsState bfsState;
+	AlgoGraphBfsCallbacks bfsCallbacks; /* all NULL */
+	int32_t edgeCount; /* edge capacity: vertexCount*averageDegree */
+	void *graphBuffer;
+	void *bfsStateBuffer;
+	size_t bfsStateBufferSize;
+} BfsFixture;
+/* Clears the fixture's BFS state, ready for a new search. */
+static void resetBfsFixture(BfsFixture *fixture)
+{
+	ALGO_VALIDATE( algoGraphBfsStateCreate(&fixture->bfsState, fixture->graph, fixture->bfsStateBuffer, fixture->bfsStateBufferSize) );
+}
+static void createBfsFixture(BfsFixture *fixture, AlgoGraphEdgeMode edgeMode, uint32_t graphFlags, int32_t vertexCount,
+	int32_t averageDegree)
+{
+	size_t graphBufferSize = 0;
+	memset(fixture, 0, sizeof(*fixture));
+	fixture->edgeCount = vertexCount*averageDegree;
+	ALGO_VALIDATE( algoGraphComputeBufferSizeWithFlags(&graphBufferSize, vertexCount, fixture->edgeCount, edgeMode,
+		kAlgoGraphEdgeIndexNone, graphFlags) );
+	fixture->graphBuffer = malloc(graphBufferSize);
+	ALGO_VALIDATE( algoGraphCreateWithFlags(&fixture->graph, vertexCount, fixture->edgeCount, edgeMode, kAlgoGraphEdgeIndexNone,
+		graphFlags, fixture->graphBuffer, graphBufferSize) );
+	addRandomEdges(fixture->graph, vertexCount, averageDegree);
+	ALGO_VALIDATE( algoGraphBfsStateComputeBufferSize(&fixture->bfsStateBufferSize, fixture->graph) );
+	fixture->bfsStateBuffer = malloc(fixture->bfsStateBufferSize);
+	resetBfsFixture(fixture);
+}
+static void destroyBfsFixture(BfsFixture *fixture)
+{
+	free(fixture->bfsStateBuffer);
+	free(fixture->graphBuffer);
+}
+
+/* Checks that a direction-optimizing BFS reaches the same vertices as algoGraphBfs(), at the same depths. */
+static void testBfsDirectionOptimizing(AlgoGraphEdgeMode edgeMode, uint32_t graphFlags, int32_t vertexCount, int32_t averageDegree,
+	int32_t passCount)
+{
+	BfsFixture fixture;
+	int32_t *depths = malloc(vertexCount*sizeof(int32_t));
+	int32_t iPass;
+	AlgoError err;
+	createBfsFixture(&fixture, edgeMode, graphFlags, vertexCount, averageDegree);
+	printf("Testing algoGraphBfsDirectionOptimizing (%s%s, %d vertices, %d edges)\n",
+		(edgeMode == kAlgoGraphEdgeDirected) ? "directed" : "undirected", (graphFlags & kAlgoGraphInEdges) ? " with in-edges" : "",
+		vertexCount, fixture.edgeCount);
+
+	for(iPass=0; iPass<passCount; ++iPass)
+	{
+		const int32_t rootVertexId = rand() % vertexCount;
+		/* Odd passes use extreme thresholds, to force a switch at nearly every level. */
+		const int32_t alpha = (iPass % 2) ? 1 : 0;
+		const int32_t beta  = (iPass % 2) ? 1 : 0;
+		resetBfsFixture(&fixture);
+		ALGO_VALIDATE( algoGraphBfs(fixture.graph, fixture.bfsState, rootVertexId, fixture.bfsCallbacks) );
+		computeBfsDepths(fixture.bfsState, rootVertexId, vertexCount, depths);
+
+		resetBfsFixture(&fixture);
+		ALGO_VALIDATE( algoGraphBfsDirectionOptimizing(fixture.graph, fixture.bfsState, rootVertexId, alpha, beta) );
+		checkBfsParents(fixture.graph, fixture.bfsState, rootVertexId, vertexCount, depths);
+	}
+	err = algoGraphBfsDirectionOptimizing(fixture.graph, fixture.bfsState, 0, -1, 0);
+	ZOMBO_ASSERT(kAlgoErrorInvalidArgument == err, "a negative alpha returned %d (expected %d)", err, kAlgoErrorInvalidArgument);
+
+	destroyBfsFixture(&fixture);
+	free(depths);
+}
+
+/* Builds the path from the root to target one algoGraphBfsStateGetVertexParent() call at a time, then reverses it.
+   Returns the number of vertices in the path, or 0 if target is undiscovered. */
+static int32_t getPathFromParents(AlgoGraphBfsState bfsState, int32_t target, int32_t outPath[])
+{
+	int isDiscovered = 0;
+	int32_t pathLength = 0, v, iPath;
+	ALGO_VALIDATE( algoGraphBfsStateIsVertexDiscovered(bfsState, target, &isDiscovered) );
+	for(v = target; v >= 0 && isDiscovered; ++pathLength)
+	{
+		outPath[pathLength] = v;
+		ALGO_VALIDATE( algoGraphBfsStateGetVertexParent(bfsState, v, &v) );
+	}
+	for(iPath=0; iPath<pathLength/2; ++iPath)
+	{
+		const int32_t temp = outPath[iPath];
+		outPath[iPath] = outPath[pathLength-1-iPath];
+		outPath[pathLength-1-iPath] = temp;
+	}
+	return pathLength;
+}
+
+/* Checks algoGraphBfsStateGetPath() and the level/parent arrays against the per-vertex accessors. */
+static void testBfsPaths(AlgoGraphEdgeMode edgeMode, int32_t vertexCount, int32_t averageDegree, int32_t queryCount)
+{
+	BfsFixture fixture;
+	const int32_t *levels = NULL, *parents = NULL;
+	int32_t *path = malloc(vertexCount*sizeof(int32_t));
+	int32_t *slowPath = malloc(vertexCount*sizeof(int32_t));
+	int32_t histogram[64], slowHistogram[64];
+	int32_t iVert, iQuery, levelCount = 0, parentCount = 0, pathLength = 0;
+	const int32_t rootVertexId = rand() % vertexCount;
+	createBfsFixture(&fixture, edgeMode, kAlgoGraphDefault, vertexCount, averageDegree);
+	const AlgoGraph graph = fixture.graph;
+	const AlgoGraphBfsState bfsState = fixture.bfsState;
+	printf("Testing algoGraphBfsStateGetPath (%s, %d vertices, %d edges)\n",
+		(edgeMode == kAlgoGraphEdgeDirected) ? "directed" : "undirected", vertexCount, fixture.edgeCount);
+
+	ALGO_VALIDATE( algoGraphBfs(graph, bfsState, rootVertexId, fixture.bfsCallbacks) );
+	ALGO_VALIDATE( algoGraphBfsStateGetLevels(bfsState, &levels, &levelCount) );
+	ALGO_VALIDATE( algoGraphBfsStateGetParents(bfsState, &parents, &parentCount) );
+	ZOMBO_ASSERT(levelCount == vertexCount && parentCount == vertexCount, "array sizes (%d, %d) should be %d", levelCount,
+		parentCount, vertexCount);
+
+	for(iQuery=0; iQuery<queryCount; ++iQuery)
+	{
+		const int32_t target = rand() % vertexCount;
+		int32_t level = -1, slowLength = 0, iPath;
+		ALGO_VALIDATE( algoGraphBfsStateGetVertexLevel(bfsState, target, &level) );
+		ZOMBO_ASSERT(level == levels[target], "vertex %d: level %d does not match the level array (%d)", target, level, levels[target]);
+		ALGO_VALIDATE( algoGraphBfsStateGetPath(bfsState, target, path, vertexCount, &pathLength) );
+		slowLength = getPathFromParents(bfsState, target, slowPath);
+		ZOMBO_ASSERT(pathLength == level+1 && pathLength == slowLength, "vertex %d (level %d): path length is %d, expected %d", target,
+			level, pathLength, slowLength);
+		ZOMBO_ASSERT(pathLength == 0 || path[0] == rootVertexId, "vertex %d: path starts at %d, not the root", target, path[0]);
+		for(iPath=0; iPath<pathLength; ++iPath)
+		{
+			int32_t weight = 0;
+			ZOMBO_ASSERT(path[iPath] == slowPath[iPath], "vertex %d: path element %d does not match", target, iPath);
+			ZOMBO_ASSERT(levels[path[iPath]] == iPath && (iPath == 0 || parents[path[iPath]] == path[iPath-1]),
+				"vertex %d: path element %d has the wrong level or parent", target, iPath);
+			if (iPath > 0)
+				ALGO_VALIDATE( algoGraphGetEdgeWeight(graph, path[iPath-1], path[iPath], &weight) ); /* fails if there's no such edge */
+		}
+		if (pathLength > 1)
+		{
+			int32_t requiredLength = 0;
+			AlgoError err = algoGraphBfsStateGetPath(bfsState, target, path, pathLength-1, &requiredLength);
+			ZOMBO_ASSERT(kAlgoErrorOperationFailed == err, "a path that does not fit returned %d (expected %d)", err, kAlgoErrorOperationFailed);
+			ZOMBO_ASSERT(requiredLength == pathLength, "required path length is %d, expected %d", requiredLength, pathLength);
+		}
+	}
+
+	memset(histogram, 0, sizeof(histogram));
+	for(iVert=0; iVert<levelCount; ++iVert)
+	{
+		if (levels[iVert] >= 0)
+			histogram[levels[iVert] < 63 ? levels[iVert] : 63] += 1;
+	}
+	memset(slowHistogram, 0, sizeof(slowHistogram));
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		int32_t level = -1;
+		ALGO_VALIDATE( algoGraphBfsStateGetVertexLevel(bfsState, iVert, &level) );
+		if (level >= 0)
+			slowHistogram[level < 63 ? level : 63] += 1;
+	}
+	ZOMBO_ASSERT(0 == memcmp(histogram, slowHistogram, sizeof(histogram)), "level histograms do not match");
+
+	destroyBfsFixture(&fixture);
+	free(slowPath);
+	free(path);
+}
+
+typedef struct BfsParallelArgs
+{
+	AlgoGraphBfsParallel search;
+	int32_t threadIndex;
+} BfsParallelArgs;
+static ZomboThreadReturn ZOMBO_THREAD_CALL bfsParallelWorker(void *voidArgs)
+{
+	BfsParallelArgs *args = (BfsParallelArgs*)voidArgs;
+	ALGO_VALIDATE( algoGraphBfsParallel(args->search, args->threadIndex) );
+	return 0;
+}
+
+/* Checks that a multi-threaded BFS reaches the same vertices as algoGraphBfs(), at the same depths, for several thread
+   counts. */
+static void testBfsParallel(AlgoGraphEdgeMode edgeMode, int32_t vertexCount, int32_t averageDegree, int32_t maxThreadCount)
+{
+	BfsFixture fixture;
+	size_t searchBufferSize = 0;
+	void *searchBuffer = NULL;
+	AlgoGraphBfsParallel search;
+	ZomboThread *threads = malloc(maxThreadCount*sizeof(ZomboThread));
+	BfsParallelArgs *args = malloc(maxThreadCount*sizeof(BfsParallelArgs));
+	int32_t *depths = malloc(vertexCount*sizeof(int32_t));
+	int32_t threadCount, iThread;
+	const int32_t rootVertexId = rand() % vertexCount;
+	int err;
+	createBfsFixture(&fixture, edgeMode, kAlgoGraphDefault, vertexCount, averageDegree);
+	const AlgoGraph graph = fixture.graph;
+	printf("Testing algoGraphBfsParallel (%s, %d vertices, %d edges)\n",
+		(edgeMode == kAlgoGraphEdgeDirected) ? "directed" : "undirected", vertexCount, fixture.edgeCount);
+
+	ALGO_VALIDATE( algoGraphBfs(graph, fixture.bfsState, rootVertexId, fixture.bfsCallbacks) );
+	computeBfsDepths(fixture.bfsState, rootVertexId, vertexCount, depths);
+
+	for(threadCount=1; threadCount<=maxThreadCount; threadCount *= 2)
+	{
+		ALGO_VALIDATE( algoGraphBfsParallelComputeBufferSize(&searchBufferSize, graph, threadCount) );
+		searchBuffer = malloc(searchBufferSize);
+		resetBfsFixture(&fixture);
+		ALGO_VALIDATE( algoGraphBfsParallelCreate(&search, graph, fixture.bfsState, rootVertexId, threadCount, searchBuffer,
+			searchBufferSize) );
+		size_t reportedSize;
+		ALGO_VALIDATE( algoGraphBfsParallelGetBufferSize(search, &reportedSize) );
+		ZOMBO_ASSERT(reportedSize == searchBufferSize, "reported size does not match input buffer size");
+		err = algoGraphBfsParallel(search, threadCount);
+		ZOMBO_ASSERT(err == kAlgoErrorInvalidArgument, "an out-of-range threadIndex returned %d (expected %d)", err, kAlgoErrorInvalidArgument);
+
+		for(iThread=0; iThread<threadCount; ++iThread)
+		{
+			args[iThread].search = search;
+			args[iThread].threadIndex = iThread;
+			err = zomboThreadCreate(threads+iThread, bfsParallelWorker, args+iThread);
+			ZOMBO_ASSERT(err == 0, "thread creation failed (%d)", err);
+		}
+		for(iThread=0; iThread<threadCount; ++iThread)
+		{
+			zomboThreadJoin(threads[iThread]);
+		}
+		checkBfsParents(graph, fixture.bfsState, rootVertexId, vertexCount, depths);
+		free(searchBuffer);
+	}
+
+	destroyBfsFixture(&fixture);
+	free(depths);
+	free(args);
+	free(threads);
+}
+
+/* Checks multi-source BFS distances against a separate algoGraphBfs() from each root. */
+static void testMultiSourceBfs(AlgoGraphEdgeMode edgeMode, int32_t vertexCount, int32_t averageDegree, int32_t rootCount)
+{
+	BfsFixture fixture;
+	size_t multiBufferSize = 0;
+	void *multiBuffer = NULL;
+	int32_t *rootVertexIds = malloc(rootCount*sizeof(int32_t));
+	int32_t *distances = malloc((size_t)rootCount*vertexCount*sizeof(int32_t));
+	int32_t *depths = malloc(vertexCount*sizeof(int32_t));
+	int32_t iRoot, iVert;
+	createBfsFixture(&fixture, edgeMode, kAlgoGraphDefault, vertexCount, averageDegree);
+	const AlgoGraph graph = fixture.graph;
+	printf("Testing algoGraphMultiSourceBfs (%s, %d vertices, %d edges, %d roots)\n",
+		(edgeMode == kAlgoGraphEdgeDirected) ? "directed" : "undirected", vertexCount, fixture.edgeCount, rootCount);
+
+	ALGO_VALIDATE( algoGraphMultiSourceBfsComputeBufferSize(&multiBufferSize, graph) );
+	multiBuffer = malloc(multiBufferSize);
+	for(iRoot=0; iRoot<rootCount; ++iRoot)
+	{
+		rootVertexIds[iRoot] = (iRoot == 1) ? rootVertexIds[0] : rand() % vertexCount; /* include a duplicate root */
+	}
+
+	ALGO_VALIDATE( algoGraphMultiSourceBfs(graph, rootVertexIds, rootCount, distances, multiBuffer, multiBufferSize) );
+	for(iRoot=0; iRoot<rootCount; ++iRoot)
+	{
+		resetBfsFixture(&fixture);
+		ALGO_VALIDATE( algoGraphBfs(graph, fixture.bfsState, rootVertexIds[iRoot], fixture.bfsCallbacks) );
+		computeBfsDepths(fixture.bfsState, rootVertexIds[iRoot], vertexCount, depths);
+		for(iVert=0; iVert<vertexCount; ++iVert)
+		{
+			const int32_t distance = distances[(size_t)iRoot*vertexCount + iVert];
+			ZOMBO_ASSERT(distance == depths[iVert], "root %d -> vertex %d: distance is %d, expected %d", rootVertexIds[iRoot], iVert,
+				distance, depths[iVert]);
+		}
+	}
+	rootVertexIds[0] = -1;
+	AlgoError err = algoGraphMultiSourceBfs(graph, rootVertexIds, rootCount, distances, multiBuffer, multiBufferSize);
+	ZOMBO_ASSERT(kAlgoErrorInvalidArgument == err, "an invalid root returned %d (expected %d)", err, kAlgoErrorInvalidArgument);
+
+	free(multiBuffer);
+	destroyBfsFixture(&fixture);
+	free(depths);
+	free(distances);
+	free(rootVertexIds);
+}
+
+/* Checks that algoGraphBfsMulti() claims every vertex for its nearest root (the first-listed root, on ties), and that
+   algoGraphDfsMulti() builds a forest covering the same vertices. Distances are checked against algoGraphMultiSourceBfs(). */
+static void testSearchMultiRoot(AlgoGraphEdgeMode edgeMode, int32_t vertexCount, int32_t averageDegree, int32_t rootCount)
+{
+	BfsFixture fixture;
+	size_t dfsStateBufferSize = 0, multiBufferSize = 0;
+	void *dfsStateBuffer = NULL, *multiBuffer = NULL;
+	AlgoGraphDfsState dfsState;
+	AlgoGraphDfsCallbacks dfsCallbacks = {NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
+	int32_t *rootVertexIds = malloc(rootCount*sizeof(int32_t));
+	int32_t *distances = malloc((size_t)rootCount*vertexCount*sizeof(int32_t));
+	int32_t *rootIndices = malloc(vertexCount*sizeof(int32_t));
+	int32_t iRoot, iVert, discoveredCount = 0;
+	createBfsFixture(&fixture, edgeMode, kAlgoGraphDefault, vertexCount, averageDegree);
+	const AlgoGraph graph = fixture.graph;
+	const AlgoGraphBfsState bfsState = fixture.bfsState;
+	const AlgoGraphBfsCallbacks bfsCallbacks = fixture.bfsCallbacks;
+	printf("Testing algoGraphBfsMulti/algoGraphDfsMulti (%s, %d vertices, %d edges, %d roots)\n",
+		(edgeMode == kAlgoGraphEdgeDirected) ? "directed" : "undirected", vertexCount, fixture.edgeCount, rootCount);
+
+	ALGO_VALIDATE( algoGraphDfsStateComputeBufferSize(&dfsStateBufferSize, graph) );
+	dfsStateBuffer = malloc(dfsStateBufferSize);
+	ALGO_VALIDATE( algoGraphMultiSourceBfsComputeBufferSize(&multiBufferSize, graph) );
+	multiBuffer = malloc(multiBufferSize);
+	for(iRoot=0; iRoot<rootCount; ++iRoot)
+	{
+		rootVertexIds[iRoot] = (iRoot == 1) ? rootVertexIds[0] : rand() % vertexCount; /* include a duplicate root */
+	}
+	ALGO_VALIDATE( algoGraphMultiSourceBfs(graph, rootVertexIds, rootCount, distances, multiBuffer, multiBufferSize) );
+
+	ALGO_VALIDATE( algoGraphBfsMulti(graph, bfsState, rootCount, rootVertexIds, bfsCallbacks) );
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		int32_t nearestRoot = -1, nearestDistance = -1, depth = 0, v = iVert, parent = -1;
+		int isDiscovered = 0;
+		for(iRoot=0; iRoot<rootCount; ++iRoot)
+		{
+			const int32_t distance = distances[(size_t)iRoot*vertexCount + iVert];
+			if (distance >= 0 && (nearestDistance < 0 || distance < nearestDistance))
+			{
+				nearestRoot = iRoot;
+				nearestDistance = distance;
+			}
+		}
+		ALGO_VALIDATE( algoGraphBfsStateIsVertexDiscovered(bfsState, iVert, &isDiscovered) );
+		ZOMBO_ASSERT(isDiscovered == (nearestRoot >= 0), "vertex %d: discovered=%d, but its nearest root is %d", iVert, isDiscovered,
+			nearestRoot);
+		rootIndices[iVert] = nearestRoot;
+		if (!isDiscovered)
+			continue;
+		discoveredCount += 1;
+		for(;; v = parent, ++depth)
+		{
+			ALGO_VALIDATE( algoGraphBfsStateGetVertexParent(bfsState, v, &parent) );
+			if (parent < 0)
+				break;
+		}
+		ZOMBO_ASSERT(depth == nearestDistance && v == rootVertexIds[nearestRoot], "vertex %d: reached root %d at depth %d, expected %d at %d",
+			iVert, v, depth, rootVertexIds[nearestRoot], nearestDistance);
+		ALGO_VALIDATE( algoGraphBfsStateGetVertexLevel(bfsState, iVert, &depth) );
+		ZOMBO_ASSERT(depth == nearestDistance, "vertex %d: level is %d, expected %d", iVert, depth, nearestDistance);
+	}
+	rootVertexIds[0] = -1;
+	AlgoError err = algoGraphBfsMulti(graph, bfsState, rootCount, rootVertexIds, bfsCallbacks);
+	ZOMBO_ASSERT(kAlgoErrorInvalidArgument == err, "an invalid BFS root returned %d (expected %d)", err, kAlgoErrorInvalidArgument);
+	rootVertexIds[0] = rootVertexIds[1];
+
+	/* The DFS forest must cover the same vertices, with valid times, and every tree must start at one of the roots. */
+	ALGO_VALIDATE( algoGraphDfsStateCreate(&dfsState, graph, dfsStateBuffer, dfsStateBufferSize) );
+	ALGO_VALIDATE( algoGraphDfsMulti(graph, dfsState, rootCount, rootVertexIds, dfsCallbacks) );
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		int isDiscovered = 0, isProcessed = 0;
+		int32_t parent = -1, entryTime = 0, exitTime = 0;
+		ALGO_VALIDATE( algoGraphDfsStateIsVertexDiscovered(dfsState, iVert, &isDiscovered) );
+		ALGO_VALIDATE( algoGraphDfsStateIsVertexProcessed(dfsState, iVert, &isProcessed) );
+		ZOMBO_ASSERT(isDiscovered == (rootIndices[iVert] >= 0) && isProcessed == isDiscovered,
+			"vertex %d: DFS discovered=%d processed=%d, BFS discovered=%d", iVert, isDiscovered, isProcessed, rootIndices[iVert] >= 0);
+		if (!isDiscovered)
+			continue;
+		ALGO_VALIDATE( algoGraphDfsStateGetVertexParent(dfsState, iVert, &parent) );
+		ALGO_VALIDATE( algoGraphDfsStateGetVertexEntryTime(dfsState, iVert, &entryTime) );
+		ALGO_VALIDATE( algoGraphDfsStateGetVertexExitTime(dfsState, iVert, &exitTime) );
+		ZOMBO_ASSERT(entryTime >= 1 && entryTime < exitTime && exitTime <= 2*discoveredCount, "vertex %d: bad entry/exit times (%d, %d)",
+			iVert, entryTime, exitTime);
+		if (parent < 0)
+		{
+			for(iRoot=0; iRoot<rootCount && rootVertexIds[iRoot] != iVert; ++iRoot) {}
+			ZOMBO_ASSERT(iRoot < rootCount, "vertex %d has no parent, but is not a root", iVert);
+		}
+		else
+		{
+			int32_t parentEntryTime = 0, parentExitTime = 0;
+			ALGO_VALIDATE( algoGraphDfsStateGetVertexEntryTime(dfsState, parent, &parentEntryTime) );
+			ALGO_VALIDATE( algoGraphDfsStateGetVertexExitTime(dfsState, parent, &parentExitTime) );
+			ZOMBO_ASSERT(parentEntryTime < entryTime && exitTime < parentExitTime, "vertex %d: not nested inside parent %d", iVert, parent);
+		}
+	}
+	rootVertexIds[0] = -1;
+	err = algoGraphDfsMulti(graph, dfsState, rootCount, rootVertexIds, dfsCallbacks);
+	ZOMBO_ASSERT(kAlgoErrorInvalidArgument == err, "an invalid DFS root returned %d (expected %d)", err, kAlgoErrorInvalidArgument);
+
+	free(multiBuffer);
+	free(dfsStateBuffer);
+	destroyBfsFixture(&fixture);
+	free(rootIndices);
+	free(distances);
+	free(rootVertexIds);
+}
+
+typedef struct SearchControlContext
+{
+	int32_t *visitOrder; /* vertices in the order they were visited by vertexFuncEarly */
+	int32_t visitCount;
+	int32_t controlCount; /* number of control callbacks so far */
+	int32_t stopInterval; /* if non-zero, every stopInterval'th control callback stops the search */
+	int32_t isStopped;
+	int32_t targetVertexId; /* if non-negative, stop as soon as this vertex is reached */
+	int32_t skipModulus; /* if non-zero, skip vertices (or edges to vertices) whose IDs are multiples of skipModulus */
+} SearchControlContext;
+static AlgoGraphSearchControl searchControl(SearchControlContext *context, int32_t vertexId)
+{
+	context->controlCount += 1;
+	if (vertexId == context->targetVertexId ||
+		(context->stopInterval > 0 && 0 == (context->controlCount % context->stopInterval)))
+	{
+		context->isStopped = 1;
+		return kAlgoGraphSearchStop;
+	}
+	if (context->skipModulus > 0 && 0 == (vertexId % context->skipModulus))
+		return kAlgoGraphSearchSkip;
+	return kAlgoGraphSearchContinue;
+}
+static void bfsRecordVisit(AlgoGraph graph, AlgoGraphBfsState bfsState, int32_t vertexId, void *userData)
+{
+	SearchControlContext *context = (SearchControlContext*)userData;
+	(void)graph;
+	(void)bfsState;
+	context->visitOrder[context->visitCount++] = vertexId;
+}
+static AlgoGraphSearchControl bfsControlVertex(AlgoGraph graph, AlgoGraphBfsState bfsState, int32_t vertexId, void *userData)
+{
+	(void)graph;
+	(void)bfsState;
+	return searchControl((SearchControlContext*)userData, vertexId);
+}
+static AlgoGraphSearchControl bfsControlEdge(AlgoGraph graph, AlgoGraphBfsState bfsState, int32_t v0, int32_t v1, void *userData)
+{
+	(void)graph;
+	(void)bfsState;
+	(void)v0;
+	return searchControl((SearchControlContext*)userData, v1);
+}
+static void dfsRecordVisit(AlgoGraph graph, AlgoGraphDfsState dfsState, int32_t vertexId, void *userData)
+{
+	SearchControlContext *context = (SearchControlContext*)userData;
+	(void)graph;
+	(void)dfsState;
+	context->visitOrder[context->visitCount++] = vertexId;
+}
+static AlgoGraphSearchControl dfsControlVertex(AlgoGraph graph, AlgoGraphDfsState dfsState, int32_t vertexId, void *userData)
+{
+	(void)graph;
+	(void)dfsState;
+	return searchControl((SearchControlContext*)userData, vertexId);
+}
+static AlgoGraphSearchControl dfsControlEdge(AlgoGraph graph, AlgoGraphDfsState dfsState, int32_t v0, int32_t v1, void *userData)
+{
+	(void)graph;
+	(void)dfsState;
+	(void)v0;
+	return searchControl((SearchControlContext*)userData, v1);
+}
+
+/* Checks that BFS/DFS searches stopped by control callbacks and resumed (over and over) produce exactly the same results as
+   uninterrupted searches, that skipped vertices and edges are never followed, and times point queries that stop early. */
+static void testSearchControl(AlgoGraphEdgeMode edgeMode, int32_t vertexCount, int32_t averageDegree, int32_t queryCount)
+{
+	const int32_t edgeCount = vertexCount*averageDegree;
+	size_t graphBufferSize = 0, bfsStateBufferSize = 0, dfsStateBufferSize = 0;
+	void *graphBuffer = NULL, *bfsBuffers[2] = {NULL, NULL}, *dfsBuffers[2] = {NULL, NULL};
+	AlgoGraph graph;
+	AlgoGraphBfsState bfsStates[2];
+	AlgoGraphDfsState dfsStates[2];
+	SearchControlContext contexts[2];
+	int32_t *visitOrders[2];
+	int32_t iVert, iState, iQuery;
+	const int32_t rootVertexId = rand() % vertexCount;
+	uint64_t startTicks, fullTicks = 0, earlyTicks = 0;
+	printf("Testing BFS/DFS control callbacks (%s, %d vertices, %d edges)\n",
+		(edgeMode == kAlgoGraphEdgeDirected) ? "directed" : "undirected", vertexCount, edgeCount);
+
+	ALGO_VALIDATE( algoGraphComputeBufferSize(&graphBufferSize, vertexCount, edgeCount, edgeMode) );
+	graphBuffer = malloc(graphBufferSize);
+	ALGO_VALIDATE( algoGraphCreate(&graph, vertexCount, edgeCount, edgeMode, graphBuffer, graphBufferSize) );
+	addRandomEdges(graph, vertexCount, averageDegree);
+	ALGO_VALIDATE( algoGraphBfsStateComputeBufferSize(&bfsStateBufferSize, graph) );
+	ALGO_VALIDATE( algoGraphDfsStateComputeBufferSize(&dfsStateBufferSize, graph) );
+	for(iState=0; iState<2; ++iState)
+	{
+		bfsBuffers[iState] = malloc(bfsStateBufferSize);
+		dfsBuffers[iState] = malloc(dfsStateBufferSize);
+		visitOrders[iState] = malloc(vertexCount*sizeof(int32_t));
+		ALGO_VALIDATE( algoGraphBfsStateCreate(bfsStates+iState, graph, bfsBuffers[iState], bfsStateBufferSize) );
+		ALGO_VALIDATE( algoGraphDfsStateCreate(dfsStates+iState, graph, dfsBuffers[iState], dfsStateBufferSize) );
+		memset(contexts+iState, 0, sizeof(SearchControlContext));
+		contexts[iState].visitOrder = visitOrders[iState];
+		contexts[iState].targetVertexId = -1;
+	}
+
+	/* State 0 runs uninterrupted; state 1 stops every few callbacks and is resumed until it completes. */
+	contexts[1].stopInterval = 7;
+	for(iState=0; iState<2; ++iState)
+	{
+		AlgoGraphBfsCallbacks bfsCallbacks = {bfsRecordVisit, contexts+iState, NULL, NULL, NULL, NULL,
+			bfsControlVertex, contexts+iState, bfsControlEdge, contexts+iState};
+		int32_t resumeCount = 0;
+		ALGO_VALIDATE( algoGraphBfs(graph, bfsStates[iState], rootVertexId, bfsCallbacks) );
+		for(; contexts[iState].isStopped; ++resumeCount)
+		{
+			contexts[iState].isStopped = 0;
+			ALGO_VALIDATE( algoGraphBfsResume(graph, bfsStates[iState], bfsCallbacks) );
+		}
+		ZOMBO_ASSERT((iState == 0) == (resumeCount == 0), "state %d: BFS was resumed %d times", iState, resumeCount);
+	}
+	ZOMBO_ASSERT(contexts[0].visitCount == contexts[1].visitCount, "resumed BFS visited %d vertices, expected %d", contexts[1].visitCount,
+		contexts[0].visitCount);
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		int32_t parent0 = -1, parent1 = -1;
+		ALGO_VALIDATE( algoGraphBfsStateGetVertexParent(bfsStates[0], iVert, &parent0) );
+		ALGO_VALIDATE( algoGraphBfsStateGetVertexParent(bfsStates[1], iVert, &parent1) );
+		ZOMBO_ASSERT(parent0 == parent1, "vertex %d: resumed BFS parent (%d) should be %d", iVert, parent1, parent0);
+		ZOMBO_ASSERT(iVert >= contexts[0].visitCount || visitOrders[0][iVert] == visitOrders[1][iVert], "BFS visit %d does not match", iVert);
+	}
+
+	for(iState=0; iState<2; ++iState)
+	{
+		AlgoGraphDfsCallbacks dfsCallbacks = {dfsRecordVisit, contexts+iState, NULL, NULL, NULL, NULL,
+			dfsControlVertex, contexts+iState, dfsControlEdge, contexts+iState};
+		contexts[iState].visitCount = 0;
+		ALGO_VALIDATE( algoGraphDfs(graph, dfsStates[iState], rootVertexId, dfsCallbacks) );
+		while(contexts[iState].isStopped)
+		{
+			contexts[iState].isStopped = 0;
+			ALGO_VALIDATE( algoGraphDfsResume(graph, dfsStates[iState], dfsCallbacks) );
+		}
+	}
+	ZOMBO_ASSERT(contexts[0].visitCount == contexts[1].visitCount, "resumed DFS visited %d vertices, expected %d", contexts[1].visitCount,
+		contexts[0].visitCount);
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		int32_t parent0 = -1, parent1 = -1, entry0 = 0, entry1 = 0, exit0 = 0, exit1 = 0;
+		ALGO_VALIDATE( algoGraphDfsStateGetVertexParent(dfsStates[0], iVert, &parent0) );
+		ALGO_VALIDATE( algoGraphDfsStateGetVertexParent(dfsStates[1], iVert, &parent1) );
+		ALGO_VALIDATE( algoGraphDfsStateGetVertexEntryTime(dfsStates[0], iVert, &entry0) );
+		ALGO_VALIDATE( algoGraphDfsStateGetVertexEntryTime(dfsStates[1], iVert, &entry1) );
+		ALGO_VALIDATE( algoGraphDfsStateGetVertexExitTime(dfsStates[0], iVert, &exit0) );
+		ALGO_VALIDATE( algoGraphDfsStateGetVertexExitTime(dfsStates[1], iVert, &exit1) );
+		ZOMBO_ASSERT(parent0 == parent1 && entry0 == entry1 && exit0 == exit1, "vertex %d: resumed DFS state does not match", iVert);
+	}
+
+	/* Skipping: no vertex may be discovered through a skipped vertex (state 0) or a skipped edge (state 1). */
+	for(iState=0; iState<2; ++iState)
+	{
+		AlgoGraphBfsCallbacks bfsCallbacks = {NULL, NULL, NULL, NULL, NULL, NULL,
+			(0 == iState) ? bfsControlVertex : NULL, contexts+iState, (1 == iState) ? bfsControlEdge : NULL, contexts+iState};
+		AlgoGraphDfsCallbacks dfsCallbacks = {NULL, NULL, NULL, NULL, NULL, NULL,
+			(0 == iState) ? dfsControlVertex : NULL, contexts+iState, (1 == iState) ? dfsControlEdge : NULL, contexts+iState};
+		contexts[iState].stopInterval = 0;
+		contexts[iState].skipModulus = 3;
+		ALGO_VALIDATE( algoGraphBfsStateReset(bfsStates[iState]) );
+		ALGO_VALIDATE( algoGraphDfsStateReset(dfsStates[iState]) );
+		ALGO_VALIDATE( algoGraphBfs(graph, bfsStates[iState], rootVertexId, bfsCallbacks) );
+		ALGO_VALIDATE( algoGraphDfs(graph, dfsStates[iState], rootVertexId, dfsCallbacks) );
+		for(iVert=0; iVert<vertexCount; ++iVert)
+		{
+			int32_t bfsParent = -1, dfsParent = -1;
+			ALGO_VALIDATE( algoGraphBfsStateGetVertexParent(bfsStates[iState], iVert, &bfsParent) );
+			ALGO_VALIDATE( algoGraphDfsStateGetVertexParent(dfsStates[iState], iVert, &dfsParent) );
+			const int32_t skipped = (0 == iState) ? bfsParent : iVert;
+			ZOMBO_ASSERT(bfsParent < 0 || 0 != (skipped % 3), "vertex %d: BFS parent %d was skipped", iVert, bfsParent);
+			ZOMBO_ASSERT(dfsParent < 0 || 0 != (((0 == iState) ? dfsParent : iVert) % 3), "vertex %d: DFS parent %d was skipped", iVert,
+				dfsParent);
+		}
+	}
+
+	/* Point queries: stop as soon as a random target is reached, and compare against searching the whole graph. */
+	for(iQuery=0; iQuery<queryCount; ++iQuery)
+	{
+		const int32_t queryRoot = rand() % vertexCount;
+		AlgoGraphBfsCallbacks fullCallbacks = {NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
+		AlgoGraphBfsCallbacks earlyCallbacks = {NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, bfsControlEdge, contexts+1};
+		int isDiscovered = 0;
+		int32_t target = rand() % vertexCount, depth0 = 0, depth1 = 0, v, parent = -1;
+		ALGO_VALIDATE( algoGraphBfsStateReset(bfsStates[0]) );
+		startTicks = zomboClockTicks();
+		ALGO_VALIDATE( algoGraphBfs(graph, bfsStates[0], queryRoot, fullCallbacks) );
+		fullTicks += zomboClockTicks() - startTicks;
+		ALGO_VALIDATE( algoGraphBfsStateIsVertexDiscovered(bfsStates[0], target, &isDiscovered) );
+		if (!isDiscovered || target == queryRoot)
+			continue;
+
+		contexts[1].skipModulus = 0;
+		contexts[1].targetVertexId = target;
+		contexts[1].isStopped = 0;
+		startTicks = zomboClockTicks();
+		ALGO_VALIDATE( algoGraphBfsStateReset(bfsStates[1]) );
+		ALGO_VALIDATE( algoGraphBfs(graph, bfsStates[1], queryRoot, earlyCallbacks) );
+		earlyTicks += zomboClockTicks() - startTicks;
+		ZOMBO_ASSERT(contexts[1].isStopped, "query %d: BFS did not stop at its target", iQuery);
+		for(v = target; v != queryRoot; v = parent, ++depth0)
+		{
+			ALGO_VALIDATE( algoGraphBfsStateGetVertexParent(bfsStates[0], v, &parent) );
+		}
+		for(v = target; v != queryRoot; v = parent, ++depth1)
+		{
+			ALGO_VALIDATE( algoGraphBfsStateGetVertexParent(bfsStates[1], v, &parent) );
+		}
+		ZOMBO_ASSERT(depth0 == depth1, "query %d: early BFS reached the target at depth %d, expected %d", iQuery, depth1, depth0);
+	}
+	printf("\tpoint queries: full BFS %8.3f ms/query, stopped at target %8.3f ms/query\n",
+		1000.0 * zomboTicksToSeconds(fullTicks) / queryCount, 1000.0 * zomboTicksToSeconds(earlyTicks) / queryCount);
+
+	for(iState=0; iState<2; ++iState)
+	{
+		free(bfsBuffers[iState]);
+		free(dfsBuffers[iState]);
+		free(visitOrders[iState]);
+	}
+	free(graphBuffer);
+}
+
+/* Everything a DFS reports through its non-control callbacks, in order: vertices as they are discovered (v) and processed
+   (-1-v), and a running hash of the reported edges. */
+typedef struct DfsTrace
+{
+	int32_t *events;
+	int32_t eventCount;
+	int32_t edgeCount;
+	uint32_t edgeHash;
+} DfsTrace;
+static void dfsTraceVertexEarly(AlgoGraph graph, AlgoGraphDfsState dfsState, int32_t vertexId, void *userData)
+{
+	DfsTrace *trace = (DfsTrace*)userData;
+	(void)graph;
+	(void)dfsState;
+	trace->events[trace->eventCount++] = vertexId;
+}
+static void dfsTraceEdge(AlgoGraph graph, AlgoGraphDfsState dfsState, int32_t v0, int32_t v1, void *userData)
+{
+	DfsTrace *trace = (DfsTrace*)userData;
+	(void)graph;
+	(void)dfsState;
+	trace->edgeCount += 1;
+	trace->edgeHash = (trace->edgeHash * 31u + (uint32_t)v0) * 31u + (uint32_t)v1;
+}
+static void dfsTraceVertexLate(AlgoGraph graph, AlgoGraphDfsState dfsState, int32_t vertexId, void *userData)
+{
+	DfsTrace *trace = (DfsTrace*)userData;
+	(void)graph;
+	(void)dfsState;
+	trace->events[trace->eventCount++] = -1-vertexId;
+}
+static void checkDfsTracesMatch(const DfsTrace *trace0, const DfsTrace *trace1, const char *testName)
+{
+	int32_t iEvent;
+	ZOMBO_ASSERT(trace0->eventCount == trace1->eventCount, "%s: lightweight DFS reported %d vertex events, expected %d", testName,
+		trace1->eventCount, trace0->eventCount);
+	ZOMBO_ASSERT(trace0->edgeCount == trace1->edgeCount && trace0->edgeHash == trace1->edgeHash,
+		"%s: lightweight DFS reported %d edges, expected %d (or they were reported in a different order)", testName,
+		trace1->edgeCount, trace0->edgeCount);
+	for(iEvent=0; iEvent<trace0->eventCount; ++iEvent)
+	{
+		ZOMBO_ASSERT(trace0->events[iEvent] == trace1->events[iEvent], "%s: vertex event %d is %d, expected %d", testName, iEvent,
+			trace1->events[iEvent], trace0->events[iEvent]);
+	}
+}
+
+/* Checks that searches with a lightweight DFS state (multiple roots, stopped/resumed and skipping control callbacks, reset,
+   and over a CSR snapshot) report exactly the same callbacks in the same order as a default state, then compares the
+   states' sizes and the time to search every vertex of the graph. */
+static void testDfsLightweight(AlgoGraphEdgeMode edgeMode, int32_t vertexCount, int32_t averageDegree, int32_t passCount)
+{
+	const int32_t edgeCount = vertexCount*averageDegree;
+	const int32_t rootCount = 3;
+	size_t graphBufferSize = 0, csrBufferSize = 0, dfsStateBufferSizes[2] = {0, 0};
+	void *graphBuffer = NULL, *csrBuffer = NULL, *dfsBuffers[2] = {NULL, NULL};
+	AlgoGraph graph;
+	AlgoGraphCsr csr;
+	AlgoGraphDfsState dfsStates[2];
+	DfsTrace traces[2];
+	SearchControlContext contexts[2];
+	int32_t *allVertexIds = malloc(vertexCount*sizeof(int32_t));
+	int32_t rootVertexIds[3];
+	int32_t iVert, iState, iPass;
+	uint64_t startTicks, searchTicks[2] = {0, 0};
+	printf("Testing lightweight DFS states (%s, %d vertices, %d edges)\n",
+		(edgeMode == kAlgoGraphEdgeDirected) ? "directed" : "undirected", vertexCount, edgeCount);
+
+	ALGO_VALIDATE( algoGraphComputeBufferSize(&graphBufferSize, vertexCount, edgeCount, edgeMode) );
+	graphBuffer = malloc(graphBufferSize);
+	ALGO_VALIDATE( algoGraphCreate(&graph, vertexCount, edgeCount, edgeMode, graphBuffer, graphBufferSize) );
+	addRandomEdges(graph, vertexCount, averageDegree);
+	ALGO_VALIDATE( algoGraphFreezeComputeBufferSize(&csrBufferSize, graph) );
+	csrBuffer = malloc(csrBufferSize);
+	ALGO_VALIDATE( algoGraphFreeze(graph, &csr, csrBuffer, csrBufferSize) );
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		allVertexIds[iVert] = iVert;
+	}
+	for(iVert=0; iVert<rootCount; ++iVert)
+	{
+		rootVertexIds[iVert] = rand() % vertexCount;
+	}
+
+	AlgoError err = algoGraphDfsStateComputeBufferSizeWithFlags(dfsStateBufferSizes, graph, 2);
+	ZOMBO_ASSERT(kAlgoErrorInvalidArgument == err, "unknown DFS state flags returned %d (expected %d)", err, kAlgoErrorInvalidArgument);
+	ALGO_VALIDATE( algoGraphDfsStateComputeBufferSizeWithFlags(dfsStateBufferSizes+0, graph, kAlgoGraphDfsStateDefault) );
+	ALGO_VALIDATE( algoGraphDfsStateComputeBufferSizeWithFlags(dfsStateBufferSizes+1, graph, kAlgoGraphDfsStateLightweight) );
+	for(iState=0; iState<2; ++iState)
+	{
+		dfsBuffers[iState] = malloc(dfsStateBufferSizes[iState]);
+		ALGO_VALIDATE( algoGraphDfsStateCreateWithFlags(dfsStates+iState, graph,
+			(0 == iState) ? kAlgoGraphDfsStateDefault : kAlgoGraphDfsStateLightweight, dfsBuffers[iState], dfsStateBufferSizes[iState]) );
+		traces[iState].events = malloc(2*vertexCount*sizeof(int32_t));
+		memset(contexts+iState, 0, sizeof(SearchControlContext));
+		contexts[iState].targetVertexId = -1;
+	}
+	ZOMBO_ASSERT(dfsStateBufferSizes[1] < dfsStateBufferSizes[0], "lightweight DFS state should be smaller");
+	{
+		int32_t parent = -1, entryTime = 0, exitTime = 0;
+		err = algoGraphDfsStateGetVertexParent(dfsStates[1], 0, &parent);
+		ZOMBO_ASSERT(kAlgoErrorOperationFailed == err, "a lightweight state's parent returned %d (expected %d)", err, kAlgoErrorOperationFailed);
+		err = algoGraphDfsStateGetVertexEntryTime(dfsStates[1], 0, &entryTime);
+		ZOMBO_ASSERT(kAlgoErrorOperationFailed == err, "a lightweight state's entry time returned %d (expected %d)", err, kAlgoErrorOperationFailed);
+		err = algoGraphDfsStateGetVertexExitTime(dfsStates[1], 0, &exitTime);
+		ZOMBO_ASSERT(kAlgoErrorOperationFailed == err, "a lightweight state's exit time returned %d (expected %d)", err, kAlgoErrorOperationFailed);
+	}
+
+	/* Pass 0: multiple roots. Pass 1: the default state runs uninterrupted, while the lightweight state stops every few
+	   callbacks and is resumed until it completes. Pass 2: both skip the same vertices and edges. Pass 3: CSR, from every
+	   vertex. */
+	for(iPass=0; iPass<4; ++iPass)
+	{
+		static const char *passNames[4] = {"multi-root", "stop", "skip", "CSR"};
+		for(iState=0; iState<2; ++iState)
+		{
+			AlgoGraphDfsCallbacks dfsCallbacks = {dfsTraceVertexEarly, traces+iState, dfsTraceEdge, traces+iState,
+				dfsTraceVertexLate, traces+iState, NULL, NULL, NULL, NULL};
+			traces[iState].eventCount = 0;
+			traces[iState].edgeCount = 0;
+			traces[iState].edgeHash = 0;
+			ALGO_VALIDATE( algoGraphDfsStateReset(dfsStates[iState]) );
+			if (0 == iPass)
+			{
+				ALGO_VALIDATE( algoGraphDfsMulti(graph, dfsStates[iState], rootCount, rootVertexIds, dfsCallbacks) );
+			}
+			else if (1 == iPass || 2 == iPass)
+			{
+				dfsCallbacks.vertexControlFunc = dfsControlVertex;
+				dfsCallbacks.vertexControlFuncUserData = contexts+iState;
+				dfsCallbacks.edgeControlFunc = dfsControlEdge;
+				dfsCallbacks.edgeControlFuncUserData = contexts+iState;
+				contexts[iState].stopInterval = (1 == iPass && 1 == iState) ? 5 : 0;
+				contexts[iState].skipModulus = (2 == iPass) ? 7 : 0;
+				ALGO_VALIDATE( algoGraphDfsMulti(graph, dfsStates[iState], rootCount, rootVertexIds, dfsCallbacks) );
+				while(contexts[iState].isStopped)
+				{
+					contexts[iState].isStopped = 0;
+					ALGO_VALIDATE( algoGraphDfsMulti(graph, dfsStates[iState], rootCount, rootVertexIds, dfsCallbacks) );
+				}
+			}
+			else
+			{
+				/* algoGraphCsrDfs() expects its root to be undiscovered, unless the state is lightweight. */
+				for(iVert=0; iVert<vertexCount; ++iVert)
+				{
+					int isDiscovered = 0;
+					ALGO_VALIDATE( algoGraphDfsStateIsVertexDiscovered(dfsStates[iState], iVert, &isDiscovered) );
+					if (!isDiscovered || 1 == iState)
+						ALGO_VALIDATE( algoGraphCsrDfs(csr, dfsStates[iState], iVert, dfsCallbacks) );
+				}
+			}
+		}
+		checkDfsTracesMatch(traces+0, traces+1, passNames[iPass]);
+		for(iVert=0; iVert<vertexCount; ++iVert)
+		{
+			int isDiscovered0 = 0, isDiscovered1 = 0, isProcessed0 = 0, isProcessed1 = 0;
+			ALGO_VALIDATE( algoGraphDfsStateIsVertexDiscovered(dfsStates[0], iVert, &isDiscovered0) );
+			ALGO_VALIDATE( algoGraphDfsStateIsVertexDiscovered(dfsStates[1], iVert, &isDiscovered1) );
+			ALGO_VALIDATE( algoGraphDfsStateIsVertexProcessed(dfsStates[0], iVert, &isProcessed0) );
+			ALGO_VALIDATE( algoGraphDfsStateIsVertexProcessed(dfsStates[1], iVert, &isProcessed1) );
+			ZOMBO_ASSERT(isDiscovered0 == isDiscovered1 && isProcessed0 == isProcessed1, "%s: vertex %d state does not match",
+				passNames[iPass], iVert);
+		}
+	}
+
+	for(iPass=0; iPass<passCount; ++iPass)
+	{
+		for(iState=0; iState<2; ++iState)
+		{
+			AlgoGraphDfsCallbacks dfsCallbacks = {NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
+			ALGO_VALIDATE( algoGraphDfsStateReset(dfsStates[iState]) );
+			startTicks = zomboClockTicks();
+			ALGO_VALIDATE( algoGraphDfsMulti(graph, dfsStates[iState], vertexCount, allVertexIds, dfsCallbacks) );
+			searchTicks[iState] += zomboClockTicks() - startTicks;
+		}
+	}
+	printf("\tdefault:     %9d bytes, %8.3f ms/search\n", (int32_t)dfsStateBufferSizes[0],
+		1000.0 * zomboTicksToSeconds(searchTicks[0]) / passCount);
+	printf("\tlightweight: %9d bytes, %8.3f ms/search\n", (int32_t)dfsStateBufferSizes[1],
+		1000.0 * zomboTicksToSeconds(searchTicks[1]) / passCount);
+
+	for(iState=0; iState<2; ++iState)
+	{
+		free(dfsBuffers[iState]);
+		free(traces[iState].events);
+	}
+	free(allVertexIds);
+	free(csrBuffer);
+	free(graphBuffer);
+}
+
+/* Checks that algoGraphAddEdges() builds the same graph as adding each edge individually (including duplicate and
+   pre-existing edges), then compares the construction and BFS times of both graphs. */
+static void testAddEdges(AlgoGraphEdgeMode edgeMode, AlgoGraphEdgeIndexMode indexMode, int32_t vertexCount, int32_t averageDegree)
+{
+	const int32_t batchEdgeCount = vertexCount*averageDegree;
+	size_t graphBufferSize = 0, addBufferSize = 0, bfsStateBufferSize = 0;
+	void *graphBuffers[2] = {NULL, NULL}, *addBuffer = NULL, *bfsStateBuffer = NULL;
+	AlgoGraph graphs[2];
+	AlgoGraphBfsState bfsState;
+	AlgoGraphBfsCallbacks bfsCallbacks = {NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
+	int32_t *srcIds = malloc(batchEdgeCount*sizeof(int32_t));
+	int32_t *destIds = malloc(batchEdgeCount*sizeof(int32_t));
+	int32_t *weights = malloc(batchEdgeCount*sizeof(int32_t));
+	int32_t *edgeIds = NULL;
+	int32_t iGraph, iVert, iEdge, maxDegree = 0, edgeCounts[2] = {0,0};
+	uint64_t startTicks, addTicks[2], bfsTicks[2];
+	AlgoError err;
+	printf("Testing algoGraphAddEdges (%s, %s, %d vertices, %d edges)\n",
+		(edgeMode == kAlgoGraphEdgeUndirected) ? "undirected" : "directed",
+		(indexMode == kAlgoGraphEdgeIndexNone) ? "no index" : "hash index", vertexCount, batchEdgeCount);
+
+	for(iEdge=0; iEdge<batchEdgeCount; ++iEdge)
+	{
+		srcIds[iEdge] = (int32_t)(((uint32_t)rand() * 32768u + (uint32_t)rand()) % (uint32_t)vertexCount);
+		do
+		{
+			destIds[iEdge] = (int32_t)(((uint32_t)rand() * 32768u + (uint32_t)rand()) % (uint32_t)vertexCount);
+		} while(destIds[iEdge] == srcIds[iEdge]);
+		weights[iEdge] = rand() % 100;
+		if (iEdge > 0 && 0 == rand() % 16) /* repeat an earlier edge, with a different weight */
+		{
+			const int32_t iRepeat = rand() % iEdge;
+			srcIds[iEdge] = (rand() % 2) ? srcIds[iRepeat] : destIds[iRepeat];
+			destIds[iEdge] = (srcIds[iEdge] == srcIds[iRepeat]) ? destIds[iRepeat] : srcIds[iRepeat];
+		}
+	}
+
+	ALGO_VALIDATE( algoGraphComputeBufferSizeWithFlags(&graphBufferSize, vertexCount, batchEdgeCount, edgeMode,
+		indexMode, kAlgoGraphEdgeWeights) );
+	for(iGraph=0; iGraph<2; ++iGraph)
+	{
+		graphBuffers[iGraph] = malloc(graphBufferSize);
+		ALGO_VALIDATE( algoGraphCreateWithFlags(graphs+iGraph, vertexCount, batchEdgeCount, edgeMode, indexMode,
+			kAlgoGraphEdgeWeights, graphBuffers[iGraph], graphBufferSize) );
+		for(iVert=0; iVert<vertexCount; ++iVert)
+		{
+			int32_t vertexId = -1;
+			ALGO_VALIDATE( algoGraphAddVertex(graphs[iGraph], algoDataFromInt(iVert), &vertexId) );
+		}
+	}
+	ALGO_VALIDATE( algoGraphAddEdgesComputeBufferSize(&addBufferSize, graphs[1], batchEdgeCount) );
+	addBuffer = malloc(addBufferSize);
+
+	/* graphs[0] adds one edge at a time. Existing edges keep their first weight, to match algoGraphAddEdges(). */
+	startTicks = zomboClockTicks();
+	for(iEdge=0; iEdge<batchEdgeCount; ++iEdge)
+	{
+		int32_t weight = -1;
+		if (kAlgoErrorNone != algoGraphGetEdgeWeight(graphs[0], srcIds[iEdge], destIds[iEdge], &weight))
+			ALGO_VALIDATE( algoGraphAddWeightedEdge(graphs[0], srcIds[iEdge], destIds[iEdge], weights[iEdge]) );
+	}
+	addTicks[0] = zomboClockTicks() - startTicks;
+	/* graphs[1] adds the first few edges individually, and then all of them in two batches that overlap those. */
+	for(iEdge=0; iEdge<batchEdgeCount/8; ++iEdge)
+	{
+		int32_t weight = -1;
+		if (kAlgoErrorNone != algoGraphGetEdgeWeight(graphs[1], srcIds[iEdge], destIds[iEdge], &weight))
+			ALGO_VALIDATE( algoGraphAddWeightedEdge(graphs[1], srcIds[iEdge], destIds[iEdge], weights[iEdge]) );
+	}
+	startTicks = zomboClockTicks();
+	ALGO_VALIDATE( algoGraphAddEdges(graphs[1], batchEdgeCount/2, srcIds, destIds, weights, addBuffer, addBufferSize) );
+	ALGO_VALIDATE( algoGraphAddEdges(graphs[1], batchEdgeCount - batchEdgeCount/2, srcIds + batchEdgeCount/2,
+		destIds + batchEdgeCount/2, weights + batchEdgeCount/2, addBuffer, addBufferSize) );
+	addTicks[1] = zomboClockTicks() - startTicks;
+	ALGO_VALIDATE( algoGraphValidate(graphs[1]) );
+
+	for(iGraph=0; iGraph<2; ++iGraph)
+	{
+		ALGO_VALIDATE( algoGraphGetCurrentEdgeCount(graphs[iGraph], edgeCounts+iGraph) );
+	}
+	ZOMBO_ASSERT(edgeCounts[0] == edgeCounts[1], "edge count (%d) should be %d", edgeCounts[1], edgeCounts[0]);
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		int32_t degrees[2] = {-1,-1};
+		ALGO_VALIDATE( algoGraphGetVertexDegree(graphs[0], iVert, degrees+0) );
+		ALGO_VALIDATE( algoGraphGetVertexDegree(graphs[1], iVert, degrees+1) );
+		ZOMBO_ASSERT(degrees[0] == degrees[1], "vertex %d degree (%d) should be %d", iVert, degrees[1], degrees[0]);
+		maxDegree = (degrees[0] > maxDegree) ? degrees[0] : maxDegree;
+	}
+	edgeIds = malloc((maxDegree+1)*sizeof(int32_t));
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		int32_t degree = -1;
+		ALGO_VALIDATE( algoGraphGetVertexDegree(graphs[0], iVert, &degree) );
+		ALGO_VALIDATE( algoGraphGetVertexEdges(graphs[0], iVert, degree, edgeIds) );
+		for(iEdge=0; iEdge<degree; ++iEdge)
+		{
+			int32_t weights2[2] = {-1,-1};
+			ALGO_VALIDATE( algoGraphGetEdgeWeight(graphs[0], iVert, edgeIds[iEdge], weights2+0) );
+			ALGO_VALIDATE( algoGraphGetEdgeWeight(graphs[1], iVert, edgeIds[iEdge], weights2+1) );
+			ZOMBO_ASSERT(weights2[0] == weights2[1], "edge %d->%d weight (%d) should be %d", iVert, edgeIds[iEdge],
+				weights2[1], weights2[0]);
+		}
+	}
+
+	/* Bad batches must leave the graph untouched. */
+	srcIds[batchEdgeCount-1] = destIds[batchEdgeCount-1];
+	err = algoGraphAddEdges(graphs[1], batchEdgeCount, srcIds, destIds, NULL, addBuffer, addBufferSize);
+	ZOMBO_ASSERT(err == kAlgoErrorInvalidArgument, "a batch with a self-connecting edge returned %d (expected %d)",
+		err, kAlgoErrorInvalidArgument);
+	err = algoGraphAddEdges(graphs[1], batchEdgeCount, srcIds, destIds, NULL, addBuffer, addBufferSize-1);
+	ZOMBO_ASSERT(err == kAlgoErrorInvalidArgument, "a buffer that is too small returned %d (expected %d)",
+		err, kAlgoErrorInvalidArgument);
+	for(iEdge=0; iEdge<batchEdgeCount; ++iEdge)
+	{
+		srcIds[iEdge] = iEdge % vertexCount;
+		destIds[iEdge] = (iEdge / vertexCount + 1 + srcIds[iEdge]) % vertexCount;
+	}
+	err = algoGraphAddEdges(graphs[1], batchEdgeCount, srcIds, destIds, NULL, addBuffer, addBufferSize);
+	ZOMBO_ASSERT(err == kAlgoErrorOperationFailed, "exceeding the edge capacity returned %d (expected %d)",
+		err, kAlgoErrorOperationFailed);
+	ALGO_VALIDATE( algoGraphGetCurrentEdgeCount(graphs[1], edgeCounts+1) );
+	ZOMBO_ASSERT(edgeCounts[0] == edgeCounts[1], "a failed batch changed the edge count");
+	ALGO_VALIDATE( algoGraphValidate(graphs[1]) );
+
+	ALGO_VALIDATE( algoGraphBfsStateComputeBufferSize(&bfsStateBufferSize, graphs[0]) );
+	bfsStateBuffer = malloc(bfsStateBufferSize);
+	for(iGraph=0; iGraph<2; ++iGraph)
+	{
+		ALGO_VALIDATE( algoGraphBfsStateCreate(&bfsState, graphs[iGraph], bfsStateBuffer, bfsStateBufferSize) );
+		startTicks = zomboClockTicks();
+		ALGO_VALIDATE( algoGraphBfs(graphs[iGraph], bfsState, 0, bfsCallbacks) );
+		bfsTicks[iGraph] = zomboClockTicks() - startTicks;
+	}
+	printf("\tone at a time: %8.3f ms to build, %8.3f ms to search\n", 1000.0 * zomboTicksToSeconds(addTicks[0]),
+		1000.0 * zomboTicksToSeconds(bfsTicks[0]));
+	printf("\tbatched:       %8.3f ms to build, %8.3f ms to search\n", 1000.0 * zomboTicksToSeconds(addTicks[1]),
+		1000.0 * zomboTicksToSeconds(bfsTicks[1]));
+
+	free(bfsStateBuffer);
+	free(addBuffer);
+	for(iGraph=0; iGraph<2; ++iGraph)
+	{
+		free(graphBuffers[iGraph]);
+	}
+	free(edgeIds);
+	free(weights);
+	free(destIds);
+	free(srcIds);
+}
+
+/* Applies the same random edits to graphs with every combination of edge index and in-edge lists, and checks that they
+   stay identical. Then compares the time needed to remove every edge of a high-degree hub vertex, and to remove vertices. */
+static void testEdgeIndex(AlgoGraphEdgeMode edgeMode, int32_t vertexCount, int32_t averageDegree, int32_t hubDegree)
+{
+	enum { kGraphCount = 4 };
+	const int32_t edgeCapacity = vertexCount*averageDegree;
+	const AlgoGraphEdgeIndexMode indexModes[kGraphCount] = {kAlgoGraphEdgeIndexNone, kAlgoGraphEdgeIndexEnabled,
+		kAlgoGraphEdgeIndexNone, kAlgoGraphEdgeIndexEnabled};
+	const uint32_t graphFlags[kGraphCount] = {kAlgoGraphEdgeWeights, kAlgoGraphEdgeWeights,
+		kAlgoGraphInEdges | kAlgoGraphEdgeWeights, kAlgoGraphInEdges | kAlgoGraphEdgeWeights};
+	const char *indexNames[kGraphCount] = {"no index", "hash index", "in-edge lists", "both"};
+	size_t graphBufferSizes[kGraphCount] = {0}, addBufferSize = 0, reorderBufferSize = 0;
+	void *graphBuffers[kGraphCount] = {NULL}, *addBuffer = NULL, *reorderBuffer = NULL;
+	AlgoGraph graphs[kGraphCount];
+	int32_t *srcIds = malloc(hubDegree*sizeof(int32_t));
+	int32_t *destIds = malloc(hubDegree*sizeof(int32_t));
+	int32_t *oldToNew = malloc(vertexCount*sizeof(int32_t));
+	int32_t *inDegrees = malloc(vertexCount*sizeof(int32_t));
+	int32_t *edgeIds = malloc(vertexCount*sizeof(int32_t));
+	int32_t iGraph, iVert, iOp, iEdge;
+	uint64_t startTicks, removeEdgeTicks[kGraphCount], removeVertexTicks[kGraphCount];
+	printf("Testing AlgoGraph edge indices (%s, %d vertices, %d edges)\n",
+		(edgeMode == kAlgoGraphEdgeUndirected) ? "undirected" : "directed", vertexCount, edgeCapacity);
+
+	for(iGraph=0; iGraph<kGraphCount; ++iGraph)
+	{
+		ALGO_VALIDATE( algoGraphComputeBufferSizeWithFlags(graphBufferSizes+iGraph, vertexCount, edgeCapacity, edgeMode,
+			indexModes[iGraph], graphFlags[iGraph]) );
+		graphBuffers[iGraph] = malloc(graphBufferSizes[iGraph]);
+		ALGO_VALIDATE( algoGraphCreateWithFlags(graphs+iGraph, vertexCount, edgeCapacity, edgeMode, indexModes[iGraph],
+			graphFlags[iGraph], graphBuffers[iGraph], graphBufferSizes[iGraph]) );
+		for(iVert=0; iVert<vertexCount; ++iVert)
+		{
+			int32_t vertexId = -1;
+			ALGO_VALIDATE( algoGraphAddVertex(graphs[iGraph], algoDataFromInt(iVert), &vertexId) );
+		}
+	}
+	size_t plainBufferSize = 0;
+	ALGO_VALIDATE( algoGraphComputeBufferSize(&plainBufferSize, vertexCount, edgeCapacity, edgeMode) );
+	ZOMBO_ASSERT(plainBufferSize < graphBufferSizes[0], "a graph without edge weights should need a smaller buffer");
+	ALGO_VALIDATE( algoGraphAddEdgesComputeBufferSize(&addBufferSize, graphs[0], hubDegree) );
+	addBuffer = malloc(addBufferSize);
+
+	for(iOp=0; iOp<2*edgeCapacity; ++iOp)
+	{
+		const int32_t v0 = rand() % vertexCount, v1 = rand() % vertexCount, op = rand() % 256;
+		int hasEdges[kGraphCount];
+		AlgoError results[kGraphCount];
+		for(iGraph=0; iGraph<kGraphCount; ++iGraph)
+		{
+			int32_t degree = -1;
+			hasEdges[iGraph] = -1;
+			if (kAlgoErrorNone != algoGraphGetVertexDegree(graphs[iGraph], v0, &degree))
+				results[iGraph] = algoGraphAddVertex(graphs[iGraph], algoDataFromInt(v0), NULL);
+			else if (op < 128)
+				results[iGraph] = algoGraphAddWeightedEdge(graphs[iGraph], v0, v1, iOp);
+			else if (op < 208)
+				results[iGraph] = algoGraphRemoveEdge(graphs[iGraph], v0, v1);
+			else if (op < 254)
+				results[iGraph] = algoGraphHasEdge(graphs[iGraph], v0, v1, hasEdges+iGraph);
+			else
+				results[iGraph] = algoGraphRemoveVertex(graphs[iGraph], v0);
+			ZOMBO_ASSERT(results[iGraph] == results[0] && hasEdges[iGraph] == hasEdges[0], "graphs diverged on operation %d", iOp);
+		}
+		if (0 == iOp % 4096)
+		{
+			for(iGraph=1; iGraph<kGraphCount; ++iGraph)
+			{
+				ALGO_VALIDATE( algoGraphValidate(graphs[iGraph]) );
+			}
+		}
+	}
+
+	/* Check in-degrees and in-edges against the outgoing edges of the unindexed graph. */
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		inDegrees[iVert] = 0;
+	}
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		int32_t degree = -1;
+		if (kAlgoErrorNone != algoGraphGetVertexDegree(graphs[0], iVert, &degree))
+			continue;
+		ALGO_VALIDATE( algoGraphGetVertexEdges(graphs[0], iVert, degree, edgeIds) );
+		for(iEdge=0; iEdge<degree; ++iEdge)
+		{
+			inDegrees[edgeIds[iEdge]] += 1;
+		}
+	}
+	for(iGraph=0; iGraph<kGraphCount; ++iGraph)
+	{
+		const int hasInEdges = (edgeMode == kAlgoGraphEdgeUndirected) || (graphFlags[iGraph] & kAlgoGraphInEdges);
+		for(iVert=0; iVert<vertexCount; ++iVert)
+		{
+			int32_t inDegree = -1;
+			AlgoError result = algoGraphGetVertexInDegree(graphs[iGraph], iVert, &inDegree);
+			if (kAlgoErrorInvalidArgument == result)
+				continue; /* invalid vertex */
+			if (!hasInEdges)
+			{
+				ZOMBO_ASSERT(kAlgoErrorOperationFailed == result, "in-degree should be unavailable without in-edge lists");
+				break;
+			}
+			ALGO_VALIDATE( result );
+			ZOMBO_ASSERT(inDegree == inDegrees[iVert], "vertex %d in-degree (%d) should be %d", iVert, inDegree, inDegrees[iVert]);
+			ALGO_VALIDATE( algoGraphGetVertexInEdges(graphs[iGraph], iVert, inDegree, edgeIds) );
+			for(iEdge=0; iEdge<inDegree; ++iEdge)
+			{
+				int hasEdge = 0;
+				ALGO_VALIDATE( algoGraphHasEdge(graphs[0], edgeIds[iEdge], iVert, &hasEdge) );
+				ZOMBO_ASSERT(hasEdge, "in-edge %d->%d does not exist", edgeIds[iEdge], iVert);
+			}
+		}
+	}
+
+	/* Reordering must rebuild the indices too. */
+	ALGO_VALIDATE( algoGraphReorderComputeBufferSize(&reorderBufferSize, graphs[kGraphCount-1]) );
+	reorderBuffer = malloc(reorderBufferSize);
+	ALGO_VALIDATE( algoGraphReorder(graphs[kGraphCount-1], kAlgoGraphReorderBfs, oldToNew, reorderBuffer, reorderBufferSize) );
+	ALGO_VALIDATE( algoGraphValidate(graphs[kGraphCount-1]) );
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		int32_t degree = -1, inDegree = -1;
+		if (kAlgoErrorNone != algoGraphGetVertexDegree(graphs[0], iVert, &degree))
+			continue;
+		ALGO_VALIDATE( algoGraphGetVertexInDegree(graphs[kGraphCount-1], oldToNew[iVert], &inDegree) );
+		ZOMBO_ASSERT(inDegree == inDegrees[iVert], "reordered in-degree (%d) should be %d", inDegree, inDegrees[iVert]);
+		ALGO_VALIDATE( algoGraphGetVertexEdges(graphs[0], iVert, degree, edgeIds) );
+		for(iEdge=0; iEdge<degree; ++iEdge)
+		{
+			int32_t weights[2] = {-1,-1};
+			ALGO_VALIDATE( algoGraphGetEdgeWeight(graphs[0], iVert, edgeIds[iEdge], weights+0) );
+			ALGO_VALIDATE( algoGraphGetEdgeWeight(graphs[kGraphCount-1], oldToNew[iVert], oldToNew[edgeIds[iEdge]], weights+1) );
+			ZOMBO_ASSERT(weights[0] == weights[1], "reordered edge weight (%d) should be %d", weights[1], weights[0]);
+		}
+	}
+
+	/* Duplicate rejection */
+	{
+		size_t rejectBufferSize = 0;
+		void *rejectBuffer = NULL;
+		AlgoGraph rejectGraph;
+		int hasEdge = 0;
+		AlgoError err;
+		ALGO_VALIDATE( algoGraphComputeBufferSizeWithEdgeIndex(&rejectBufferSize, 4, 4, edgeMode, kAlgoGraphEdgeIndexRejectDuplicates) );
+		rejectBuffer = malloc(rejectBufferSize);
+		ALGO_VALIDATE( algoGraphCreateWithEdgeIndex(&rejectGraph, 4, 4, edgeMode, kAlgoGraphEdgeIndexRejectDuplicates, rejectBuffer, rejectBufferSize) );
+		for(iVert=0; iVert<4; ++iVert)
+		{
+			ALGO_VALIDATE( algoGraphAddVertex(rejectGraph, algoDataFromInt(iVert), NULL) );
+		}
+		ALGO_VALIDATE( algoGraphAddEdge(rejectGraph, 0, 1) );
+		err = algoGraphAddEdge(rejectGraph, 0, 1);
+		ZOMBO_ASSERT(err == kAlgoErrorOperationFailed, "adding a duplicate edge returned %d (expected %d)", err, kAlgoErrorOperationFailed);
+		err = algoGraphAddEdge(rejectGraph, 1, 0);
+		ZOMBO_ASSERT((err == kAlgoErrorOperationFailed) == (edgeMode == kAlgoGraphEdgeUndirected),
+			"reverse edge should be rejected only in undirected graphs (returned %d)", err);
+		ALGO_VALIDATE( algoGraphHasEdge(rejectGraph, 1, 0, &hasEdge) );
+		ZOMBO_ASSERT(hasEdge, "edge 1->0 should exist");
+		ALGO_VALIDATE( algoGraphRemoveEdge(rejectGraph, 0, 1) );
+		ALGO_VALIDATE( algoGraphHasEdge(rejectGraph, 0, 1, &hasEdge) );
+		ZOMBO_ASSERT(!hasEdge, "edge 0->1 should have been removed");
+		ALGO_VALIDATE( algoGraphValidate(rejectGraph) );
+		/* Batches are rejected as a whole if any edge already exists, or appears twice in the batch. */
+		{
+			const int32_t batchSrcIds[3] = {2, 3, 0}, batchDestIds[3] = {3, 2, 2};
+			size_t rejectAddBufferSize = 0;
+			void *rejectAddBuffer = NULL;
+			int32_t edgeCountBefore = -1, edgeCountAfter = -1;
+			ALGO_VALIDATE( algoGraphAddEdge(rejectGraph, 0, 2) );
+			ALGO_VALIDATE( algoGraphAddEdgesComputeBufferSize(&rejectAddBufferSize, rejectGraph, 3) );
+			rejectAddBuffer = malloc(rejectAddBufferSize);
+			ALGO_VALIDATE( algoGraphGetCurrentEdgeCount(rejectGraph, &edgeCountBefore) );
+			err = algoGraphAddEdges(rejectGraph, 3, batchSrcIds, batchDestIds, NULL, rejectAddBuffer, rejectAddBufferSize);
+			ZOMBO_ASSERT(err == kAlgoErrorOperationFailed, "adding a batch with an existing edge returned %d (expected %d)",
+				err, kAlgoErrorOperationFailed);
+			ALGO_VALIDATE( algoGraphGetCurrentEdgeCount(rejectGraph, &edgeCountAfter) );
+			ZOMBO_ASSERT(edgeCountAfter == edgeCountBefore, "a rejected batch changed the edge count");
+			err = algoGraphAddEdges(rejectGraph, 2, batchSrcIds, batchDestIds, NULL, rejectAddBuffer, rejectAddBufferSize);
+			ZOMBO_ASSERT((err == kAlgoErrorOperationFailed) == (edgeMode == kAlgoGraphEdgeUndirected),
+				"a batch with 2->3 and 3->2 should be rejected only in undirected graphs (returned %d)", err);
+			if (edgeMode == kAlgoGraphEdgeUndirected)
+			{
+				ALGO_VALIDATE( algoGraphAddEdges(rejectGraph, 1, batchSrcIds, batchDestIds, NULL, rejectAddBuffer, rejectAddBufferSize) );
+			}
+			ALGO_VALIDATE( algoGraphHasEdge(rejectGraph, 2, 3, &hasEdge) );
+			ZOMBO_ASSERT(hasEdge, "edge 2->3 should exist");
+			ALGO_VALIDATE( algoGraphValidate(rejectGraph) );
+			free(rejectAddBuffer);
+		}
+		free(rejectBuffer);
+	}
+
+	/* Re-weighting an edge must update its incoming copy too. */
+	for(iGraph=0; iGraph<kGraphCount; ++iGraph)
+	{
+		int32_t inDegree = -1, inSrcIds[2] = {-1,-1}, inWeights[2] = {-1,-1};
+		AlgoError err;
+		ALGO_VALIDATE( algoGraphCreateWithFlags(graphs+iGraph, vertexCount, edgeCapacity, edgeMode, indexModes[iGraph],
+			graphFlags[iGraph], graphBuffers[iGraph], graphBufferSizes[iGraph]) );
+		for(iVert=0; iVert<3; ++iVert)
+		{
+			ALGO_VALIDATE( algoGraphAddVertex(graphs[iGraph], algoDataFromInt(iVert), NULL) );
+		}
+		ALGO_VALIDATE( algoGraphAddWeightedEdge(graphs[iGraph], 0, 2, 5) );
+		ALGO_VALIDATE( algoGraphAddWeightedEdge(graphs[iGraph], 1, 2, 6) );
+		ALGO_VALIDATE( algoGraphAddWeightedEdge(graphs[iGraph], 0, 2, 9) );
+		ALGO_VALIDATE( algoGraphValidate(graphs[iGraph]) );
+		if (edgeMode == kAlgoGraphEdgeDirected && !(graphFlags[iGraph] & kAlgoGraphInEdges))
+		{
+			err = algoGraphGetVertexInEdgeWeights(graphs[iGraph], 2, 2, inWeights);
+			ZOMBO_ASSERT(err == kAlgoErrorOperationFailed, "in-edge weights without in-edge lists returned %d (expected %d)",
+				err, kAlgoErrorOperationFailed);
+			continue;
+		}
+		ALGO_VALIDATE( algoGraphGetVertexInDegree(graphs[iGraph], 2, &inDegree) );
+		ZOMBO_ASSERT(inDegree == 2, "vertex 2 in-degree (%d) should be 2", inDegree);
+		ALGO_VALIDATE( algoGraphGetVertexInEdges(graphs[iGraph], 2, inDegree, inSrcIds) );
+		ALGO_VALIDATE( algoGraphGetVertexInEdgeWeights(graphs[iGraph], 2, inDegree, inWeights) );
+		for(iEdge=0; iEdge<inDegree; ++iEdge)
+		{
+			const int32_t expectedWeight = (0 == inSrcIds[iEdge]) ? 9 : 6;
+			ZOMBO_ASSERT(inWeights[iEdge] == expectedWeight, "in-edge %d->2 has weight %d (expected %d)", inSrcIds[iEdge],
+				inWeights[iEdge], expectedWeight);
+		}
+	}
+
+	for(iGraph=0; iGraph<kGraphCount; ++iGraph)
+	{
+		/* Remove every edge of a hub vertex, in random order. */
+		ALGO_VALIDATE( algoGraphCreateWithFlags(graphs+iGraph, vertexCount, edgeCapacity, edgeMode, indexModes[iGraph],
+			graphFlags[iGraph], graphBuffers[iGraph], graphBufferSizes[iGraph]) );
+		for(iVert=0; iVert<vertexCount; ++iVert)
+		{
+			ALGO_VALIDATE( algoGraphAddVertex(graphs[iGraph], algoDataFromInt(iVert), NULL) );
+		}
+		for(iEdge=0; iEdge<hubDegree; ++iEdge)
+		{
+			srcIds[iEdge] = 0;
+			destIds[iEdge] = 1 + iEdge;
+		}
+		ALGO_VALIDATE( algoGraphAddEdges(graphs[iGraph], hubDegree, srcIds, destIds, NULL, addBuffer, addBufferSize) );
+		ALGO_VALIDATE( algoGraphValidate(graphs[iGraph]) );
+		for(iEdge=hubDegree-1; iEdge>0; --iEdge)
+		{
+			const int32_t iSwap = rand() % (iEdge+1), swap = destIds[iEdge];
+			destIds[iEdge] = destIds[iSwap];
+			destIds[iSwap] = swap;
+		}
+		startTicks = zomboClockTicks();
+		for(iEdge=0; iEdge<hubDegree; ++iEdge)
+		{
+			ALGO_VALIDATE( algoGraphRemoveEdge(graphs[iGraph], 0, destIds[iEdge]) );
+		}
+		removeEdgeTicks[iGraph] = zomboClockTicks() - startTicks;
+		ALGO_VALIDATE( algoGraphValidate(graphs[iGraph]) );
+
+		/* Fill the graph with random edges, then remove some of its vertices. */
+		for(iEdge=0; iEdge<edgeCapacity/2; ++iEdge)
+		{
+			const int32_t v0 = rand() % vertexCount, v1 = rand() % vertexCount;
+			if (v0 != v1)
+				ALGO_VALIDATE( algoGraphAddEdge(graphs[iGraph], v0, v1) );
+		}
+		startTicks = zomboClockTicks();
+		for(iVert=0; iVert<vertexCount; iVert += 64)
+		{
+			ALGO_VALIDATE( algoGraphRemoveVertex(graphs[iGraph], iVert) );
+		}
+		removeVertexTicks[iGraph] = zomboClockTicks() - startTicks;
+		ALGO_VALIDATE( algoGraphValidate(graphs[iGraph]) );
+	}
+	for(iGraph=0; iGraph<kGraphCount; ++iGraph)
+	{
+		printf("\t%-14s removing %d hub edges: %9.3f ms, removing %d vertices: %9.3f ms\n", indexNames[iGraph], hubDegree,
+			1000.0 * zomboTicksToSeconds(removeEdgeTicks[iGraph]), vertexCount/64, 1000.0 * zomboTicksToSeconds(removeVertexTicks[iGraph]));
+	}
+
+	free(reorderBuffer);
+	free(addBuffer);
+	for(iGraph=0; iGraph<kGraphCount; ++iGraph)
+	{
+		free(graphBuffers[iGraph]);
+	}
+	free(edgeIds);
+	free(inDegrees);
+	free(oldToNew);
+	free(destIds);
+	free(srcIds);
+}
+
+/* Builds a square grid graph whose vertex IDs are shuffled (so neighbors are scattered in memory), reorders it, and checks
+   that the reordered graph has the same structure, then compares BFS times before and after. */
+static void testReorder(AlgoGraphReorderStrategy strategy, const char *strategyName, int32_t gridSize)
+{
+	const int32_t vertexCount = gridSize*gridSize;
+	const int32_t edgeCount = 2*vertexCount;
+	size_t graphBufferSize = 0, reorderBufferSize = 0, bfsStateBufferSize = 0;
+	void *graphBuffer = NULL, *reorderBuffer = NULL, *bfsStateBuffer = NULL;
+	AlgoGraph graph;
+	AlgoGraphBfsState bfsState;
+	AlgoGraphBfsCallbacks bfsCallbacks = {NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
+	int32_t *cellVertexIds = malloc(vertexCount*sizeof(int32_t));
+	int32_t *oldToNew = malloc(vertexCount*sizeof(int32_t));
+	int32_t *edgeIds = malloc(vertexCount*sizeof(int32_t));
+	int32_t iCell, iVert, iPass, newVertexCount = 0;
+	int64_t oldSpan = 0, newSpan = 0;
+	uint64_t startTicks, oldTicks = 0, newTicks = 0;
+	printf("Testing algoGraphReorder (%s, %dx%d grid)\n", strategyName, gridSize, gridSize);
+
+	ALGO_VALIDATE( algoGraphComputeBufferSizeWithFlags(&graphBufferSize, vertexCount, edgeCount, kAlgoGraphEdgeUndirected,
+		kAlgoGraphEdgeIndexNone, kAlgoGraphEdgeWeights) );
+	graphBuffer = malloc(graphBufferSize);
+	ALGO_VALIDATE( algoGraphCreateWithFlags(&graph, vertexCount, edgeCount, kAlgoGraphEdgeUndirected, kAlgoGraphEdgeIndexNone,
+		kAlgoGraphEdgeWeights, graphBuffer, graphBufferSize) );
+	for(iCell=0; iCell<vertexCount; ++iCell)
+	{
+		ALGO_VALIDATE( algoGraphAddVertex(graph, algoDataFromInt(iCell), cellVertexIds+iCell) );
+	}
+	for(iCell=vertexCount-1; iCell>0; --iCell) /* shuffle vertex IDs; each vertex's data still names its cell */
+	{
+		int32_t iSwap = (int32_t)(((uint32_t)rand() * 32768u + (uint32_t)rand()) % (uint32_t)(iCell+1));
+		int32_t swap = cellVertexIds[iCell];
+		cellVertexIds[iCell] = cellVertexIds[iSwap];
+		cellVertexIds[iSwap] = swap;
+		ALGO_VALIDATE( algoGraphSetVertexData(graph, cellVertexIds[iCell], algoDataFromInt(iCell)) );
+		ALGO_VALIDATE( algoGraphSetVertexData(graph, cellVertexIds[iSwap], algoDataFromInt(iSwap)) );
+	}
+	for(iCell=0; iCell<vertexCount; ++iCell)
+	{
+		const int32_t x = iCell % gridSize, y = iCell / gridSize;
+		if (x+1 < gridSize)
+			ALGO_VALIDATE( algoGraphAddWeightedEdge(graph, cellVertexIds[iCell], cellVertexIds[iCell+1], x) );
+		if (y+1 < gridSize)
+			ALGO_VALIDATE( algoGraphAddWeightedEdge(graph, cellVertexIds[iCell], cellVertexIds[iCell+gridSize], y) );
+	}
+	/* Punch a few holes in the grid, so there are invalid vertex IDs to skip. */
+	for(iCell=gridSize+1; iCell<vertexCount; iCell += 97)
+	{
+		ALGO_VALIDATE( algoGraphRemoveVertex(graph, cellVertexIds[iCell]) );
+		cellVertexIds[iCell] = -1;
+	}
+	ALGO_VALIDATE( algoGraphBfsStateComputeBufferSize(&bfsStateBufferSize, graph) );
+	bfsStateBuffer = malloc(bfsStateBufferSize);
+	for(iPass=0; iPass<4; ++iPass)
+	{
+		ALGO_VALIDATE( algoGraphBfsStateCreate(&bfsState, graph, bfsStateBuffer, bfsStateBufferSize) );
+		startTicks = zomboClockTicks();
+		ALGO_VALIDATE( algoGraphBfs(graph, bfsState, cellVertexIds[0], bfsCallbacks) );
+		oldTicks += zomboClockTicks() - startTicks;
+	}
+
+	ALGO_VALIDATE( algoGraphReorderComputeBufferSize(&reorderBufferSize, graph) );
+	reorderBuffer = malloc(reorderBufferSize);
+	ALGO_VALIDATE( algoGraphReorder(graph, strategy, oldToNew, reorderBuffer, reorderBufferSize) );
+	ALGO_VALIDATE( algoGraphValidate(graph) );
+
+	/* Every surviving cell must keep its data and its weighted edges to the surviving neighboring cells. */
+	for(iCell=0; iCell<vertexCount; ++iCell)
+	{
+		const int32_t x = iCell % gridSize, y = iCell / gridSize;
+		int32_t newVertexId, degree = -1, expectedDegree = 0, weight = -1;
+		AlgoData vertexData;
+		if (cellVertexIds[iCell] < 0)
+			continue;
+		newVertexId = oldToNew[cellVertexIds[iCell]];
+		ZOMBO_ASSERT(newVertexId >= 0, "valid vertex %d was not renumbered", cellVertexIds[iCell]);
+		newVertexCount += 1;
+		ALGO_VALIDATE( algoGraphGetVertexData(graph, newVertexId, &vertexData) );
+		ZOMBO_ASSERT(vertexData.asInt == iCell, "vertex data was not moved with the vertex");
+		if (x+1 < gridSize && cellVertexIds[iCell+1] >= 0)
+		{
+			ALGO_VALIDATE( algoGraphGetEdgeWeight(graph, newVertexId, oldToNew[cellVertexIds[iCell+1]], &weight) );
+			ZOMBO_ASSERT(weight == x, "edge weight was not moved with the edge");
+			oldSpan += abs(cellVertexIds[iCell] - cellVertexIds[iCell+1]);
+			newSpan += abs(newVertexId - oldToNew[cellVertexIds[iCell+1]]);
+		}
+		if (y+1 < gridSize && cellVertexIds[iCell+gridSize] >= 0)
+		{
+			ALGO_VALIDATE( algoGraphGetEdgeWeight(graph, newVertexId, oldToNew[cellVertexIds[iCell+gridSize]], &weight) );
+			ZOMBO_ASSERT(weight == y, "edge weight was not moved with the edge");
+			oldSpan += abs(cellVertexIds[iCell] - cellVertexIds[iCell+gridSize]);
+			newSpan += abs(newVertexId - oldToNew[cellVertexIds[iCell+gridSize]]);
+		}
+		expectedDegree += (x > 0          && cellVertexIds[iCell-1] >= 0)        ? 1 : 0;
+		expectedDegree += (x+1 < gridSize && cellVertexIds[iCell+1] >= 0)        ? 1 : 0;
+		expectedDegree += (y > 0          && cellVertexIds[iCell-gridSize] >= 0) ? 1 : 0;
+		expectedDegree += (y+1 < gridSize && cellVertexIds[iCell+gridSize] >= 0) ? 1 : 0;
+		ALGO_VALIDATE( algoGraphGetVertexDegree(graph, newVertexId, &degree) );
+		ZOMBO_ASSERT(degree == expectedDegree, "vertex degree (%d) should be %d", degree, expectedDegree);
+		ALGO_VALIDATE( algoGraphGetVertexEdges(graph, newVertexId, degree, edgeIds) );
+	}
+	int32_t currentVertexCount = -1;
+	ALGO_VALIDATE( algoGraphGetCurrentVertexCount(graph, &currentVertexCount) );
+	ZOMBO_ASSERT(currentVertexCount == newVertexCount, "vertex count changed");
+	for(iVert=0; iVert<newVertexCount; ++iVert)
+	{
+		int32_t degree = -1;
+		ALGO_VALIDATE( algoGraphGetVertexDegree(graph, iVert, &degree) ); /* new IDs must be [0..vertexCount) */
+	}
+	int32_t newVertexId = -1;
+	ALGO_VALIDATE( algoGraphAddVertex(graph, algoDataFromInt(-1), &newVertexId) );
+	ZOMBO_ASSERT(newVertexId == newVertexCount, "new vertices should be allocated after the reordered ones");
+
+	for(iPass=0; iPass<4; ++iPass)
+	{
+		ALGO_VALIDATE( algoGraphBfsStateCreate(&bfsState, graph, bfsStateBuffer, bfsStateBufferSize) );
+		startTicks = zomboClockTicks();
+		ALGO_VALIDATE( algoGraphBfs(graph, bfsState, oldToNew[cellVertexIds[0]], bfsCallbacks) );
+		newTicks += zomboClockTicks() - startTicks;
+	}
+	printf("\taverage edge span: %lld -> %lld; BFS: %.3f ms -> %.3f ms\n", (long long)(oldSpan / edgeCount),
+		(long long)(newSpan / edgeCount), 1000.0 * zomboTicksToSeconds(oldTicks) / 4, 1000.0 * zomboTicksToSeconds(newTicks) / 4);
+
+	free(bfsStateBuffer);
+	free(reorderBuffer);
+	free(graphBuffer);
+	free(edgeIds);
+	free(oldToNew);
+	free(cellVertexIds);
+}
+
+/* Checks that every vertex's BFS and DFS state in a and b matches. */
+static void checkSearchStatesMatch(AlgoGraphBfsState bfsA, AlgoGraphBfsState bfsB, AlgoGraphDfsState dfsA, AlgoGraphDfsState dfsB,
+	int32_t vertexCount)
+{
+	int32_t iVert;
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		int discoveredA = 0, discoveredB = 0, processedA = 0, processedB = 0;
+		int32_t parentA = -1, parentB = -1, entryA = -1, entryB = -1, exitA = -1, exitB = -1;
+		ALGO_VALIDATE( algoGraphBfsStateIsVertexDiscovered(bfsA, iVert, &discoveredA) );
+		ALGO_VALIDATE( algoGraphBfsStateIsVertexDiscovered(bfsB, iVert, &discoveredB) );
+		ALGO_VALIDATE( algoGraphBfsStateIsVertexProcessed(bfsA, iVert, &processedA) );
+		ALGO_VALIDATE( algoGraphBfsStateIsVertexProcessed(bfsB, iVert, &processedB) );
+		ALGO_VALIDATE( algoGraphBfsStateGetVertexParent(bfsA, iVert, &parentA) );
+		ALGO_VALIDATE( algoGraphBfsStateGetVertexParent(bfsB, iVert, &parentB) );
+		ZOMBO_ASSERT(discoveredA == discoveredB && processedA == processedB && parentA == parentB,
+			"vertex %d: BFS states do not match", iVert);
+		ALGO_VALIDATE( algoGraphDfsStateIsVertexDiscovered(dfsA, iVert, &discoveredA) );
+		ALGO_VALIDATE( algoGraphDfsStateIsVertexDiscovered(dfsB, iVert, &discoveredB) );
+		ALGO_VALIDATE( algoGraphDfsStateIsVertexProcessed(dfsA, iVert, &processedA) );
+		ALGO_VALIDATE( algoGraphDfsStateIsVertexProcessed(dfsB, iVert, &processedB) );
+		ALGO_VALIDATE( algoGraphDfsStateGetVertexParent(dfsA, iVert, &parentA) );
+		ALGO_VALIDATE( algoGraphDfsStateGetVertexParent(dfsB, iVert, &parentB) );
+		ALGO_VALIDATE( algoGraphDfsStateGetVertexEntryTime(dfsA, iVert, &entryA) );
+		ALGO_VALIDATE( algoGraphDfsStateGetVertexEntryTime(dfsB, iVert, &entryB) );
+		ALGO_VALIDATE( algoGraphDfsStateGetVertexExitTime(dfsA, iVert, &exitA) );
+		ALGO_VALIDATE( algoGraphDfsStateGetVertexExitTime(dfsB, iVert, &exitB) );
+		ZOMBO_ASSERT(discoveredA == discoveredB && processedA == processedB && parentA == parentB && entryA == entryB && exitA == exitB,
+			"vertex %d: DFS states do not match", iVert);
+	}
+}
+
+/* Runs many short searches on a large graph made of small clusters, reusing one set of search states with
+   algoGraphBfsStateReset()/algoGraphDfsStateReset(), and checks the results against freshly created states.
+   Reset states are shared between every BFS variant, which must all record the vertices they touch. */
+static void testSearchStateReset(AlgoGraphEdgeMode edgeMode, int32_t vertexCount, int32_t clusterSize, int32_t queryCount)
+{
+	const int32_t edgeCount = vertexCount*2;
+	size_t graphBufferSize = 0, bfsStateBufferSize = 0, dfsStateBufferSize = 0, searchBufferSize = 0;
+	void *graphBuffer = NULL, *bfsBuffers[2] = {NULL, NULL}, *dfsBuffers[2] = {NULL, NULL}, *searchBuffer = NULL;
+	AlgoGraph graph;
+	AlgoGraphBfsState bfsStates[2];
+	AlgoGraphDfsState dfsStates[2];
+	AlgoGraphBfsParallel search;
+	AlgoGraphBfsCallbacks bfsCallbacks = {NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
+	AlgoGraphDfsCallbacks dfsCallbacks = {NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
+	int32_t iVert, iEdge, iQuery, iState;
+	uint64_t startTicks, createTicks = 0, resetTicks = 0;
+	printf("Testing algoGraphBfsStateReset/algoGraphDfsStateReset (%s, %d vertices, clusters of %d)\n",
+		(edgeMode == kAlgoGraphEdgeDirected) ? "directed" : "undirected", vertexCount, clusterSize);
+
+	ALGO_VALIDATE( algoGraphComputeBufferSize(&graphBufferSize, vertexCount, edgeCount, edgeMode) );
+	graphBuffer = malloc(graphBufferSize);
+	ALGO_VALIDATE( algoGraphCreate(&graph, vertexCount, edgeCount, edgeMode, graphBuffer, graphBufferSize) );
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		int32_t vertexId = -1;
+		ALGO_VALIDATE( algoGraphAddVertex(graph, algoDataFromInt(iVert), &vertexId) );
+	}
+	for(iEdge=0; iEdge<edgeCount; ++iEdge)
+	{
+		int32_t v0 = (int32_t)(((uint32_t)rand() * 32768u + (uint32_t)rand()) % (uint32_t)vertexCount);
+		int32_t v1 = v0 - (v0 % clusterSize) + (rand() % clusterSize);
+		if (v0 != v1 && v1 < vertexCount)
+			ALGO_VALIDATE( algoGraphAddEdge(graph, v0, v1) );
+	}
+	ALGO_VALIDATE( algoGraphBfsStateComputeBufferSize(&bfsStateBufferSize, graph) );
+	ALGO_VALIDATE( algoGraphDfsStateComputeBufferSize(&dfsStateBufferSize, graph) );
+	ALGO_VALIDATE( algoGraphBfsParallelComputeBufferSize(&searchBufferSize, graph, 1) );
+	searchBuffer = malloc(searchBufferSize);
+	for(iState=0; iState<2; ++iState)
+	{
+		bfsBuffers[iState] = malloc(bfsStateBufferSize);
+		dfsBuffers[iState] = malloc(dfsStateBufferSize);
+	}
+	ALGO_VALIDATE( algoGraphBfsStateCreate(bfsStates+1, graph, bfsBuffers[1], bfsStateBufferSize) );
+	ALGO_VALIDATE( algoGraphDfsStateCreate(dfsStates+1, graph, dfsBuffers[1], dfsStateBufferSize) );
+	AlgoError err = algoGraphBfsStateReset(NULL);
+	ZOMBO_ASSERT(kAlgoErrorInvalidArgument == err, "resetting a NULL BFS state returned %d (expected %d)", err, kAlgoErrorInvalidArgument);
+	err = algoGraphDfsStateReset(NULL);
+	ZOMBO_ASSERT(kAlgoErrorInvalidArgument == err, "resetting a NULL DFS state returned %d (expected %d)", err, kAlgoErrorInvalidArgument);
+
+	for(iQuery=0; iQuery<queryCount; ++iQuery)
+	{
+		/* Some queries search a second root without resetting in between, as when labeling components. */
+		const int32_t roots[2] = { rand() % vertexCount, rand() % vertexCount };
+		const int32_t rootCount = 1 + (rand() % 2);
+		const int32_t variant = iQuery % 3;
+		int32_t iRoot;
+
+		startTicks = zomboClockTicks();
+		ALGO_VALIDATE( algoGraphBfsStateCreate(bfsStates+0, graph, bfsBuffers[0], bfsStateBufferSize) );
+		ALGO_VALIDATE( algoGraphDfsStateCreate(dfsStates+0, graph, dfsBuffers[0], dfsStateBufferSize) );
+		createTicks += zomboClockTicks() - startTicks;
+		startTicks = zomboClockTicks();
+		ALGO_VALIDATE( algoGraphBfsStateReset(bfsStates[1]) );
+		ALGO_VALIDATE( algoGraphDfsStateReset(dfsStates[1]) );
+		resetTicks += zomboClockTicks() - startTicks;
+
+		for(iState=0; iState<2; ++iState)
+		{
+			for(iRoot=0; iRoot<rootCount; ++iRoot)
+			{
+				int isDiscovered = 0;
+				ALGO_VALIDATE( algoGraphBfsStateIsVertexDiscovered(bfsStates[iState], roots[iRoot], &isDiscovered) );
+				if (isDiscovered)
+					continue;
+				if (0 == variant)
+				{
+					ALGO_VALIDATE( algoGraphBfs(graph, bfsStates[iState], roots[iRoot], bfsCallbacks) );
+				}
+				else if (1 == variant)
+				{
+					ALGO_VALIDATE( algoGraphBfsDirectionOptimizing(graph, bfsStates[iState], roots[iRoot], 0, 0) );
+				}
+				else
+				{
+					ALGO_VALIDATE( algoGraphBfsParallelCreate(&search, graph, bfsStates[iState], roots[iRoot], 1, searchBuffer, searchBufferSize) );
+					ALGO_VALIDATE( algoGraphBfsParallel(search, 0) );
+				}
+				ALGO_VALIDATE( algoGraphDfsStateIsVertexDiscovered(dfsStates[iState], roots[iRoot], &isDiscovered) );
+				if (!isDiscovered)
+					ALGO_VALIDATE( algoGraphDfs(graph, dfsStates[iState], roots[iRoot], dfsCallbacks) );
+			}
+		}
+		/* Checking every vertex costs as much as a full create, so only check a few of the queries. */
+		if (0 == (iQuery % 64) || iQuery >= queryCount-3)
+			checkSearchStatesMatch(bfsStates[0], bfsStates[1], dfsStates[0], dfsStates[1], vertexCount);
+	}
+	printf("\tcreate: %8.3f us/query, reset: %8.3f us/query\n", 1e6 * zomboTicksToSeconds(createTicks) / queryCount,
+		1e6 * zomboTicksToSeconds(resetTicks) / queryCount);
+
+	for(iState=0; iState<2; ++iState)
+	{
+		free(bfsBuffers[iState]);
+		free(dfsBuffers[iState]);
+	}
+	free(searchBuffer);
+	free(graphBuffer);
+}
+
+/* Checks that algoGraphCsrBfsSimd() finds the same parents, levels and discovered/processed vertices as algoGraphBfs(),
+   with every instruction set the CPU supports. A few hub vertices have enough edges to span several filter batches. */
+static void testCsrBfsSimd(AlgoGraphEdgeMode edgeMode, int32_t vertexCount, int32_t averageDegree, int32_t hubDegree)
+{
+	const int32_t hubCount = 4;
+	const int32_t edgeCount = vertexCount*averageDegree + hubCount*hubDegree;
+	size_t graphBufferSize = 0, csrBufferSize = 0, bfsStateBufferSize = 0;
+	void *graphBuffer = NULL, *csrBuffer = NULL, *bfsBuffers[2] = {NULL, NULL};
+	AlgoGraph graph;
+	AlgoGraphCsr csr;
+	AlgoGraphBfsState bfsStates[2];
+	AlgoGraphBfsCallbacks bfsCallbacks = {NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
+	AlgoSimdLevel supportedLevel = kAlgoSimdScalar;
+	int32_t iVert, iEdge, iHub, level;
+	const int32_t rootVertexId = rand() % vertexCount;
+	ALGO_VALIDATE( algoGetSupportedSimdLevel(&supportedLevel) );
+	printf("Testing algoGraphCsrBfsSimd (%s, %d vertices, %d edges, supported SIMD level: %d)\n",
+		(edgeMode == kAlgoGraphEdgeDirected) ? "directed" : "undirected", vertexCount, edgeCount, supportedLevel);
+
+	ALGO_VALIDATE( algoGraphComputeBufferSize(&graphBufferSize, vertexCount, edgeCount, edgeMode) );
+	graphBuffer = malloc(graphBufferSize);
+	ALGO_VALIDATE( algoGraphCreate(&graph, vertexCount, edgeCount, edgeMode, graphBuffer, graphBufferSize) );
+	addRandomEdges(graph, vertexCount, averageDegree);
+	for(iHub=0; iHub<hubCount; ++iHub)
+	{
+		const int32_t hubVertexId = rand() % vertexCount;
+		for(iEdge=0; iEdge<hubDegree; ++iEdge)
+		{
+			int32_t v1 = (int32_t)(((uint32_t)rand() * 32768u + (uint32_t)rand()) % (uint32_t)vertexCount);
+			if (v1 != hubVertexId)
+				ALGO_VALIDATE( algoGraphAddEdge(graph, hubVertexId, v1) );
+		}
+	}
+	ALGO_VALIDATE( algoGraphFreezeComputeBufferSize(&csrBufferSize, graph) );
+	csrBuffer = malloc(csrBufferSize);
+	ALGO_VALIDATE( algoGraphFreeze(graph, &csr, csrBuffer, csrBufferSize) );
+	ALGO_VALIDATE( algoGraphBfsStateComputeBufferSize(&bfsStateBufferSize, graph) );
+	bfsBuffers[0] = malloc(bfsStateBufferSize);
+	bfsBuffers[1] = malloc(bfsStateBufferSize);
+	ALGO_VALIDATE( algoGraphBfsStateCreate(bfsStates+0, graph, bfsBuffers[0], bfsStateBufferSize) );
+	ALGO_VALIDATE( algoGraphBfsStateCreate(bfsStates+1, graph, bfsBuffers[1], bfsStateBufferSize) );
+	ALGO_VALIDATE( algoGraphBfs(graph, bfsStates[0], rootVertexId, bfsCallbacks) );
+	AlgoError err = algoGraphCsrBfsSimd(csr, bfsStates[1], rootVertexId, (AlgoSimdLevel)3);
+	ZOMBO_ASSERT(kAlgoErrorInvalidArgument == err, "an invalid SIMD level returned %d (expected %d)", err, kAlgoErrorInvalidArgument);
+
+	/* Also ask for AVX-512 on CPUs without it, which must fall back to the best supported kernel. */
+	for(level=kAlgoSimdScalar; level<=kAlgoSimdAvx512; ++level)
+	{
+		ALGO_VALIDATE( algoGraphBfsStateReset(bfsStates[1]) );
+		ALGO_VALIDATE( algoGraphCsrBfsSimd(csr, bfsStates[1], rootVertexId, (AlgoSimdLevel)level) );
+		for(iVert=0; iVert<vertexCount; ++iVert)
+		{
+			int32_t parent0 = -1, parent1 = -1, level0 = -1, level1 = -1;
+			int isDiscovered0 = 0, isDiscovered1 = 0, isProcessed0 = 0, isProcessed1 = 0;
+			ALGO_VALIDATE( algoGraphBfsStateGetVertexParent(bfsStates[0], iVert, &parent0) );
+			ALGO_VALIDATE( algoGraphBfsStateGetVertexParent(bfsStates[1], iVert, &parent1) );
+			ALGO_VALIDATE( algoGraphBfsStateGetVertexLevel(bfsStates[0], iVert, &level0) );
+			ALGO_VALIDATE( algoGraphBfsStateGetVertexLevel(bfsStates[1], iVert, &level1) );
+			ALGO_VALIDATE( algoGraphBfsStateIsVertexDiscovered(bfsStates[0], iVert, &isDiscovered0) );
+			ALGO_VALIDATE( algoGraphBfsStateIsVertexDiscovered(bfsStates[1], iVert, &isDiscovered1) );
+			ALGO_VALIDATE( algoGraphBfsStateIsVertexProcessed(bfsStates[0], iVert, &isProcessed0) );
+			ALGO_VALIDATE( algoGraphBfsStateIsVertexProcessed(bfsStates[1], iVert, &isProcessed1) );
+			ZOMBO_ASSERT(parent0 == parent1 && level0 == level1, "SIMD level %d: vertex %d has parent %d at level %d, expected %d at %d",
+				level, iVert, parent1, level1, parent0, level0);
+			ZOMBO_ASSERT(isDiscovered0 == isDiscovered1 && isProcessed0 == isProcessed1, "SIMD level %d: vertex %d state does not match",
+				level, iVert);
+		}
+	}
+
+	free(bfsBuffers[0]);
+	free(bfsBuffers[1]);
+	free(csrBuffer);
+	free(graphBuffer);
+}
+
+/* Builds a large random graph (edges added in random order, so each vertex's edge list is scattered throughout the edge
+   pool) and times a full BFS over the edge lists and over a frozen CSR snapshot. */
+static void benchmarkCsrBfs(int32_t vertexCount, int32_t averageDegree, int32_t passCount)
+{
+	const int32_t edgeCount = vertexCount*averageDegree;
+	size_t graphBufferSize = 0, csrBufferSize = 0, bfsStateBufferSize = 0;
+	void *graphBuffer = NULL, *csrBuffer = NULL, *bfsStateBuffer = NULL;
+	AlgoGraph graph;
+	AlgoGraphCsr csr;
+	AlgoGraphBfsState bfsState;
+	AlgoGraphBfsCallbacks bfsCallbacks = {NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
+	int32_t *listParents = malloc(vertexCount*sizeof(int32_t));
+	int32_t iVert, iEdge, iPass;
+	uint64_t startTicks, listTicks = 0, csrTicks = 0, freezeTicks;
+
+	ALGO_VALIDATE( algoGraphComputeBufferSize(&graphBufferSize, vertexCount, edgeCount, kAlgoGraphEdgeDirected) );
+	graphBuffer = malloc(graphBufferSize);
+	ALGO_VALIDATE( algoGraphCreate(&graph, vertexCount, edgeCount, kAlgoGraphEdgeDirected, graphBuffer, graphBufferSize) );
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		int32_t vertexId = -1;
+		ALGO_VALIDATE( algoGraphAddVertex(graph, algoDataFromInt(iVert), &vertexId) );
+	}
+	for(iEdge=0; iEdge<edgeCount; ++iEdge)
+	{
+		int32_t v0 = (int32_t)(((uint32_t)rand() * 32768u + (uint32_t)rand()) % (uint32_t)vertexCount);
+		int32_t v1 = (int32_t)(((uint32_t)rand() * 32768u + (uint32_t)rand()) % (uint32_t)vertexCount);
+		if (v0 != v1) /* no self-connecting edges */
+			ALGO_VALIDATE( algoGraphAddEdge(graph, v0, v1) );
+	}
+
+	ALGO_VALIDATE( algoGraphFreezeComputeBufferSize(&csrBufferSize, graph) );
+	csrBuffer = malloc(csrBufferSize);
+	startTicks = zomboClockTicks();
+	ALGO_VALIDATE( algoGraphFreeze(graph, &csr, csrBuffer, csrBufferSize) );
+	freezeTicks = zomboClockTicks() - startTicks;
+
+	ALGO_VALIDATE( algoGraphBfsStateComputeBufferSize(&bfsStateBufferSize, graph) );
+	bfsStateBuffer = malloc(bfsStateBufferSize);
+	for(iPass=0; iPass<passCount; ++iPass)
+	{
+		ALGO_VALIDATE( algoGraphBfsStateCreate(&bfsState, graph, bfsStateBuffer, bfsStateBufferSize) );
+		startTicks = zomboClockTicks();
+		ALGO_VALIDATE( algoGraphBfs(graph, bfsState, 0, bfsCallbacks) );
+		listTicks += zomboClockTicks() - startTicks;
+		for(iVert=0; iVert<vertexCount; ++iVert)
+		{
+			ALGO_VALIDATE( algoGraphBfsStateGetVertexParent(bfsState, iVert, listParents+iVert) );
+		}
+
+		ALGO_VALIDATE( algoGraphBfsStateCreate(&bfsState, graph, bfsStateBuffer, bfsStateBufferSize) );
+		startTicks = zomboClockTicks();
+		ALGO_VALIDATE( algoGraphCsrBfs(csr, bfsState, 0, bfsCallbacks) );
+		csrTicks += zomboClockTicks() - startTicks;
+		for(iVert=0; iVert<vertexCount; ++iVert)
+		{
+			int32_t parent = -1;
+			ALGO_VALIDATE( algoGraphBfsStateGetVertexParent(bfsState, iVert, &parent) );
+			ZOMBO_ASSERT(parent == listParents[iVert], "vertex %d: CSR BFS parent (%d) should be %d", iVert, parent, listParents[iVert]);
+		}
+	}
+	int32_t actualEdgeCount = 0;
+	ALGO_VALIDATE( algoGraphGetCurrentEdgeCount(graph, &actualEdgeCount) );
+	printf("\n\nBenchmark: BFS over %d vertices, %d edges (%d passes)\n", vertexCount, actualEdgeCount, passCount);
+	printf("\tedge lists:  %8.3f ms/pass\n", 1000.0 * zomboTicksToSeconds(listTicks) / passCount);
+	printf("\tCSR:         %8.3f ms/pass (+%.3f ms to freeze)\n", 1000.0 * zomboTicksToSeconds(csrTicks) / passCount,
+		1000.0 * zomboTicksToSeconds(freezeTicks));
+
+	free(bfsStateBuffer);
+	free(csrBuffer);
+	free(graphBuffer);
+	free(listParents);
+}
+
+/* Builds a random graph much larger than the last-level cache and times full BFS passes over its edge lists and over a
+   CSR snapshot, with and without kAlgoGraphBfsStatePrefetch. The prefetching searches must find the same parents. */
+static void benchmarkBfsPrefetch(int32_t vertexCount, int32_t averageDegree, int32_t passCount)
+{
+	const int32_t edgeCount = vertexCount*averageDegree;
+	size_t graphBufferSize = 0, csrBufferSize = 0, bfsStateBufferSize = 0;
+	void *graphBuffer = NULL, *csrBuffer = NULL, *bfsStateBuffer = NULL;
+	AlgoGraph graph;
+	AlgoGraphCsr csr;
+	AlgoGraphBfsState bfsState;
+	AlgoGraphBfsCallbacks bfsCallbacks = {NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
+	int32_t *defaultParents = malloc(vertexCount*sizeof(int32_t));
+	int32_t iVert, iPass, iSearch;
+	uint64_t startTicks, searchTicks[4] = {0, 0, 0, 0};
+
+	ALGO_VALIDATE( algoGraphComputeBufferSize(&graphBufferSize, vertexCount, edgeCount, kAlgoGraphEdgeDirected) );
+	graphBuffer = malloc(graphBufferSize);
+	ALGO_VALIDATE( algoGraphCreate(&graph, vertexCount, edgeCount, kAlgoGraphEdgeDirected, graphBuffer, graphBufferSize) );
+	addRandomEdges(graph, vertexCount, averageDegree);
+	ALGO_VALIDATE( algoGraphFreezeComputeBufferSize(&csrBufferSize, graph) );
+	csrBuffer = malloc(csrBufferSize);
+	ALGO_VALIDATE( algoGraphFreeze(graph, &csr, csrBuffer, csrBufferSize) );
+
+	AlgoError err = algoGraphBfsStateComputeBufferSizeWithFlags(&bfsStateBufferSize, graph, 2);
+	ZOMBO_ASSERT(kAlgoErrorInvalidArgument == err, "unknown BFS state flags returned %d (expected %d)", err, kAlgoErrorInvalidArgument);
+	ALGO_VALIDATE( algoGraphBfsStateComputeBufferSizeWithFlags(&bfsStateBufferSize, graph, kAlgoGraphBfsStatePrefetch) );
+	bfsStateBuffer = malloc(bfsStateBufferSize);
+	/* Searches 0 and 1 use the edge lists, 2 and 3 the CSR snapshot; odd searches prefetch. */
+	for(iPass=0; iPass<passCount; ++iPass)
+	{
+		for(iSearch=0; iSearch<4; ++iSearch)
+		{
+			ALGO_VALIDATE( algoGraphBfsStateCreateWithFlags(&bfsState, graph,
+				(iSearch & 1) ? kAlgoGraphBfsStatePrefetch : kAlgoGraphBfsStateDefault, bfsStateBuffer, bfsStateBufferSize) );
+			startTicks = zomboClockTicks();
+			if (iSearch < 2)
+				ALGO_VALIDATE( algoGraphBfs(graph, bfsState, 0, bfsCallbacks) );
+			else
+				ALGO_VALIDATE( algoGraphCsrBfs(csr, bfsState, 0, bfsCallbacks) );
+			searchTicks[iSearch] += zomboClockTicks() - startTicks;
+			for(iVert=0; iVert<vertexCount; ++iVert)
+			{
+				int32_t parent = -1;
+				ALGO_VALIDATE( algoGraphBfsStateGetVertexParent(bfsState, iVert, &parent) );
+				if (0 == iSearch)
+					defaultParents[iVert] = parent;
+				else
+					ZOMBO_ASSERT(parent == defaultParents[iVert], "search %d: vertex %d parent (%d) should be %d", iSearch, iVert,
+						parent, defaultParents[iVert]);
+			}
+		}
+	}
+	printf("Benchmark: BFS prefetching over %d vertices, %d edges, %.1f MB graph (%d passes)\n", vertexCount, edgeCount,
+		(double)graphBufferSize / (1024.0*1024.0), passCount);
+	printf("\tedge lists:            %8.3f ms/pass\n", 1000.0 * zomboTicksToSeconds(searchTicks[0]) / passCount);
+	printf("\tedge lists, prefetch:  %8.3f ms/pass\n", 1000.0 * zomboTicksToSeconds(searchTicks[1]) / passCount);
+	printf("\tCSR:                   %8.3f ms/pass\n", 1000.0 * zomboTicksToSeconds(searchTicks[2]) / passCount);
+	printf("\tCSR, prefetch:         %8.3f ms/pass\n", 1000.0 * zomboTicksToSeconds(searchTicks[3]) / passCount);
+
+	free(bfsStateBuffer);
+	free(csrBuffer);
+	free(graphBuffer);
+	free(defaultParents);
+}
+
+/* Builds the same kind of random DAG as test_topo.c (every edge leads to a higher vertex ID) and times a full BFS from
+   vertex 0 with algoGraphBfs(), algoGraphCsrBfs() and algoGraphCsrBfsSimd() at each supported SIMD level. All of them
+   must find the same parents. */
+static void benchmarkCsrBfsSimd(int32_t vertexCount, int32_t averageEdgesPerVertex, int32_t passCount)
+{
+	const int32_t edgeCapacity = vertexCount*averageEdgesPerVertex;
+	size_t graphBufferSize = 0, csrBufferSize = 0, bfsStateBufferSize = 0;
+	void *graphBuffer = NULL, *csrBuffer = NULL, *bfsStateBuffer = NULL;
+	AlgoGraph graph;
+	AlgoGraphCsr csr;
+	AlgoGraphBfsState bfsState;
+	AlgoGraphBfsCallbacks bfsCallbacks = {NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
+	AlgoSimdLevel supportedLevel = kAlgoSimdScalar;
+	int32_t *expectedParents = malloc(vertexCount*sizeof(int32_t));
+	int32_t iVert, iEdge, iPass, iSearch;
+	uint64_t startTicks, searchTicks[5] = {0, 0, 0, 0, 0};
+	static const char *searchNames[5] = {"algoGraphBfs", "algoGraphCsrBfs", "CsrBfsSimd (scalar)", "CsrBfsSimd (AVX2)",
+		"CsrBfsSimd (AVX-512)"};
+
+	ALGO_VALIDATE( algoGraphComputeBufferSize(&graphBufferSize, vertexCount, edgeCapacity, kAlgoGraphEdgeDirected) );
+	graphBuffer = malloc(graphBufferSize);
+	ALGO_VALIDATE( algoGraphCreate(&graph, vertexCount, edgeCapacity, kAlgoGraphEdgeDirected, graphBuffer, graphBufferSize) );
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		int32_t vertexId = -1;
+		ALGO_VALIDATE( algoGraphAddVertex(graph, algoDataFromInt(iVert), &vertexId) );
+	}
+	for(iEdge=0; iEdge<edgeCapacity; ++iEdge)
+	{
+		int32_t srcVertex = iEdge % vertexCount;
+		if (srcVertex == vertexCount-1)
+			continue;
+		int32_t dstVertex = srcVertex + 1 + (int32_t)((((uint32_t)rand() * 32768u) + (uint32_t)rand()) % (uint32_t)(vertexCount-srcVertex-1));
+		ALGO_VALIDATE( algoGraphAddEdge(graph, srcVertex, dstVertex) );
+	}
+	ALGO_VALIDATE( algoGraphFreezeComputeBufferSize(&csrBufferSize, graph) );
+	csrBuffer = malloc(csrBufferSize);
+	ALGO_VALIDATE( algoGraphFreeze(graph, &csr, csrBuffer, csrBufferSize) );
+	ALGO_VALIDATE( algoGraphBfsStateComputeBufferSize(&bfsStateBufferSize, graph) );
+	bfsStateBuffer = malloc(bfsStateBufferSize);
+	ALGO_VALIDATE( algoGetSupportedSimdLevel(&supportedLevel) );
+
+	for(iPass=0; iPass<passCount; ++iPass)
+	{
+		for(iSearch=0; iSearch<3+(int32_t)supportedLevel; ++iSearch)
+		{
+			ALGO_VALIDATE( algoGraphBfsStateCreate(&bfsState, graph, bfsStateBuffer, bfsStateBufferSize) );
+			startTicks = zomboClockTicks();
+			if (0 == iSearch)
+				ALGO_VALIDATE( algoGraphBfs(graph, bfsState, 0, bfsCallbacks) );
+			else if (1 == iSearch)
+				ALGO_VALIDATE( algoGraphCsrBfs(csr, bfsState, 0, bfsCallbacks) );
+			else
+				ALGO_VALIDATE( algoGraphCsrBfsSimd(csr, bfsState, 0, (AlgoSimdLevel)(iSearch-2)) );
+			searchTicks[iSearch] += zomboClockTicks() - startTicks;
+			for(iVert=0; iVert<vertexCount; ++iVert)
+			{
+				int32_t parent = -1;
+				ALGO_VALIDATE( algoGraphBfsStateGetVertexParent(bfsState, iVert, &parent) );
+				if (0 == iSearch)
+					expectedParents[iVert] = parent;
+				else
+					ZOMBO_ASSERT(parent == expectedParents[iVert], "%s: vertex %d parent (%d) should be %d", searchNames[iSearch],
+						iVert, parent, expectedParents[iVert]);
+			}
+		}
+	}
+	int32_t actualEdgeCount = 0;
+	ALGO_VALIDATE( algoGraphGetCurrentEdgeCount(graph, &actualEdgeCount) );
+	printf("Benchmark: BFS over a random DAG (%d vertices, %d edges, %d passes)\n", vertexCount, actualEdgeCount, passCount);
+	for(iSearch=0; iSearch<3+(int32_t)supportedLevel; ++iSearch)
+	{
+		printf("\t%-22s %8.3f ms/pass\n", searchNames[iSearch], 1000.0 * zomboTicksToSeconds(searchTicks[iSearch]) / passCount);
+	}
+
+	free(bfsStateBuffer);
+	free(csrBuffer);
+	free(graphBuffer);
+	free(expectedParents);
+}
+
+int main(int argc, char *argv[])
+{
+	/* The benchmarks take much longer than the tests; run them only when asked to. */
+	const int runBenchmarks = (argc > 1 && 0 == strcmp(argv[1], "--benchmark"));
 	unsigned int randomSeed = (unsigned int)time(NULL);
 	int32_t kVertexCapacity;
 	int32_t kEdgeCapacity;
@@ -183,7 +2266,9 @@ int main(void)
 		AlgoGraphBfsCallbacks bfsCallbacks = {
 			bfsProcessPersonEarly, NULL,
 			bfsProcessEdge, NULL,
-			bfsProcessPersonLate, NULL
+			bfsProcessPersonLate, NULL,
+			NULL, NULL,
+			NULL, NULL
 		};
 		ALGO_VALIDATE( algoGraphBfs(graph, bfsState, people[kCort].vertexId, bfsCallbacks) );
 		int32_t *parents = (int32_t*)malloc(kNumPeople*sizeof(int32_t));
@@ -219,7 +2304,9 @@ int main(void)
 		AlgoGraphDfsCallbacks dfsCallbacks = {
 			dfsProcessPersonEarly, NULL,
 			dfsProcessEdge, NULL,
-			dfsProcessPersonLate, NULL
+			dfsProcessPersonLate, NULL,
+			NULL, NULL,
+			NULL, NULL
 		};
 		ALGO_VALIDATE( algoGraphDfs(graph, dfsState, people[kCort].vertexId, dfsCallbacks) );
 		for(iPerson=0; iPerson<kNumPeople; iPerson += 1)
@@ -233,6 +2320,78 @@ int main(void)
 	}
 	ALGO_VALIDATE( algoGraphValidate(graph) );
 
+	/* Frozen CSR snapshot: traversals must visit vertices in exactly the same order as the edge-list versions. */
+	{
+		void *csrBuffer = NULL;
+		size_t csrBufferSize = 0;
+		AlgoGraphCsr csr;
+		ALGO_VALIDATE( algoGraphFreezeComputeBufferSize(&csrBufferSize, graph) );
+		csrBuffer = malloc(csrBufferSize);
+		ALGO_VALIDATE( algoGraphFreeze(graph, &csr, csrBuffer, csrBufferSize) );
+
+		size_t reportedSize;
+		ALGO_VALIDATE( algoGraphCsrGetBufferSize(csr, &reportedSize) );
+		ZOMBO_ASSERT(reportedSize == csrBufferSize, "reported size does not match input buffer size");
+
+		int32_t iPerson;
+		for(iPerson=0; iPerson<kNumPeople; iPerson += 1)
+		{
+			int32_t degree, csrDegree, iRoommate;
+			int32_t roommateIds[kNumPeople];
+			const int32_t *csrRoommateIds = NULL;
+			ALGO_VALIDATE( algoGraphGetVertexDegree(graph, people[iPerson].vertexId, &degree) );
+			ALGO_VALIDATE( algoGraphGetVertexEdges(graph, people[iPerson].vertexId, degree, roommateIds) );
+			ALGO_VALIDATE( algoGraphCsrGetVertexEdges(csr, people[iPerson].vertexId, &csrRoommateIds, &csrDegree) );
+			ZOMBO_ASSERT(degree == csrDegree, "%s: CSR degree (%d) should be %d", people[iPerson].name, csrDegree, degree);
+			for(iRoommate=0; iRoommate<degree; ++iRoommate)
+			{
+				ZOMBO_ASSERT(roommateIds[iRoommate] == csrRoommateIds[iRoommate], "%s: CSR edge %d does not match", people[iPerson].name, iRoommate);
+			}
+		}
+
+		void *bfsBuffers[2] = {NULL, NULL}, *dfsBuffers[2] = {NULL, NULL};
+		size_t bfsStateBufferSize = 0, dfsStateBufferSize = 0;
+		AlgoGraphBfsState bfsStates[2];
+		AlgoGraphDfsState dfsStates[2];
+		AlgoGraphBfsCallbacks bfsCallbacks = {NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
+		AlgoGraphDfsCallbacks dfsCallbacks = {NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
+		ALGO_VALIDATE( algoGraphBfsStateComputeBufferSize(&bfsStateBufferSize, graph) );
+		ALGO_VALIDATE( algoGraphDfsStateComputeBufferSize(&dfsStateBufferSize, graph) );
+		for(int iState=0; iState<2; ++iState)
+		{
+			bfsBuffers[iState] = malloc(bfsStateBufferSize);
+			dfsBuffers[iState] = malloc(dfsStateBufferSize);
+			ALGO_VALIDATE( algoGraphBfsStateCreate(bfsStates+iState, graph, bfsBuffers[iState], bfsStateBufferSize) );
+			ALGO_VALIDATE( algoGraphDfsStateCreate(dfsStates+iState, graph, dfsBuffers[iState], dfsStateBufferSize) );
+		}
+		ALGO_VALIDATE( algoGraphBfs(graph, bfsStates[0], people[kCort].vertexId, bfsCallbacks) );
+		ALGO_VALIDATE( algoGraphCsrBfs(csr, bfsStates[1], people[kCort].vertexId, bfsCallbacks) );
+		ALGO_VALIDATE( algoGraphDfs(graph, dfsStates[0], people[kCort].vertexId, dfsCallbacks) );
+		ALGO_VALIDATE( algoGraphCsrDfs(csr, dfsStates[1], people[kCort].vertexId, dfsCallbacks) );
+		for(iPerson=0; iPerson<kNumPeople; iPerson += 1)
+		{
+			int32_t parent0 = -1, parent1 = -1, entry0 = -1, entry1 = -1, exit0 = -1, exit1 = -1;
+			ALGO_VALIDATE( algoGraphBfsStateGetVertexParent(bfsStates[0], people[iPerson].vertexId, &parent0) );
+			ALGO_VALIDATE( algoGraphBfsStateGetVertexParent(bfsStates[1], people[iPerson].vertexId, &parent1) );
+			ZOMBO_ASSERT(parent0 == parent1, "%s: CSR BFS parent (%d) should be %d", people[iPerson].name, parent1, parent0);
+			ALGO_VALIDATE( algoGraphDfsStateGetVertexParent(dfsStates[0], people[iPerson].vertexId, &parent0) );
+			ALGO_VALIDATE( algoGraphDfsStateGetVertexParent(dfsStates[1], people[iPerson].vertexId, &parent1) );
+			ZOMBO_ASSERT(parent0 == parent1, "%s: CSR DFS parent (%d) should be %d", people[iPerson].name, parent1, parent0);
+			ALGO_VALIDATE( algoGraphDfsStateGetVertexEntryTime(dfsStates[0], people[iPerson].vertexId, &entry0) );
+			ALGO_VALIDATE( algoGraphDfsStateGetVertexEntryTime(dfsStates[1], people[iPerson].vertexId, &entry1) );
+			ALGO_VALIDATE( algoGraphDfsStateGetVertexExitTime(dfsStates[0], people[iPerson].vertexId, &exit0) );
+			ALGO_VALIDATE( algoGraphDfsStateGetVertexExitTime(dfsStates[1], people[iPerson].vertexId, &exit1) );
+			ZOMBO_ASSERT(entry0 == entry1 && exit0 == exit1, "%s: CSR DFS times do not match", people[iPerson].name);
+		}
+		for(int iState=0; iState<2; ++iState)
+		{
+			free(bfsBuffers[iState]);
+			free(dfsBuffers[iState]);
+		}
+		free(csrBuffer);
+	}
+	ALGO_VALIDATE( algoGraphValidate(graph) );
+
 	{
 		int32_t iPerson;
 		printf("\n\nRemoving cort...\n");
@@ -260,4 +2419,48 @@ int main(void)
 	ALGO_VALIDATE( algoGraphValidate(graph) );
 
 	free(graphBuffer);
+
+	testEdgeMutation(kAlgoGraphEdgeUndirected, 100000);
+	testEdgeMutation(kAlgoGraphEdgeDirected, 100000);
+	testShortestPathBidirectional(kAlgoGraphEdgeUndirected, kAlgoGraphDefault, 20000, 30000, 100);
+	testShortestPathBidirectional(kAlgoGraphEdgeDirected, kAlgoGraphDefault, 20000, 50000, 100);
+	testShortestPathBidirectional(kAlgoGraphEdgeDirected, kAlgoGraphInEdges, 20000, 50000, 100);
+	testBfsDirectionOptimizing(kAlgoGraphEdgeUndirected, kAlgoGraphDefault, 16*1024, 8, 6);
+	testBfsDirectionOptimizing(kAlgoGraphEdgeDirected, kAlgoGraphDefault, 8*1024, 8, 4);
+	testBfsDirectionOptimizing(kAlgoGraphEdgeDirected, kAlgoGraphInEdges, 8*1024, 8, 4);
+	testBfsPaths(kAlgoGraphEdgeUndirected, 16*1024, 2, 1000);
+	testBfsPaths(kAlgoGraphEdgeDirected, 16*1024, 3, 1000);
+	testBfsParallel(kAlgoGraphEdgeUndirected, 16*1024, 8, (zomboCpuCount() > 4) ? 2*zomboCpuCount() : 8);
+	testBfsParallel(kAlgoGraphEdgeDirected, 8*1024, 4, 4);
+	testMultiSourceBfs(kAlgoGraphEdgeUndirected, 8*1024, 8, 50);
+	testMultiSourceBfs(kAlgoGraphEdgeDirected, 4*1024, 4, 30);
+	testSearchMultiRoot(kAlgoGraphEdgeUndirected, 8*1024, 1, 40);
+	testSearchMultiRoot(kAlgoGraphEdgeDirected, 8*1024, 2, 40);
+	testSearchControl(kAlgoGraphEdgeUndirected, 16*1024, 4, 50);
+	testSearchControl(kAlgoGraphEdgeDirected, 16*1024, 4, 50);
+	testDfsLightweight(kAlgoGraphEdgeUndirected, 32*1024, 2, 4);
+	testDfsLightweight(kAlgoGraphEdgeDirected, 32*1024, 4, 4);
+	testAddEdges(kAlgoGraphEdgeUndirected, kAlgoGraphEdgeIndexNone, 16*1024, 8);
+	testAddEdges(kAlgoGraphEdgeDirected, kAlgoGraphEdgeIndexNone, 16*1024, 8);
+	testAddEdges(kAlgoGraphEdgeUndirected, kAlgoGraphEdgeIndexEnabled, 16*1024, 8);
+	testAddEdges(kAlgoGraphEdgeDirected, kAlgoGraphEdgeIndexEnabled, 16*1024, 8);
+	testEdgeIndex(kAlgoGraphEdgeUndirected, 8*1024, 4, 6000);
+	testEdgeIndex(kAlgoGraphEdgeDirected, 8*1024, 4, 6000);
+	testReorder(kAlgoGraphReorderReverseCuthillMcKee, "reverse Cuthill-McKee", 512);
+	testReorder(kAlgoGraphReorderBfs, "BFS", 512);
+	testReorder(kAlgoGraphReorderDegreeDescending, "descending degree", 256);
+	testSearchStateReset(kAlgoGraphEdgeUndirected, 128*1024, 16, 200);
+	testSearchStateReset(kAlgoGraphEdgeDirected, 128*1024, 16, 200);
+	testCsrBfsSimd(kAlgoGraphEdgeUndirected, 64*1024, 4, 1000);
+	testCsrBfsSimd(kAlgoGraphEdgeDirected, 64*1024, 8, 1000);
+	if (runBenchmarks)
+	{
+		benchmarkCsrBfs(512*1024, 8, 4);
+		benchmarkBfsPrefetch(2*1024*1024, 8, 2);
+		benchmarkCsrBfsSimd(1024*1024, 16, 4);
+	}
+	else
+	{
+		printf("Skipping benchmarks (run with --benchmark to enable them)\n");
+	}
 }
@@ -21,17 +21,7 @@ static uint64_t packWordAsInt(const char *word)
 	return id;
 }
 
-static int32_t wangHash32(int32_t key) /* see https://gist.github.com/badboy/6267743 */
-{
-  key = ~key + (key << 15); /* key = (key << 15) - key - 1; */
-  key =  key ^ (key >> 12);
-  key =  key + (key <<  2);
-  key =  key ^ (key >>  4);
-  key =  key * 2057;        /* key = (key + (key << 3)) + (key << 11); */
-  key =  key ^ (key >> 16);
-  return key;
-}
-static uint64_t wangHash64(uint64_t key)
+static uint64_t wangHash64(uint64_t key) /* see https://gist.github.com/badboy/6267743 */
 {
   key = (~key) + (key << 21);               // key = (key << 21) - key - 1;
   key =   key  ^ (key >> 24);
@@ -157,6 +147,23 @@ static void hashRemoveEntry_Word(HashTable_Word *table, const char *key)
 	table->recycledEntryList = doomedEntry;
 }
 
+/* A* heuristic: the number of letters that differ between two words. Each edge changes exactly one letter, so this
+   never overestimates the remaining path length. */
+static int32_t hammingDistanceHeuristic(AlgoGraph graph, int32_t vertexId, int32_t goalVertexId, void *userData)
+{
+	AlgoData vertData = algoDataFromPtr(NULL), goalData = algoDataFromPtr(NULL);
+	(void)userData;
+	ALGO_VALIDATE( algoGraphGetVertexData(graph, vertexId, &vertData) );
+	ALGO_VALIDATE( algoGraphGetVertexData(graph, goalVertexId, &goalData) );
+	const char *word = ((const HashEntry_Word*)vertData.asPtr)->key;
+	const char *goalWord = ((const HashEntry_Word*)goalData.asPtr)->key;
+	int32_t distance = 0;
+	for(; *word && *goalWord; ++word, ++goalWord)
+	{
+		distance += (*word != *goalWord) ? 1 : 0;
+	}
+	return distance;
+}
 
 int main(void)
 {
@@ -193,7 +200,7 @@ int main(void)
 	{
 		char *newline = strchr(nextWord, '\n');
 		ZOMBO_ASSERT(NULL != newline, "word doesn't end in newline");
-		size_t wordLength = newline - nextWord;
+		int wordLength = (int)(newline - nextWord);
 		nextWord[wordLength] = 0;
 		if (wordLength > kMaxWordLength)
 			continue;
@@ -256,7 +263,7 @@ int main(void)
 			wordEntry = wordEntry->next)
 		{
 			const char *word = wordEntry->key;
-			size_t wordLength = strlen(word);
+			int wordLength = (int)strlen(word);
 			for(int iChar=0;
 				iChar<wordLength;
 				++iChar)
@@ -329,7 +336,7 @@ int main(void)
 				iEdge < wordEdgeCount;
 				iEdge += 1)
 			{
-				AlgoData vertData;
+				AlgoData vertData = algoDataFromPtr(NULL);
 				ALGO_VALIDATE( algoGraphGetVertexData(hamGraph, wordEdges[iEdge], &vertData) );
 				HashEntry_Word *edgeEntry = vertData.asPtr;
 				fprintf(hamFile, "%s\"%s\"", (iEdge>0) ? ", " : "", edgeEntry->key);
@@ -348,13 +355,21 @@ int main(void)
 	ALGO_VALIDATE( algoGraphBfsStateComputeBufferSize(&hamGraphBfsBufferSize, hamGraph) );
 	void *hamGraphBfsBuffer = malloc(hamGraphBfsBufferSize);
 	AlgoGraphBfsState hamBfs;
+	size_t hamGraphAStarBufferSize = 0;
+	ALGO_VALIDATE( algoGraphDijkstraStateComputeBufferSize(&hamGraphAStarBufferSize, hamGraph) );
+	void *hamGraphAStarBuffer = malloc(hamGraphAStarBufferSize);
+	AlgoGraphDijkstraState hamAStar;
+	size_t hamGraphPathBufferSize = 0;
+	ALGO_VALIDATE( algoGraphShortestPathBidirectionalComputeBufferSize(&hamGraphPathBufferSize, hamGraph) );
+	void *hamGraphPathBuffer = malloc(hamGraphPathBufferSize);
+	int32_t *hamPath = malloc(wordCount*sizeof(int32_t));
 	printf("Ctrl-D + Enter to exit\n\n");
 	for(;;)
 	{
 		printf("start: ");
 		char startWord[32] = {0};
 		scanf("%31s", startWord);
-		if (strlen(startWord) > kMaxWordLength)
+		if ((int)strlen(startWord) > kMaxWordLength)
 		{
 			printf("ERROR: Too long! max word length is %d\n\n", kMaxWordLength);
 			int c;
@@ -370,7 +385,7 @@ int main(void)
 		printf(" goal: ");
 		char goalWord[32] = {0};
 		scanf("%31s", goalWord);
-		if (strlen(goalWord) > kMaxWordLength)
+		if ((int)strlen(goalWord) > kMaxWordLength)
 		{
 			printf("ERROR: Too long! max word length is %d\n\n", kMaxWordLength);
 			int c;
@@ -399,28 +414,54 @@ int main(void)
 			continue;
 		}
 
+		/* A full BFS from the start word, for comparison. */
 		ALGO_VALIDATE( algoGraphBfsStateCreate(&hamBfs, hamGraph, hamGraphBfsBuffer, hamGraphBfsBufferSize) );
 		AlgoGraphBfsCallbacks hamBfsCallbacks = {
 			NULL, NULL,
 			NULL, NULL,
 			NULL, NULL,
+			NULL, NULL,
+			NULL, NULL,
 		};
 		ALGO_VALIDATE( algoGraphBfs(hamGraph, hamBfs, startEntry->vertexId, hamBfsCallbacks) );
-		int32_t parentId = -1;
-		ALGO_VALIDATE( algoGraphBfsStateGetVertexParent(hamBfs, goalEntry->vertexId, &parentId) );
-		if (parentId == -1)
+
+		ALGO_VALIDATE( algoGraphDijkstraStateCreate(&hamAStar, hamGraph, hamGraphAStarBuffer, hamGraphAStarBufferSize) );
+		ALGO_VALIDATE( algoGraphAStar(hamGraph, hamAStar, startEntry->vertexId, goalEntry->vertexId, hammingDistanceHeuristic, NULL) );
+		int32_t pathLength = -1;
+		ALGO_VALIDATE( algoGraphDijkstraStateGetVertexDistance(hamAStar, goalEntry->vertexId, &pathLength) );
+		if (pathLength < 0)
 		{
 			printf("ERROR: no valid hamming path found from '%s' to '%s'\n\n", startWord, goalWord);
 			continue;
 		}
+		{
+			int32_t bfsVisitCount = 0, aStarVisitCount = 0, vertexCapacity = 0, iVisitWord;
+			ALGO_VALIDATE( algoGraphGetVertexCapacity(hamGraph, &vertexCapacity) );
+			for(iVisitWord=0; iVisitWord<vertexCapacity; ++iVisitWord)
+			{
+				int isProcessed = 0, isSettled = 0;
+				if (kAlgoErrorNone != algoGraphDijkstraStateIsVertexSettled(hamAStar, iVisitWord, &isSettled))
+					continue; /* removed vertex */
+				ALGO_VALIDATE( algoGraphBfsStateIsVertexProcessed(hamBfs, iVisitWord, &isProcessed) );
+				bfsVisitCount += isProcessed;
+				aStarVisitCount += isSettled;
+			}
+			printf("%d steps (BFS expanded %d words, A* expanded %d)\n", pathLength, bfsVisitCount, aStarVisitCount);
+		}
+		/* Cross-check the path length with a bidirectional BFS. Unweighted edges have unit weight, so these must agree. */
+		int32_t hamPathLength = 0;
+		ALGO_VALIDATE( algoGraphShortestPathBidirectional(hamGraph, startEntry->vertexId, goalEntry->vertexId, hamPath, wordCount,
+			&hamPathLength, hamGraphPathBuffer, hamGraphPathBufferSize) );
+		ZOMBO_ASSERT(hamPathLength == pathLength+1, "bidirectional BFS path has %d words; expected %d", hamPathLength, pathLength+1);
+		int32_t parentId = -1;
 		printf("%s ", goalEntry->key);
 		for(;;)
 		{
 			parentId = -1;
-			ALGO_VALIDATE( algoGraphBfsStateGetVertexParent(hamBfs, goalEntry->vertexId, &parentId) );
+			ALGO_VALIDATE( algoGraphDijkstraStateGetVertexParent(hamAStar, goalEntry->vertexId, &parentId) );
 			if (parentId == -1)
 				break;
-			AlgoData vertData;
+			AlgoData vertData = algoDataFromPtr(NULL);
 			ALGO_VALIDATE( algoGraphGetVertexData(hamGraph, parentId, &vertData) );
 			goalEntry = vertData.asPtr;
 			printf("%s ", goalEntry->key);
@@ -428,6 +469,9 @@ int main(void)
 		printf("\n\n");
 	}
 
+	free(hamPath);
+	free(hamGraphPathBuffer);
+	free(hamGraphAStarBuffer);
 	free(hamGraphBfsBuffer);
 	free(hamGraphBuffer);
 	free(hashBuffer);
@@ -0,0 +1,184 @@
+#include "test_common.h"
+
+static int testMinMaxHeapInsert(AlgoMinMaxHeap heap, int32_t heapContents[])
+{
+	int32_t capacity = -1;
+	int32_t beforeSize = -1, afterSize = -1;
+	AlgoData newKey, newData;
+	ALGO_VALIDATE( algoMinMaxHeapGetCapacity(heap, &capacity) );
+	ALGO_VALIDATE( algoMinMaxHeapGetCurrentSize(heap, &beforeSize) );
+	if (beforeSize == capacity)
+	{
+		AlgoError err = algoMinMaxHeapInsert(heap, algoDataFromInt(0), algoDataFromInt(0));
+		ZOMBO_ASSERT(err == kAlgoErrorOperationFailed, "algoMinMaxHeapInsert() on a full heap returned %d (expected %d)",
+			err, kAlgoErrorOperationFailed);
+		return 0; /* heap is full */
+	}
+	newKey = algoDataFromInt(rand() % capacity);
+	newData = newKey;
+	ALGO_VALIDATE( algoMinMaxHeapInsert(heap, newKey, newData) );
+	heapContents[newKey.asInt] += 1;
+
+	ALGO_VALIDATE( algoMinMaxHeapGetCurrentSize(heap, &afterSize) );
+	ZOMBO_ASSERT(beforeSize+1 == afterSize, "heap grew by more than one entry");
+	return 1;
+}
+
+static int testMinMaxHeapPop(AlgoMinMaxHeap heap, int32_t heapContents[], int popMax)
+{
+	int32_t capacity = -1;
+	int32_t beforeSize = -1, afterSize = -1;
+	AlgoData key, keyPeek;
+	AlgoData data, dataPeek;
+	int iVal;
+	ALGO_VALIDATE( algoMinMaxHeapGetCapacity(heap, &capacity) );
+	ALGO_VALIDATE( algoMinMaxHeapGetCurrentSize(heap, &beforeSize) );
+	if (beforeSize == 0)
+	{
+		AlgoError err = algoMinMaxHeapPopMin(heap, NULL, NULL);
+		ZOMBO_ASSERT(err == kAlgoErrorOperationFailed, "algoMinMaxHeapPopMin() on an empty heap returned %d (expected %d)",
+			err, kAlgoErrorOperationFailed);
+		err = algoMinMaxHeapPopMax(heap, NULL, NULL);
+		ZOMBO_ASSERT(err == kAlgoErrorOperationFailed, "algoMinMaxHeapPopMax() on an empty heap returned %d (expected %d)",
+			err, kAlgoErrorOperationFailed);
+		return 0; /* heap is empty */
+	}
+	if (popMax)
+	{
+		ALGO_VALIDATE( algoMinMaxHeapPeekMax(heap, &keyPeek, &dataPeek) );
+		ALGO_VALIDATE( algoMinMaxHeapPopMax(heap, &key, &data) );
+	}
+	else
+	{
+		ALGO_VALIDATE( algoMinMaxHeapPeekMin(heap, &keyPeek, &dataPeek) );
+		ALGO_VALIDATE( algoMinMaxHeapPopMin(heap, &key, &data) );
+	}
+	/* Peeked data should match popped data */
+	ZOMBO_ASSERT(keyPeek.asInt == key.asInt, "Peeked key (%d) does not match popped key (%d)", keyPeek.asInt, key.asInt);
+	ZOMBO_ASSERT(dataPeek.asInt == data.asInt, "Peeked data (%d) does not match popped data (%d)", dataPeek.asInt, data.asInt);
+	/* key and data must match (in this test environment) */
+	ZOMBO_ASSERT(key.asInt == data.asInt, "key (%d) must match data (%d)", key.asInt, data.asInt);
+	ZOMBO_ASSERT(key.asInt >= 0 && key.asInt < capacity, "key (%d) must be in the range [0..%d)", key.asInt, capacity);
+	/* Make sure the key is the smallest/largest key in the heap (all counters below/above it must be zero). */
+	if (popMax)
+	{
+		for(iVal=key.asInt+1; iVal<capacity; ++iVal)
+		{
+			ZOMBO_ASSERT(heapContents[iVal] == 0, "maxKey (%d) is not the largest key in the heap", key.asInt);
+		}
+	}
+	else
+	{
+		for(iVal=0; iVal<key.asInt; ++iVal)
+		{
+			ZOMBO_ASSERT(heapContents[iVal] == 0, "minKey (%d) is not the smallest key in the heap", key.asInt);
+		}
+	}
+	/* Make sure the key is in the heap in the first place */
+	ZOMBO_ASSERT(heapContents[key.asInt] > 0, "key (%d) is not actually in the heap", key.asInt);
+	heapContents[key.asInt] -= 1;
+
+	ALGO_VALIDATE( algoMinMaxHeapGetCurrentSize(heap, &afterSize) );
+	ZOMBO_ASSERT(beforeSize-1 == afterSize, "heap shrunk by more than one element");
+	return 1;
+}
+
+int main(void)
+{
+	unsigned int randomSeed = (unsigned int)time(NULL);
+	const int32_t kHeapCapacity = 16*1024;
+	const int32_t kTestCount = 100;
+	int32_t *heapContents = NULL;
+	void *heapBuffer = NULL;
+	size_t heapBufferSize = 0;
+	AlgoMinMaxHeap heap;
+	int currentSize = 0;
+	int iHeapTest;
+	printf("Random seed: 0x%08X\n", randomSeed);
+	srand(randomSeed);
+	printf("Testing AlgoMinMaxHeap (capacity: %d, test count: %d)\n", kHeapCapacity, kTestCount);
+
+	heapContents = malloc(kHeapCapacity*sizeof(int32_t));
+	memset(heapContents, 0, kHeapCapacity*sizeof(int32_t));
+
+	ALGO_VALIDATE( algoMinMaxHeapComputeBufferSize(&heapBufferSize, kHeapCapacity) );
+	heapBuffer = malloc(heapBufferSize);
+	ALGO_VALIDATE( algoMinMaxHeapCreate(&heap, kHeapCapacity, algoDataCompareIntAscending, heapBuffer, heapBufferSize) );
+
+	size_t reportedSize;
+	ALGO_VALIDATE( algoMinMaxHeapGetBufferSize(heap, &reportedSize) );
+	ZOMBO_ASSERT(reportedSize == heapBufferSize, "reported size does not match input buffer size");
+
+	ALGO_VALIDATE( algoMinMaxHeapGetCurrentSize(heap, &currentSize) );
+	ZOMBO_ASSERT(0 == currentSize, "newly created heap has size=%d", currentSize);
+	testMinMaxHeapPop(heap, heapContents, 0);
+	for(iHeapTest=0; iHeapTest<kTestCount; ++iHeapTest)
+	{
+		int32_t numAdds = rand() % (kHeapCapacity-currentSize+1);
+		int32_t iAdd, iPop, iVal;
+		int32_t numPops;
+		int32_t elemCount = 0;
+		printf(" - Adding %d elements...\n", numAdds);
+		for(iAdd=0; iAdd<numAdds; ++iAdd)
+		{
+			testMinMaxHeapInsert(heap, heapContents);
+		}
+		ALGO_VALIDATE( algoMinMaxHeapValidate(heap) );
+
+		ALGO_VALIDATE( algoMinMaxHeapGetCurrentSize(heap, &currentSize) );
+		numPops = (currentSize > 0) ? 1 + (rand() % currentSize) : 0;
+		printf(" - Popping %d elements from both ends...\n", numPops);
+		for(iPop=0; iPop<numPops; ++iPop)
+		{
+			testMinMaxHeapPop(heap, heapContents, rand() % 2);
+			if ((iPop % 256) == 0)
+			{
+				ALGO_VALIDATE( algoMinMaxHeapValidate(heap) );
+			}
+		}
+		ALGO_VALIDATE( algoMinMaxHeapValidate(heap) );
+
+		ALGO_VALIDATE( algoMinMaxHeapGetCurrentSize(heap, &currentSize) );
+		for(iVal=0; iVal<kHeapCapacity; ++iVal)
+		{
+			elemCount += heapContents[iVal];
+		}
+		ZOMBO_ASSERT(elemCount == currentSize, "elemCount (%d) != currentSize (%d)", elemCount, currentSize);
+		printf(" - %d elements left!\n\n", currentSize);
+#if defined(_MSC_VER)
+		_ASSERTE(_CrtCheckMemory());
+#endif
+	}
+
+	/* Bounded beam: keep only the best kBeamWidth keys seen so far, evicting the worst when full. */
+	{
+		const int32_t kBeamWidth = 64;
+		int32_t iKey, beamSize = 0;
+		AlgoData worstKey;
+		ALGO_VALIDATE( algoMinMaxHeapCreate(&heap, kBeamWidth, algoDataCompareIntAscending, heapBuffer, heapBufferSize) );
+		printf(" - Beam search with width %d...\n", kBeamWidth);
+		for(iKey=kHeapCapacity-1; iKey>=0; --iKey)
+		{
+			AlgoData key = algoDataFromInt(iKey);
+			ALGO_VALIDATE( algoMinMaxHeapGetCurrentSize(heap, &beamSize) );
+			if (beamSize == kBeamWidth)
+			{
+				ALGO_VALIDATE( algoMinMaxHeapPeekMax(heap, &worstKey, NULL) );
+				if (worstKey.asInt <= key.asInt)
+					continue;
+				ALGO_VALIDATE( algoMinMaxHeapPopMax(heap, NULL, NULL) );
+			}
+			ALGO_VALIDATE( algoMinMaxHeapInsert(heap, key, key) );
+		}
+		ALGO_VALIDATE( algoMinMaxHeapValidate(heap) );
+		for(iKey=0; iKey<kBeamWidth; ++iKey)
+		{
+			AlgoData bestKey;
+			ALGO_VALIDATE( algoMinMaxHeapPopMin(heap, &bestKey, NULL) );
+			ZOMBO_ASSERT(bestKey.asInt == iKey, "beam returned key %d, expected %d", bestKey.asInt, iKey);
+		}
+	}
+
+	free(heapBuffer);
+	free(heapContents);
+}
@@ -0,0 +1,172 @@
+#include "test_common.h"
+
+typedef struct WorkerArgs
+{
+	AlgoMultiQueue queue;
+	int32_t threadIndex;
+	int32_t opCount;
+	int32_t firstElemId; /* each worker inserts IDs [firstElemId, firstElemId+opCount) */
+	uint8_t *popCounts; /* indexed by element ID; shared by all workers */
+	int32_t popCount; /* output: number of successful pops */
+} WorkerArgs;
+
+/* Alternates inserts and pops, recording every popped element. */
+static ZomboThreadReturn ZOMBO_THREAD_CALL mixedWorker(void *voidArgs)
+{
+	WorkerArgs *args = (WorkerArgs*)voidArgs;
+	uint32_t rng = 0x12345u + 7919u*(uint32_t)args->threadIndex;
+	int32_t iOp;
+	args->popCount = 0;
+	for(iOp=0; iOp<args->opCount; ++iOp)
+	{
+		AlgoData key, data;
+		rng = rng*1664525u + 1013904223u;
+		ALGO_VALIDATE( algoMultiQueueInsert(args->queue, algoDataFromInt((int32_t)(rng >> 8)), algoDataFromInt(args->firstElemId + iOp)) );
+		if (kAlgoErrorNone == algoMultiQueuePop(args->queue, &key, &data))
+		{
+			args->popCounts[data.asInt] += 1;
+			args->popCount += 1;
+		}
+	}
+	return 0;
+}
+
+static void testSingleThreaded(void)
+{
+	const int32_t kCapacity = 64*1024;
+	size_t queueBufferSize = 0;
+	void *queueBuffer = NULL;
+	AlgoMultiQueue queue;
+	int32_t *popCounts = calloc(kCapacity, sizeof(int32_t));
+	int32_t iElem, currentSize = -1, capacity = -1, heapCount = -1;
+	int64_t totalRankError = 0;
+	AlgoData key, data;
+	AlgoError err;
+	printf("Single-threaded correctness (capacity: %d)\n", kCapacity);
+
+	ALGO_VALIDATE( algoMultiQueueComputeBufferSize(&queueBufferSize, kCapacity, 4, 2) );
+	queueBuffer = malloc(queueBufferSize);
+	ALGO_VALIDATE( algoMultiQueueCreate(&queue, kCapacity, 4, 2, algoDataCompareIntAscending, queueBuffer, queueBufferSize) );
+
+	size_t reportedSize;
+	ALGO_VALIDATE( algoMultiQueueGetBufferSize(queue, &reportedSize) );
+	ZOMBO_ASSERT(reportedSize == queueBufferSize, "reported size does not match input buffer size");
+	ALGO_VALIDATE( algoMultiQueueGetCapacity(queue, &capacity) );
+	ZOMBO_ASSERT(capacity == kCapacity, "capacity (%d) should be %d", capacity, kCapacity);
+	ALGO_VALIDATE( algoMultiQueueGetHeapCount(queue, &heapCount) );
+	ZOMBO_ASSERT(heapCount == 8, "heap count (%d) should be 8", heapCount);
+
+	/* Keys are a permutation of [0..capacity), so a popped key's rank error is easy to measure. */
+	for(iElem=0; iElem<kCapacity; ++iElem)
+	{
+		int32_t keyValue = (int32_t)(((int64_t)iElem * 40503) % kCapacity);
+		ALGO_VALIDATE( algoMultiQueueInsert(queue, algoDataFromInt(keyValue), algoDataFromInt(keyValue)) );
+	}
+	ALGO_VALIDATE( algoMultiQueueGetCurrentSize(queue, &currentSize) );
+	ZOMBO_ASSERT(currentSize == kCapacity, "currentSize (%d) should be %d", currentSize, kCapacity);
+	err = algoMultiQueueInsert(queue, algoDataFromInt(0), algoDataFromInt(0));
+	ZOMBO_ASSERT(err == kAlgoErrorOperationFailed, "inserting into a full queue returned %d (expected %d)", err, kAlgoErrorOperationFailed);
+
+	for(iElem=0; iElem<kCapacity; ++iElem)
+	{
+		int32_t rank = 0, iKey;
+		ALGO_VALIDATE( algoMultiQueuePop(queue, &key, &data) );
+		ZOMBO_ASSERT(key.asInt == data.asInt, "key (%d) must match data (%d)", key.asInt, data.asInt);
+		ZOMBO_ASSERT(popCounts[key.asInt] == 0, "key %d popped twice", key.asInt);
+		if ((iElem % 64) == 0) /* measuring every pop is O(N^2) */
+		{
+			for(iKey=0; iKey<key.asInt; ++iKey)
+			{
+				rank += (popCounts[iKey] == 0) ? 1 : 0;
+			}
+			totalRankError += rank;
+		}
+		popCounts[key.asInt] = 1;
+	}
+	err = algoMultiQueuePop(queue, &key, &data);
+	ZOMBO_ASSERT(err == kAlgoErrorOperationFailed, "popping an empty queue returned %d (expected %d)", err, kAlgoErrorOperationFailed);
+	printf("\tmean rank error: %.2f\n", (double)totalRankError / (double)(kCapacity/64));
+
+	free(popCounts);
+	free(queueBuffer);
+}
+
+static double runMixedWorkload(int32_t threadCount, int32_t queueThreadCount, int32_t relaxationFactor, int32_t opsPerThread)
+{
+	const int32_t totalOps = threadCount*opsPerThread;
+	size_t queueBufferSize = 0;
+	void *queueBuffer = NULL;
+	AlgoMultiQueue queue;
+	ZomboThread *threads = malloc(threadCount*sizeof(ZomboThread));
+	WorkerArgs *args = malloc(threadCount*sizeof(WorkerArgs));
+	uint8_t *popCounts = calloc(totalOps, sizeof(uint8_t));
+	int32_t iThread, iElem, totalPops = 0, remaining = 0;
+	uint64_t startTicks, endTicks;
+	AlgoData key, data;
+
+	ALGO_VALIDATE( algoMultiQueueComputeBufferSize(&queueBufferSize, totalOps, queueThreadCount, relaxationFactor) );
+	queueBuffer = malloc(queueBufferSize);
+	ALGO_VALIDATE( algoMultiQueueCreate(&queue, totalOps, queueThreadCount, relaxationFactor, algoDataCompareIntAscending,
+		queueBuffer, queueBufferSize) );
+
+	startTicks = zomboClockTicks();
+	for(iThread=0; iThread<threadCount; ++iThread)
+	{
+		args[iThread].queue = queue;
+		args[iThread].threadIndex = iThread;
+		args[iThread].opCount = opsPerThread;
+		args[iThread].firstElemId = iThread*opsPerThread;
+		args[iThread].popCounts = popCounts;
+		int err = zomboThreadCreate(threads+iThread, mixedWorker, args+iThread);
+		ZOMBO_ASSERT(err == 0, "thread creation failed (%d)", err);
+	}
+	for(iThread=0; iThread<threadCount; ++iThread)
+	{
+		zomboThreadJoin(threads[iThread]);
+		totalPops += args[iThread].popCount;
+	}
+	endTicks = zomboClockTicks();
+
+	/* Every inserted element must be popped exactly once, either by a worker or by the drain below. */
+	while(kAlgoErrorNone == algoMultiQueuePop(queue, &key, &data))
+	{
+		popCounts[data.asInt] += 1;
+		remaining += 1;
+	}
+	ZOMBO_ASSERT(totalPops + remaining == totalOps, "popped %d elements, expected %d", totalPops + remaining, totalOps);
+	for(iElem=0; iElem<totalOps; ++iElem)
+	{
+		ZOMBO_ASSERT(popCounts[iElem] == 1, "element %d popped %d times", iElem, popCounts[iElem]);
+	}
+
+	free(popCounts);
+	free(args);
+	free(threads);
+	free(queueBuffer);
+	return (double)(2*totalOps) / zomboTicksToSeconds(endTicks - startTicks);
+}
+
+int main(void)
+{
+	unsigned int randomSeed = (unsigned int)time(NULL);
+	const int32_t kOpsPerThread = 256*1024;
+	const int32_t kRelaxationFactor = 2;
+	int32_t maxThreadCount = 2*zomboCpuCount();
+	int32_t threadCount;
+	printf("Random seed: 0x%08X\n", randomSeed);
+	srand(randomSeed);
+
+	testSingleThreaded();
+
+	if (maxThreadCount < 4)
+		maxThreadCount = 4;
+	printf("\nThroughput (%d insert+pop pairs per thread, %d CPUs)\n", kOpsPerThread, zomboCpuCount());
+	printf("\tthreads   locked AlgoHeap (ops/sec)   MultiQueue c=%d (ops/sec)\n", kRelaxationFactor);
+	for(threadCount=1; threadCount<=maxThreadCount; threadCount *= 2)
+	{
+		/* A MultiQueue with a single heap is exactly one AlgoHeap behind one lock. */
+		double lockedRate = runMixedWorkload(threadCount, 1, 1, kOpsPerThread);
+		double multiRate = runMixedWorkload(threadCount, threadCount, kRelaxationFactor, kOpsPerThread);
+		printf("\t%7d   %25.0f   %24.0f\n", threadCount, lockedRate, multiRate);
+	}
+}
@@ -0,0 +1,192 @@
+#include "test_common.h"
+
+typedef struct TestHeap
+{
+	AlgoPairingHeap heap;
+	int32_t *contents; /* number of elements in the heap with each key */
+} TestHeap;
+
+static int testPairingHeapInsert(TestHeap *th, int32_t keyRange, AlgoPairingHeapNode handles[], int32_t elemId)
+{
+	int32_t beforeSize = -1, afterSize = -1;
+	AlgoData newKey = algoDataFromInt(rand() % keyRange);
+	AlgoData newData = algoDataFromInt(elemId);
+	AlgoError insertErr;
+	ALGO_VALIDATE( algoPairingHeapGetCurrentSize(th->heap, &beforeSize) );
+	insertErr = algoPairingHeapInsert(th->heap, newKey, newData, handles+elemId);
+	if (kAlgoErrorOperationFailed == insertErr)
+	{
+		return 0; /* node pool is exhausted */
+	}
+	ALGO_VALIDATE( insertErr );
+	th->contents[newKey.asInt] += 1;
+	ALGO_VALIDATE( algoPairingHeapGetCurrentSize(th->heap, &afterSize) );
+	ZOMBO_ASSERT(beforeSize+1 == afterSize, "heap grew by more than one entry");
+	return 1;
+}
+
+static int testPairingHeapPop(TestHeap *th, int32_t keyRange, AlgoPairingHeapNode handles[])
+{
+	int32_t beforeSize = -1, afterSize = -1;
+	AlgoData minKey, minKeyPeek;
+	AlgoData minData, minDataPeek;
+	int iVal;
+	ALGO_VALIDATE( algoPairingHeapGetCurrentSize(th->heap, &beforeSize) );
+	if (beforeSize == 0)
+	{
+		return 0; /* heap is empty */
+	}
+	ALGO_VALIDATE( algoPairingHeapPeek(th->heap, &minKeyPeek, &minDataPeek) );
+	ALGO_VALIDATE( algoPairingHeapPop(th->heap, &minKey, &minData) );
+	ZOMBO_ASSERT(minKeyPeek.asInt == minKey.asInt, "Peeked key (%d) does not match popped key (%d)", minKeyPeek.asInt, minKey.asInt);
+	ZOMBO_ASSERT(minDataPeek.asInt == minData.asInt, "Peeked data (%d) does not match popped data (%d)", minDataPeek.asInt, minData.asInt);
+	ZOMBO_ASSERT(minKey.asInt >= 0 && minKey.asInt < keyRange, "minKey (%d) must be in the range [0..%d)", minKey.asInt, keyRange);
+	for(iVal=0; iVal<minKey.asInt; ++iVal)
+	{
+		ZOMBO_ASSERT(th->contents[iVal] == 0, "minKey (%d) is not the smallest key in the heap", minKey.asInt);
+	}
+	ZOMBO_ASSERT(th->contents[minKey.asInt] > 0, "minKey (%d) is not actually in the heap", minKey.asInt);
+	ZOMBO_ASSERT(NULL != handles[minData.asInt], "popped element %d was not live", minData.asInt);
+	th->contents[minKey.asInt] -= 1;
+	handles[minData.asInt] = NULL;
+
+	ALGO_VALIDATE( algoPairingHeapGetCurrentSize(th->heap, &afterSize) );
+	ZOMBO_ASSERT(beforeSize-1 == afterSize, "heap shrunk by more than one element");
+	return 1;
+}
+
+static void testPairingHeapDecreaseKey(TestHeap *th, AlgoPairingHeapNode node)
+{
+	AlgoData oldKey, oldData, newKey, checkKey;
+	ALGO_VALIDATE( algoPairingHeapGetNodeContents(th->heap, node, &oldKey, &oldData) );
+	newKey = algoDataFromInt(oldKey.asInt - (rand() % (oldKey.asInt+1)));
+	ALGO_VALIDATE( algoPairingHeapDecreaseKey(th->heap, node, newKey) );
+	ALGO_VALIDATE( algoPairingHeapGetNodeContents(th->heap, node, &checkKey, NULL) );
+	ZOMBO_ASSERT(checkKey.asInt == newKey.asInt, "decreased key (%d) was not stored (%d)", newKey.asInt, checkKey.asInt);
+	th->contents[oldKey.asInt] -= 1;
+	th->contents[newKey.asInt] += 1;
+	if (oldKey.asInt > 0)
+	{
+		AlgoError err = algoPairingHeapDecreaseKey(th->heap, node, algoDataFromInt(newKey.asInt+1));
+		ZOMBO_ASSERT(kAlgoErrorInvalidArgument == err, "increasing a key returned %d (expected %d)", err, kAlgoErrorInvalidArgument);
+	}
+}
+
+int main(void)
+{
+	unsigned int randomSeed = (unsigned int)time(NULL);
+	const int32_t kNodeCapacity = 16*1024;
+	const int32_t kTestCount = 100;
+	int32_t nodeSize = 0;
+	size_t poolBufferSize = 0, heapBufferSize = 0;
+	void *poolBuffer = NULL, *heapBufferA = NULL, *heapBufferB = NULL;
+	AlgoAllocPool nodePool;
+	AlgoPairingHeapNode *handles = NULL;
+	uint8_t *elemOwners = NULL;
+	TestHeap heapA, heapB;
+	int32_t nextElemId = 0;
+	size_t reportedSize = 0;
+	int iTest;
+	printf("Random seed: 0x%08X\n", randomSeed);
+	srand(randomSeed);
+	printf("Testing AlgoPairingHeap (capacity: %d, test count: %d)\n", kNodeCapacity, kTestCount);
+
+	ALGO_VALIDATE( algoPairingHeapComputeNodeSize(&nodeSize) );
+	ALGO_VALIDATE( algoAllocPoolComputeBufferSize(&poolBufferSize, nodeSize, kNodeCapacity) );
+	poolBuffer = malloc(poolBufferSize);
+	ALGO_VALIDATE( algoAllocPoolCreate(&nodePool, nodeSize, kNodeCapacity, poolBuffer, poolBufferSize) );
+
+	ALGO_VALIDATE( algoPairingHeapComputeBufferSize(&heapBufferSize) );
+	heapBufferA = malloc(heapBufferSize);
+	heapBufferB = malloc(heapBufferSize);
+	ALGO_VALIDATE( algoPairingHeapCreate(&heapA.heap, algoDataCompareIntAscending, nodePool, heapBufferA, heapBufferSize) );
+	ALGO_VALIDATE( algoPairingHeapCreate(&heapB.heap, algoDataCompareIntAscending, nodePool, heapBufferB, heapBufferSize) );
+	heapA.contents = calloc(kNodeCapacity, sizeof(int32_t));
+	heapB.contents = calloc(kNodeCapacity, sizeof(int32_t));
+
+	ALGO_VALIDATE( algoPairingHeapGetBufferSize(heapA.heap, &reportedSize) );
+	ZOMBO_ASSERT(reportedSize == heapBufferSize, "reported size does not match input buffer size");
+
+	/* Element IDs index into handles[]; every insert uses a fresh ID so stale handles are never reused. */
+	handles = calloc(kNodeCapacity*kTestCount, sizeof(AlgoPairingHeapNode));
+	elemOwners = calloc(kNodeCapacity*kTestCount, sizeof(uint8_t)); /* 1 = heap A, 2 = heap B */
+
+	for(iTest=0; iTest<kTestCount; ++iTest)
+	{
+		int32_t sizeA = 0, sizeB = 0, elemCount = 0;
+		int32_t numAdds = rand() % kNodeCapacity;
+		int32_t iAdd, iPop, iVal, numPops, numDecreases;
+		printf(" - Adding %d elements...\n", numAdds);
+		for(iAdd=0; iAdd<numAdds; ++iAdd)
+		{
+			int32_t ownerIndex = 1 + (rand() % 2);
+			if (!testPairingHeapInsert((ownerIndex == 1) ? &heapA : &heapB, kNodeCapacity, handles, nextElemId))
+				break;
+			elemOwners[nextElemId] = (uint8_t)ownerIndex;
+			nextElemId += 1;
+		}
+		ALGO_VALIDATE( algoPairingHeapValidate(heapA.heap) );
+		ALGO_VALIDATE( algoPairingHeapValidate(heapB.heap) );
+
+		/* Decrease the keys of random live elements, in whichever heap they belong to. */
+		numDecreases = 0;
+		for(iVal=0; iVal<nextElemId && numDecreases < 1000; ++iVal)
+		{
+			int32_t elemId = rand() % nextElemId;
+			TestHeap *owner = (elemOwners[elemId] == 1) ? &heapA : &heapB;
+			AlgoData elemData;
+			if (NULL == handles[elemId])
+				continue;
+			ALGO_VALIDATE( algoPairingHeapGetNodeContents(owner->heap, handles[elemId], NULL, &elemData) );
+			ZOMBO_ASSERT(elemData.asInt == elemId, "handle %d refers to element %d", elemId, elemData.asInt);
+			testPairingHeapDecreaseKey(owner, handles[elemId]);
+			numDecreases += 1;
+		}
+		ALGO_VALIDATE( algoPairingHeapValidate(heapA.heap) );
+		ALGO_VALIDATE( algoPairingHeapValidate(heapB.heap) );
+
+		printf(" - Melding heaps...\n");
+		ALGO_VALIDATE( algoPairingHeapMeld(heapA.heap, heapB.heap) );
+		for(iVal=0; iVal<kNodeCapacity; ++iVal)
+		{
+			heapA.contents[iVal] += heapB.contents[iVal];
+			heapB.contents[iVal] = 0;
+		}
+		for(iVal=0; iVal<nextElemId; ++iVal)
+		{
+			elemOwners[iVal] = 1;
+		}
+		ALGO_VALIDATE( algoPairingHeapGetCurrentSize(heapB.heap, &sizeB) );
+		ZOMBO_ASSERT(0 == sizeB, "source heap should be empty after meld (size=%d)", sizeB);
+		ALGO_VALIDATE( algoPairingHeapValidate(heapA.heap) );
+		ALGO_VALIDATE( algoPairingHeapValidate(heapB.heap) );
+
+		ALGO_VALIDATE( algoPairingHeapGetCurrentSize(heapA.heap, &sizeA) );
+		numPops = (sizeA > 0) ? 1 + (rand() % sizeA) : 0;
+		printf(" - Popping %d elements...\n", numPops);
+		for(iPop=0; iPop<numPops; ++iPop)
+		{
+			testPairingHeapPop(&heapA, kNodeCapacity, handles);
+		}
+		ALGO_VALIDATE( algoPairingHeapValidate(heapA.heap) );
+
+		ALGO_VALIDATE( algoPairingHeapGetCurrentSize(heapA.heap, &sizeA) );
+		for(iVal=0; iVal<kNodeCapacity; ++iVal)
+		{
+			elemCount += heapA.contents[iVal];
+		}
+		ZOMBO_ASSERT(elemCount == sizeA, "elemCount (%d) != currentSize (%d)", elemCount, sizeA);
+		printf(" - %d elements left!\n\n", sizeA);
+#if defined(_MSC_VER)
+		_ASSERTE(_CrtCheckMemory());
+#endif
+	}
+
+	free(handles);
+	free(elemOwners);
+	free(heapA.contents);
+	free(heapB.contents);
+	free(heapBufferA);
+	free(heapBufferB);
+	free(poolBuffer);
+}
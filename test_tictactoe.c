@@ -276,6 +276,8 @@ int main(void)
 	AlgoGraphDfsCallbacks dfsCallbacks = {
 		dfsValidateVertex, NULL,
 		NULL, NULL,
+		NULL, NULL,
+		NULL, NULL,
 		NULL, NULL
 	};
 	ALGO_VALIDATE( algoGraphDfs(graph, dfsState, startVertexId, dfsCallbacks) );
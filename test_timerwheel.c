@@ -0,0 +1,251 @@
+#include "test_common.h"
+
+typedef struct TimerState
+{
+	uint64_t deadline;
+	AlgoTimerWheelTimer handle;
+	int32_t isPending;
+} TimerState;
+
+typedef struct FireContext
+{
+	TimerState *timers;
+	uint64_t previousTime; /* time before the current advance */
+	uint64_t lastDeadline; /* effective deadline of the most recently fired timer during the current advance */
+	int32_t fireCount;
+} FireContext;
+
+static void onTimerExpired(AlgoTimerWheel wheel, uint64_t deadline, AlgoData timerData, void *userData)
+{
+	FireContext *context = (FireContext*)userData;
+	TimerState *timer = context->timers + timerData.asInt;
+	uint64_t currentTime = 0;
+	ALGO_VALIDATE( algoTimerWheelGetCurrentTime(wheel, &currentTime) );
+	ZOMBO_ASSERT(timer->isPending, "timer %d fired but was not pending", timerData.asInt);
+	ZOMBO_ASSERT(timer->deadline == deadline, "timer %d reported deadline %llu, expected %llu", timerData.asInt,
+		(unsigned long long)deadline, (unsigned long long)timer->deadline);
+	ZOMBO_ASSERT(deadline <= currentTime, "timer %d fired early", timerData.asInt);
+	/* Timers that were already overdue when scheduled fire together, at the first tick after the previous advance. */
+	if (deadline <= context->previousTime)
+		deadline = context->previousTime + 1;
+	ZOMBO_ASSERT(deadline >= context->lastDeadline, "timer %d fired out of order", timerData.asInt);
+	context->lastDeadline = deadline;
+	timer->isPending = 0;
+	context->fireCount += 1;
+}
+
+static void testTimerWheel(int32_t timerCapacity, int32_t stepCount)
+{
+	size_t wheelBufferSize = 0;
+	void *wheelBuffer = NULL;
+	AlgoTimerWheel wheel;
+	TimerState *timers = calloc(timerCapacity, sizeof(TimerState));
+	FireContext context;
+	uint64_t currentTime = ((uint64_t)rand() << 20) + 16;
+	int32_t iStep, iTimer, currentSize = -1;
+	printf("Testing AlgoTimerWheel (capacity: %d, steps: %d)\n", timerCapacity, stepCount);
+
+	ALGO_VALIDATE( algoTimerWheelComputeBufferSize(&wheelBufferSize, timerCapacity) );
+	wheelBuffer = malloc(wheelBufferSize);
+	ALGO_VALIDATE( algoTimerWheelCreate(&wheel, timerCapacity, currentTime, wheelBuffer, wheelBufferSize) );
+	ALGO_VALIDATE( algoTimerWheelValidate(wheel) );
+
+	size_t reportedSize;
+	ALGO_VALIDATE( algoTimerWheelGetBufferSize(wheel, &reportedSize) );
+	ZOMBO_ASSERT(reportedSize == wheelBufferSize, "reported size does not match input buffer size");
+
+	context.timers = timers;
+	for(iStep=0; iStep<stepCount; ++iStep)
+	{
+		int32_t expectedFires = 0, pendingCount = 0;
+		uint64_t newTime;
+		/* Schedule, reschedule or cancel random timers, with deadlines spread across many orders of magnitude
+		   (including some that are already overdue). */
+		for(iTimer=0; iTimer<timerCapacity/16; ++iTimer)
+		{
+			TimerState *timer = timers + (rand() % timerCapacity);
+			AlgoData timerData = algoDataFromInt((int32_t)(timer - timers));
+			if (timer->isPending)
+			{
+				uint64_t deadline = 0;
+				AlgoData checkData;
+				ALGO_VALIDATE( algoTimerWheelGetTimerContents(wheel, timer->handle, &deadline, &checkData) );
+				ZOMBO_ASSERT(deadline == timer->deadline && checkData.asInt == timerData.asInt, "timer contents are incorrect");
+				ALGO_VALIDATE( algoTimerWheelCancel(wheel, timer->handle) );
+				timer->isPending = 0;
+				if (rand() % 2)
+					continue;
+			}
+			timer->deadline = currentTime + ((uint64_t)rand() << (rand() % 30)) - 16;
+			ALGO_VALIDATE( algoTimerWheelSchedule(wheel, timer->deadline, timerData, &timer->handle) );
+			timer->isPending = 1;
+		}
+		ALGO_VALIDATE( algoTimerWheelValidate(wheel) );
+
+		newTime = currentTime + ((uint64_t)rand() << (rand() % 20));
+		for(iTimer=0; iTimer<timerCapacity; ++iTimer)
+		{
+			pendingCount += timers[iTimer].isPending;
+			expectedFires += (timers[iTimer].isPending && timers[iTimer].deadline <= newTime) ? 1 : 0;
+		}
+		ALGO_VALIDATE( algoTimerWheelGetCurrentSize(wheel, &currentSize) );
+		ZOMBO_ASSERT(currentSize == pendingCount, "currentSize (%d) should be %d", currentSize, pendingCount);
+
+		context.previousTime = currentTime;
+		context.lastDeadline = 0;
+		context.fireCount = 0;
+		ALGO_VALIDATE( algoTimerWheelAdvance(wheel, newTime, onTimerExpired, &context) );
+		ZOMBO_ASSERT(context.fireCount == expectedFires, "%d timers fired, expected %d", context.fireCount, expectedFires);
+		ALGO_VALIDATE( algoTimerWheelValidate(wheel) );
+		currentTime = newTime;
+	}
+	AlgoError err = algoTimerWheelAdvance(wheel, currentTime-1, onTimerExpired, &context);
+	ZOMBO_ASSERT(kAlgoErrorInvalidArgument == err, "advancing backwards returned %d (expected %d)", err, kAlgoErrorInvalidArgument);
+
+	/* Fill the wheel to capacity, then drain it completely. */
+	ALGO_VALIDATE( algoTimerWheelGetCurrentSize(wheel, &currentSize) );
+	for(iTimer=0; iTimer<timerCapacity; ++iTimer)
+	{
+		if (!timers[iTimer].isPending)
+		{
+			timers[iTimer].deadline = currentTime + rand();
+			ALGO_VALIDATE( algoTimerWheelSchedule(wheel, timers[iTimer].deadline, algoDataFromInt(iTimer), &timers[iTimer].handle) );
+			timers[iTimer].isPending = 1;
+		}
+	}
+	err = algoTimerWheelSchedule(wheel, currentTime, algoDataFromInt(0), NULL);
+	ZOMBO_ASSERT(kAlgoErrorOperationFailed == err, "scheduling in a full wheel returned %d (expected %d)", err, kAlgoErrorOperationFailed);
+	context.previousTime = currentTime;
+	context.lastDeadline = 0;
+	context.fireCount = 0;
+	ALGO_VALIDATE( algoTimerWheelAdvance(wheel, UINT64_MAX, onTimerExpired, &context) );
+	ZOMBO_ASSERT(context.fireCount == timerCapacity, "%d timers fired, expected %d", context.fireCount, timerCapacity);
+	ALGO_VALIDATE( algoTimerWheelGetCurrentSize(wheel, &currentSize) );
+	ZOMBO_ASSERT(currentSize == 0, "wheel should be empty (size=%d)", currentSize);
+
+	free(wheelBuffer);
+	free(timers);
+}
+
+static void countExpired(AlgoTimerWheel wheel, uint64_t deadline, AlgoData timerData, void *userData)
+{
+	(void)wheel;
+	(void)deadline;
+	(void)timerData;
+	*(int32_t*)userData += 1;
+}
+
+/* Checks that algoTimerWheelAdvanceToNow() follows wall-clock time, in nanoseconds, while the process sleeps. */
+static void testTimerWheelClock(void)
+{
+	const uint64_t kDelayNs = 50*1000*1000;
+	size_t wheelBufferSize = 0;
+	void *wheelBuffer = NULL;
+	AlgoTimerWheel wheel;
+	int32_t fireCount = 0;
+	uint64_t startTime = algoTimerWheelClockTicks(), endTime;
+	printf("Testing algoTimerWheelAdvanceToNow()\n");
+
+	ALGO_VALIDATE( algoTimerWheelComputeBufferSize(&wheelBufferSize, 1) );
+	wheelBuffer = malloc(wheelBufferSize);
+	ALGO_VALIDATE( algoTimerWheelCreate(&wheel, 1, startTime, wheelBuffer, wheelBufferSize) );
+	ALGO_VALIDATE( algoTimerWheelSchedule(wheel, startTime + kDelayNs, algoDataFromInt(0), NULL) );
+	ALGO_VALIDATE( algoTimerWheelAdvanceToNow(wheel, countExpired, &fireCount) );
+	ZOMBO_ASSERT(fireCount == 0, "a timer %llu ns away fired immediately", (unsigned long long)kDelayNs);
+	zomboSleepMsec(2 * (uint32_t)(kDelayNs / 1000000));
+	ALGO_VALIDATE( algoTimerWheelAdvanceToNow(wheel, countExpired, &fireCount) );
+	ZOMBO_ASSERT(fireCount == 1, "the timer did not fire after sleeping past its deadline");
+	endTime = algoTimerWheelClockTicks();
+	ZOMBO_ASSERT(endTime - startTime >= kDelayNs, "sleeping for %llu ns only advanced the clock by %llu ns",
+		(unsigned long long)(2*kDelayNs), (unsigned long long)(endTime - startTime));
+
+	free(wheelBuffer);
+}
+
+/* Schedules timerCount timers, cancels half of them, then advances through every deadline in many small steps.
+   AlgoHeap has no cancel operation, so the heap version uses the usual lazy deletion: cancelled timers are flagged,
+   and skipped when they reach the top of the heap. */
+static void benchmarkTimers(int32_t timerCount, int32_t stepCount)
+{
+	const int32_t kMaxDelay = 1<<24;
+	int32_t *deadlines = malloc(timerCount*sizeof(int32_t));
+	uint8_t *isCancelled = calloc(timerCount, sizeof(uint8_t));
+	size_t heapBufferSize = 0, wheelBufferSize = 0;
+	void *heapBuffer = NULL, *wheelBuffer = NULL;
+	AlgoHeap heap;
+	AlgoTimerWheel wheel;
+	AlgoTimerWheelTimer *handles = malloc(timerCount*sizeof(AlgoTimerWheelTimer));
+	int32_t iTimer, iStep, heapFired = 0, wheelFired = 0;
+	uint64_t startTicks, heapTicks, wheelTicks;
+
+	for(iTimer=0; iTimer<timerCount; ++iTimer)
+	{
+		deadlines[iTimer] = 1 + (int32_t)(((uint32_t)rand() * 32768u + (uint32_t)rand()) % (uint32_t)kMaxDelay);
+	}
+
+	ALGO_VALIDATE( algoHeapComputeBufferSize(&heapBufferSize, timerCount) );
+	heapBuffer = malloc(heapBufferSize);
+	ALGO_VALIDATE( algoHeapCreate(&heap, timerCount, algoDataCompareIntAscending, heapBuffer, heapBufferSize) );
+	startTicks = zomboClockTicks();
+	for(iTimer=0; iTimer<timerCount; ++iTimer)
+	{
+		ALGO_VALIDATE( algoHeapInsert(heap, algoDataFromInt(deadlines[iTimer]), algoDataFromInt(iTimer)) );
+	}
+	for(iTimer=0; iTimer<timerCount; iTimer += 2)
+	{
+		isCancelled[iTimer] = 1;
+	}
+	for(iStep=1; iStep<=stepCount; ++iStep)
+	{
+		const int32_t now = (int32_t)((int64_t)kMaxDelay * iStep / stepCount);
+		AlgoData topKey, topData;
+		while(kAlgoErrorNone == algoHeapPeek(heap, &topKey, NULL) && topKey.asInt <= now)
+		{
+			ALGO_VALIDATE( algoHeapPop(heap, NULL, &topData) );
+			heapFired += isCancelled[topData.asInt] ? 0 : 1;
+		}
+	}
+	heapTicks = zomboClockTicks() - startTicks;
+
+	ALGO_VALIDATE( algoTimerWheelComputeBufferSize(&wheelBufferSize, timerCount) );
+	wheelBuffer = malloc(wheelBufferSize);
+	ALGO_VALIDATE( algoTimerWheelCreate(&wheel, timerCount, 0, wheelBuffer, wheelBufferSize) );
+	startTicks = zomboClockTicks();
+	for(iTimer=0; iTimer<timerCount; ++iTimer)
+	{
+		ALGO_VALIDATE( algoTimerWheelSchedule(wheel, deadlines[iTimer], algoDataFromInt(iTimer), handles+iTimer) );
+	}
+	for(iTimer=0; iTimer<timerCount; iTimer += 2)
+	{
+		ALGO_VALIDATE( algoTimerWheelCancel(wheel, handles[iTimer]) );
+	}
+	for(iStep=1; iStep<=stepCount; ++iStep)
+	{
+		const uint64_t now = (uint64_t)kMaxDelay * iStep / stepCount;
+		ALGO_VALIDATE( algoTimerWheelAdvance(wheel, now, countExpired, &wheelFired) );
+	}
+	wheelTicks = zomboClockTicks() - startTicks;
+
+	ZOMBO_ASSERT(heapFired == timerCount/2 && wheelFired == timerCount/2, "fired %d (heap) and %d (wheel) timers, expected %d",
+		heapFired, wheelFired, timerCount/2);
+	printf("Benchmark: %d timers, half cancelled, %d advances\n", timerCount, stepCount);
+	printf("\tAlgoHeap:       %8.3f ms\n", 1000.0 * zomboTicksToSeconds(heapTicks));
+	printf("\tAlgoTimerWheel: %8.3f ms\n", 1000.0 * zomboTicksToSeconds(wheelTicks));
+
+	free(handles);
+	free(wheelBuffer);
+	free(heapBuffer);
+	free(isCancelled);
+	free(deadlines);
+}
+
+int main(void)
+{
+	unsigned int randomSeed = (unsigned int)time(NULL);
+	printf("Random seed: 0x%08X\n", randomSeed);
+	srand(randomSeed);
+
+	testTimerWheel(16*1024, 1000);
+	testTimerWheelClock();
+	benchmarkTimers(1024*1024, 10000);
+}
@@ -5,12 +5,161 @@ typedef struct GraphEdge
 	int32_t v0, v1;
 } GraphEdge;
 
+#define kTopoSortThreadCount 4
+typedef struct TopoSortArgs
+{
+	AlgoGraphTopoSortParallel sort;
+	int32_t threadIndex;
+	AlgoError result;
+} TopoSortArgs;
+static ZomboThreadReturn ZOMBO_THREAD_CALL topoSortWorker(void *voidArgs)
+{
+	TopoSortArgs *args = (TopoSortArgs*)voidArgs;
+	args->result = algoGraphTopoSortParallel(args->sort, args->threadIndex);
+	return 0;
+}
+/* Runs a parallel topological sort on kTopoSortThreadCount threads, and returns the error code they all agree on. */
+static AlgoError runTopoSortParallel(AlgoGraph graph, int32_t sortedVertexIds[], int32_t vertexCount, int32_t vertexLevels[])
+{
+	size_t sortBufferSize = 0;
+	ALGO_VALIDATE( algoGraphTopoSortParallelComputeBufferSize(&sortBufferSize, graph, kTopoSortThreadCount) );
+	void *sortBuffer = malloc(sortBufferSize);
+	AlgoGraphTopoSortParallel sort;
+	ALGO_VALIDATE( algoGraphTopoSortParallelCreate(&sort, graph, kTopoSortThreadCount, sortedVertexIds, vertexCount, vertexLevels,
+		sortBuffer, sortBufferSize) );
+	ZomboThread threads[kTopoSortThreadCount];
+	TopoSortArgs args[kTopoSortThreadCount];
+	int iThread;
+	for(iThread=0; iThread<kTopoSortThreadCount; ++iThread)
+	{
+		args[iThread].sort = sort;
+		args[iThread].threadIndex = iThread;
+		int err = zomboThreadCreate(threads+iThread, topoSortWorker, args+iThread);
+		ZOMBO_ASSERT(err == 0, "thread creation failed (%d)", err);
+	}
+	for(iThread=0; iThread<kTopoSortThreadCount; ++iThread)
+	{
+		zomboThreadJoin(threads[iThread]);
+		ZOMBO_ASSERT(args[iThread].result == args[0].result, "threads disagree about the result");
+	}
+	free(sortBuffer);
+	return args[0].result;
+}
+
+/* Inserts random edges through an AlgoGraphTopoOrder, checking that it rejects exactly the edges that would close a cycle
+   and that the order stays valid for all accepted edges. */
+static void testTopoOrder(uint32_t graphFlags, int32_t vertexCount, int32_t initialEdgeCount, int32_t insertCount)
+{
+	const int32_t edgeCapacity = initialEdgeCount + insertCount;
+	size_t graphBufferSize = 0, orderBufferSize = 0, bfsStateBufferSize = 0, topoBufferSize = 0;
+	void *graphBuffer = NULL, *orderBuffer = NULL, *bfsStateBuffer = NULL, *topoBuffer = NULL;
+	AlgoGraph graph;
+	AlgoGraphTopoOrder order;
+	AlgoGraphBfsState bfsState;
+	AlgoGraphBfsCallbacks bfsCallbacks = {NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
+	GraphEdge *edges = malloc(edgeCapacity*sizeof(GraphEdge));
+	int32_t *sortedVertexIds = malloc(vertexCount*sizeof(int32_t));
+	int32_t edgeCount = 0, rejectedCount = 0, iVert, iEdge, iInsert;
+	uint64_t startTicks, insertTicks = 0, sortTicks;
+	printf("Testing AlgoGraphTopoOrder (%s%d vertices, %d initial edges, %d insertions)\n",
+		(graphFlags & kAlgoGraphInEdges) ? "in-edges, " : "", vertexCount, initialEdgeCount, insertCount);
+
+	ALGO_VALIDATE( algoGraphComputeBufferSizeWithFlags(&graphBufferSize, vertexCount, edgeCapacity, kAlgoGraphEdgeDirected,
+		kAlgoGraphEdgeIndexNone, graphFlags) );
+	graphBuffer = malloc(graphBufferSize);
+	ALGO_VALIDATE( algoGraphCreateWithFlags(&graph, vertexCount, edgeCapacity, kAlgoGraphEdgeDirected, kAlgoGraphEdgeIndexNone,
+		graphFlags, graphBuffer, graphBufferSize) );
+	for(iVert=0; iVert<vertexCount; ++iVert)
+	{
+		int32_t vertexId = -1;
+		ALGO_VALIDATE( algoGraphAddVertex(graph, algoDataFromInt(iVert), &vertexId) );
+	}
+	/* Start from a DAG whose edges all point from lower to higher vertex IDs. */
+	for(iEdge=0; iEdge<initialEdgeCount; ++iEdge)
+	{
+		int32_t v0 = rand() % (vertexCount-1);
+		int32_t v1 = v0 + 1 + (rand() % (vertexCount-v0-1));
+		ALGO_VALIDATE( algoGraphAddEdge(graph, v0, v1) );
+		edges[edgeCount].v0 = v0;
+		edges[edgeCount].v1 = v1;
+		edgeCount += 1;
+	}
+	ALGO_VALIDATE( algoGraphTopoOrderComputeBufferSize(&orderBufferSize, graph) );
+	orderBuffer = malloc(orderBufferSize);
+	ALGO_VALIDATE( algoGraphTopoOrderCreate(&order, graph, orderBuffer, orderBufferSize) );
+	size_t reportedSize;
+	ALGO_VALIDATE( algoGraphTopoOrderGetBufferSize(order, &reportedSize) );
+	ZOMBO_ASSERT(reportedSize == orderBufferSize, "reported size does not match input buffer size");
+	ALGO_VALIDATE( algoGraphBfsStateComputeBufferSize(&bfsStateBufferSize, graph) );
+	bfsStateBuffer = malloc(bfsStateBufferSize);
+
+	for(iInsert=0; iInsert<insertCount; ++iInsert)
+	{
+		int32_t v0 = rand() % vertexCount, v1 = rand() % vertexCount;
+		if (v0 == v1)
+			continue;
+		startTicks = zomboClockTicks();
+		AlgoError insertErr = algoGraphTopoOrderAddEdge(order, v0, v1);
+		insertTicks += zomboClockTicks() - startTicks;
+		if (kAlgoErrorNone == insertErr)
+		{
+			edges[edgeCount].v0 = v0;
+			edges[edgeCount].v1 = v1;
+			edgeCount += 1;
+			continue;
+		}
+		ZOMBO_ASSERT(kAlgoErrorOperationFailed == insertErr, "unexpected error %d", insertErr);
+		rejectedCount += 1;
+		if (rejectedCount <= 100) /* confirm that the rejected edge really closes a cycle */
+		{
+			int isReachable = 0;
+			ALGO_VALIDATE( algoGraphBfsStateCreate(&bfsState, graph, bfsStateBuffer, bfsStateBufferSize) );
+			ALGO_VALIDATE( algoGraphBfs(graph, bfsState, v1, bfsCallbacks) );
+			ALGO_VALIDATE( algoGraphBfsStateIsVertexDiscovered(bfsState, v0, &isReachable) );
+			ZOMBO_ASSERT(isReachable, "edge %d->%d was rejected, but %d can't reach %d", v0, v1, v1, v0);
+		}
+	}
+	for(iEdge=0; iEdge<edgeCount; ++iEdge)
+	{
+		int32_t index0 = -1, index1 = -1;
+		ALGO_VALIDATE( algoGraphTopoOrderGetVertexIndex(order, edges[iEdge].v0, &index0) );
+		ALGO_VALIDATE( algoGraphTopoOrderGetVertexIndex(order, edges[iEdge].v1, &index1) );
+		ZOMBO_ASSERT(index0 < index1, "Edge %d [%d->%d] is not properly sorted", iEdge, edges[iEdge].v0, edges[iEdge].v1);
+	}
+	ALGO_VALIDATE( algoGraphTopoOrderGetSortedVertices(order, sortedVertexIds, vertexCount) );
+	for(iVert=1; iVert<vertexCount; ++iVert)
+	{
+		int32_t index0 = -1, index1 = -1;
+		ALGO_VALIDATE( algoGraphTopoOrderGetVertexIndex(order, sortedVertexIds[iVert-1], &index0) );
+		ALGO_VALIDATE( algoGraphTopoOrderGetVertexIndex(order, sortedVertexIds[iVert], &index1) );
+		ZOMBO_ASSERT(index0 < index1, "sorted vertices are out of order");
+	}
+
+	ALGO_VALIDATE( algoGraphTopoSortComputeBufferSize(&topoBufferSize, graph) );
+	topoBuffer = malloc(topoBufferSize);
+	startTicks = zomboClockTicks();
+	ALGO_VALIDATE( algoGraphTopoSort(graph, sortedVertexIds, vertexCount, topoBuffer, topoBufferSize) );
+	sortTicks = zomboClockTicks() - startTicks;
+	printf("\t%d edges rejected; %.3f us/insertion (a full algoGraphTopoSort() takes %.3f ms)\n", rejectedCount,
+		1000000.0 * zomboTicksToSeconds(insertTicks) / insertCount, 1000.0 * zomboTicksToSeconds(sortTicks));
+
+	free(topoBuffer);
+	free(bfsStateBuffer);
+	free(orderBuffer);
+	free(graphBuffer);
+	free(sortedVertexIds);
+	free(edges);
+}
+
 int main(void)
 {
 	unsigned int randomSeed = (unsigned int)time(NULL);
 	printf("Random seed: 0x%08X\n", randomSeed);
 	srand(randomSeed);
 
+	testTopoOrder(kAlgoGraphDefault, 32768, 65536, 16384);
+	testTopoOrder(kAlgoGraphInEdges, 32768, 65536, 16384);
+
 	for(;;)
 	{
 		int32_t kVertexCapacity = 16384;
@@ -37,7 +186,7 @@ int main(void)
 		ZOMBO_ASSERT(actualVertexCount == vertexCount, "adding N vertices didn't result in an N-vertex graph...?");
 
 		GraphEdge *edges = malloc(kEdgeCapacity*sizeof(GraphEdge));
-		size_t edgesEntryCount = 0;
+		int32_t edgesEntryCount = 0;
 		for(iEdge=0; iEdge<vertexCount*kAverageEdgesPerVertex; ++iEdge)
 		{
 			int32_t srcVertex = iEdge % vertexCount;
@@ -61,8 +210,54 @@ int main(void)
 		ALGO_VALIDATE( algoGraphTopoSortComputeBufferSize(&topoBufferSize, graph) );
 		void *topoBuffer = malloc(topoBufferSize);
 		ALGO_VALIDATE( algoGraphTopoSort(graph, sortedVertexIds, vertexCount, topoBuffer, topoBufferSize) );
+
+		printf("\tTopoSort (CSR)\n");
+		size_t csrBufferSize = 0;
+		ALGO_VALIDATE( algoGraphFreezeComputeBufferSize(&csrBufferSize, graph) );
+		void *csrBuffer = malloc(csrBufferSize);
+		AlgoGraphCsr csr;
+		ALGO_VALIDATE( algoGraphFreeze(graph, &csr, csrBuffer, csrBufferSize) );
+		int32_t *csrSortedVertexIds = malloc(vertexCount*sizeof(int32_t));
+		ALGO_VALIDATE( algoGraphCsrTopoSort(csr, csrSortedVertexIds, vertexCount, topoBuffer, topoBufferSize) );
+		ZOMBO_ASSERT(0 == memcmp(sortedVertexIds, csrSortedVertexIds, vertexCount*sizeof(int32_t)),
+			"CSR topological sort does not match");
+		free(csrSortedVertexIds);
+		free(csrBuffer);
 		free(topoBuffer);
 
+		printf("\tTopoSort (parallel)\n");
+		int32_t *parallelSortedVertexIds = malloc(vertexCount*sizeof(int32_t));
+		int32_t *vertexLevels = malloc(kVertexCapacity*sizeof(int32_t));
+		uint8_t *hasTightPredecessor = calloc(kVertexCapacity, sizeof(uint8_t));
+		ALGO_VALIDATE( runTopoSortParallel(graph, parallelSortedVertexIds, vertexCount, vertexLevels) );
+		for(int iSortedVert=1; iSortedVert<vertexCount; ++iSortedVert)
+		{
+			ZOMBO_ASSERT(vertexLevels[parallelSortedVertexIds[iSortedVert-1]] <= vertexLevels[parallelSortedVertexIds[iSortedVert]],
+				"parallel sort output is not ordered by level");
+		}
+		/* Every edge must go to a higher level, and every vertex above level 0 needs a predecessor exactly one level below. */
+		for(iEdge=0; iEdge<edgesEntryCount; ++iEdge)
+		{
+			int32_t level0 = vertexLevels[edges[iEdge].v0], level1 = vertexLevels[edges[iEdge].v1];
+			ZOMBO_ASSERT(level0 >= 0 && level1 > level0, "edge %d->%d goes from level %d to level %d", edges[iEdge].v0, edges[iEdge].v1,
+				level0, level1);
+			hasTightPredecessor[edges[iEdge].v1] |= (level1 == level0+1) ? 1 : 0;
+		}
+		for(iVert=0; iVert<vertexCount; ++iVert)
+		{
+			ZOMBO_ASSERT(vertexLevels[iVert] == 0 || hasTightPredecessor[iVert], "vertex %d's level (%d) is too high", iVert, vertexLevels[iVert]);
+		}
+		/* Reversing any edge creates a cycle. */
+		ALGO_VALIDATE( algoGraphAddEdge(graph, edges[0].v1, edges[0].v0) );
+		AlgoError cycleErr = runTopoSortParallel(graph, parallelSortedVertexIds, vertexCount, vertexLevels);
+		ZOMBO_ASSERT(cycleErr == kAlgoErrorOperationFailed, "sorting a graph with a cycle returned %d (expected %d)",
+			cycleErr, kAlgoErrorOperationFailed);
+		ZOMBO_ASSERT(vertexLevels[edges[0].v0] == -1 && vertexLevels[edges[0].v1] == -1, "vertices on a cycle should not be sorted");
+		ALGO_VALIDATE( algoGraphRemoveEdge(graph, edges[0].v1, edges[0].v0) );
+		free(hasTightPredecessor);
+		free(vertexLevels);
+		free(parallelSortedVertexIds);
+
 		printf("\tVerifying results\n");
 		int isSortCorrect = 1;
 		int32_t *vertexToSortedIndex = malloc(kVertexCapacity*sizeof(int32_t));